@@ -0,0 +1,208 @@
+/**
+ * CjkTokenizer 实现
+ */
+
+#include "cjk_tokenizer.h"
+#include <sqlite3.h>
+#include <iostream>
+#include <new>
+#include <vector>
+
+namespace suyan {
+
+namespace {
+
+/**
+ * 分词器实例：包装的 unicode61 分词器
+ */
+struct TokenizerInstance {
+    fts5_tokenizer base;
+    Fts5Tokenizer* baseTokenizer = nullptr;
+};
+
+/**
+ * 一次分词调用的上下文
+ */
+struct TokenizeContext {
+    void* ftsContext;
+    int flags;
+    int (*xToken)(void*, int, const char*, int, int, int);
+    std::vector<int> charOffsets;       // 复用的字符偏移缓冲区
+};
+
+int xCreate(void* userData, const char** args, int argCount, Fts5Tokenizer** out) {
+    auto* api = static_cast<fts5_api*>(userData);
+    auto* instance = new (std::nothrow) TokenizerInstance();
+    if (!instance) {
+        return SQLITE_NOMEM;
+    }
+
+    void* baseUserData = nullptr;
+    int rc = api->xFindTokenizer(api, "unicode61", &baseUserData, &instance->base);
+    if (rc == SQLITE_OK) {
+        // 参数（如 remove_diacritics）原样传给 unicode61
+        rc = instance->base.xCreate(baseUserData, args, argCount, &instance->baseTokenizer);
+    }
+    if (rc != SQLITE_OK) {
+        delete instance;
+        return rc;
+    }
+
+    *out = reinterpret_cast<Fts5Tokenizer*>(instance);
+    return SQLITE_OK;
+}
+
+void xDelete(Fts5Tokenizer* tokenizer) {
+    auto* instance = reinterpret_cast<TokenizerInstance*>(tokenizer);
+    if (instance->baseTokenizer) {
+        instance->base.xDelete(instance->baseTokenizer);
+    }
+    delete instance;
+}
+
+/**
+ * 处理 unicode61 输出的一个词：不含中日韩字符时原样输出，否则切分
+ */
+int splitToken(void* ctx, int tflags, const char* token, int tokenLen, int start, int end) {
+    auto* context = static_cast<TokenizeContext*>(ctx);
+
+    // 记录每个字符的起始字节偏移，同时判断是否含中日韩字符
+    auto& offsets = context->charOffsets;
+    offsets.clear();
+    bool hasCjk = false;
+    for (int pos = 0; pos < tokenLen;) {
+        offsets.push_back(pos);
+        hasCjk |= CjkTokenizer::isCjk(CjkTokenizer::decodeUtf8(token, tokenLen, pos));
+    }
+    if (!hasCjk) {
+        return context->xToken(context->ftsContext, tflags, token, tokenLen, start, end);
+    }
+    int charCount = static_cast<int>(offsets.size());
+    offsets.push_back(tokenLen);
+
+    // 折叠前后长度一致时可以精确定位原文偏移，否则使用整个词的范围
+    bool exactOffsets = (end - start) == tokenLen;
+    auto emit = [&](int firstChar, int lastChar, int flags) {
+        int from = offsets[firstChar];
+        int to = offsets[lastChar + 1];
+        return context->xToken(context->ftsContext, flags, token + from, to - from,
+                               exactOffsets ? start + from : start,
+                               exactOffsets ? start + to : end);
+    };
+    auto isCjkAt = [&](int index) {
+        int pos = offsets[index];
+        return CjkTokenizer::isCjk(CjkTokenizer::decodeUtf8(token, tokenLen, pos));
+    };
+
+    bool isDocument = (context->flags & FTS5_TOKENIZE_DOCUMENT) != 0;
+    int i = 0;
+    while (i < charCount) {
+        bool cjk = isCjkAt(i);
+        int runEnd = i + 1;
+        while (runEnd < charCount && isCjkAt(runEnd) == cjk) {
+            ++runEnd;
+        }
+
+        int rc = SQLITE_OK;
+        if (!cjk || runEnd - i == 1) {
+            // 非中日韩片段或单个字：整体输出
+            rc = emit(i, runEnd - 1, 0);
+        } else {
+            for (int j = i; j + 1 < runEnd && rc == SQLITE_OK; ++j) {
+                rc = emit(j, j + 1, 0);
+            }
+            // 段末字与最后一个二元组同位置，供单字前缀查询命中
+            if (rc == SQLITE_OK && isDocument) {
+                rc = emit(runEnd - 1, runEnd - 1, FTS5_TOKEN_COLOCATED);
+            }
+        }
+        if (rc != SQLITE_OK) {
+            return rc;
+        }
+        i = runEnd;
+    }
+    return SQLITE_OK;
+}
+
+int xTokenize(Fts5Tokenizer* tokenizer, void* ctx, int flags, const char* text, int textLen,
+              int (*xToken)(void*, int, const char*, int, int, int)) {
+    auto* instance = reinterpret_cast<TokenizerInstance*>(tokenizer);
+    TokenizeContext context{ctx, flags, xToken, {}};
+    return instance->base.xTokenize(instance->baseTokenizer, &context, flags, text, textLen,
+                                    splitToken);
+}
+
+/**
+ * 获取连接的 FTS5 API（SQLite 未启用 FTS5 时返回 nullptr）
+ */
+fts5_api* getFts5Api(sqlite3* db) {
+    fts5_api* api = nullptr;
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, "SELECT fts5(?1)", -1, &stmt, nullptr) == SQLITE_OK) {
+        sqlite3_bind_pointer(stmt, 1, &api, "fts5_api_ptr", nullptr);
+        sqlite3_step(stmt);
+    }
+    sqlite3_finalize(stmt);
+    return api;
+}
+
+} // anonymous namespace
+
+bool CjkTokenizer::registerTokenizer(sqlite3* db) {
+    fts5_api* api = getFts5Api(db);
+    if (!api) {
+        std::cerr << "CjkTokenizer: SQLite 未启用 FTS5" << std::endl;
+        return false;
+    }
+
+    fts5_tokenizer tokenizer{xCreate, xDelete, xTokenize};
+    int rc = api->xCreateTokenizer(api, kName, api, &tokenizer, nullptr);
+    if (rc != SQLITE_OK) {
+        std::cerr << "CjkTokenizer: 注册分词器失败: " << sqlite3_errstr(rc) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+uint32_t CjkTokenizer::decodeUtf8(const char* s, int len, int& pos) {
+    auto c = static_cast<unsigned char>(s[pos++]);
+    if (c < 0x80) {
+        return c;
+    }
+    int extra = c >= 0xF0 ? 3 : (c >= 0xE0 ? 2 : 1);
+    uint32_t cp = c & (0x3F >> extra);
+    for (int i = 0; i < extra && pos < len; ++i) {
+        cp = (cp << 6) | (static_cast<unsigned char>(s[pos++]) & 0x3F);
+    }
+    return cp;
+}
+
+bool CjkTokenizer::isCjk(uint32_t codepoint) {
+    return (codepoint >= 0x3040 && codepoint <= 0x30FF)      // 平假名、片假名
+        || (codepoint >= 0x3400 && codepoint <= 0x4DBF)      // 扩展 A
+        || (codepoint >= 0x4E00 && codepoint <= 0x9FFF)      // 基本汉字
+        || (codepoint >= 0xAC00 && codepoint <= 0xD7AF)      // 谚文音节
+        || (codepoint >= 0xF900 && codepoint <= 0xFAFF)      // 兼容汉字
+        || (codepoint >= 0x20000 && codepoint <= 0x3134F);   // 扩展 B 及以后
+}
+
+bool CjkTokenizer::isIndexedSubstring(const std::string& keyword) {
+    const char* text = keyword.data();
+    int len = static_cast<int>(keyword.size());
+    bool hasCjk = false;
+    for (int pos = 0; pos < len;) {
+        uint32_t cp = decodeUtf8(text, len, pos);
+        if (isCjk(cp)) {
+            hasCjk = true;
+        } else if (cp < 0x80) {
+            if ((cp >= '0' && cp <= '9') || ((cp | 0x20) >= 'a' && (cp | 0x20) <= 'z')) {
+                return false;
+            }
+        } else if (!(cp >= 0x3000 && cp <= 0x303F) && !(cp >= 0xFF00 && cp <= 0xFF0F)) {
+            return false;   // 中文标点以外的其他文字
+        }
+    }
+    return hasCjk;
+}
+
+} // namespace suyan
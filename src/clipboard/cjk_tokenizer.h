@@ -0,0 +1,70 @@
+/**
+ * CjkTokenizer - 剪贴板全文搜索的中日韩分词器
+ *
+ * FTS5 默认的 unicode61 分词器把一整段连续的汉字当作一个词，
+ * 无法按子串搜索中文（如在「明天下午的会议纪要」中搜索「会议」）。
+ *
+ * 本分词器包装 unicode61：非中日韩文字保持 unicode61 的分词和大小写折叠，
+ * 连续的中日韩字符切分为重叠的二元组（bigram）：
+ *   「会议纪要」 → 会议 / 议纪 / 纪要 (+ 末字「要」，与「纪要」同位置)
+ *
+ * 查询时同样切分为二元组，按短语匹配即为子串匹配。
+ * 文档中每段末字额外以同位置（colocated）的单字索引，
+ * 使单字前缀查询（「要」*）也能命中段末的字。
+ */
+
+#ifndef SUYAN_CLIPBOARD_CJK_TOKENIZER_H
+#define SUYAN_CLIPBOARD_CJK_TOKENIZER_H
+
+#include <cstdint>
+#include <string>
+
+// 前向声明 SQLite
+struct sqlite3;
+
+namespace suyan {
+
+/**
+ * CjkTokenizer - 分词器注册工具类
+ *
+ * 无状态工具类，所有方法均为静态方法。
+ */
+class CjkTokenizer {
+public:
+    /**
+     * 分词器名称（建表时 tokenize='suyan_cjk'）
+     */
+    static constexpr const char* kName = "suyan_cjk";
+
+    /**
+     * 在数据库连接上注册分词器
+     *
+     * 分词器按连接注册，每次打开数据库后、访问 FTS 表之前都需要调用。
+     *
+     * @param db 数据库连接
+     * @return 是否成功（SQLite 未启用 FTS5 时返回 false）
+     */
+    static bool registerTokenizer(sqlite3* db);
+
+    /**
+     * 解码一个 UTF-8 字符，返回码位并前移 pos
+     */
+    static uint32_t decodeUtf8(const char* s, int len, int& pos);
+
+    /**
+     * 判断码位是否为中日韩文字（汉字、假名、谚文）
+     */
+    static bool isCjk(uint32_t codepoint);
+
+    /**
+     * 判断关键词能否完全由索引匹配
+     *
+     * 关键词只含中日韩文字（以及空白和标点）时，二元组索引能找到所有子串匹配；
+     * 含英文、数字等其他文字时，词中间的子串（如 "ello"）不在索引中，需要另行匹配。
+     */
+    static bool isIndexedSubstring(const std::string& keyword);
+};
+
+} // namespace suyan
+
+#endif // SUYAN_CLIPBOARD_CJK_TOKENIZER_H
@@ -0,0 +1,166 @@
+/**
+ * ClipboardIngestor 实现
+ */
+
+#include "clipboard_ingestor.h"
+#include <algorithm>
+#include <iostream>
+
+namespace suyan {
+
+namespace {
+
+/**
+ * 判断两份待入库内容是否按同一内容合并
+ *
+ * 只在两边都已有完整指纹且相同时合并。预筛键只采样部分字节，
+ * 相同长度、只在采样窗口之外不同的内容（如改了一个数字）预筛键也相同，
+ * 不能据此丢弃；没有完整指纹的内容都保留，由入库线程和存储去重。
+ */
+bool isQueuedDuplicate(const ClipboardContent& a, const ClipboardContent& b) {
+    return a.type == b.type &&
+           !a.contentHash.empty() &&
+           a.contentHash == b.contentHash;
+}
+
+} // namespace
+
+ClipboardIngestor::ClipboardIngestor(Handler handler, size_t capacity,
+                                     const IContentFingerprinter& fingerprinter)
+    : handler_(std::move(handler))
+    , capacity_(std::max<size_t>(1, capacity))
+    , fingerprinter_(fingerprinter)
+{
+}
+
+ClipboardIngestor::~ClipboardIngestor() {
+    stop();
+}
+
+// ========== 启动和停止 ==========
+
+void ClipboardIngestor::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+        return;
+    }
+
+    stopping_ = false;
+    running_ = true;
+    worker_ = std::thread(&ClipboardIngestor::run, this);
+}
+
+void ClipboardIngestor::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        stopping_ = true;
+    }
+    queueCondition_.notify_one();
+
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+}
+
+bool ClipboardIngestor::isRunning() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_ && !stopping_;
+}
+
+// ========== 队列操作 ==========
+
+bool ClipboardIngestor::enqueue(ClipboardContent content) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_ || stopping_) {
+            return false;
+        }
+
+        // 相同内容在队列中等待时，只保留最新的一次（来源应用以最新为准）
+        // 不在主线程持锁计算完整指纹，只合并完整指纹相同的内容
+        auto it = std::find_if(queue_.begin(), queue_.end(),
+            [&content](const ClipboardContent& pending) {
+                return isQueuedDuplicate(pending, content);
+            });
+        if (it != queue_.end()) {
+            queue_.erase(it);
+            ++coalescedCount_;
+        }
+
+        // 队列已满：丢弃最旧的待处理内容
+        if (queue_.size() >= capacity_) {
+            queue_.pop_front();
+            ++droppedCount_;
+            std::cerr << "ClipboardIngestor: 队列已满，丢弃最旧的内容" << std::endl;
+        }
+
+        queue_.push_back(std::move(content));
+    }
+    queueCondition_.notify_one();
+    return true;
+}
+
+void ClipboardIngestor::waitForIdle() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idleCondition_.wait(lock, [this] {
+        return !running_ || (queue_.empty() && !busy_);
+    });
+}
+
+size_t ClipboardIngestor::getPendingCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+}
+
+uint64_t ClipboardIngestor::getCoalescedCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return coalescedCount_;
+}
+
+uint64_t ClipboardIngestor::getDroppedCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return droppedCount_;
+}
+
+// ========== 工作线程 ==========
+
+void ClipboardIngestor::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        queueCondition_.wait(lock, [this] {
+            return stopping_ || !queue_.empty();
+        });
+
+        // 停止前处理完剩余内容
+        if (queue_.empty()) {
+            break;
+        }
+
+        ClipboardContent content = std::move(queue_.front());
+        queue_.pop_front();
+        busy_ = true;
+
+        lock.unlock();
+        ContentFingerprint::ensureHash(content, fingerprinter_);
+        if (handler_) {
+            handler_(content);
+        }
+        lock.lock();
+
+        busy_ = false;
+        if (queue_.empty()) {
+            idleCondition_.notify_all();
+        }
+    }
+
+    // 唤醒停止期间仍在等待的调用方
+    idleCondition_.notify_all();
+}
+
+} // namespace suyan
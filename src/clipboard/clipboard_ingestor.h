@@ -0,0 +1,143 @@
+/**
+ * ClipboardIngestor - 剪贴板内容后台入库队列
+ *
+ * 剪贴板变化在主线程回调，而入库需要查重、写 SQLite，
+ * 图片还要解码、重新编码和生成缩略图，大截图会让候选窗口和输入法卡顿。
+ *
+ * 主线程只把内容放入有界队列，由专用工作线程按顺序逐个处理：
+ * - 队列中已有完整指纹相同的内容时合并，只保留最新的一次
+ *   （入队时不计算完整指纹；没有完整指纹的内容都保留，由工作线程补齐指纹后交给存储去重）
+ * - 队列已满时丢弃最旧的待处理内容（剪贴板快速变化时，中间状态价值最低）
+ *
+ * 工作线程在调用处理函数前补齐完整指纹（contentHash）。
+ * 处理函数在工作线程执行，需要通知 UI 时由调用方投递回主线程。
+ */
+
+#ifndef SUYAN_CLIPBOARD_CLIPBOARD_INGESTOR_H
+#define SUYAN_CLIPBOARD_CLIPBOARD_INGESTOR_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "clipboard_monitor.h"
+#include "content_fingerprint.h"
+
+namespace suyan {
+
+/**
+ * ClipboardIngestor - 后台入库队列
+ *
+ * 单个工作线程，保证入库顺序与剪贴板变化顺序一致。
+ */
+class ClipboardIngestor {
+public:
+    /**
+     * 入库处理函数（在工作线程调用）
+     */
+    using Handler = std::function<void(const ClipboardContent&)>;
+
+    /**
+     * 默认队列容量
+     *
+     * 图片内容可能有数 MB，容量限制了排队内容占用的内存。
+     */
+    static constexpr size_t kDefaultCapacity = 8;
+
+    /**
+     * 构造入库队列
+     *
+     * @param handler 入库处理函数
+     * @param capacity 队列容量（至少为 1）
+     * @param fingerprinter 完整指纹算法（需比调用方存活更久）
+     */
+    explicit ClipboardIngestor(Handler handler, size_t capacity = kDefaultCapacity,
+                               const IContentFingerprinter& fingerprinter =
+                                   ContentFingerprint::defaultFingerprinter());
+
+    /**
+     * 析构时停止工作线程（处理完剩余内容）
+     */
+    ~ClipboardIngestor();
+
+    // 禁止拷贝和移动
+    ClipboardIngestor(const ClipboardIngestor&) = delete;
+    ClipboardIngestor& operator=(const ClipboardIngestor&) = delete;
+    ClipboardIngestor(ClipboardIngestor&&) = delete;
+    ClipboardIngestor& operator=(ClipboardIngestor&&) = delete;
+
+    /**
+     * 启动工作线程
+     */
+    void start();
+
+    /**
+     * 停止工作线程
+     *
+     * 处理完队列中剩余的内容后返回，之后 enqueue() 不再接受内容。
+     */
+    void stop();
+
+    /**
+     * 检查工作线程是否在运行
+     */
+    bool isRunning() const;
+
+    /**
+     * 加入队列（主线程调用，不阻塞）
+     *
+     * @param content 剪贴板内容
+     * @return 是否已加入（未运行时返回 false）
+     */
+    bool enqueue(ClipboardContent content);
+
+    /**
+     * 等待队列中的内容全部处理完成
+     */
+    void waitForIdle();
+
+    /**
+     * 获取待处理数量
+     */
+    size_t getPendingCount() const;
+
+    /**
+     * 获取合并的内容数（与待处理内容相同）
+     */
+    uint64_t getCoalescedCount() const;
+
+    /**
+     * 获取因队列已满丢弃的内容数
+     */
+    uint64_t getDroppedCount() const;
+
+private:
+    /**
+     * 工作线程主循环
+     */
+    void run();
+
+    // 成员变量
+    Handler handler_;
+    size_t capacity_;
+    const IContentFingerprinter& fingerprinter_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable queueCondition_;    // 有新内容或请求停止
+    std::condition_variable idleCondition_;     // 队列处理完成
+    std::deque<ClipboardContent> queue_;
+    std::thread worker_;
+    bool running_ = false;
+    bool stopping_ = false;
+    bool busy_ = false;                         // 工作线程正在处理一项内容
+    uint64_t coalescedCount_ = 0;
+    uint64_t droppedCount_ = 0;
+};
+
+} // namespace suyan
+
+#endif // SUYAN_CLIPBOARD_CLIPBOARD_INGESTOR_H
@@ -0,0 +1,146 @@
+/**
+ * ClipboardItemDelegate 实现
+ *
+ * 样式与原先的列表项组件一致：左侧 60x40 缩略图区域，右侧两行（预览、相对时间），
+ * 底部分隔线。文本按可用宽度省略，不换行。
+ *
+ * Requirements: 5.3-5.6
+ */
+
+#include "clipboard_item_delegate.h"
+#include "clipboard_list_model.h"
+
+#include <QDateTime>
+#include <QFontMetrics>
+#include <QPainter>
+#include <QPainterPath>
+
+namespace suyan {
+
+ClipboardItemDelegate::ClipboardItemDelegate(QObject* parent)
+    : QStyledItemDelegate(parent)
+{
+    contentFont_.setPixelSize(13);
+    timestampFont_.setPixelSize(11);
+}
+
+void ClipboardItemDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option,
+                                  const QModelIndex& index) const
+{
+    // 直接读取模型中的记录，绘制时不经过 QVariant 转换
+    auto* model = qobject_cast<const ClipboardListModel*>(index.model());
+    if (!model || index.row() >= model->rowCount()) {
+        return;
+    }
+    const PreviewRecord& record = model->recordAt(index.row());
+
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+
+    const QRect& rect = option.rect;
+
+    // 背景：选中为半透明蓝色，悬停为半透明黑色
+    if (option.state & QStyle::State_Selected) {
+        painter->fillRect(rect, QColor(0, 122, 255, 40));
+    } else if (option.state & QStyle::State_MouseOver) {
+        painter->fillRect(rect, QColor(0, 0, 0, 20));
+    }
+
+    QRect content = rect.adjusted(MARGIN_H, MARGIN_V, -MARGIN_H, -MARGIN_V);
+
+    // 左侧：缩略图（仅图片类型，已按显示尺寸缓存，不读取文件、不解码）
+    if (record.type == ClipboardContentType::Image) {
+        QRect thumbnailRect(content.left(), content.top() + (content.height() - THUMBNAIL_HEIGHT) / 2,
+                            THUMBNAIL_WIDTH, THUMBNAIL_HEIGHT);
+        QPainterPath background;
+        background.addRoundedRect(thumbnailRect, 4, 4);
+        painter->fillPath(background, QColor(0xf0, 0xf0, 0xf0));
+
+        QPixmap thumbnail = ThumbnailCache::instance().pixmap(record.thumbnailPath);
+        if (!thumbnail.isNull()) {
+            QRect target(QPoint(0, 0), thumbnail.size());
+            target.moveCenter(thumbnailRect.center());
+            painter->drawPixmap(target, thumbnail);
+        } else {
+            // 尚未加载（后台加载完成后重绘）或无法解码：显示占位
+            painter->setFont(timestampFont_);
+            painter->setPen(QColor(0x99, 0x99, 0x99));
+            painter->drawText(thumbnailRect, Qt::AlignCenter, QStringLiteral("[图片]"));
+        }
+
+        content.setLeft(thumbnailRect.right() + 1 + SPACING);
+    }
+
+    // 右侧：内容预览和时间戳，两行整体垂直居中
+    QFontMetrics contentMetrics(contentFont_);
+    QFontMetrics timestampMetrics(timestampFont_);
+    int blockHeight = contentMetrics.height() + LINE_SPACING + timestampMetrics.height();
+    int top = content.top() + (content.height() - blockHeight) / 2;
+
+    QRect textRect(content.left(), top, content.width(), contentMetrics.height());
+    QString text = contentMetrics.elidedText(ClipboardListModel::displayText(record),
+                                             Qt::ElideRight, textRect.width());
+    painter->setFont(contentFont_);
+    painter->setPen(QColor(0x33, 0x33, 0x33));
+    painter->drawText(textRect, Qt::AlignLeft | Qt::AlignVCenter, text);
+
+    QRect timestampRect(content.left(), textRect.bottom() + 1 + LINE_SPACING,
+                        content.width(), timestampMetrics.height());
+    painter->setFont(timestampFont_);
+    painter->setPen(QColor(0x99, 0x99, 0x99));
+    painter->drawText(timestampRect, Qt::AlignLeft | Qt::AlignVCenter, formatRelativeTime(record.lastUsedAt));
+
+    // 底部分隔线
+    painter->setRenderHint(QPainter::Antialiasing, false);
+    painter->setPen(QColor(230, 230, 230));
+    painter->drawLine(rect.left() + MARGIN_H, rect.bottom(), rect.right() - MARGIN_H, rect.bottom());
+
+    painter->restore();
+}
+
+QSize ClipboardItemDelegate::sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const
+{
+    Q_UNUSED(index);
+    return QSize(option.rect.width(), ITEM_HEIGHT);
+}
+
+QString ClipboardItemDelegate::formatRelativeTime(int64_t timestampMs)
+{
+    QDateTime recordTime = QDateTime::fromMSecsSinceEpoch(timestampMs);
+    QDateTime now = QDateTime::currentDateTime();
+    qint64 diffSecs = recordTime.secsTo(now);
+
+    if (diffSecs < 60) {
+        return "刚刚";
+    }
+
+    qint64 diffMins = diffSecs / 60;
+    if (diffMins < 60) {
+        return QString("%1分钟前").arg(diffMins);
+    }
+
+    qint64 diffHours = diffMins / 60;
+    if (diffHours < 24) {
+        return QString("%1小时前").arg(diffHours);
+    }
+
+    qint64 diffDays = diffHours / 24;
+    if (diffDays < 7) {
+        return QString("%1天前").arg(diffDays);
+    }
+
+    if (diffDays < 30) {
+        qint64 weeks = diffDays / 7;
+        return QString("%1周前").arg(weeks);
+    }
+
+    if (diffDays < 365) {
+        qint64 months = diffDays / 30;
+        return QString("%1个月前").arg(months);
+    }
+
+    qint64 years = diffDays / 365;
+    return QString("%1年前").arg(years);
+}
+
+} // namespace suyan
@@ -0,0 +1,74 @@
+/**
+ * ClipboardItemDelegate - 剪贴板列表项绘制
+ *
+ * 在 QListView 中直接绘制单条记录：缩略图（图片类型）、内容预览、相对时间。
+ * 选中、悬停状态取自视图（QStyle::State_Selected、State_MouseOver），
+ * 不为列表项创建任何 widget，滚动时每帧只绘制可见的几行。
+ *
+ * Requirements: 5.3-5.6
+ */
+
+#ifndef SUYAN_CLIPBOARD_CLIPBOARD_ITEM_DELEGATE_H
+#define SUYAN_CLIPBOARD_CLIPBOARD_ITEM_DELEGATE_H
+
+#include <QStyledItemDelegate>
+#include <QFont>
+#include <QString>
+#include <cstdint>
+
+#include "thumbnail_cache.h"
+
+namespace suyan {
+
+/**
+ * ClipboardItemDelegate - 剪贴板列表项绘制
+ *
+ * 直接读取 ClipboardListModel 中的记录（不经过 QVariant），缩略图取自 ThumbnailCache（只在 UI 线程绘制）。
+ */
+class ClipboardItemDelegate : public QStyledItemDelegate {
+    Q_OBJECT
+
+public:
+    /**
+     * 列表项高度（固定，视图按统一高度布局）
+     */
+    static constexpr int ITEM_HEIGHT = 60;
+
+    explicit ClipboardItemDelegate(QObject* parent = nullptr);
+    ~ClipboardItemDelegate() override = default;
+
+    /**
+     * 绘制列表项
+     */
+    void paint(QPainter* painter, const QStyleOptionViewItem& option,
+               const QModelIndex& index) const override;
+
+    /**
+     * 列表项尺寸（宽度随视图，高度固定）
+     */
+    QSize sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+
+    /**
+     * 格式化相对时间
+     *
+     * @param timestampMs Unix 毫秒时间戳
+     * @return 相对时间字符串（如"5分钟前"）
+     */
+    static QString formatRelativeTime(int64_t timestampMs);
+
+private:
+    QFont contentFont_;     // 内容预览字体（13px）
+    QFont timestampFont_;   // 时间戳字体（11px）
+
+    // 样式常量
+    static constexpr int THUMBNAIL_WIDTH = ThumbnailCache::kDisplayWidth;
+    static constexpr int THUMBNAIL_HEIGHT = ThumbnailCache::kDisplayHeight;
+    static constexpr int MARGIN_H = 12;     // 左右边距
+    static constexpr int MARGIN_V = 8;      // 上下边距
+    static constexpr int SPACING = 12;      // 缩略图与内容的间距
+    static constexpr int LINE_SPACING = 4;  // 内容与时间戳的行距
+};
+
+} // namespace suyan
+
+#endif // SUYAN_CLIPBOARD_CLIPBOARD_ITEM_DELEGATE_H
@@ -2,19 +2,23 @@
  * ClipboardList 实现
  *
  * 性能优化：
- * - 虚拟化渲染：仅渲染可见区域的 widget，减少内存占用
- * - 懒加载：滚动时按需加载更多记录
- * - 延迟缩略图加载：滚动停止后才加载图片
- * - Widget 回收：超出可见区域的 widget 被回收
+ * - 模型/视图：列表项由委托直接绘制，不创建、回收 widget
+ * - 统一项高度：可见范围由视图按滚动位置直接计算，不逐项查询位置
+ * - 懒加载：滚动接近底部时按游标加载下一页
+ * - 后台搜索：按请求序号丢弃过时的结果，第一页之后送达的完整结果只插入其余记录
+ * - 后台缩略图：图集中没有的缩略图先显示占位，加载完成后重绘
  *
  * Requirements: 5.2, 6.1-6.5
  */
 
 #include "clipboard_list.h"
-#include "clipboard_manager.h"
+#include "clipboard_list_model.h"
+#include "clipboard_item_delegate.h"
+#include "clipboard_searcher.h"
+#include "thumbnail_cache.h"
 
 #include <QScrollBar>
-#include <QListWidgetItem>
+#include <QKeyEvent>
 #include <QApplication>
 
 namespace suyan {
@@ -24,6 +28,28 @@ ClipboardList::ClipboardList(QWidget* parent)
 {
     setupUI();
     connectSignals();
+
+    // 后台搜索，结果投递回主线程
+    searcher_ = std::make_unique<ClipboardSearcher>([this](SearchResult result) {
+        QMetaObject::invokeMethod(this, [this, result = std::move(result)]() mutable {
+            onSearchResult(std::move(result));
+        });
+    }, SEARCH_LIMIT, ClipboardListModel::kPageSize);
+    searcher_->start();
+
+    // 缩略图在后台加载完成后重绘可见的行
+    ThumbnailCache::instance().setReadyHandler([this](const std::string&) {
+        QMetaObject::invokeMethod(this, [this]() {
+            listView_->viewport()->update();
+        });
+    });
+}
+
+ClipboardList::~ClipboardList()
+{
+    // 先停止工作线程，之后不会再投递结果
+    ThumbnailCache::instance().setReadyHandler(nullptr);
+    searcher_->stop();
 }
 
 void ClipboardList::setupUI()
@@ -32,36 +58,38 @@ void ClipboardList::setupUI()
     mainLayout_->setContentsMargins(0, 0, 0, 0);
     mainLayout_->setSpacing(0);
 
-    // 创建列表组件
-    listWidget_ = new QListWidget(this);
-    listWidget_->setFrameShape(QFrame::NoFrame);
-    listWidget_->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-    listWidget_->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
-    listWidget_->setSelectionMode(QAbstractItemView::SingleSelection);
-    listWidget_->setSpacing(0);
-    
-    // 启用统一项高度以优化性能
-    listWidget_->setUniformItemSizes(true);
+    // 创建模型和委托
+    model_ = new ClipboardListModel(this);
+    delegate_ = new ClipboardItemDelegate(this);
+
+    // 创建列表视图
+    listView_ = new QListView(this);
+    listView_->setModel(model_);
+    listView_->setItemDelegate(delegate_);
+    listView_->setFrameShape(QFrame::NoFrame);
+    listView_->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    listView_->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+    listView_->setSelectionMode(QAbstractItemView::SingleSelection);
+    listView_->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    listView_->setSpacing(0);
+
+    // 统一项高度：视图只向委托查询一次尺寸，按行号计算位置
+    listView_->setUniformItemSizes(true);
+
+    // 悬停高亮（委托按 State_MouseOver 绘制）
+    listView_->setMouseTracking(true);
+    listView_->viewport()->setAttribute(Qt::WA_Hover, true);
+    listView_->viewport()->setCursor(Qt::PointingHandCursor);
 
     // 设置样式
-    listWidget_->setStyleSheet(
-        "QListWidget {"
+    listView_->setStyleSheet(
+        "QListView {"
         "    background-color: white;"
         "    border: none;"
         "}"
-        "QListWidget::item {"
-        "    border: none;"
-        "    padding: 0px;"
-        "}"
-        "QListWidget::item:selected {"
-        "    background-color: transparent;"
-        "}"
-        "QListWidget::item:hover {"
-        "    background-color: transparent;"
-        "}"
     );
 
-    mainLayout_->addWidget(listWidget_);
+    mainLayout_->addWidget(listView_);
 
     // 创建空列表提示标签
     emptyHintLabel_ = new QLabel(this);
@@ -75,276 +103,103 @@ void ClipboardList::setupUI()
     );
     emptyHintLabel_->hide();
     mainLayout_->addWidget(emptyHintLabel_);
-
-    // 创建滚动停止检测定时器
-    scrollStopTimer_ = new QTimer(this);
-    scrollStopTimer_->setSingleShot(true);
-    connect(scrollStopTimer_, &QTimer::timeout,
-            this, &ClipboardList::onScrollingStopped);
 }
 
 void ClipboardList::connectSignals()
 {
-    // 连接滚动条信号，实现懒加载和虚拟化渲染
-    connect(listWidget_->verticalScrollBar(), &QScrollBar::valueChanged,
+    // 连接滚动条信号，实现懒加载
+    connect(listView_->verticalScrollBar(), &QScrollBar::valueChanged,
             this, &ClipboardList::onScrollValueChanged);
+
+    connect(listView_, &QListView::clicked,
+            this, &ClipboardList::onItemClicked);
+    connect(listView_->selectionModel(), &QItemSelectionModel::currentChanged,
+            this, &ClipboardList::onCurrentChanged);
 }
 
 void ClipboardList::loadRecords()
 {
-    // 清空当前列表
-    clear();
-
-    // 重置状态
-    loadedCount_ = 0;
-    hasMoreRecords_ = true;
-    isFiltering_ = false;
+    // 清空当前列表并重置状态
     currentKeyword_.clear();
-    allRecords_.clear();
-    renderedIndices_.clear();
-
-    // 加载第一批记录
-    loadMoreRecords();
-}
-
-void ClipboardList::loadMoreRecords()
-{
-    if (isLoading_ || !hasMoreRecords_ || isFiltering_) {
-        return;
-    }
-
-    isLoading_ = true;
-
-    // 从数据库加载记录
-    auto records = ClipboardStore::instance().getAllRecords(PAGE_SIZE, loadedCount_);
-
-    if (records.empty()) {
-        hasMoreRecords_ = false;
-        isLoading_ = false;
-        updateEmptyHint();
-        return;
-    }
-
-    // 如果返回的记录数少于 PAGE_SIZE，说明没有更多记录了
-    if (static_cast<int>(records.size()) < PAGE_SIZE) {
-        hasMoreRecords_ = false;
-    }
-
-    // 添加记录到列表（仅创建占位项）
-    for (const auto& record : records) {
-        addRecordToList(record);
-        allRecords_.push_back(record);
-    }
+    selectedRecordId_ = -1;
+    showEmptyHint(false);
 
-    loadedCount_ += static_cast<int>(records.size());
-    isLoading_ = false;
+    // 停止搜索；重新加载意味着记录可能有变化，之前的搜索结果不能再用于细化
+    searcher_->cancel();
+    searcher_->invalidateCache();
+    searchGeneration_ = 0;
 
-    // 更新可见区域的 widget
-    updateVisibleWidgets();
+    // 加载第一批记录
+    model_->loadFirstPage();
 
     updateEmptyHint();
-    emit loadCompleted(loadedCount_);
-}
-
-void ClipboardList::addRecordToList(const ClipboardRecord& record)
-{
-    Q_UNUSED(record);
-    
-    // 创建列表项（占位，不创建 widget）
-    auto* item = new QListWidgetItem(listWidget_);
-    
-    // 设置固定高度（与 ClipboardItemWidget::WIDGET_HEIGHT 一致）
-    item->setSizeHint(QSize(listWidget_->viewport()->width(), 60));
-}
-
-ClipboardItemWidget* ClipboardList::ensureWidgetForIndex(int index)
-{
-    if (index < 0 || index >= static_cast<int>(allRecords_.size())) {
-        return nullptr;
-    }
-
-    auto* item = listWidget_->item(index);
-    if (!item) {
-        return nullptr;
-    }
-
-    // 检查是否已有 widget
-    auto* existingWidget = qobject_cast<ClipboardItemWidget*>(
-        listWidget_->itemWidget(item)
-    );
-    if (existingWidget) {
-        return existingWidget;
-    }
-
-    // 创建新的 widget
-    const auto& record = allRecords_[index];
-    auto* widget = new ClipboardItemWidget(record, listWidget_);
-    
-    // 设置列表项大小
-    item->setSizeHint(widget->sizeHint());
-    
-    // 将 widget 设置到列表项
-    listWidget_->setItemWidget(item, widget);
-    
-    // 连接点击信号
-    connect(widget, &ClipboardItemWidget::clicked,
-            this, &ClipboardList::onItemClicked);
-
-    // 如果是选中的记录，设置选中状态
-    if (record.id == selectedRecordId_) {
-        widget->setSelected(true);
-    }
-
-    renderedIndices_.insert(index);
-    return widget;
-}
-
-void ClipboardList::recycleInvisibleWidgets()
-{
-    if (renderedIndices_.size() <= MAX_RENDERED_WIDGETS) {
-        return;
-    }
-
-    int firstVisible, lastVisible;
-    getVisibleRange(firstVisible, lastVisible);
-
-    // 扩展可见范围（保留缓冲区）
-    int keepStart = qMax(0, firstVisible - VISIBLE_BUFFER);
-    int keepEnd = qMin(listWidget_->count() - 1, lastVisible + VISIBLE_BUFFER);
-
-    // 收集需要回收的索引
-    QList<int> toRecycle;
-    for (int index : renderedIndices_) {
-        if (index < keepStart || index > keepEnd) {
-            toRecycle.append(index);
-        }
-    }
-
-    // 回收 widget
-    for (int index : toRecycle) {
-        auto* item = listWidget_->item(index);
-        if (item) {
-            auto* widget = listWidget_->itemWidget(item);
-            if (widget) {
-                listWidget_->removeItemWidget(item);
-                widget->deleteLater();
-            }
-        }
-        renderedIndices_.remove(index);
-    }
+    emit loadCompleted(model_->rowCount());
 }
 
-void ClipboardList::getVisibleRange(int& firstVisible, int& lastVisible) const
+void ClipboardList::loadMoreRecords()
 {
-    firstVisible = -1;
-    lastVisible = -1;
-
-    if (listWidget_->count() == 0) {
+    if (!model_->canFetchMore(QModelIndex())) {
         return;
     }
 
-    QRect viewportRect = listWidget_->viewport()->rect();
-    
-    // 查找第一个可见项
-    for (int i = 0; i < listWidget_->count(); ++i) {
-        auto* item = listWidget_->item(i);
-        QRect itemRect = listWidget_->visualItemRect(item);
-        if (itemRect.intersects(viewportRect)) {
-            firstVisible = i;
-            break;
-        }
-    }
-
-    // 查找最后一个可见项
-    for (int i = listWidget_->count() - 1; i >= 0; --i) {
-        auto* item = listWidget_->item(i);
-        QRect itemRect = listWidget_->visualItemRect(item);
-        if (itemRect.intersects(viewportRect)) {
-            lastVisible = i;
-            break;
-        }
-    }
-}
-
-void ClipboardList::updateVisibleWidgets()
-{
-    int firstVisible, lastVisible;
-    getVisibleRange(firstVisible, lastVisible);
-
-    if (firstVisible < 0 || lastVisible < 0) {
+    int previousCount = model_->rowCount();
+    model_->fetchMore(QModelIndex());
+    if (model_->rowCount() == previousCount) {
         return;
     }
 
-    // 扩展渲染范围（预渲染缓冲区）
-    int renderStart = qMax(0, firstVisible - VISIBLE_BUFFER);
-    int renderEnd = qMin(listWidget_->count() - 1, lastVisible + VISIBLE_BUFFER);
-
-    // 为可见范围内的项创建 widget
-    for (int i = renderStart; i <= renderEnd; ++i) {
-        ensureWidgetForIndex(i);
-    }
-
-    // 回收不可见的 widget
-    recycleInvisibleWidgets();
-}
-
-void ClipboardList::onScrollingStopped()
-{
-    // 滚动停止后，确保所有可见项都有 widget
-    updateVisibleWidgets();
+    // 选中的记录可能在新加载的一页中
+    syncSelection();
+    emit loadCompleted(model_->rowCount());
 }
 
 void ClipboardList::filterByKeyword(const QString& keyword)
 {
     currentKeyword_ = keyword.trimmed();
-
-    // 清空当前列表
-    listWidget_->clear();
     selectedRecordId_ = -1;
-    renderedIndices_.clear();
-    allRecords_.clear();
 
     if (currentKeyword_.isEmpty()) {
         // 关键词为空，退出过滤模式，重新加载
-        isFiltering_ = false;
-        loadedCount_ = 0;
-        hasMoreRecords_ = true;
-        loadMoreRecords();
+        searcher_->cancel();
+        searchGeneration_ = 0;
+        model_->loadFirstPage();
+        updateEmptyHint();
+        emit loadCompleted(model_->rowCount());
         return;
     }
 
-    // 进入过滤模式
-    isFiltering_ = true;
-
-    // 使用 FTS 搜索
-    auto results = ClipboardStore::instance().searchText(
-        currentKeyword_.toStdString(), 
-        1000  // 搜索时返回更多结果
-    );
+    // 后台搜索（搜索时返回更多结果，不再分页），取代之前未完成的搜索
+    searchGeneration_ = searcher_->search(currentKeyword_.toStdString());
+}
 
-    // 添加搜索结果到列表
-    for (const auto& record : results) {
-        allRecords_.push_back(record);
-        addRecordToList(record);
+void ClipboardList::onSearchResult(SearchResult result)
+{
+    // 已被新的搜索或重新加载取代
+    if (result.generation == 0 || result.generation != searchGeneration_) {
+        return;
     }
 
-    // 更新可见区域的 widget
-    updateVisibleWidgets();
-
-    // 更新空列表提示
-    if (results.empty()) {
-        showEmptyHint(true, "无匹配结果");
+    if (shownSearchGeneration_ == result.generation) {
+        // 第一页之后送达的完整结果
+        model_->extendSearchResults(std::move(result.records));
     } else {
-        showEmptyHint(false);
+        model_->setSearchResults(std::move(result.records));
+        shownSearchGeneration_ = result.generation;
+    }
+    if (result.complete) {
+        searchGeneration_ = 0;
     }
 
-    emit loadCompleted(static_cast<int>(results.size()));
+    // 更新空列表提示
+    updateEmptyHint();
+    emit loadCompleted(model_->rowCount());
 }
 
 void ClipboardList::refresh()
 {
-    if (isFiltering_ && !currentKeyword_.isEmpty()) {
-        // 过滤模式下，重新执行搜索
+    if (!currentKeyword_.isEmpty()) {
+        // 过滤模式下，记录有变化，重新执行搜索（不在之前的结果中细化）
+        searcher_->invalidateCache();
         filterByKeyword(currentKeyword_);
     } else {
         // 正常模式下，重新加载
@@ -354,18 +209,16 @@ void ClipboardList::refresh()
 
 void ClipboardList::clear()
 {
-    listWidget_->clear();
-    allRecords_.clear();
-    loadedCount_ = 0;
-    hasMoreRecords_ = true;
+    searcher_->cancel();
+    searchGeneration_ = 0;
+    model_->clear();
     selectedRecordId_ = -1;
-    renderedIndices_.clear();
     showEmptyHint(false);
 }
 
 int ClipboardList::recordCount() const
 {
-    return listWidget_->count();
+    return model_->rowCount();
 }
 
 int64_t ClipboardList::selectedRecordId() const
@@ -375,73 +228,74 @@ int64_t ClipboardList::selectedRecordId() const
 
 void ClipboardList::selectRecord(int64_t recordId)
 {
-    // 先取消之前的选中状态
-    for (int i = 0; i < listWidget_->count(); ++i) {
-        auto* item = listWidget_->item(i);
-        auto* widget = qobject_cast<ClipboardItemWidget*>(
-            listWidget_->itemWidget(item)
-        );
-        if (widget) {
-            if (widget->recordId() == recordId) {
-                widget->setSelected(true);
-                selectedRecordId_ = recordId;
-                listWidget_->scrollToItem(item);
-            } else if (widget->recordId() == selectedRecordId_) {
-                widget->setSelected(false);
-            }
-        }
-    }
-    
     selectedRecordId_ = recordId;
+    syncSelection();
 }
 
-void ClipboardList::updateTimestamps()
+void ClipboardList::syncSelection()
 {
-    // 只更新已渲染的 widget
-    for (int index : renderedIndices_) {
-        auto* item = listWidget_->item(index);
-        if (item) {
-            auto* widget = qobject_cast<ClipboardItemWidget*>(
-                listWidget_->itemWidget(item)
-            );
-            if (widget) {
-                widget->updateTimestamp();
-            }
-        }
+    int row = model_->rowOf(selectedRecordId_);
+    if (row < 0) {
+        return;
+    }
+
+    QModelIndex index = model_->index(row);
+    if (listView_->currentIndex() != index) {
+        listView_->selectionModel()->setCurrentIndex(index, QItemSelectionModel::ClearAndSelect);
     }
+    listView_->scrollTo(index);
 }
 
-void ClipboardList::onScrollValueChanged(int value)
+void ClipboardList::updateTimestamps()
 {
-    // 重启滚动停止检测定时器
-    scrollStopTimer_->start(SCROLL_STOP_DELAY_MS);
-    lastScrollValue_ = value;
+    // 相对时间在绘制时计算，只需重绘可见项
+    listView_->viewport()->update();
+}
 
-    // 检查是否滚动到底部附近，触发懒加载
-    QScrollBar* scrollBar = listWidget_->verticalScrollBar();
-    int maxValue = scrollBar->maximum();
+void ClipboardList::keyPressEvent(QKeyEvent* event)
+{
+    if (event->key() == Qt::Key_Down || event->key() == Qt::Key_Up) {
+        QApplication::sendEvent(listView_, event);
+        return;
+    }
+    QWidget::keyPressEvent(event);
+}
 
-    if (maxValue - value < SCROLL_THRESHOLD) {
+void ClipboardList::onScrollValueChanged(int value)
+{
+    // 检查是否滚动到底部附近，提前加载下一页
+    // （视图只在滚动到最底部时才调用 fetchMore，提前加载避免滚动停顿）
+    QScrollBar* scrollBar = listView_->verticalScrollBar();
+    if (scrollBar->maximum() - value < SCROLL_THRESHOLD) {
         loadMoreRecords();
     }
-
-    // 实时更新可见区域的 widget
-    updateVisibleWidgets();
 }
 
-void ClipboardList::onItemClicked(int64_t recordId)
+void ClipboardList::onItemClicked(const QModelIndex& index)
 {
+    if (!index.isValid()) {
+        return;
+    }
+
     // 更新选中状态
+    int64_t recordId = model_->recordAt(index.row()).id;
     selectRecord(recordId);
 
     // 发射选中信号
     emit itemSelected(recordId);
 }
 
+void ClipboardList::onCurrentChanged(const QModelIndex& current)
+{
+    if (current.isValid()) {
+        selectedRecordId_ = model_->recordAt(current.row()).id;
+    }
+}
+
 void ClipboardList::updateEmptyHint()
 {
-    if (listWidget_->count() == 0) {
-        if (isFiltering_) {
+    if (model_->rowCount() == 0) {
+        if (model_->isSearchResult()) {
             showEmptyHint(true, "无匹配结果");
         } else {
             showEmptyHint(true, "暂无剪贴板历史");
@@ -457,10 +311,10 @@ void ClipboardList::showEmptyHint(bool show, const QString& message)
     if (show) {
         emptyHintLabel_->setText(message);
         emptyHintLabel_->show();
-        listWidget_->hide();
+        listView_->hide();
     } else {
         emptyHintLabel_->hide();
-        listWidget_->show();
+        listView_->show();
     }
 }
 
@@ -1,13 +1,16 @@
 /**
  * ClipboardList - 剪贴板历史列表视图
  *
- * 封装 QListWidget，实现剪贴板历史记录的列表展示。
+ * 封装 QListView，实现剪贴板历史记录的列表展示。
  * 支持滚动懒加载、关键词过滤、记录选择。
  * 
  * 性能优化：
- * - 虚拟化渲染：仅渲染可见区域的 widget
- * - 懒加载：滚动时按需加载更多记录
- * - 延迟缩略图加载：滚动停止后才加载图片
+ * - 模型/视图：ClipboardListModel 只保存预览记录，ClipboardItemDelegate 直接绘制列表项，
+ *   不为列表项创建 widget，滚动时每帧只绘制可见的几行
+ * - 统一项高度：视图按行号直接计算位置，不逐项测量
+ * - 懒加载：滚动接近底部时按游标加载下一页
+ * - 后台搜索：关键词过滤由 ClipboardSearcher 在工作线程执行，继续输入时在上一次结果中细化，
+ *   结果较多时先显示第一页，新输入中止过时的查询
  *
  * Requirements: 5.2, 6.1-6.5
  */
@@ -16,26 +19,26 @@
 #define SUYAN_CLIPBOARD_CLIPBOARD_LIST_H
 
 #include <QWidget>
-#include <QListWidget>
+#include <QListView>
 #include <QVBoxLayout>
 #include <QLabel>
-#include <QScrollBar>
 #include <QString>
-#include <QTimer>
-#include <QSet>
-#include <vector>
 #include <cstdint>
-
-#include "clipboard_store.h"
-#include "clipboard_item_widget.h"
+#include <memory>
 
 namespace suyan {
 
+// 前向声明
+class ClipboardListModel;
+class ClipboardItemDelegate;
+class ClipboardSearcher;
+struct SearchResult;
+
 /**
  * ClipboardList - 剪贴板历史列表视图
  *
- * 封装 QListWidget，提供剪贴板历史记录的列表展示功能。
- * 实现虚拟化渲染以优化大数据量下的滚动性能。
+ * 封装 QListView，提供剪贴板历史记录的列表展示功能。
+ * 内存占用只与已加载的预览记录数有关，与滚动位置和可见行数无关。
  */
 class ClipboardList : public QWidget {
     Q_OBJECT
@@ -47,19 +50,21 @@ public:
      * @param parent 父组件
      */
     explicit ClipboardList(QWidget* parent = nullptr);
-    ~ClipboardList() override = default;
+    ~ClipboardList() override;
 
     /**
      * 加载历史记录
      *
-     * 清空当前列表，从数据库加载记录并创建 ClipboardItemWidget。
-     * 初始加载 PAGE_SIZE 条记录，后续通过滚动懒加载。
+     * 清空当前列表，从数据库加载第一页记录（ClipboardListModel::kPageSize 条），
+     * 后续通过滚动懒加载。
      */
     void loadRecords();
 
     /**
      * 根据关键词过滤显示
      *
+     * 在后台搜索，结果送达前保留当前列表，送达后发射 loadCompleted。
+     *
      * @param keyword 搜索关键词，空字符串显示全部
      */
     void filterByKeyword(const QString& keyword);
@@ -96,7 +101,7 @@ public:
     void selectRecord(int64_t recordId);
 
     /**
-     * 更新所有项的时间戳显示
+     * 更新所有项的时间戳显示（重绘可见项，相对时间在绘制时计算）
      */
     void updateTimestamps();
 
@@ -120,9 +125,15 @@ signals:
      */
     void listEmpty();
 
+protected:
+    /**
+     * 按键事件：上下键移动选中项（窗口转发的导航键）
+     */
+    void keyPressEvent(QKeyEvent* event) override;
+
 private slots:
     /**
-     * 处理滚动事件，实现懒加载
+     * 处理滚动事件，接近底部时预先加载下一页
      *
      * @param value 滚动条当前值
      */
@@ -131,19 +142,14 @@ private slots:
     /**
      * 处理列表项点击
      *
-     * @param recordId 被点击的记录 ID
+     * @param index 被点击的列表项
      */
-    void onItemClicked(int64_t recordId);
+    void onItemClicked(const QModelIndex& index);
 
     /**
-     * 更新可见区域的 widget（虚拟化渲染）
+     * 视图的当前项变化（键盘导航）时同步选中的记录 ID
      */
-    void updateVisibleWidgets();
-
-    /**
-     * 滚动停止后的处理（延迟加载缩略图等）
-     */
-    void onScrollingStopped();
+    void onCurrentChanged(const QModelIndex& current);
 
 private:
     /**
@@ -162,32 +168,14 @@ private:
     void loadMoreRecords();
 
     /**
-     * 添加记录到列表（仅创建占位项，不创建 widget）
-     *
-     * @param record 剪贴板记录
-     */
-    void addRecordToList(const ClipboardRecord& record);
-
-    /**
-     * 为指定索引创建或获取 widget
-     *
-     * @param index 列表项索引
-     * @return 对应的 widget，如果记录不存在返回 nullptr
-     */
-    ClipboardItemWidget* ensureWidgetForIndex(int index);
-
-    /**
-     * 回收不可见的 widget
+     * 处理后台搜索送达的结果（主线程）
      */
-    void recycleInvisibleWidgets();
+    void onSearchResult(SearchResult result);
 
     /**
-     * 获取当前可见的列表项索引范围
-     *
-     * @param firstVisible 输出：第一个可见项索引
-     * @param lastVisible 输出：最后一个可见项索引
+     * 选中 selectedRecordId_ 对应的行（记录已加载时）
      */
-    void getVisibleRange(int& firstVisible, int& lastVisible) const;
+    void syncSelection();
 
     /**
      * 更新空列表提示
@@ -204,31 +192,21 @@ private:
 
     // UI 组件
     QVBoxLayout* mainLayout_ = nullptr;
-    QListWidget* listWidget_ = nullptr;
+    QListView* listView_ = nullptr;
     QLabel* emptyHintLabel_ = nullptr;
+    ClipboardListModel* model_ = nullptr;
+    ClipboardItemDelegate* delegate_ = nullptr;
+    std::unique_ptr<ClipboardSearcher> searcher_;
 
     // 数据
-    std::vector<ClipboardRecord> allRecords_;       // 所有已加载的记录
     QString currentKeyword_;                         // 当前过滤关键词
     int64_t selectedRecordId_ = -1;                 // 当前选中的记录 ID
-
-    // 虚拟化渲染状态
-    QSet<int> renderedIndices_;                     // 已渲染 widget 的索引
-    QTimer* scrollStopTimer_ = nullptr;            // 滚动停止检测定时器
-    int lastScrollValue_ = 0;                       // 上次滚动位置
-
-    // 懒加载状态
-    int loadedCount_ = 0;                           // 已加载的记录数量
-    bool isLoading_ = false;                        // 是否正在加载
-    bool hasMoreRecords_ = true;                    // 是否还有更多记录
-    bool isFiltering_ = false;                      // 是否处于过滤模式
+    uint64_t searchGeneration_ = 0;                 // 最新的搜索请求序号（0 表示没有进行中的搜索）
+    uint64_t shownSearchGeneration_ = 0;            // 列表中显示的搜索结果的请求序号
 
     // 常量
-    static constexpr int PAGE_SIZE = 50;            // 每次加载的记录数量
-    static constexpr int SCROLL_THRESHOLD = 100;   // 触发加载的滚动阈值（像素）
-    static constexpr int VISIBLE_BUFFER = 5;       // 可见区域外额外渲染的项数
-    static constexpr int MAX_RENDERED_WIDGETS = 30; // 最大同时渲染的 widget 数量
-    static constexpr int SCROLL_STOP_DELAY_MS = 100; // 滚动停止检测延迟
+    static constexpr int SCROLL_THRESHOLD = 300;    // 触发加载的滚动阈值（像素，约 5 行）
+    static constexpr int SEARCH_LIMIT = 1000;       // 搜索时返回的最大结果数
 };
 
 } // namespace suyan
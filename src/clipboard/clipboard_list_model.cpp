@@ -0,0 +1,156 @@
+/**
+ * ClipboardListModel 实现
+ *
+ * Requirements: 5.2, 6.1-6.5
+ */
+
+#include "clipboard_list_model.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace suyan {
+
+ClipboardListModel::ClipboardListModel(QObject* parent)
+    : QAbstractListModel(parent)
+{
+}
+
+// ========== QAbstractListModel ==========
+
+int ClipboardListModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return static_cast<int>(records_.size());
+}
+
+QVariant ClipboardListModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= rowCount()) {
+        return QVariant();
+    }
+
+    const auto& record = recordAt(index.row());
+    switch (role) {
+        case Qt::DisplayRole:
+            return displayText(record);
+        case RecordIdRole:
+            return QVariant::fromValue<qint64>(record.id);
+        case ContentTypeRole:
+            return static_cast<int>(record.type);
+        case LastUsedAtRole:
+            return QVariant::fromValue<qint64>(record.lastUsedAt);
+        case ThumbnailPathRole:
+            return QString::fromStdString(record.thumbnailPath);
+        default:
+            return QVariant();
+    }
+}
+
+bool ClipboardListModel::canFetchMore(const QModelIndex& parent) const
+{
+    return !parent.isValid() && !searchResult_ && hasMore_;
+}
+
+void ClipboardListModel::fetchMore(const QModelIndex& parent)
+{
+    if (!canFetchMore(parent)) {
+        return;
+    }
+
+    // 从已加载的最后一条之后继续
+    RecordCursor cursor;
+    if (!records_.empty()) {
+        cursor = RecordCursor(records_.back());
+    }
+    auto records = ClipboardStore::instance().getRecordsAfter(cursor, kPageSize);
+
+    // 返回的记录数少于一页，说明没有更多记录了
+    if (static_cast<int>(records.size()) < kPageSize) {
+        hasMore_ = false;
+    }
+    if (records.empty()) {
+        return;
+    }
+
+    int first = rowCount();
+    beginInsertRows(QModelIndex(), first, first + static_cast<int>(records.size()) - 1);
+    records_.insert(records_.end(), std::make_move_iterator(records.begin()),
+                    std::make_move_iterator(records.end()));
+    endInsertRows();
+}
+
+// ========== 数据加载 ==========
+
+void ClipboardListModel::loadFirstPage()
+{
+    clear();
+    fetchMore(QModelIndex());
+}
+
+void ClipboardListModel::setSearchResults(std::vector<PreviewRecord> records)
+{
+    beginResetModel();
+    records_ = std::move(records);
+    hasMore_ = false;
+    searchResult_ = true;
+    endResetModel();
+}
+
+void ClipboardListModel::extendSearchResults(std::vector<PreviewRecord> records)
+{
+    bool samePrefix = searchResult_ && records.size() >= records_.size() &&
+        std::equal(records_.begin(), records_.end(), records.begin(),
+                   [](const PreviewRecord& a, const PreviewRecord& b) { return a.id == b.id; });
+    if (!samePrefix) {
+        setSearchResults(std::move(records));
+        return;
+    }
+    if (records.size() == records_.size()) {
+        return;
+    }
+
+    int first = rowCount();
+    beginInsertRows(QModelIndex(), first, static_cast<int>(records.size()) - 1);
+    records_.insert(records_.end(), std::make_move_iterator(records.begin() + first),
+                    std::make_move_iterator(records.end()));
+    endInsertRows();
+}
+
+void ClipboardListModel::clear()
+{
+    beginResetModel();
+    records_.clear();
+    hasMore_ = true;
+    searchResult_ = false;
+    endResetModel();
+}
+
+// ========== 记录访问 ==========
+
+int ClipboardListModel::rowOf(int64_t recordId) const
+{
+    for (size_t i = 0; i < records_.size(); ++i) {
+        if (records_[i].id == recordId) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+QString ClipboardListModel::displayText(const PreviewRecord& record)
+{
+    switch (record.type) {
+        case ClipboardContentType::Text:
+            // 存储层生成的预览已折叠为单行并截断
+            return QString::fromStdString(record.preview);
+        case ClipboardContentType::Image:
+            return QStringLiteral("[图片]");
+        default:
+            return QStringLiteral("[未知内容]");
+    }
+}
+
+} // namespace suyan
@@ -0,0 +1,128 @@
+/**
+ * ClipboardListModel - 剪贴板历史列表的数据模型
+ *
+ * 为 QListView 提供剪贴板记录（预览），两种模式：
+ * - 历史模式：按最后使用时间降序，通过 canFetchMore/fetchMore 按游标分页加载，
+ *   视图滚动到底部附近时才读取下一页
+ * - 搜索模式：设置后台搜索送达的结果（先第一页，再补全其余结果），不再分页
+ *
+ * 模型只保存预览记录，不创建任何 widget，列表项由 ClipboardItemDelegate 直接绘制。
+ *
+ * Requirements: 5.2, 6.1-6.5
+ */
+
+#ifndef SUYAN_CLIPBOARD_CLIPBOARD_LIST_MODEL_H
+#define SUYAN_CLIPBOARD_CLIPBOARD_LIST_MODEL_H
+
+#include <QAbstractListModel>
+#include <cstdint>
+#include <vector>
+
+#include "clipboard_store.h"
+
+namespace suyan {
+
+/**
+ * ClipboardListModel - 剪贴板历史列表模型
+ */
+class ClipboardListModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    /**
+     * 自定义数据角色（Qt::DisplayRole 为列表显示的文本）
+     */
+    enum Role {
+        RecordIdRole = Qt::UserRole + 1,    // 记录 ID（qint64）
+        ContentTypeRole,                     // 内容类型（int，ClipboardContentType）
+        LastUsedAtRole,                      // 最后使用时间（qint64，Unix 毫秒）
+        ThumbnailPathRole,                   // 缩略图路径（QString，ThumbnailCache 的键）
+    };
+
+    /**
+     * 每页加载的记录数量
+     */
+    static constexpr int kPageSize = 50;
+
+    explicit ClipboardListModel(QObject* parent = nullptr);
+    ~ClipboardListModel() override = default;
+
+    // ========== QAbstractListModel ==========
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    /**
+     * 历史模式下还有未加载的记录时返回 true
+     */
+    bool canFetchMore(const QModelIndex& parent) const override;
+
+    /**
+     * 从已加载的最后一条之后读取下一页
+     */
+    void fetchMore(const QModelIndex& parent) override;
+
+    // ========== 数据加载 ==========
+
+    /**
+     * 切换到历史模式并重新加载第一页
+     */
+    void loadFirstPage();
+
+    /**
+     * 切换到搜索模式，显示搜索结果
+     *
+     * @param records 搜索结果（按最后使用时间降序）
+     */
+    void setSearchResults(std::vector<PreviewRecord> records);
+
+    /**
+     * 用完整的搜索结果补全已显示的第一页
+     *
+     * 前面的记录与已显示的相同时只插入其余记录（保留滚动位置和选中项），否则整体替换。
+     *
+     * @param records 完整的搜索结果（按最后使用时间降序）
+     */
+    void extendSearchResults(std::vector<PreviewRecord> records);
+
+    /**
+     * 清空模型（回到历史模式，下次 fetchMore 从第一页开始）
+     */
+    void clear();
+
+    /**
+     * 是否处于搜索模式
+     */
+    bool isSearchResult() const { return searchResult_; }
+
+    // ========== 记录访问 ==========
+
+    /**
+     * 获取指定行的记录
+     *
+     * @param row 行号（须在 [0, rowCount) 内）
+     */
+    const PreviewRecord& recordAt(int row) const { return records_[static_cast<size_t>(row)]; }
+
+    /**
+     * 查找记录所在的行
+     *
+     * @param recordId 记录 ID
+     * @return 行号，未加载时返回 -1
+     */
+    int rowOf(int64_t recordId) const;
+
+    /**
+     * 获取列表项显示的文本（文本记录为预览，图片为 "[图片]"）
+     */
+    static QString displayText(const PreviewRecord& record);
+
+private:
+    std::vector<PreviewRecord> records_;    // 已加载的记录（仅预览）
+    bool hasMore_ = true;                   // 历史模式下是否还有更多记录
+    bool searchResult_ = false;             // 是否为搜索结果
+};
+
+} // namespace suyan
+
+#endif // SUYAN_CLIPBOARD_CLIPBOARD_LIST_MODEL_H
@@ -7,16 +7,42 @@
 #include "clipboard_manager.h"
 #include "clipboard_store.h"
 #include "image_storage.h"
+#include "thumbnail_cache.h"
+#include "text_storage.h"
+#include "pinyin_table.h"
+#include "clipboard_ingestor.h"
 #include "clipboard_monitor.h"
 
 #include <QDebug>
+#include <QMetaObject>
+#include <chrono>
 #include <filesystem>
 #include <iostream>
 
+#ifdef Q_OS_MAC
+#include <pthread/qos.h>
+#endif
+
 namespace fs = std::filesystem;
 
 namespace suyan {
 
+namespace {
+
+// 存储空间统计的校准间隔（7 天）
+constexpr int64_t kStorageReconcileIntervalMs = 7LL * 24 * 60 * 60 * 1000;
+
+// 回收孤儿文件时每页的图片记录数（每页遍历一次对应哈希范围内的分片目录）
+constexpr int kOrphanPageSize = 200;
+
+// 回收孤儿文件的页间暂停，减少对入库和界面的影响
+constexpr int kOrphanPagePauseMs = 20;
+
+// 无引用文件的最短未修改时间（入库时先写文件后写记录，期间的文件不是孤儿）
+constexpr auto kOrphanFileMinAge = std::chrono::hours(1);
+
+} // anonymous namespace
+
 // ========== 单例实现 ==========
 
 ClipboardManager& ClipboardManager::instance() {
@@ -35,7 +61,7 @@ ClipboardManager::~ClipboardManager() {
 
 // ========== 初始化和关闭 ==========
 
-bool ClipboardManager::initialize(const std::string& dataDir) {
+bool ClipboardManager::initialize(const std::string& dataDir, const std::string& pinyinDictPath) {
     if (initialized_) {
         if (dataDir_ == dataDir) {
             return true;
@@ -55,6 +81,13 @@ bool ClipboardManager::initialize(const std::string& dataDir) {
         return false;
     }
 
+    // 加载读音表（打开数据库之前，读音表变化时数据库会重建拼音索引）
+    // 加载失败不是致命错误，拼音搜索不可用
+    if (!pinyinDictPath.empty() && !PinyinTable::instance().load(pinyinDictPath)) {
+        qWarning() << "ClipboardManager: 加载读音表失败，拼音搜索不可用:"
+                   << QString::fromStdString(pinyinDictPath);
+    }
+
     // 初始化 ClipboardStore
     if (!ClipboardStore::instance().initialize(dbPath_)) {
         qWarning() << "ClipboardManager: 初始化 ClipboardStore 失败";
@@ -68,15 +101,35 @@ bool ClipboardManager::initialize(const std::string& dataDir) {
         return false;
     }
 
+    // 打开缩略图图集（失败不是致命错误，列表项直接解码缩略图文件）
+    if (!ThumbnailCache::instance().initialize(clipboardDir_ + "/thumbnails.atlas")) {
+        qWarning() << "ClipboardManager: 打开缩略图图集失败";
+    }
+
+    // 初始化 TextStorage
+    if (!TextStorage::instance().initialize(clipboardDir_)) {
+        qWarning() << "ClipboardManager: 初始化 TextStorage 失败";
+        ImageStorage::instance().shutdown();
+        ClipboardStore::instance().shutdown();
+        return false;
+    }
+
     // 创建剪贴板监听器
     monitor_.reset(createClipboardMonitor());
     if (!monitor_) {
         qWarning() << "ClipboardManager: 创建剪贴板监听器失败";
+        TextStorage::instance().shutdown();
         ImageStorage::instance().shutdown();
         ClipboardStore::instance().shutdown();
         return false;
     }
 
+    // 启动后台入库线程
+    ingestor_ = std::make_unique<ClipboardIngestor>([this](const ClipboardContent& content) {
+        ingestContent(content);
+    });
+    ingestor_->start();
+
     // 设置监听回调
     monitor_->setCallback([this](const ClipboardContent& content) {
         onClipboardChanged(content);
@@ -102,7 +155,23 @@ void ClipboardManager::shutdown() {
     // 释放监听器
     monitor_.reset();
 
+    // 处理完已排队的内容后停止入库线程（须在关闭存储之前）
+    ingestor_.reset();
+
+    // 等待正在进行的存储空间校准
+    stopReconcile_ = true;
+    if (reconcileThread_.joinable()) {
+        reconcileThread_.join();
+    }
+
+    // 等待清空历史后的文件删除完成
+    if (cleanupThread_.joinable()) {
+        cleanupThread_.join();
+    }
+
     // 关闭存储
+    TextStorage::instance().shutdown();
+    ThumbnailCache::instance().shutdown();
     ImageStorage::instance().shutdown();
     ClipboardStore::instance().shutdown();
 
@@ -161,14 +230,14 @@ bool ClipboardManager::isMonitoring() const {
 
 // ========== 历史记录管理 ==========
 
-std::vector<ClipboardRecord> ClipboardManager::getHistory(int limit, int offset) {
+std::vector<PreviewRecord> ClipboardManager::getHistory(int limit, int offset) {
     if (!initialized_) {
         return {};
     }
     return ClipboardStore::instance().getAllRecords(limit, offset);
 }
 
-std::vector<ClipboardRecord> ClipboardManager::search(const std::string& keyword, int limit) {
+std::vector<PreviewRecord> ClipboardManager::search(const std::string& keyword, int limit) {
     if (!initialized_) {
         return {};
     }
@@ -182,7 +251,7 @@ bool ClipboardManager::pasteRecord(int64_t recordId) {
         return false;
     }
 
-    // 获取记录
+    // 获取完整记录（列表中只有预览）
     auto record = ClipboardStore::instance().getRecord(recordId);
     if (!record) {
         qWarning() << "ClipboardManager: 记录不存在:" << recordId;
@@ -195,7 +264,17 @@ bool ClipboardManager::pasteRecord(int64_t recordId) {
 
     if (record->type == ClipboardContentType::Text) {
         content.type = MonitorContentType::Text;
-        content.textData = record->content;
+        if (record->textChunks.empty()) {
+            content.textData = record->content;
+        } else {
+            // 大文本：从分块文件读取原文
+            content.textData = TextStorage::instance().loadText(record->textChunks);
+            if (content.textData.empty()) {
+                qWarning() << "ClipboardManager: 加载大文本失败，记录 ID:" << recordId;
+                emit pasteCompleted(recordId, false);
+                return false;
+            }
+        }
     } else if (record->type == ClipboardContentType::Image) {
         content.type = MonitorContentType::Image;
         // 从文件加载图片数据
@@ -244,11 +323,17 @@ bool ClipboardManager::deleteRecord(int64_t recordId) {
 
     // 删除图片文件
     if (record->type == ClipboardContentType::Image) {
-        deleteImageFiles(*record);
+        deleteImageFiles(record->content, record->thumbnailPath);
     }
 
     // 删除数据库记录
     bool success = ClipboardStore::instance().deleteRecord(recordId);
+
+    // 删除不再被引用的大文本分块（须在记录删除之后检查引用）
+    if (success && !record->textChunks.empty()) {
+        deleteUnreferencedTextChunks(record->textChunks);
+    }
+
     if (success) {
         emit recordDeleted(recordId);
         qDebug() << "ClipboardManager: 删除记录成功:" << recordId;
@@ -262,18 +347,18 @@ bool ClipboardManager::clearHistory() {
         return false;
     }
 
-    // 获取所有记录（用于删除图片文件）
-    auto records = ClipboardStore::instance().clearAll();
-
-    // 删除所有图片文件
-    for (const auto& record : records) {
-        if (record.type == ClipboardContentType::Image) {
-            deleteImageFiles(record);
-        }
+    // 清空记录，提交成功后才删除图片文件和大文本分块（失败时回滚，文件都保留）
+    auto& store = ClipboardStore::instance();
+    int64_t recordCount = store.getRecordCount();
+    std::vector<DeletedRecord> fileRecords;
+    if (!store.clearAll(&fileRecords)) {
+        return false;
     }
+    scheduleFileCleanup(std::move(fileRecords));
+    ThumbnailCache::instance().clear();
 
     emit historyCleared();
-    qDebug() << "ClipboardManager: 历史记录已清空，删除" << records.size() << "条记录";
+    qDebug() << "ClipboardManager: 历史记录已清空，删除" << recordCount << "条记录";
 
     return true;
 }
@@ -298,16 +383,134 @@ void ClipboardManager::performCleanup() {
     // 删除过期记录
     auto deletedRecords = ClipboardStore::instance().deleteExpiredRecords(maxAgeDays_, maxCount_);
 
-    // 删除关联的图片文件
+    // 删除关联的图片文件和大文本分块
     for (const auto& record : deletedRecords) {
         if (record.type == ClipboardContentType::Image) {
-            deleteImageFiles(record);
+            deleteImageFiles(record.imagePath, record.thumbnailPath);
+        }
+        if (!record.textChunks.empty()) {
+            deleteUnreferencedTextChunks(record.textChunks);
         }
     }
 
     if (!deletedRecords.empty()) {
         qDebug() << "ClipboardManager: 清理完成，删除" << deletedRecords.size() << "条记录";
     }
+
+    // 上限可能已调低
+    enforceStorageQuota(0);
+
+    scheduleStorageReconcile();
+}
+
+int64_t ClipboardManager::getStorageSize() {
+    if (!initialized_) {
+        return 0;
+    }
+    return ClipboardStore::instance().getTotalFileSize();
+}
+
+void ClipboardManager::reconcileStorageSize() {
+    if (!initialized_) {
+        return;
+    }
+
+    auto& store = ClipboardStore::instance();
+
+    // 图片文件可能被外部删除，旧记录的占用空间也不含缩略图
+    int corrected = 0;
+    for (const auto& entry : store.getImageFiles()) {
+        // 关闭时中止：已修正的记录保留，总量在下次校准时重新累计
+        if (stopReconcile_) {
+            qDebug() << "ClipboardManager: 存储空间校准中止，已修正" << corrected << "条记录";
+            return;
+        }
+        int64_t actualSize = ImageStorage::instance().getImageFileSize(entry.imagePath, entry.thumbnailPath);
+        if (actualSize != entry.fileSize && store.updateFileSize(entry.id, actualSize)) {
+            ++corrected;
+        }
+    }
+
+    int64_t totalSize = store.recalculateTotalFileSize();
+    qDebug() << "ClipboardManager: 存储空间校准完成，修正" << corrected
+             << "条记录，总计" << totalSize << "字节";
+}
+
+OrphanCollectResult ClipboardManager::collectOrphans() {
+    OrphanCollectResult result;
+    if (!initialized_) {
+        return result;
+    }
+
+    auto& store = ClipboardStore::instance();
+    auto& imageStorage = ImageStorage::instance();
+
+    // 图片目录不可访问时不能据此判断记录的原图已丢失
+    std::error_code ec;
+    if (!fs::is_directory(imageStorage.getImagesDir(), ec)) {
+        return result;
+    }
+
+    auto modifiedBefore = fs::file_time_type::clock::now() - kOrphanFileMinAge;
+    std::string afterHash;
+    while (!stopReconcile_) {
+        // 一页记录覆盖哈希范围 (afterHash, 最后一条的哈希]，最后一页不设上界
+        auto page = store.getImageFilesAfterHash(afterHash, kOrphanPageSize);
+        if (!page) {
+            break;
+        }
+        const auto& records = *page;
+        bool lastPage = static_cast<int>(records.size()) < kOrphanPageSize;
+        std::string upToHash = lastPage ? "" : records.back().contentHash;
+        auto files = imageStorage.listStoredFiles(afterHash, upToHash);
+
+        // 两边都按哈希排序：同一哈希的文件只有路径与该记录一致时才被引用
+        std::vector<bool> imageFound(records.size(), false);
+        size_t index = 0;
+        for (const auto& file : files) {
+            while (index < records.size() && records[index].contentHash < file.hash) {
+                ++index;
+            }
+            if (index < records.size() && records[index].contentHash == file.hash) {
+                if (file.path == records[index].imagePath) {
+                    imageFound[index] = true;
+                    continue;
+                }
+                if (file.path == records[index].thumbnailPath) {
+                    continue;
+                }
+            }
+            if (file.modifiedAt < modifiedBefore && imageStorage.deleteStoredFile(file)) {
+                ++result.deletedFiles;
+                result.bytesReclaimed += file.size;
+            }
+        }
+
+        // 原图丢失的记录（不在分片目录中的旧路径逐个检查）
+        for (size_t i = 0; i < records.size(); ++i) {
+            const auto& record = records[i];
+            if (imageFound[i] || imageStorage.imageExists(record.imagePath) ||
+                !store.deleteRecord(record.id)) {
+                continue;
+            }
+            result.bytesReclaimed += imageStorage.getImageFileSize("", record.thumbnailPath);
+            imageStorage.deleteImage("", record.thumbnailPath);
+            ++result.deletedRecords;
+            QMetaObject::invokeMethod(this, [this, recordId = record.id]() {
+                emit recordDeleted(recordId);
+            }, Qt::QueuedConnection);
+        }
+
+        if (lastPage) {
+            break;
+        }
+        afterHash = upToHash;
+        std::this_thread::sleep_for(std::chrono::milliseconds(kOrphanPagePauseMs));
+    }
+
+    qDebug() << "ClipboardManager: 孤儿文件回收完成，删除" << result.deletedFiles << "个文件、"
+             << result.deletedRecords << "条记录，回收" << result.bytesReclaimed << "字节";
+    return result;
 }
 
 // ========== 配置 ==========
@@ -340,6 +543,11 @@ void ClipboardManager::setMaxCount(int count) {
     qDebug() << "ClipboardManager: 最大保留条数设置为" << maxCount_;
 }
 
+void ClipboardManager::setMaxStorageMB(int megabytes) {
+    maxStorageBytes_ = static_cast<int64_t>(std::max(0, megabytes)) * 1024 * 1024;
+    qDebug() << "ClipboardManager: 存储空间上限设置为" << std::max(0, megabytes) << "MB";
+}
+
 // ========== 私有方法 ==========
 
 void ClipboardManager::onClipboardChanged(const ClipboardContent& content) {
@@ -351,6 +559,11 @@ void ClipboardManager::onClipboardChanged(const ClipboardContent& content) {
         return;
     }
 
+    // 主线程只入队，查重、写库和图片处理都在入库线程完成
+    ingestor_->enqueue(content);
+}
+
+void ClipboardManager::ingestContent(const ClipboardContent& content) {
     bool success = false;
 
     if (content.isText()) {
@@ -365,10 +578,10 @@ void ClipboardManager::onClipboardChanged(const ClipboardContent& content) {
 }
 
 bool ClipboardManager::handleTextContent(const ClipboardContent& content) {
-    // 检查文本长度是否超过阈值
-    if (content.textData.size() > MAX_TEXT_LENGTH) {
-        qDebug() << "ClipboardManager: 文本长度超过阈值，忽略"
-                 << "(" << content.textData.size() << " > " << MAX_TEXT_LENGTH << ")";
+    // 检查文本长度是否超过上限
+    if (content.textData.size() > MAX_LARGE_TEXT_LENGTH) {
+        qDebug() << "ClipboardManager: 文本长度超过上限，忽略"
+                 << "(" << content.textData.size() << " > " << MAX_LARGE_TEXT_LENGTH << ")";
         return false;
     }
 
@@ -385,6 +598,11 @@ bool ClipboardManager::handleTextContent(const ClipboardContent& content) {
         return false;
     }
 
+    // 超过阈值的大文本分块存储到文件
+    if (content.textData.size() > MAX_TEXT_LENGTH) {
+        return handleLargeTextContent(content);
+    }
+
     // 创建记录
     ClipboardRecord record;
     record.type = ClipboardContentType::Text;
@@ -404,7 +622,7 @@ bool ClipboardManager::handleTextContent(const ClipboardContent& content) {
         // 获取完整记录（包含时间戳等）
         auto fullRecord = ClipboardStore::instance().getRecord(result.id);
         if (fullRecord) {
-            emit recordAdded(*fullRecord);
+            notifyRecordAdded(*fullRecord);
             qDebug() << "ClipboardManager: 添加文本记录成功，ID:" << result.id
                      << ", 长度:" << content.textData.size();
         }
@@ -415,7 +633,65 @@ bool ClipboardManager::handleTextContent(const ClipboardContent& content) {
     return true;
 }
 
+bool ClipboardManager::handleLargeTextContent(const ClipboardContent& content) {
+    // 先检查是否已存在相同哈希的记录（避免重复压缩）
+    auto& store = ClipboardStore::instance();
+    auto existing = store.findByHash(content.contentHash);
+    if (existing) {
+        store.updateLastUsedTime(existing->id);
+        qDebug() << "ClipboardManager: 大文本记录已存在，更新时间戳，ID:" << existing->id;
+        return true;
+    }
+
+    TextStorageResult result;
+    AddRecordResult addResult;
+    {
+        // 分块在记录之间共享：写入分块到插入记录之间，不能被主线程当作无引用分块删除
+        std::lock_guard<std::mutex> lock(textChunksMutex_);
+
+        // 分块压缩存储原文
+        result = TextStorage::instance().saveText(content.textData);
+        if (!result.success) {
+            qWarning() << "ClipboardManager: 保存大文本失败:"
+                       << QString::fromStdString(result.errorMessage);
+            return false;
+        }
+
+        // 创建记录：数据库只保存预览（FTS 只索引预览）
+        ClipboardRecord record;
+        record.type = ClipboardContentType::Text;
+        record.content = ClipboardStore::makePreview(content.textData);
+        record.contentHash = content.contentHash;
+        record.sourceApp = content.sourceApp;
+        record.fileSize = result.compressedSize;
+        record.contentLength = static_cast<int64_t>(content.textData.size());
+        record.textChunks = result.chunks;
+
+        addResult = store.addRecord(record);
+    }
+    if (addResult.id <= 0) {
+        qWarning() << "ClipboardManager: 添加大文本记录失败";
+        deleteUnreferencedTextChunks(result.chunks);
+        return false;
+    }
+
+    if (addResult.isNew) {
+        auto fullRecord = store.getRecord(addResult.id);
+        if (fullRecord) {
+            notifyRecordAdded(*fullRecord);
+            qDebug() << "ClipboardManager: 添加大文本记录成功，ID:" << addResult.id
+                     << ", 长度:" << content.textData.size()
+                     << ", 压缩后:" << result.compressedSize;
+        }
+    }
+
+    return true;
+}
+
 bool ClipboardManager::handleImageContent(const ClipboardContent& content) {
+    // 图片文件按哈希命名：保存文件到写入记录之间，不能被后台清理当作已清空记录的文件删除
+    std::lock_guard<std::mutex> lock(imageFilesMutex_);
+
     // 先检查是否已存在相同哈希的记录（避免重复保存图片）
     auto existing = ClipboardStore::instance().findByHash(content.contentHash);
     if (existing) {
@@ -445,10 +721,10 @@ bool ClipboardManager::handleImageContent(const ClipboardContent& content) {
     record.contentHash = content.contentHash;
     record.sourceApp = content.sourceApp;
     record.thumbnailPath = result.thumbnailPath;
-    record.imageFormat = content.imageFormat;
+    record.imageFormat = result.format;     // 存储格式（TIFF 已转为 PNG）
     record.imageWidth = result.width;
     record.imageHeight = result.height;
-    record.fileSize = result.fileSize;
+    record.fileSize = result.fileSize + result.thumbnailSize;  // 占用空间含缩略图
 
     // 添加到存储
     auto addResult = ClipboardStore::instance().addRecord(record);
@@ -461,26 +737,205 @@ bool ClipboardManager::handleImageContent(const ClipboardContent& content) {
 
     // 只有新记录才发射 recordAdded 信号
     if (addResult.isNew) {
+        // 列表显示前写入缩略图图集
+        ThumbnailCache::instance().ensure(result.thumbnailPath);
+
         // 获取完整记录
         auto fullRecord = ClipboardStore::instance().getRecord(addResult.id);
         if (fullRecord) {
-            emit recordAdded(*fullRecord);
+            notifyRecordAdded(*fullRecord);
             qDebug() << "ClipboardManager: 添加图片记录成功，ID:" << addResult.id
                      << ", 尺寸:" << result.width << "x" << result.height;
         }
+        enforceStorageQuota(addResult.id);
     }
 
     return true;
 }
 
-void ClipboardManager::deleteImageFiles(const ClipboardRecord& record) {
-    if (record.type != ClipboardContentType::Image) {
+void ClipboardManager::deleteImageFiles(const std::string& imagePath,
+                                        const std::string& thumbnailPath) {
+    ImageStorage::instance().deleteImage(imagePath, thumbnailPath);
+    qDebug() << "ClipboardManager: 删除图片文件:" 
+             << QString::fromStdString(imagePath);
+}
+
+void ClipboardManager::deleteUnreferencedImageFiles(const DeletedRecord& record) {
+    std::lock_guard<std::mutex> lock(imageFilesMutex_);
+    if (ClipboardStore::instance().findByHash(record.contentHash)) {
+        return;     // 同一图片已重新入库，文件路径相同
+    }
+    deleteImageFiles(record.imagePath, record.thumbnailPath);
+}
+
+void ClipboardManager::scheduleFileCleanup(std::vector<DeletedRecord> records) {
+    if (records.empty()) {
         return;
     }
 
-    ImageStorage::instance().deleteImage(record.content, record.thumbnailPath);
-    qDebug() << "ClipboardManager: 删除图片文件:" 
-             << QString::fromStdString(record.content);
+    // 上一次清理未结束时等待（连续清空才会发生）
+    if (cleanupThread_.joinable()) {
+        cleanupThread_.join();
+    }
+
+    cleanupThread_ = std::thread([this, records = std::move(records)]() {
+#ifdef Q_OS_MAC
+        pthread_set_qos_class_self_np(QOS_CLASS_UTILITY, 0);
+#endif
+        for (const auto& record : records) {
+            if (record.type == ClipboardContentType::Image) {
+                deleteUnreferencedImageFiles(record);
+            }
+            if (!record.textChunks.empty()) {
+                deleteUnreferencedTextChunks(record.textChunks);
+            }
+        }
+        qDebug() << "ClipboardManager: 清空历史后删除" << records.size() << "条记录的文件";
+    });
+}
+
+void ClipboardManager::deleteUnreferencedTextChunks(const std::string& textChunks) {
+    std::lock_guard<std::mutex> lock(textChunksMutex_);
+    std::vector<std::string> unreferenced;
+    for (const auto& chunkHash : TextStorage::parseChunkList(textChunks)) {
+        if (!ClipboardStore::instance().isTextChunkReferenced(chunkHash)) {
+            unreferenced.push_back(chunkHash);
+        }
+    }
+    TextStorage::instance().deleteChunks(unreferenced);
+}
+
+void ClipboardManager::notifyRecordAdded(const ClipboardRecord& record) {
+    // 入库在工作线程完成，信号回到主线程发射，UI 槽函数按直接连接在主线程执行
+    QMetaObject::invokeMethod(this, [this, record]() {
+        emit recordAdded(record);
+    }, Qt::QueuedConnection);
+}
+
+void ClipboardManager::enforceStorageQuota(int64_t keepId) {
+    int64_t maxBytes = maxStorageBytes_;
+    auto& store = ClipboardStore::instance();
+    // 总量含大文本，不超出时图片一定不超出，省去按图片累计
+    if (maxBytes <= 0 || store.getTotalFileSize() <= maxBytes) {
+        return;
+    }
+
+    auto evictedRecords = store.evictImagesOverQuota(maxBytes, keepId);
+    for (const auto& record : evictedRecords) {
+        deleteImageFiles(record.imagePath, record.thumbnailPath);
+        QMetaObject::invokeMethod(this, [this, recordId = record.id]() {
+            emit recordDeleted(recordId);
+        }, Qt::QueuedConnection);
+    }
+
+    if (!evictedRecords.empty()) {
+        qDebug() << "ClipboardManager: 超出存储空间上限，淘汰" << evictedRecords.size()
+                 << "张图片，当前总计" << store.getTotalFileSize() << "字节";
+    }
+}
+
+void ClipboardManager::scheduleStorageReconcile() {
+    if (reconciling_) {
+        return;
+    }
+
+    // 上次校准的时间保存在数据库中（墙上时间），重启后不会立即重新校准；
+    // 时钟被调回到上次校准之前时视为到期
+    int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    int64_t lastReconcileAt = ClipboardStore::instance().getLastReconcileTime();
+    if (lastReconcileAt > 0 && now >= lastReconcileAt && now - lastReconcileAt < kStorageReconcileIntervalMs) {
+        return;
+    }
+
+    // 上一次校准已结束，回收线程
+    if (reconcileThread_.joinable()) {
+        reconcileThread_.join();
+    }
+
+    reconciling_ = true;
+    stopReconcile_ = false;
+    reconcileThread_ = std::thread([this, now]() {
+#ifdef Q_OS_MAC
+        // 维护任务，降低 CPU 和磁盘 I/O 优先级
+        pthread_set_qos_class_self_np(QOS_CLASS_BACKGROUND, 0);
+#endif
+        migrateLegacyImages();
+        collectOrphans();
+        reconcileStorageSize();
+        syncThumbnailAtlas();
+
+        // 中途关闭的校准不记录时间，下次启动后继续
+        if (!stopReconcile_) {
+            ClipboardStore::instance().setLastReconcileTime(now);
+        }
+        reconciling_ = false;
+    });
+}
+
+void ClipboardManager::migrateLegacyImages() {
+    auto& store = ClipboardStore::instance();
+    auto& imageStorage = ImageStorage::instance();
+
+    auto entries = store.getLegacyImageFiles();
+    if (entries.empty()) {
+        return;
+    }
+
+    // 已是相对路径的保持不变，移动失败的保留旧路径
+    auto migrate = [&imageStorage](const std::string& path, bool isThumbnail) {
+        if (!fs::path(path).is_absolute()) {
+            return path;
+        }
+        std::string migrated = imageStorage.migrateLegacyFile(path, isThumbnail);
+        return migrated.empty() ? path : migrated;
+    };
+
+    // 关闭时中止：未迁移的记录仍可按旧路径读取（resolvePath），下次校准时继续
+    int migratedCount = 0;
+    for (const auto& entry : entries) {
+        if (stopReconcile_) {
+            break;
+        }
+        std::string imagePath = migrate(entry.imagePath, false);
+        std::string thumbnailPath = migrate(entry.thumbnailPath, true);
+        if (!store.updateImagePaths(entry.id, imagePath, thumbnailPath)) {
+            // 记录在迁移期间被删除时清理已移动的文件，其他失败下次重试
+            if (!store.getRecord(entry.id)) {
+                imageStorage.deleteImage(imagePath, thumbnailPath);
+            }
+            continue;
+        }
+        ++migratedCount;
+    }
+
+    qDebug() << "ClipboardManager: 图片迁移到分片目录，完成" << migratedCount
+             << "/" << entries.size() << "条记录";
+}
+
+void ClipboardManager::syncThumbnailAtlas() {
+    std::vector<std::string> thumbnailPaths;
+    int added = 0;
+    for (const auto& entry : ClipboardStore::instance().getImageFiles()) {
+        // 关闭时中止：未写入的缩略图在显示时补齐，下次校准时继续
+        if (stopReconcile_) {
+            qDebug() << "ClipboardManager: 缩略图图集同步中止，已新增" << added << "张";
+            return;
+        }
+        if (entry.thumbnailPath.empty()) {
+            continue;
+        }
+        if (!ThumbnailCache::instance().contains(entry.thumbnailPath) &&
+            ThumbnailCache::instance().ensure(entry.thumbnailPath)) {
+            ++added;
+        }
+        thumbnailPaths.push_back(entry.thumbnailPath);
+    }
+
+    // 路径列表完整时才能压缩（否则会丢掉未列出的有效条目）
+    bool compacted = !stopReconcile_ && ThumbnailCache::instance().compact(thumbnailPaths);
+    qDebug() << "ClipboardManager: 缩略图图集同步完成，新增" << added << "张"
+             << (compacted ? "，已压缩" : "");
 }
 
 } // namespace suyan
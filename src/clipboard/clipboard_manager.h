@@ -1,15 +1,20 @@
 /**
  * ClipboardManager - 剪贴板管理核心类
  *
- * 整合 ClipboardStore、ImageStorage、IClipboardMonitor，
+ * 整合 ClipboardStore、ImageStorage、TextStorage、IClipboardMonitor，
  * 提供剪贴板历史记录的完整管理功能。
  *
  * 功能：
  * - 剪贴板监听控制
  * - 历史记录管理（添加、查询、删除）
- * - 内容去重（基于 SHA-256 哈希）
+ * - 内容去重（基于内容指纹，见 ContentFingerprint）
  * - 粘贴操作（写入系统剪贴板）
  * - 自动清理（根据保留策略）
+ * - 存储空间统计（数据库累计值，后台定期校准）
+ * - 孤儿文件回收（后台按内容哈希归并分片目录和图片记录）
+ *
+ * 剪贴板变化时主线程只入队，入库由 ClipboardIngestor 的工作线程完成，
+ * recordAdded 信号投递回主线程发射。
  */
 
 #ifndef SUYAN_CLIPBOARD_CLIPBOARD_MANAGER_H
@@ -17,8 +22,11 @@
 
 #include <QObject>
 #include <QString>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 #include <functional>
 
@@ -30,13 +38,29 @@ namespace suyan {
 // 前向声明
 class ImageStorage;
 class IClipboardMonitor;
+class ClipboardIngestor;
 
 /**
  * 文本长度阈值（64KB）
- * 超过此长度的文本不记录
+ * 超过此长度的文本压缩分块存储到文件（TextStorage），数据库只保存预览
  */
 constexpr size_t MAX_TEXT_LENGTH = 65536;
 
+/**
+ * 大文本长度上限（32MB）
+ * 超过此长度的文本不记录
+ */
+constexpr size_t MAX_LARGE_TEXT_LENGTH = 32 * 1024 * 1024;
+
+/**
+ * 孤儿文件回收结果
+ */
+struct OrphanCollectResult {
+    int deletedFiles = 0;           // 删除的无记录引用的文件数
+    int deletedRecords = 0;         // 删除的原图已丢失的记录数
+    int64_t bytesReclaimed = 0;     // 回收的空间（字节）
+};
+
 /**
  * ClipboardManager - 剪贴板管理核心类
  *
@@ -60,12 +84,13 @@ public:
     /**
      * 初始化剪贴板管理器
      *
-     * 初始化所有组件：ClipboardStore、ImageStorage、IClipboardMonitor。
+     * 初始化所有组件：ClipboardStore、ImageStorage、TextStorage、IClipboardMonitor。
      *
      * @param dataDir 数据目录路径（如 ~/Library/Application Support/SuYan）
+     * @param pinyinDictPath 字表路径，用于拼音搜索（为空时不加载，拼音搜索不可用）
      * @return 是否成功
      */
-    bool initialize(const std::string& dataDir);
+    bool initialize(const std::string& dataDir, const std::string& pinyinDictPath = "");
 
     /**
      * 关闭剪贴板管理器
@@ -110,9 +135,9 @@ public:
      *
      * @param limit 最大返回数量
      * @param offset 偏移量（用于分页）
-     * @return 记录列表（按最后使用时间降序）
+     * @return 预览记录列表（按最后使用时间降序）
      */
-    std::vector<ClipboardRecord> getHistory(int limit = 100, int offset = 0);
+    std::vector<PreviewRecord> getHistory(int limit = 100, int offset = 0);
 
     /**
      * 搜索记录
@@ -121,9 +146,9 @@ public:
      *
      * @param keyword 搜索关键词
      * @param limit 最大返回数量
-     * @return 匹配的记录列表
+     * @return 匹配的预览记录列表
      */
-    std::vector<ClipboardRecord> search(const std::string& keyword, int limit = 100);
+    std::vector<PreviewRecord> search(const std::string& keyword, int limit = 100);
 
     /**
      * 粘贴指定记录
@@ -148,7 +173,7 @@ public:
     /**
      * 清空历史记录
      *
-     * 删除所有记录和关联的图片文件。
+     * 删除所有记录，提交成功后在后台线程删除关联的图片文件和大文本分块。
      *
      * @return 是否成功
      */
@@ -168,6 +193,35 @@ public:
      */
     void performCleanup();
 
+    /**
+     * 获取历史记录占用的存储空间（字节）
+     *
+     * 读取数据库中随记录增删累计的总量（图片含缩略图、大文本分块），不扫描目录。
+     */
+    int64_t getStorageSize();
+
+    /**
+     * 校准存储空间统计
+     *
+     * 逐个读取图片文件的实际大小，修正与记录不一致的占用空间，再按全部记录重新累计总量。
+     * 耗时与图片数成正比，performCleanup 定期在后台线程调用；关闭时中止，不重新累计总量。
+     */
+    void reconcileStorageSize();
+
+    /**
+     * 回收孤儿文件
+     *
+     * 按内容哈希顺序把分片目录中的文件与图片记录归并，双向清理：
+     * - 没有记录引用的原图、缩略图（入库中途退出、删除文件失败时留下），
+     *   只删除一小时内未修改过的，已保存但记录还未写入的图片不受影响
+     * - 原图已丢失的记录（同时删除缩略图，在主线程发射 recordDeleted）
+     * 每次处理一页记录及其哈希范围内的文件，页间暂停；关闭时在页间停止。
+     * 随存储空间校准在后台线程运行。
+     *
+     * @return 删除的文件数、记录数和回收的空间
+     */
+    OrphanCollectResult collectOrphans();
+
     // ========== 配置 ==========
 
     /**
@@ -206,10 +260,26 @@ public:
      */
     int getMaxCount() const { return maxCount_; }
 
+    /**
+     * 设置存储空间上限
+     *
+     * 图片入库后图片占用的空间超出上限时，立即按最后使用时间淘汰最旧的图片。
+     *
+     * @param megabytes 上限（MB，0 表示不限制）
+     */
+    void setMaxStorageMB(int megabytes);
+
+    /**
+     * 获取存储空间上限（字节，0 表示不限制）
+     */
+    int64_t getMaxStorageBytes() const { return maxStorageBytes_; }
+
 signals:
     /**
      * 新记录添加信号
      *
+     * 记录在后台入库，信号总是在主线程发射。
+     *
      * @param record 新添加的记录
      */
     void recordAdded(const ClipboardRecord& record);
@@ -251,12 +321,21 @@ private:
     /**
      * 处理剪贴板内容变化
      *
-     * 由监听器回调调用。
+     * 由监听器回调调用（主线程），只把内容加入入库队列。
      *
      * @param content 新的剪贴板内容
      */
     void onClipboardChanged(const ClipboardContent& content);
 
+    /**
+     * 入库剪贴板内容
+     *
+     * 在入库线程调用。
+     *
+     * @param content 剪贴板内容
+     */
+    void ingestContent(const ClipboardContent& content);
+
     /**
      * 处理文本内容
      *
@@ -265,6 +344,16 @@ private:
      */
     bool handleTextContent(const ClipboardContent& content);
 
+    /**
+     * 处理大文本内容（超过 MAX_TEXT_LENGTH）
+     *
+     * 原文分块压缩存储到文件，记录只保存预览和分块清单。
+     *
+     * @param content 剪贴板内容
+     * @return 是否成功处理
+     */
+    bool handleLargeTextContent(const ClipboardContent& content);
+
     /**
      * 处理图片内容
      *
@@ -276,20 +365,88 @@ private:
     /**
      * 删除图片文件
      *
-     * @param record 包含图片路径的记录
+     * @param imagePath 图片路径
+     * @param thumbnailPath 缩略图路径
+     */
+    void deleteImageFiles(const std::string& imagePath, const std::string& thumbnailPath);
+
+    /**
+     * 删除不再被引用的大文本分块
+     *
+     * @param textChunks 被删除记录的分块清单
+     */
+    void deleteUnreferencedTextChunks(const std::string& textChunks);
+
+    /**
+     * 删除已清空记录的图片文件（同一图片已重新入库时保留）
+     */
+    void deleteUnreferencedImageFiles(const DeletedRecord& record);
+
+    /**
+     * 在后台线程删除已清空记录的图片文件和大文本分块
+     *
+     * @param records ClipboardStore::clearAll 提交后返回的关联文件的记录
      */
-    void deleteImageFiles(const ClipboardRecord& record);
+    void scheduleFileCleanup(std::vector<DeletedRecord> records);
+
+    /**
+     * 在主线程发射 recordAdded 信号
+     *
+     * @param record 新添加的记录
+     */
+    void notifyRecordAdded(const ClipboardRecord& record);
+
+    /**
+     * 超出存储空间上限时淘汰最久未使用的图片
+     *
+     * 先读取累计总量（O(1)，含大文本），未超出时直接返回；超出时按图片总量分批删除图片记录和文件，
+     * 并在主线程发射 recordDeleted 信号。
+     *
+     * @param keepId 不淘汰的记录 ID（刚入库的记录）
+     */
+    void enforceStorageQuota(int64_t keepId);
+
+    /**
+     * 到期时在后台线程校准存储空间统计（每周一次，上次完成的时间保存在数据库中）
+     *
+     * 校准前先迁移旧版本平铺存放的图片（见 migrateLegacyImages）并回收孤儿文件（见 collectOrphans），
+     * 校准后同步缩略图图集（见 syncThumbnailAtlas）。线程以后台优先级运行。
+     */
+    void scheduleStorageReconcile();
+
+    /**
+     * 把还没有写入图集的缩略图补齐，并在无用条目过多时压缩图集
+     */
+    void syncThumbnailAtlas();
+
+    /**
+     * 把旧版本平铺存放的图片移到分片目录，记录改为相对路径
+     *
+     * 只处理仍使用绝对路径的记录，迁移完成后查询为空，不再有额外开销。
+     * 单个文件移动失败时保留旧路径，下次启动重试。
+     */
+    void migrateLegacyImages();
 
     // 成员变量
     bool initialized_ = false;
     bool enabled_ = true;
     int maxAgeDays_ = 30;
     int maxCount_ = 1000;
+    std::atomic<int64_t> maxStorageBytes_{0};   // 入库线程读取，主线程设置
     std::string dataDir_;
     std::string clipboardDir_;
     std::string dbPath_;
 
     std::unique_ptr<IClipboardMonitor> monitor_;
+    std::unique_ptr<ClipboardIngestor> ingestor_;
+    std::mutex textChunksMutex_;    // 串行化大文本分块的写入和无引用删除
+    std::mutex imageFilesMutex_;    // 串行化图片文件的写入和清空历史后的删除
+
+    std::thread reconcileThread_;           // 存储空间校准线程
+    std::atomic<bool> reconciling_{false};  // 校准是否正在进行
+    std::atomic<bool> stopReconcile_{false};    // 关闭时通知校准线程中止各项维护任务
+
+    std::thread cleanupThread_;             // 清空历史后删除文件的线程
 };
 
 } // namespace suyan
@@ -47,7 +47,8 @@ struct ClipboardContent {
     std::vector<uint8_t> imageData;         // 图片二进制数据（type == Image 时有效）
     std::string imageFormat;                // 图片格式（png, jpeg, gif 等）
     std::string sourceApp;                  // 来源应用标识（Bundle ID）
-    std::string contentHash;                // SHA-256 哈希值
+    uint64_t quickKey = 0;                  // 预筛键（长度 + 采样字节，见 ContentFingerprint）
+    std::string contentHash;                // 内容指纹（入库线程按需计算，见 ContentFingerprint）
     
     /**
      * 检查内容是否有效
@@ -0,0 +1,249 @@
+/**
+ * ClipboardSearcher 实现
+ */
+
+#include "clipboard_searcher.h"
+#include <algorithm>
+
+namespace suyan {
+
+ClipboardSearcher::ClipboardSearcher(Handler handler, int limit, int firstPageSize)
+    : handler_(std::move(handler))
+    , limit_(std::max(1, limit))
+    , firstPageSize_(std::clamp(firstPageSize, 1, std::max(1, limit)))
+{
+}
+
+ClipboardSearcher::~ClipboardSearcher() {
+    stop();
+}
+
+// ========== 启动和停止 ==========
+
+void ClipboardSearcher::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+        return;
+    }
+
+    stopping_ = false;
+    running_ = true;
+    worker_ = std::thread(&ClipboardSearcher::run, this);
+}
+
+void ClipboardSearcher::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        stopping_ = true;
+        pending_.reset();
+        ++generation_;      // 中止正在执行的查询
+    }
+    queueCondition_.notify_one();
+
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+}
+
+bool ClipboardSearcher::isRunning() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_ && !stopping_;
+}
+
+// ========== 请求 ==========
+
+uint64_t ClipboardSearcher::search(std::string keyword) {
+    uint64_t generation;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_ || stopping_ || keyword.empty()) {
+            return 0;
+        }
+
+        // 排队中的旧请求直接被取代，正在执行的查询在下一次取消检查时中止
+        pending_ = std::move(keyword);
+        generation = ++generation_;
+    }
+    queueCondition_.notify_one();
+    return generation;
+}
+
+void ClipboardSearcher::cancel() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.reset();
+    ++generation_;
+}
+
+void ClipboardSearcher::invalidateCache() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++cacheEpoch_;
+}
+
+void ClipboardSearcher::waitForIdle() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idleCondition_.wait(lock, [this] {
+        return !running_ || (!pending_ && !busy_);
+    });
+}
+
+uint64_t ClipboardSearcher::getQueryCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queryCount_;
+}
+
+uint64_t ClipboardSearcher::getRefinedCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return refinedCount_;
+}
+
+uint64_t ClipboardSearcher::getCancelledCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cancelledCount_;
+}
+
+// ========== 工作线程 ==========
+
+void ClipboardSearcher::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        queueCondition_.wait(lock, [this] {
+            return stopping_ || pending_.has_value();
+        });
+
+        if (stopping_) {
+            break;
+        }
+
+        std::string keyword = std::move(*pending_);
+        pending_.reset();
+        uint64_t generation = generation_;
+        uint64_t cacheEpoch = cacheEpoch_;
+        busy_ = true;
+
+        lock.unlock();
+        process(keyword, generation, cacheEpoch);
+        lock.lock();
+
+        busy_ = false;
+        if (!pending_) {
+            idleCondition_.notify_all();
+        }
+    }
+
+    // 唤醒停止期间仍在等待的调用方
+    idleCondition_.notify_all();
+}
+
+void ClipboardSearcher::process(const std::string& keyword, uint64_t generation, uint64_t cacheEpoch) {
+    SearchCancelCheck isCancelled = [this, generation] {
+        return generation_.load() != generation;
+    };
+
+    // 记录增删后，之前的结果不再完整
+    if (cacheEpoch != cachedEpoch_) {
+        cache_.clear();
+        cachedEpoch_ = cacheEpoch;
+    }
+
+    auto finish = [this, &isCancelled](uint64_t* counter) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (isCancelled()) {
+            ++cancelledCount_;
+        } else {
+            ++*counter;
+        }
+    };
+
+    // 继续输入：在之前的完整结果中细化
+    if (auto refined = refineFromCache(keyword, isCancelled)) {
+        if (!isCancelled()) {
+            cacheResult(keyword, *refined, cacheEpoch);
+            deliver(generation, keyword, std::move(*refined), true);
+        }
+        finish(&refinedCount_);
+        return;
+    }
+    if (isCancelled()) {
+        finish(&queryCount_);
+        return;
+    }
+
+    // 先查询第一页立即送达
+    auto records = ClipboardStore::instance().searchText(keyword, firstPageSize_, isCancelled);
+    if (isCancelled()) {
+        finish(&queryCount_);
+        return;
+    }
+    if (static_cast<int>(records.size()) >= firstPageSize_ && firstPageSize_ < limit_) {
+        deliver(generation, keyword, std::move(records), false);
+
+        records = ClipboardStore::instance().searchText(keyword, limit_, isCancelled);
+        if (isCancelled()) {
+            finish(&queryCount_);
+            return;
+        }
+    }
+
+    // 结果达到上限时不完整，不能用于细化
+    if (static_cast<int>(records.size()) < limit_) {
+        cacheResult(keyword, records, cacheEpoch);
+    }
+    deliver(generation, keyword, std::move(records), true);
+    finish(&queryCount_);
+}
+
+std::optional<std::vector<PreviewRecord>> ClipboardSearcher::refineFromCache(
+        const std::string& keyword, const SearchCancelCheck& isCancelled) {
+    const CachedResult* base = nullptr;
+    for (const auto& cached : cache_) {
+        if (keyword.compare(0, cached.keyword.size(), cached.keyword) == 0 &&
+            (!base || cached.keyword.size() > base->keyword.size())) {
+            base = &cached;
+        }
+    }
+    if (!base) {
+        return std::nullopt;
+    }
+    return ClipboardStore::instance().refineSearch(base->keyword, base->records, keyword, isCancelled);
+}
+
+void ClipboardSearcher::cacheResult(const std::string& keyword, const std::vector<PreviewRecord>& records,
+                                    uint64_t cacheEpoch) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (cacheEpoch != cacheEpoch_) {
+            return;     // 查询期间记录有变化
+        }
+    }
+
+    // 只保留关键词的前缀链（删字后仍可从更短的关键词细化）
+    cache_.erase(std::remove_if(cache_.begin(), cache_.end(), [&keyword](const CachedResult& cached) {
+        return keyword.compare(0, cached.keyword.size(), cached.keyword) != 0 || cached.keyword == keyword;
+    }), cache_.end());
+    if (cache_.size() >= kMaxCachedResults) {
+        cache_.erase(cache_.begin());
+    }
+    cache_.push_back(CachedResult{keyword, records});
+}
+
+void ClipboardSearcher::deliver(uint64_t generation, const std::string& keyword,
+                                std::vector<PreviewRecord> records, bool complete) {
+    if (!handler_) {
+        return;
+    }
+
+    SearchResult result;
+    result.generation = generation;
+    result.keyword = keyword;
+    result.records = std::move(records);
+    result.complete = complete;
+    handler_(std::move(result));
+}
+
+} // namespace suyan
@@ -0,0 +1,214 @@
+/**
+ * ClipboardSearcher - 剪贴板边输入边搜索的后台执行器
+ *
+ * 搜索框每次输入（防抖后）都要搜索一次，在主线程执行会让窗口卡顿，
+ * 逐字输入 "meeting" 时每个前缀都重新查询、读取全部结果也是浪费。
+ *
+ * 由专用工作线程执行搜索，只保留最新的一次请求：
+ * - 新请求到达时，排队中的旧请求直接丢弃，正在执行的查询被中止（SearchCancelCheck）
+ * - 关键词在之前某次关键词之后继续输入时，在那次的完整结果中细化（ClipboardStore::refineSearch），
+ *   不重新读取记录、不扫描全表
+ * - 否则先查询第一页立即送达，再查询其余结果（结果较多时列表先显示第一页）
+ *
+ * 结果处理函数在工作线程调用，需要更新 UI 时由调用方投递回主线程，
+ * 并按 generation 丢弃已被新请求取代的结果。
+ */
+
+#ifndef SUYAN_CLIPBOARD_CLIPBOARD_SEARCHER_H
+#define SUYAN_CLIPBOARD_CLIPBOARD_SEARCHER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "clipboard_store.h"
+
+namespace suyan {
+
+/**
+ * 搜索结果
+ */
+struct SearchResult {
+    uint64_t generation = 0;            // 请求序号（search() 的返回值）
+    std::string keyword;                // 搜索关键词
+    std::vector<PreviewRecord> records; // 匹配的预览记录（按最后使用时间降序）
+    bool complete = true;               // false 表示只是第一页，其余结果稍后送达
+};
+
+/**
+ * ClipboardSearcher - 后台搜索
+ *
+ * 单个工作线程，同一时刻只执行最新的一次请求。
+ */
+class ClipboardSearcher {
+public:
+    /**
+     * 结果处理函数（在工作线程调用）
+     */
+    using Handler = std::function<void(SearchResult)>;
+
+    /**
+     * 默认最大结果数
+     */
+    static constexpr int kDefaultLimit = 1000;
+
+    /**
+     * 默认第一页结果数（与列表分页大小一致）
+     */
+    static constexpr int kDefaultFirstPageSize = 50;
+
+    /**
+     * 最多保留的完整结果数（用于细化的前缀链）
+     */
+    static constexpr size_t kMaxCachedResults = 8;
+
+    /**
+     * 构造搜索执行器
+     *
+     * @param handler 结果处理函数
+     * @param limit 最大结果数
+     * @param firstPageSize 第一页结果数（结果多于此数时先送达第一页）
+     */
+    explicit ClipboardSearcher(Handler handler, int limit = kDefaultLimit,
+                               int firstPageSize = kDefaultFirstPageSize);
+
+    /**
+     * 析构时停止工作线程（中止正在执行的查询）
+     */
+    ~ClipboardSearcher();
+
+    // 禁止拷贝和移动
+    ClipboardSearcher(const ClipboardSearcher&) = delete;
+    ClipboardSearcher& operator=(const ClipboardSearcher&) = delete;
+    ClipboardSearcher(ClipboardSearcher&&) = delete;
+    ClipboardSearcher& operator=(ClipboardSearcher&&) = delete;
+
+    /**
+     * 启动工作线程
+     */
+    void start();
+
+    /**
+     * 停止工作线程
+     *
+     * 丢弃排队的请求并中止正在执行的查询，之后 search() 不再接受请求。
+     */
+    void stop();
+
+    /**
+     * 检查工作线程是否在运行
+     */
+    bool isRunning() const;
+
+    /**
+     * 提交搜索请求（主线程调用，不阻塞）
+     *
+     * 取代之前所有未完成的请求。
+     *
+     * @param keyword 搜索关键词（非空）
+     * @return 请求序号（未运行时返回 0）
+     */
+    uint64_t search(std::string keyword);
+
+    /**
+     * 取消所有未完成的请求（如搜索框已清空）
+     */
+    void cancel();
+
+    /**
+     * 清除细化用的结果缓存
+     *
+     * 记录增删后调用，之前的结果不再包含全部匹配。
+     */
+    void invalidateCache();
+
+    /**
+     * 等待所有请求处理完成
+     */
+    void waitForIdle();
+
+    /**
+     * 获取执行完整查询的请求数
+     */
+    uint64_t getQueryCount() const;
+
+    /**
+     * 获取在之前结果中细化完成的请求数
+     */
+    uint64_t getRefinedCount() const;
+
+    /**
+     * 获取被新请求取代而中止的请求数
+     */
+    uint64_t getCancelledCount() const;
+
+private:
+    /**
+     * 缓存的完整结果（包含关键词的全部匹配）
+     */
+    struct CachedResult {
+        std::string keyword;
+        std::vector<PreviewRecord> records;
+    };
+
+    /**
+     * 工作线程主循环
+     */
+    void run();
+
+    /**
+     * 执行一次请求
+     */
+    void process(const std::string& keyword, uint64_t generation, uint64_t cacheEpoch);
+
+    /**
+     * 在缓存中细化（选最长的、是关键词前缀的缓存关键词）
+     */
+    std::optional<std::vector<PreviewRecord>> refineFromCache(const std::string& keyword,
+                                                              const SearchCancelCheck& isCancelled);
+
+    /**
+     * 保存完整结果，丢弃不是该关键词前缀的缓存
+     */
+    void cacheResult(const std::string& keyword, const std::vector<PreviewRecord>& records,
+                     uint64_t cacheEpoch);
+
+    /**
+     * 送达结果
+     */
+    void deliver(uint64_t generation, const std::string& keyword,
+                 std::vector<PreviewRecord> records, bool complete);
+
+    // 成员变量
+    Handler handler_;
+    int limit_;
+    int firstPageSize_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable queueCondition_;    // 有新请求或请求停止
+    std::condition_variable idleCondition_;     // 请求处理完成
+    std::optional<std::string> pending_;        // 排队的请求（只保留最新的一次）
+    std::thread worker_;
+    bool running_ = false;
+    bool stopping_ = false;
+    bool busy_ = false;                         // 工作线程正在处理请求
+    std::atomic<uint64_t> generation_{0};       // 最新的请求序号（用于中止过时的查询）
+    uint64_t cacheEpoch_ = 0;                   // invalidateCache() 时递增
+    uint64_t queryCount_ = 0;
+    uint64_t refinedCount_ = 0;
+    uint64_t cancelledCount_ = 0;
+
+    // 只在工作线程访问
+    std::vector<CachedResult> cache_;           // 完整结果，关键词依次为前一个的延续
+    uint64_t cachedEpoch_ = 0;                  // cache_ 对应的 cacheEpoch_
+};
+
+} // namespace suyan
+
+#endif // SUYAN_CLIPBOARD_CLIPBOARD_SEARCHER_H
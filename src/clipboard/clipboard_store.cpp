@@ -6,16 +6,511 @@
  */
 
 #include "clipboard_store.h"
+#include "cjk_tokenizer.h"
+#include "pinyin_table.h"
+#include "pinyin_tokenizer.h"
 #include <sqlite3.h>
 #include <filesystem>
 #include <iostream>
 #include <chrono>
 #include <algorithm>
+#include <unordered_map>
 
 namespace fs = std::filesystem;
 
 namespace suyan {
 
+namespace {
+
+// 数据库结构版本（PRAGMA user_version）
+// 1: clipboard_fts 改用中日韩二元组分词器
+// 2: 增加 preview、content_length 列并重排列顺序，更新触发器只在内容变化时触发
+// 3: 增加 text_chunks 列（大文本分块清单）
+// 4: 增加拼音索引 clipboard_pinyin，触发器同时维护两个索引
+// 5: 触发器累计 file_size 总量（存储空间统计）
+constexpr int kSchemaVersion = 5;
+
+// FTS 匹配数超过此值时改为按最后使用时间索引扫描
+// （直接排序需要读取每条匹配记录，常用字的匹配可达数万条）
+constexpr int kRecencyScanThreshold = 1000;
+
+// 主表：content 最长 64KB，放在最后一列
+// （SQLite 按列顺序读取记录，大字段之后的列需要先遍历溢出页才能读到）
+constexpr const char* kCreateHistoryTableSQL = R"(
+    CREATE TABLE IF NOT EXISTS clipboard_history (
+        id INTEGER PRIMARY KEY AUTOINCREMENT,
+        content_type INTEGER NOT NULL,
+        content_hash TEXT NOT NULL UNIQUE,
+        source_app TEXT,
+        thumbnail_path TEXT,
+        image_format TEXT,
+        image_width INTEGER DEFAULT 0,
+        image_height INTEGER DEFAULT 0,
+        file_size INTEGER DEFAULT 0,
+        created_at INTEGER NOT NULL,
+        last_used_at INTEGER NOT NULL,
+        preview TEXT NOT NULL DEFAULT '',
+        content_length INTEGER NOT NULL DEFAULT 0,
+        text_chunks TEXT NOT NULL DEFAULT '',
+        content TEXT NOT NULL
+    );
+)";
+
+// 拼音索引：与 clipboard_fts 共用主表的 content 列，按读音分词
+// 查询的最后一个音节按前缀匹配，前缀索引覆盖首字母和两个字母的前缀
+constexpr const char* kCreatePinyinTableSQL = R"(
+    CREATE VIRTUAL TABLE IF NOT EXISTS clipboard_pinyin USING fts5(
+        content,
+        content='clipboard_history',
+        content_rowid='id',
+        tokenize='suyan_pinyin',
+        prefix='1,2'
+    );
+)";
+
+// 键值表：记录拼音索引建立时使用的读音表版本、file_size 总量
+constexpr const char* kCreateMetaTableSQL = R"(
+    CREATE TABLE IF NOT EXISTS clipboard_meta (
+        key TEXT PRIMARY KEY,
+        value TEXT NOT NULL
+    );
+)";
+
+constexpr const char* kPinyinVersionKey = "pinyin_table";
+
+// 上次校准存储空间的时间（Unix 毫秒）
+constexpr const char* kLastReconcileKey = "storage_reconciled_at";
+
+// 存储空间统计：触发器随记录增删累计 file_size，查询总量不需要扫描表或目录
+// （键名 file_size_total 直接写在触发器中）
+constexpr const char* kCreateSizeTriggersSQL = R"(
+    CREATE TRIGGER IF NOT EXISTS clipboard_size_ai AFTER INSERT ON clipboard_history
+    WHEN NEW.file_size != 0
+    BEGIN
+        UPDATE clipboard_meta SET value = value + NEW.file_size WHERE key = 'file_size_total';
+    END;
+    CREATE TRIGGER IF NOT EXISTS clipboard_size_au AFTER UPDATE OF file_size ON clipboard_history
+    BEGIN
+        UPDATE clipboard_meta SET value = value + NEW.file_size - OLD.file_size
+        WHERE key = 'file_size_total';
+    END;
+)";
+
+// 删除记录时扣减总量（与 clipboard_ad 一样，清空历史时临时移除）
+constexpr const char* kCreateSizeDeleteTriggerSQL = R"(
+    CREATE TRIGGER IF NOT EXISTS clipboard_size_ad AFTER DELETE ON clipboard_history
+    WHEN OLD.file_size != 0
+    BEGIN
+        UPDATE clipboard_meta SET value = value - OLD.file_size WHERE key = 'file_size_total';
+    END;
+)";
+
+// 按记录重新累计总量（校准）
+constexpr const char* kRecalculateFileSizeSQL = R"(
+    INSERT OR REPLACE INTO clipboard_meta (key, value)
+    SELECT 'file_size_total', COALESCE(SUM(file_size), 0) FROM clipboard_history;
+)";
+
+constexpr const char* kCreateHistoryIndexesSQL = R"(
+    CREATE INDEX IF NOT EXISTS idx_clipboard_hash 
+        ON clipboard_history(content_hash);
+    CREATE INDEX IF NOT EXISTS idx_clipboard_last_used 
+        ON clipboard_history(last_used_at DESC);
+    CREATE INDEX IF NOT EXISTS idx_clipboard_created 
+        ON clipboard_history(created_at DESC);
+    CREATE INDEX IF NOT EXISTS idx_clipboard_type 
+        ON clipboard_history(content_type);
+)";
+
+// 插入触发器：仅对文本类型创建 FTS 索引
+constexpr const char* kCreateInsertTriggerSQL = R"(
+    CREATE TRIGGER IF NOT EXISTS clipboard_ai AFTER INSERT ON clipboard_history
+    WHEN NEW.content_type = 0
+    BEGIN
+        INSERT INTO clipboard_fts(rowid, content) VALUES (NEW.id, NEW.content);
+        INSERT INTO clipboard_pinyin(rowid, content) VALUES (NEW.id, NEW.content);
+    END;
+)";
+
+// 删除触发器：同步删除 FTS 索引
+// 清空历史时临时移除（有触发器时 DELETE 无法整表截断，需逐行更新索引）
+constexpr const char* kCreateDeleteTriggerSQL = R"(
+    CREATE TRIGGER IF NOT EXISTS clipboard_ad AFTER DELETE ON clipboard_history
+    WHEN OLD.content_type = 0
+    BEGIN
+        INSERT INTO clipboard_fts(clipboard_fts, rowid, content) 
+        VALUES ('delete', OLD.id, OLD.content);
+        INSERT INTO clipboard_pinyin(clipboard_pinyin, rowid, content) 
+        VALUES ('delete', OLD.id, OLD.content);
+    END;
+)";
+
+// 更新触发器：内容变化时同步 FTS 索引
+// 只监听 content 列，更新最后使用时间等不会重建索引
+constexpr const char* kCreateUpdateTriggerSQL = R"(
+    CREATE TRIGGER IF NOT EXISTS clipboard_au AFTER UPDATE OF content ON clipboard_history
+    WHEN OLD.content_type = 0
+    BEGIN
+        INSERT INTO clipboard_fts(clipboard_fts, rowid, content) 
+        VALUES ('delete', OLD.id, OLD.content);
+        INSERT INTO clipboard_fts(rowid, content) VALUES (NEW.id, NEW.content);
+        INSERT INTO clipboard_pinyin(clipboard_pinyin, rowid, content) 
+        VALUES ('delete', OLD.id, OLD.content);
+        INSERT INTO clipboard_pinyin(rowid, content) VALUES (NEW.id, NEW.content);
+    END;
+)";
+
+// ========== 只读连接使用的查询 ==========
+
+constexpr const char* kFindByHashSQL = R"(
+    SELECT id, content_type, content, content_hash, source_app, thumbnail_path,
+           image_format, image_width, image_height, file_size, created_at, last_used_at,
+           content_length, text_chunks
+    FROM clipboard_history
+    WHERE content_hash = ?
+)";
+
+constexpr const char* kGetByIdSQL = R"(
+    SELECT id, content_type, content, content_hash, source_app, thumbnail_path,
+           image_format, image_width, image_height, file_size, created_at, last_used_at,
+           content_length, text_chunks
+    FROM clipboard_history
+    WHERE id = ?
+)";
+
+constexpr const char* kGetAllSQL = R"(
+    SELECT id, content_type, preview, content_length, source_app, thumbnail_path,
+           image_format, image_width, image_height, file_size, created_at, last_used_at
+    FROM clipboard_history
+    ORDER BY last_used_at DESC, id
+    LIMIT ? OFFSET ?
+)";
+
+// 键集分页：idx_clipboard_last_used 按 last_used_at 降序、同值时按 id 升序排列，
+// 排序与索引一致，从游标位置开始沿索引读取 limit 条即可
+constexpr const char* kGetPageSQL = R"(
+    SELECT id, content_type, preview, content_length, source_app, thumbnail_path,
+           image_format, image_width, image_height, file_size, created_at, last_used_at
+    FROM clipboard_history
+    WHERE last_used_at <= ?1 AND (last_used_at < ?1 OR id > ?2)
+    ORDER BY last_used_at DESC, id
+    LIMIT ?3
+)";
+
+constexpr const char* kCountSQL = R"(
+    SELECT COUNT(*) FROM clipboard_history
+)";
+
+// FTS 搜索：匹配较少时取出全部匹配再排序
+constexpr const char* kSearchFtsSQL = R"(
+    SELECT h.id, h.content_type, h.preview, h.content_length, h.source_app, 
+           h.thumbnail_path, h.image_format, h.image_width, h.image_height, 
+           h.file_size, h.created_at, h.last_used_at
+    FROM clipboard_history h
+    INNER JOIN clipboard_fts f ON h.id = f.rowid
+    WHERE clipboard_fts MATCH ?
+    ORDER BY h.last_used_at DESC
+    LIMIT ?
+)";
+
+// 匹配较多时：沿最后使用时间索引扫描，取满 limit 条即停止
+constexpr const char* kSearchFtsRecentSQL = R"(
+    SELECT id, content_type, preview, content_length, source_app, 
+           thumbnail_path, image_format, image_width, image_height, 
+           file_size, created_at, last_used_at
+    FROM clipboard_history INDEXED BY idx_clipboard_last_used
+    WHERE id IN (SELECT rowid FROM clipboard_fts WHERE clipboard_fts MATCH ?)
+    ORDER BY last_used_at DESC
+    LIMIT ?
+)";
+
+// 统计匹配数，最多数到上限
+constexpr const char* kCountFtsSQL = R"(
+    SELECT COUNT(*) FROM (
+        SELECT 1 FROM clipboard_fts WHERE clipboard_fts MATCH ? LIMIT ?
+    )
+)";
+
+// 拼音搜索（与 FTS 搜索相同的两种执行计划）
+constexpr const char* kSearchPinyinSQL = R"(
+    SELECT h.id, h.content_type, h.preview, h.content_length, h.source_app, 
+           h.thumbnail_path, h.image_format, h.image_width, h.image_height, 
+           h.file_size, h.created_at, h.last_used_at
+    FROM clipboard_history h
+    INNER JOIN clipboard_pinyin p ON h.id = p.rowid
+    WHERE clipboard_pinyin MATCH ?
+    ORDER BY h.last_used_at DESC
+    LIMIT ?
+)";
+
+constexpr const char* kSearchPinyinRecentSQL = R"(
+    SELECT id, content_type, preview, content_length, source_app, 
+           thumbnail_path, image_format, image_width, image_height, 
+           file_size, created_at, last_used_at
+    FROM clipboard_history INDEXED BY idx_clipboard_last_used
+    WHERE id IN (SELECT rowid FROM clipboard_pinyin WHERE clipboard_pinyin MATCH ?)
+    ORDER BY last_used_at DESC
+    LIMIT ?
+)";
+
+constexpr const char* kCountPinyinSQL = R"(
+    SELECT COUNT(*) FROM (
+        SELECT 1 FROM clipboard_pinyin WHERE clipboard_pinyin MATCH ? LIMIT ?
+    )
+)";
+
+// LIKE 搜索（降级方案）
+constexpr const char* kSearchLikeSQL = R"(
+    SELECT id, content_type, preview, content_length, source_app, 
+           thumbnail_path, image_format, image_width, image_height, 
+           file_size, created_at, last_used_at
+    FROM clipboard_history
+    WHERE content_type = 0 AND content LIKE ?
+    ORDER BY last_used_at DESC
+    LIMIT ?
+)";
+
+// 细化搜索：只取匹配的 ID，与上一次结果求交
+constexpr const char* kMatchFtsIdsSQL = R"(
+    SELECT rowid FROM clipboard_fts WHERE clipboard_fts MATCH ?
+)";
+
+constexpr const char* kMatchPinyinIdsSQL = R"(
+    SELECT rowid FROM clipboard_pinyin WHERE clipboard_pinyin MATCH ?
+)";
+
+// 细化 LIKE 搜索：按主键逐条检查上一次结果
+constexpr const char* kMatchLikeByIdSQL = R"(
+    SELECT 1 FROM clipboard_history
+    WHERE id = ? AND content_type = 0 AND content LIKE ?
+)";
+
+constexpr const char* kTotalFileSizeSQL = R"(
+    SELECT CAST(value AS INTEGER) FROM clipboard_meta WHERE key = 'file_size_total'
+)";
+
+constexpr const char* kMetaIntegerSQL = R"(
+    SELECT CAST(value AS INTEGER) FROM clipboard_meta WHERE key = ?
+)";
+
+// 图片记录的文件（校准存储空间时逐个读取实际大小）
+constexpr const char* kImageFilesSQL = R"(
+    SELECT id, content, thumbnail_path, file_size
+    FROM clipboard_history WHERE content_type = 1
+)";
+
+// 按内容哈希分页的图片记录（沿哈希索引读取，回收孤儿文件时与分片目录归并）
+constexpr const char* kImageFilesAfterHashSQL = R"(
+    SELECT id, content, thumbnail_path, file_size, content_hash
+    FROM clipboard_history
+    WHERE content_hash > ? AND content_type = 1
+    ORDER BY content_hash
+    LIMIT ?
+)";
+
+// 仍使用绝对路径的图片记录（新记录的路径相对于剪贴板目录）
+constexpr const char* kLegacyImageFilesSQL = R"(
+    SELECT id, content, thumbnail_path, file_size
+    FROM clipboard_history
+    WHERE content_type = 1 AND (content LIKE '/%' OR thumbnail_path LIKE '/%')
+)";
+
+// 大文本分块引用检查（沿部分索引只扫描大文本记录）
+constexpr const char* kChunkReferencedSQL = R"(
+    SELECT 1 FROM clipboard_history
+    WHERE text_chunks != '' AND instr(text_chunks, ?) > 0
+    LIMIT 1
+)";
+
+// 打开只读连接时预编译的语句
+constexpr const char* kReaderStatements[] = {
+    kFindByHashSQL, kGetByIdSQL, kGetAllSQL, kGetPageSQL, kCountSQL,
+    kSearchFtsSQL, kSearchFtsRecentSQL, kCountFtsSQL,
+    kSearchPinyinSQL, kSearchPinyinRecentSQL, kCountPinyinSQL,
+    kSearchLikeSQL, kChunkReferencedSQL, kTotalFileSizeSQL, kMetaIntegerSQL,
+    kMatchFtsIdsSQL, kMatchPinyinIdsSQL, kMatchLikeByIdSQL,
+};
+
+// 连接遇到锁时的等待时间（WAL 模式下读写互不阻塞，只有检查点等少数情况需要等待）
+constexpr int kBusyTimeoutMs = 1000;
+
+// 清理过期记录时每批删除的条数（每批一个事务，避免长时间持有写锁）
+constexpr int kExpiryBatchSize = 500;
+
+// 按存储空间淘汰图片时每批删除的条数（图片记录较少，单批通常即可回到上限以内）
+constexpr int kEvictionBatchSize = 100;
+
+// 搜索时检查取消的间隔（SQLite 虚拟机指令数）
+constexpr int kCancelCheckInterval = 1000;
+
+/**
+ * 搜索期间在只读连接上安装进度回调，取消检查返回 true 时中止正在执行的语句
+ *
+ * 被中止的语句返回 SQLITE_INTERRUPT，下一次 sqlite3_reset 后可以继续使用。
+ */
+class CancelScope {
+public:
+    CancelScope(sqlite3* db, const SearchCancelCheck& isCancelled)
+        : db_(isCancelled ? db : nullptr), isCancelled_(isCancelled) {
+        if (db_) {
+            sqlite3_progress_handler(db_, kCancelCheckInterval, &CancelScope::onProgress, this);
+        }
+    }
+
+    ~CancelScope() {
+        if (db_) {
+            sqlite3_progress_handler(db_, 0, nullptr, nullptr);
+        }
+    }
+
+    CancelScope(const CancelScope&) = delete;
+    CancelScope& operator=(const CancelScope&) = delete;
+
+    bool cancelled() const { return isCancelled_ && isCancelled_(); }
+
+private:
+    static int onProgress(void* userData) {
+        return static_cast<CancelScope*>(userData)->cancelled() ? 1 : 0;
+    }
+
+    sqlite3* db_;
+    const SearchCancelCheck& isCancelled_;
+};
+
+/**
+ * 构造 FTS 查询：整个关键词作为短语（双引号转义为两个双引号），末尾加通配符支持前缀匹配
+ * 中文按二元组分词，短语匹配即为子串匹配
+ */
+std::string buildFtsQuery(const std::string& keyword) {
+    std::string query = "\"";
+    for (char c : keyword) {
+        query += c;
+        if (c == '"') {
+            query += '"';
+        }
+    }
+    query += "\"*";
+    return query;
+}
+
+/**
+ * 读取 kImageFilesSQL 格式的结果行（第 5 列为内容哈希时一并读取）
+ *
+ * @param complete 非空时写入是否读完所有行（查询出错时为 false）
+ */
+std::vector<ImageFileEntry> readImageFiles(sqlite3_stmt* stmt, bool* complete = nullptr) {
+    std::vector<ImageFileEntry> results;
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        ImageFileEntry entry;
+        entry.id = sqlite3_column_int64(stmt, 0);
+        const char* imagePath = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+        entry.imagePath = imagePath ? imagePath : "";
+        const char* thumbnailPath = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
+        entry.thumbnailPath = thumbnailPath ? thumbnailPath : "";
+        entry.fileSize = sqlite3_column_int64(stmt, 3);
+        if (sqlite3_column_count(stmt) > 4) {
+            const char* hash = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
+            entry.contentHash = hash ? hash : "";
+        }
+        results.push_back(std::move(entry));
+    }
+    if (complete) {
+        *complete = rc == SQLITE_DONE;
+    }
+    return results;
+}
+
+bool isAsciiSpace(unsigned char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+/**
+ * SQL 函数 suyan_preview(content)：升级数据库时为已有记录生成预览
+ */
+void previewFunction(sqlite3_context* context, int argc, sqlite3_value** argv) {
+    (void)argc;
+    const char* text = reinterpret_cast<const char*>(sqlite3_value_text(argv[0]));
+    std::string preview = ClipboardStore::makePreview(text ? text : "");
+    sqlite3_result_text(context, preview.c_str(), static_cast<int>(preview.size()), SQLITE_TRANSIENT);
+}
+
+} // anonymous namespace
+
+// ========== 只读连接 ==========
+
+/**
+ * 只读连接：WAL 模式下与写连接并发读取，每个连接有自己的预编译语句缓存
+ *
+ * 同一时间只借给一个线程使用。
+ */
+struct ClipboardStore::ReaderConnection {
+    sqlite3* db = nullptr;
+    std::unordered_map<const char*, sqlite3_stmt*> statements;  // 以 SQL 常量地址为键
+
+    ~ReaderConnection() {
+        for (auto& [sql, stmt] : statements) {
+            sqlite3_finalize(stmt);
+        }
+        sqlite3_close(db);
+    }
+
+    /**
+     * 获取预编译语句（首次使用时编译，失败时缓存 nullptr，不重复编译）
+     */
+    sqlite3_stmt* statement(const char* sql) {
+        auto it = statements.find(sql);
+        if (it != statements.end()) {
+            return it->second;
+        }
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_prepare_v3(db, sql, -1, SQLITE_PREPARE_PERSISTENT, &stmt, nullptr) != SQLITE_OK) {
+            std::cerr << "ClipboardStore: 只读连接准备语句失败: " << sqlite3_errmsg(db) << std::endl;
+            stmt = nullptr;
+        }
+        statements.emplace(sql, stmt);
+        return stmt;
+    }
+
+    /**
+     * 重置所有语句，结束读事务（未重置的语句会一直持有旧快照）
+     */
+    void resetStatements() {
+        for (auto& [sql, stmt] : statements) {
+            if (stmt) {
+                sqlite3_reset(stmt);
+                sqlite3_clear_bindings(stmt);
+            }
+        }
+    }
+};
+
+/**
+ * 借出的只读连接，析构时归还连接池
+ */
+class ClipboardStore::ReaderLease {
+public:
+    explicit ReaderLease(ClipboardStore& store)
+        : store_(store), reader_(store.acquireReader()) {}
+
+    ~ReaderLease() {
+        if (reader_) {
+            store_.releaseReader(reader_);
+        }
+    }
+
+    ReaderLease(const ReaderLease&) = delete;
+    ReaderLease& operator=(const ReaderLease&) = delete;
+
+    ReaderConnection* operator->() const { return reader_; }
+    ReaderConnection& operator*() const { return *reader_; }
+    explicit operator bool() const { return reader_ != nullptr; }
+
+private:
+    ClipboardStore& store_;
+    ReaderConnection* reader_;
+};
+
 // ========== 单例实现 ==========
 
 ClipboardStore& ClipboardStore::instance() {
@@ -27,9 +522,41 @@ ClipboardStore::~ClipboardStore() {
     shutdown();
 }
 
+std::string ClipboardStore::makePreview(const std::string& text) {
+    std::string preview;
+    size_t charCount = 0;
+    bool pendingSpace = false;
+
+    for (char ch : text) {
+        auto c = static_cast<unsigned char>(ch);
+        if (isAsciiSpace(c)) {
+            pendingSpace = !preview.empty();
+            continue;
+        }
+
+        // 字符的首字节（非 UTF-8 后续字节）：计数，超出时截断
+        if ((c & 0xC0) != 0x80) {
+            if (charCount + (pendingSpace ? 1 : 0) >= kPreviewLength) {
+                preview += "...";
+                return preview;
+            }
+            if (pendingSpace) {
+                preview += ' ';
+                ++charCount;
+                pendingSpace = false;
+            }
+            ++charCount;
+        }
+        preview += ch;
+    }
+    return preview;
+}
+
 // ========== 初始化和关闭 ==========
 
-bool ClipboardStore::initialize(const std::string& dbPath) {
+bool ClipboardStore::initialize(const std::string& dbPath, int readerCount) {
+    std::lock_guard<std::recursive_mutex> lock(writeMutex_);
+
     if (initialized_) {
         // 如果已初始化且路径相同，直接返回成功
         if (dbPath_ == dbPath) {
@@ -63,8 +590,27 @@ bool ClipboardStore::initialize(const std::string& dbPath) {
         return false;
     }
 
+    // 升级旧版本数据库
+    if (!migrateSchema()) {
+        closeDatabase();
+        return false;
+    }
+
+    // 读音表变化时重建拼音索引
+    // 失败不是致命错误：关闭拼音搜索，避免按不一致的索引匹配
+    pinyinSearchEnabled_ = syncPinyinIndex() && PinyinTable::instance().isLoaded();
+
     // 准备预编译语句
     if (!prepareStatements()) {
+        finalizeStatements();
+        closeDatabase();
+        return false;
+    }
+
+    // 打开只读连接（表结构已由写连接建好）
+    if (!openReaders(readerCount)) {
+        closeReaders();
+        finalizeStatements();
         closeDatabase();
         return false;
     }
@@ -74,13 +620,17 @@ bool ClipboardStore::initialize(const std::string& dbPath) {
 }
 
 void ClipboardStore::shutdown() {
+    std::lock_guard<std::recursive_mutex> lock(writeMutex_);
+
     if (!initialized_) {
         return;
     }
 
+    // 先停止借出只读连接，等待正在进行的查询归还后关闭
+    initialized_ = false;
+    closeReaders();
     finalizeStatements();
     closeDatabase();
-    initialized_ = false;
 }
 
 // ========== 数据库操作 ==========
@@ -105,6 +655,12 @@ bool ClipboardStore::openDatabase() {
 
     // 启用外键约束
     sqlite3_exec(db_, "PRAGMA foreign_keys=ON;", nullptr, nullptr, nullptr);
+    sqlite3_busy_timeout(db_, kBusyTimeoutMs);
+
+    // 注册中日韩分词器（访问 FTS 表之前）
+    // 失败不是致命错误，搜索功能会降级
+    CjkTokenizer::registerTokenizer(db_);
+    PinyinTokenizer::registerTokenizer(db_);
 
     return true;
 }
@@ -116,36 +672,77 @@ void ClipboardStore::closeDatabase() {
     }
 }
 
+bool ClipboardStore::openReaders(int count) {
+    std::lock_guard<std::mutex> lock(readersMutex_);
+
+    for (int i = 0; i < std::max(1, count); ++i) {
+        auto reader = std::make_unique<ReaderConnection>();
+        int rc = sqlite3_open_v2(dbPath_.c_str(), &reader->db,
+                                 SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, nullptr);
+        if (rc != SQLITE_OK) {
+            std::cerr << "ClipboardStore: 打开只读连接失败: " << sqlite3_errmsg(reader->db) << std::endl;
+            return false;
+        }
+        sqlite3_busy_timeout(reader->db, kBusyTimeoutMs);
+
+        // 分词器按连接注册，FTS 查询在只读连接上执行
+        CjkTokenizer::registerTokenizer(reader->db);
+        PinyinTokenizer::registerTokenizer(reader->db);
+
+        // 预编译常用语句，首次搜索不需要等待编译
+        for (const char* sql : kReaderStatements) {
+            reader->statement(sql);
+        }
+        reader->resetStatements();
+
+        idleReaders_.push_back(reader.get());
+        readers_.push_back(std::move(reader));
+    }
+
+    readersOpen_ = true;
+    return true;
+}
+
+void ClipboardStore::closeReaders() {
+    std::unique_lock<std::mutex> lock(readersMutex_);
+
+    readersOpen_ = false;
+    readersAvailable_.notify_all();
+    readersAvailable_.wait(lock, [this] { return idleReaders_.size() == readers_.size(); });
+
+    idleReaders_.clear();
+    readers_.clear();
+}
+
+ClipboardStore::ReaderConnection* ClipboardStore::acquireReader() {
+    std::unique_lock<std::mutex> lock(readersMutex_);
+
+    readersAvailable_.wait(lock, [this] { return !readersOpen_ || !idleReaders_.empty(); });
+    if (!readersOpen_) {
+        return nullptr;
+    }
+
+    ReaderConnection* reader = idleReaders_.back();
+    idleReaders_.pop_back();
+    return reader;
+}
+
+void ClipboardStore::releaseReader(ReaderConnection* reader) {
+    reader->resetStatements();
+    {
+        std::lock_guard<std::mutex> lock(readersMutex_);
+        idleReaders_.push_back(reader);
+    }
+    // 可能有查询在等待空闲连接，也可能 closeReaders 在等待全部归还
+    readersAvailable_.notify_all();
+}
+
 bool ClipboardStore::createTables() {
     // 创建主表
-    const char* createTableSQL = R"(
-        CREATE TABLE IF NOT EXISTS clipboard_history (
-            id INTEGER PRIMARY KEY AUTOINCREMENT,
-            content_type INTEGER NOT NULL,
-            content TEXT NOT NULL,
-            content_hash TEXT NOT NULL UNIQUE,
-            source_app TEXT,
-            thumbnail_path TEXT,
-            image_format TEXT,
-            image_width INTEGER DEFAULT 0,
-            image_height INTEGER DEFAULT 0,
-            file_size INTEGER DEFAULT 0,
-            created_at INTEGER NOT NULL,
-            last_used_at INTEGER NOT NULL
-        );
-
-        CREATE INDEX IF NOT EXISTS idx_clipboard_hash 
-            ON clipboard_history(content_hash);
-        CREATE INDEX IF NOT EXISTS idx_clipboard_last_used 
-            ON clipboard_history(last_used_at DESC);
-        CREATE INDEX IF NOT EXISTS idx_clipboard_created 
-            ON clipboard_history(created_at DESC);
-        CREATE INDEX IF NOT EXISTS idx_clipboard_type 
-            ON clipboard_history(content_type);
-    )";
+    std::string createTableSQL = std::string(kCreateHistoryTableSQL) + kCreateHistoryIndexesSQL;
 
     char* errMsg = nullptr;
-    int rc = sqlite3_exec(db_, createTableSQL, nullptr, nullptr, &errMsg);
+    int rc = sqlite3_exec(db_, createTableSQL.c_str(), nullptr, nullptr, &errMsg);
     if (rc != SQLITE_OK) {
         std::cerr << "ClipboardStore: 创建主表失败: " << errMsg << std::endl;
         sqlite3_free(errMsg);
@@ -157,7 +754,9 @@ bool ClipboardStore::createTables() {
         CREATE VIRTUAL TABLE IF NOT EXISTS clipboard_fts USING fts5(
             content,
             content='clipboard_history',
-            content_rowid='id'
+            content_rowid='id',
+            tokenize='suyan_cjk',
+            prefix='1'
         );
     )";
 
@@ -168,34 +767,19 @@ bool ClipboardStore::createTables() {
         // FTS 创建失败不是致命错误，搜索功能会降级
     }
 
-    // 创建触发器同步 FTS 索引
-    const char* createTriggersSQL = R"(
-        -- 插入触发器：仅对文本类型创建 FTS 索引
-        CREATE TRIGGER IF NOT EXISTS clipboard_ai AFTER INSERT ON clipboard_history
-        WHEN NEW.content_type = 0
-        BEGIN
-            INSERT INTO clipboard_fts(rowid, content) VALUES (NEW.id, NEW.content);
-        END;
-
-        -- 删除触发器
-        CREATE TRIGGER IF NOT EXISTS clipboard_ad AFTER DELETE ON clipboard_history
-        WHEN OLD.content_type = 0
-        BEGIN
-            INSERT INTO clipboard_fts(clipboard_fts, rowid, content) 
-            VALUES ('delete', OLD.id, OLD.content);
-        END;
-
-        -- 更新触发器
-        CREATE TRIGGER IF NOT EXISTS clipboard_au AFTER UPDATE ON clipboard_history
-        WHEN OLD.content_type = 0
-        BEGIN
-            INSERT INTO clipboard_fts(clipboard_fts, rowid, content) 
-            VALUES ('delete', OLD.id, OLD.content);
-            INSERT INTO clipboard_fts(rowid, content) VALUES (NEW.id, NEW.content);
-        END;
-    )";
+    // 创建拼音索引和版本记录
+    std::string createPinyinSQL = std::string(kCreatePinyinTableSQL) + kCreateMetaTableSQL;
+    rc = sqlite3_exec(db_, createPinyinSQL.c_str(), nullptr, nullptr, &errMsg);
+    if (rc != SQLITE_OK) {
+        std::cerr << "ClipboardStore: 创建拼音索引失败: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+        // 拼音索引创建失败不是致命错误，拼音搜索不可用
+    }
 
-    rc = sqlite3_exec(db_, createTriggersSQL, nullptr, nullptr, &errMsg);
+    // 创建触发器同步 FTS 索引
+    std::string createTriggersSQL = std::string(kCreateInsertTriggerSQL) +
+                                    kCreateUpdateTriggerSQL + kCreateDeleteTriggerSQL;
+    rc = sqlite3_exec(db_, createTriggersSQL.c_str(), nullptr, nullptr, &errMsg);
     if (rc != SQLITE_OK) {
         std::cerr << "ClipboardStore: 创建触发器失败: " << errMsg << std::endl;
         sqlite3_free(errMsg);
@@ -205,45 +789,257 @@ bool ClipboardStore::createTables() {
     return true;
 }
 
-bool ClipboardStore::prepareStatements() {
+bool ClipboardStore::migrateSchema() {
+    sqlite3_stmt* stmt = nullptr;
+    int version = 0;
+    if (sqlite3_prepare_v2(db_, "PRAGMA user_version;", -1, &stmt, nullptr) == SQLITE_OK &&
+        sqlite3_step(stmt) == SQLITE_ROW) {
+        version = sqlite3_column_int(stmt, 0);
+    }
+    sqlite3_finalize(stmt);
+
+    // FTS 表是否已使用二元组分词器（版本 1 的重建失败时，之后每次启动重试）
+    bool ftsCurrent = false;
+    if (sqlite3_prepare_v2(db_, "SELECT sql FROM sqlite_master WHERE name = 'clipboard_fts';",
+                           -1, &stmt, nullptr) == SQLITE_OK &&
+        sqlite3_step(stmt) == SQLITE_ROW) {
+        const char* sql = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        ftsCurrent = sql && std::string(sql).find(CjkTokenizer::kName) != std::string::npos;
+    }
+    sqlite3_finalize(stmt);
+
+    if (version >= kSchemaVersion && ftsCurrent) {
+        return true;
+    }
+
+    char* errMsg = nullptr;
     int rc;
 
-    // INSERT 语句
-    const char* insertSQL = R"(
-        INSERT INTO clipboard_history 
-        (content_type, content, content_hash, source_app, thumbnail_path, 
-         image_format, image_width, image_height, file_size, created_at, last_used_at)
-        VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+    // 版本 1：用二元组分词器重建 FTS 索引（旧索引按 unicode61 分词，无法搜索中文子串）
+    // 仅索引文本记录，与插入触发器一致
+    std::string rebuildFtsSQL = R"(
+        BEGIN TRANSACTION;
+        DROP TABLE IF EXISTS clipboard_fts;
+        CREATE VIRTUAL TABLE clipboard_fts USING fts5(
+            content,
+            content='clipboard_history',
+            content_rowid='id',
+            tokenize='suyan_cjk',
+            prefix='1'
+        );
+        INSERT INTO clipboard_fts(rowid, content)
+            SELECT id, content FROM clipboard_history WHERE content_type = 0;
     )";
-    rc = sqlite3_prepare_v2(db_, insertSQL, -1, &stmtInsert_, nullptr);
-    if (rc != SQLITE_OK) {
-        std::cerr << "ClipboardStore: 准备 INSERT 语句失败: " << sqlite3_errmsg(db_) << std::endl;
-        return false;
+    if (version < 1) {
+        rebuildFtsSQL += "PRAGMA user_version = 1;";
+    }
+    rebuildFtsSQL += "COMMIT;";
+
+    if (version < 1 || !ftsCurrent) {
+        rc = sqlite3_exec(db_, rebuildFtsSQL.c_str(), nullptr, nullptr, &errMsg);
+        if (rc != SQLITE_OK) {
+            // 分词器不可用等情况下保留旧索引（搜索降级），之后的升级照常进行，下次启动时重试
+            std::cerr << "ClipboardStore: 重建 FTS 索引失败: " << errMsg << std::endl;
+            sqlite3_free(errMsg);
+            sqlite3_exec(db_, "ROLLBACK;", nullptr, nullptr, nullptr);
+        }
+    }
+
+    // 版本 2：按新的列顺序重建主表，同时为文本记录生成预览
+    // id 保持不变，FTS 索引无需重建；复制期间新表还没有触发器，不会重复索引
+    if (version < 2) {
+        sqlite3_create_function(db_, "suyan_preview", 1, SQLITE_UTF8 | SQLITE_DETERMINISTIC,
+                                nullptr, previewFunction, nullptr, nullptr);
+
+        std::string upgradeSQL = R"(
+            BEGIN TRANSACTION;
+            ALTER TABLE clipboard_history RENAME TO clipboard_history_old;
+        )";
+        upgradeSQL += kCreateHistoryTableSQL;
+        upgradeSQL += R"(
+            INSERT INTO clipboard_history
+                (id, content_type, content_hash, source_app, thumbnail_path, image_format,
+                 image_width, image_height, file_size, created_at, last_used_at,
+                 preview, content_length, content)
+            SELECT id, content_type, content_hash, source_app, thumbnail_path, image_format,
+                   image_width, image_height, file_size, created_at, last_used_at,
+                   CASE WHEN content_type = 0 THEN suyan_preview(content) ELSE '' END,
+                   CASE WHEN content_type = 0 THEN length(CAST(content AS BLOB)) ELSE 0 END,
+                   content
+            FROM clipboard_history_old;
+
+            -- 保留自增序号，已删除记录的 id 不会被复用
+            DELETE FROM sqlite_sequence WHERE name = 'clipboard_history';
+            INSERT INTO sqlite_sequence (name, seq)
+                SELECT 'clipboard_history', seq FROM sqlite_sequence
+                WHERE name = 'clipboard_history_old';
+
+            DROP TABLE clipboard_history_old;
+        )";
+        upgradeSQL += kCreateHistoryIndexesSQL;
+        upgradeSQL += kCreateInsertTriggerSQL;
+        upgradeSQL += kCreateUpdateTriggerSQL;
+        upgradeSQL += kCreateDeleteTriggerSQL;
+        upgradeSQL += R"(
+            PRAGMA user_version = 2;
+            COMMIT;
+        )";
+
+        rc = sqlite3_exec(db_, upgradeSQL.c_str(), nullptr, nullptr, &errMsg);
+        if (rc != SQLITE_OK) {
+            std::cerr << "ClipboardStore: 升级数据库失败: " << errMsg << std::endl;
+            sqlite3_free(errMsg);
+            sqlite3_exec(db_, "ROLLBACK;", nullptr, nullptr, nullptr);
+            return false;
+        }
+    }
+
+    // 版本 3：增加大文本分块清单列（版本 2 重建的表已包含）
+    // 部分索引只包含大文本记录，用于检查分块引用
+    if (version < 3) {
+        sqlite3_stmt* probe = nullptr;
+        bool hasChunksColumn = sqlite3_prepare_v2(
+            db_, "SELECT text_chunks FROM clipboard_history LIMIT 0;", -1, &probe, nullptr) == SQLITE_OK;
+        sqlite3_finalize(probe);
+
+        std::string upgradeSQL = "BEGIN TRANSACTION;";
+        if (!hasChunksColumn) {
+            upgradeSQL += "ALTER TABLE clipboard_history ADD COLUMN text_chunks TEXT NOT NULL DEFAULT '';";
+        }
+        upgradeSQL += R"(
+            CREATE INDEX IF NOT EXISTS idx_clipboard_text_chunks
+                ON clipboard_history(text_chunks) WHERE text_chunks != '';
+            PRAGMA user_version = 3;
+            COMMIT;
+        )";
+
+        rc = sqlite3_exec(db_, upgradeSQL.c_str(), nullptr, nullptr, &errMsg);
+        if (rc != SQLITE_OK) {
+            std::cerr << "ClipboardStore: 升级数据库失败: " << errMsg << std::endl;
+            sqlite3_free(errMsg);
+            sqlite3_exec(db_, "ROLLBACK;", nullptr, nullptr, nullptr);
+            return false;
+        }
+    }
+
+    // 版本 4：重建触发器，同时维护拼音索引（拼音索引表由 createTables 创建，
+    // 已有记录的拼音索引由 syncPinyinIndex 建立）
+    if (version < 4) {
+        std::string upgradeSQL = R"(
+            BEGIN TRANSACTION;
+            DROP TRIGGER IF EXISTS clipboard_ai;
+            DROP TRIGGER IF EXISTS clipboard_au;
+            DROP TRIGGER IF EXISTS clipboard_ad;
+        )";
+        upgradeSQL += kCreateInsertTriggerSQL;
+        upgradeSQL += kCreateUpdateTriggerSQL;
+        upgradeSQL += kCreateDeleteTriggerSQL;
+        upgradeSQL += R"(
+            PRAGMA user_version = 4;
+            COMMIT;
+        )";
+
+        rc = sqlite3_exec(db_, upgradeSQL.c_str(), nullptr, nullptr, &errMsg);
+        if (rc != SQLITE_OK) {
+            std::cerr << "ClipboardStore: 升级数据库失败: " << errMsg << std::endl;
+            sqlite3_free(errMsg);
+            sqlite3_exec(db_, "ROLLBACK;", nullptr, nullptr, nullptr);
+            return false;
+        }
+    }
+
+    // 版本 5：创建存储空间统计触发器，按已有记录计算初始总量
+    if (version < 5) {
+        std::string upgradeSQL = "BEGIN TRANSACTION;";
+        upgradeSQL += kCreateMetaTableSQL;
+        upgradeSQL += kCreateSizeTriggersSQL;
+        upgradeSQL += kCreateSizeDeleteTriggerSQL;
+        upgradeSQL += kRecalculateFileSizeSQL;
+        upgradeSQL += R"(
+            PRAGMA user_version = 5;
+            COMMIT;
+        )";
+
+        rc = sqlite3_exec(db_, upgradeSQL.c_str(), nullptr, nullptr, &errMsg);
+        if (rc != SQLITE_OK) {
+            std::cerr << "ClipboardStore: 升级数据库失败: " << errMsg << std::endl;
+            sqlite3_free(errMsg);
+            sqlite3_exec(db_, "ROLLBACK;", nullptr, nullptr, nullptr);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool ClipboardStore::syncPinyinIndex() {
+    const std::string& tableVersion = PinyinTable::instance().getVersion();
+
+    // 没有版本记录时索引为空，与空读音表一致
+    std::string indexVersion;
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db_, "SELECT value FROM clipboard_meta WHERE key = ?;",
+                           -1, &stmt, nullptr) == SQLITE_OK) {
+        sqlite3_bind_text(stmt, 1, kPinyinVersionKey, -1, SQLITE_STATIC);
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            const char* value = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+            indexVersion = value ? value : "";
+        }
+    }
+    sqlite3_finalize(stmt);
+
+    if (indexVersion == tableVersion) {
+        return true;
+    }
+
+    // 读音表变化：按新读音重建（删除旧索引依赖旧读音，不能逐行更新）
+    // 仅索引文本记录，与插入触发器一致
+    char* errMsg = nullptr;
+    int rc = sqlite3_exec(db_, R"(
+        BEGIN TRANSACTION;
+        INSERT INTO clipboard_pinyin(clipboard_pinyin) VALUES ('delete-all');
+        INSERT INTO clipboard_pinyin(rowid, content)
+            SELECT id, content FROM clipboard_history WHERE content_type = 0;
+    )", nullptr, nullptr, &errMsg);
+
+    if (rc == SQLITE_OK) {
+        rc = sqlite3_prepare_v2(db_, "INSERT OR REPLACE INTO clipboard_meta (key, value) VALUES (?, ?);",
+                                -1, &stmt, nullptr);
+        if (rc == SQLITE_OK) {
+            sqlite3_bind_text(stmt, 1, kPinyinVersionKey, -1, SQLITE_STATIC);
+            sqlite3_bind_text(stmt, 2, tableVersion.c_str(), -1, SQLITE_TRANSIENT);
+            rc = sqlite3_step(stmt) == SQLITE_DONE ? SQLITE_OK : SQLITE_ERROR;
+        }
+        sqlite3_finalize(stmt);
+    }
+    if (rc == SQLITE_OK) {
+        rc = sqlite3_exec(db_, "COMMIT;", nullptr, nullptr, &errMsg);
     }
 
-    // FIND BY HASH 语句
-    const char* findByHashSQL = R"(
-        SELECT id, content_type, content, content_hash, source_app, thumbnail_path,
-               image_format, image_width, image_height, file_size, created_at, last_used_at
-        FROM clipboard_history
-        WHERE content_hash = ?
-    )";
-    rc = sqlite3_prepare_v2(db_, findByHashSQL, -1, &stmtFindByHash_, nullptr);
     if (rc != SQLITE_OK) {
-        std::cerr << "ClipboardStore: 准备 FIND BY HASH 语句失败: " << sqlite3_errmsg(db_) << std::endl;
+        std::cerr << "ClipboardStore: 重建拼音索引失败: "
+                  << (errMsg ? errMsg : sqlite3_errmsg(db_)) << std::endl;
+        sqlite3_free(errMsg);
+        sqlite3_exec(db_, "ROLLBACK;", nullptr, nullptr, nullptr);
         return false;
     }
+    return true;
+}
+
+bool ClipboardStore::prepareStatements() {
+    int rc;
 
-    // GET BY ID 语句
-    const char* getByIdSQL = R"(
-        SELECT id, content_type, content, content_hash, source_app, thumbnail_path,
-               image_format, image_width, image_height, file_size, created_at, last_used_at
-        FROM clipboard_history
-        WHERE id = ?
+    // INSERT 语句
+    const char* insertSQL = R"(
+        INSERT INTO clipboard_history 
+        (content_type, content, content_hash, source_app, thumbnail_path, 
+         image_format, image_width, image_height, file_size, created_at, last_used_at,
+         preview, content_length, text_chunks)
+        VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
     )";
-    rc = sqlite3_prepare_v2(db_, getByIdSQL, -1, &stmtGetById_, nullptr);
+    rc = sqlite3_prepare_v2(db_, insertSQL, -1, &stmtInsert_, nullptr);
     if (rc != SQLITE_OK) {
-        std::cerr << "ClipboardStore: 准备 GET BY ID 语句失败: " << sqlite3_errmsg(db_) << std::endl;
+        std::cerr << "ClipboardStore: 准备 INSERT 语句失败: " << sqlite3_errmsg(db_) << std::endl;
         return false;
     }
 
@@ -257,20 +1053,6 @@ bool ClipboardStore::prepareStatements() {
         return false;
     }
 
-    // GET ALL 语句
-    const char* getAllSQL = R"(
-        SELECT id, content_type, content, content_hash, source_app, thumbnail_path,
-               image_format, image_width, image_height, file_size, created_at, last_used_at
-        FROM clipboard_history
-        ORDER BY last_used_at DESC
-        LIMIT ? OFFSET ?
-    )";
-    rc = sqlite3_prepare_v2(db_, getAllSQL, -1, &stmtGetAll_, nullptr);
-    if (rc != SQLITE_OK) {
-        std::cerr << "ClipboardStore: 准备 GET ALL 语句失败: " << sqlite3_errmsg(db_) << std::endl;
-        return false;
-    }
-
     // DELETE 语句
     const char* deleteSQL = R"(
         DELETE FROM clipboard_history WHERE id = ?
@@ -281,19 +1063,10 @@ bool ClipboardStore::prepareStatements() {
         return false;
     }
 
-    // COUNT 语句
-    const char* countSQL = R"(
-        SELECT COUNT(*) FROM clipboard_history
-    )";
-    rc = sqlite3_prepare_v2(db_, countSQL, -1, &stmtCount_, nullptr);
-    if (rc != SQLITE_OK) {
-        std::cerr << "ClipboardStore: 准备 COUNT 语句失败: " << sqlite3_errmsg(db_) << std::endl;
-        return false;
-    }
-
-    // UPDATE TIMESTAMP（用于哈希去重时更新时间戳）
+    // UPDATE TIMESTAMP（哈希去重：已有记录时更新时间戳并返回 ID，一次完成查重和更新）
     const char* updateTimestampSQL = R"(
         UPDATE clipboard_history SET last_used_at = ? WHERE content_hash = ?
+        RETURNING id
     )";
     rc = sqlite3_prepare_v2(db_, updateTimestampSQL, -1, &stmtUpdateTimestamp_, nullptr);
     if (rc != SQLITE_OK) {
@@ -301,39 +1074,54 @@ bool ClipboardStore::prepareStatements() {
         return false;
     }
 
-    // FTS 搜索语句（预编译以提高性能）
-    const char* searchFtsSQL = R"(
-        SELECT h.id, h.content_type, h.content, h.content_hash, h.source_app, 
-               h.thumbnail_path, h.image_format, h.image_width, h.image_height, 
-               h.file_size, h.created_at, h.last_used_at
-        FROM clipboard_history h
-        INNER JOIN clipboard_fts f ON h.id = f.rowid
-        WHERE clipboard_fts MATCH ?
-        ORDER BY h.last_used_at DESC
-        LIMIT ?
+    // DELETE EXPIRED 语句：按最后使用时间排名，跳过最近的 N 条（?2），
+    // 其余记录中创建时间早于阈值（?1）的删除，每次最多 ?3 条
+    // 只返回清理图片文件所需的字段，文本内容不返回
+    const char* deleteExpiredSQL = R"(
+        DELETE FROM clipboard_history
+        WHERE id IN (
+            SELECT id FROM (
+                SELECT id, created_at FROM clipboard_history
+                ORDER BY last_used_at DESC, id
+                LIMIT -1 OFFSET ?2
+            )
+            WHERE created_at < ?1
+            LIMIT ?3
+        )
+        RETURNING id, content_type,
+                  CASE WHEN content_type = 1 THEN content END,
+                  thumbnail_path, text_chunks, content_hash
     )";
-    rc = sqlite3_prepare_v2(db_, searchFtsSQL, -1, &stmtSearchFts_, nullptr);
+    rc = sqlite3_prepare_v2(db_, deleteExpiredSQL, -1, &stmtDeleteExpired_, nullptr);
     if (rc != SQLITE_OK) {
-        // FTS 搜索语句准备失败不是致命错误，会降级到 LIKE 搜索
-        std::cerr << "ClipboardStore: 准备 FTS 搜索语句失败（将使用 LIKE 降级）: " << sqlite3_errmsg(db_) << std::endl;
-        stmtSearchFts_ = nullptr;
-    }
-
-    // LIKE 搜索语句（降级方案，预编译以提高性能）
-    const char* searchLikeSQL = R"(
-        SELECT id, content_type, content, content_hash, source_app, 
-               thumbnail_path, image_format, image_width, image_height, 
-               file_size, created_at, last_used_at
-        FROM clipboard_history
-        WHERE content_type = 0 AND content LIKE ?
-        ORDER BY last_used_at DESC
-        LIMIT ?
+        std::cerr << "ClipboardStore: 准备 DELETE EXPIRED 语句失败: " << sqlite3_errmsg(db_) << std::endl;
+        return false;
+    }
+
+    // EVICT IMAGES 语句：图片按最后使用时间从旧到新累计 file_size，
+    // 删除累计到自身之前仍不足超出量（图片总量 - ?1）的记录，跳过 ?2，每次最多 ?3 条。
+    // 只比较图片的总量：大文本分块不会被淘汰，计入后单靠大文本就能超出上限，
+    // 每次入库都会淘汰全部图片
+    const char* evictImagesSQL = R"(
+        DELETE FROM clipboard_history
+        WHERE id IN (
+            SELECT id FROM (
+                SELECT id, SUM(file_size) OVER (ORDER BY last_used_at, id) - file_size AS freed_before
+                FROM clipboard_history
+                WHERE content_type = 1 AND id != ?2
+            )
+            WHERE freed_before < (
+                SELECT COALESCE(SUM(file_size), 0) FROM clipboard_history WHERE content_type = 1
+            ) - ?1
+            ORDER BY freed_before
+            LIMIT ?3
+        )
+        RETURNING id, content_type, content, thumbnail_path, text_chunks, content_hash
     )";
-    rc = sqlite3_prepare_v2(db_, searchLikeSQL, -1, &stmtSearchLike_, nullptr);
+    rc = sqlite3_prepare_v2(db_, evictImagesSQL, -1, &stmtEvictImages_, nullptr);
     if (rc != SQLITE_OK) {
-        std::cerr << "ClipboardStore: 准备 LIKE 搜索语句失败: " << sqlite3_errmsg(db_) << std::endl;
-        // LIKE 搜索失败也不是致命错误
-        stmtSearchLike_ = nullptr;
+        std::cerr << "ClipboardStore: 准备 EVICT IMAGES 语句失败: " << sqlite3_errmsg(db_) << std::endl;
+        return false;
     }
 
     return true;
@@ -341,15 +1129,11 @@ bool ClipboardStore::prepareStatements() {
 
 void ClipboardStore::finalizeStatements() {
     if (stmtInsert_) { sqlite3_finalize(stmtInsert_); stmtInsert_ = nullptr; }
-    if (stmtFindByHash_) { sqlite3_finalize(stmtFindByHash_); stmtFindByHash_ = nullptr; }
-    if (stmtGetById_) { sqlite3_finalize(stmtGetById_); stmtGetById_ = nullptr; }
     if (stmtUpdateLastUsed_) { sqlite3_finalize(stmtUpdateLastUsed_); stmtUpdateLastUsed_ = nullptr; }
-    if (stmtGetAll_) { sqlite3_finalize(stmtGetAll_); stmtGetAll_ = nullptr; }
     if (stmtDelete_) { sqlite3_finalize(stmtDelete_); stmtDelete_ = nullptr; }
-    if (stmtCount_) { sqlite3_finalize(stmtCount_); stmtCount_ = nullptr; }
     if (stmtUpdateTimestamp_) { sqlite3_finalize(stmtUpdateTimestamp_); stmtUpdateTimestamp_ = nullptr; }
-    if (stmtSearchFts_) { sqlite3_finalize(stmtSearchFts_); stmtSearchFts_ = nullptr; }
-    if (stmtSearchLike_) { sqlite3_finalize(stmtSearchLike_); stmtSearchLike_ = nullptr; }
+    if (stmtDeleteExpired_) { sqlite3_finalize(stmtDeleteExpired_); stmtDeleteExpired_ = nullptr; }
+    if (stmtEvictImages_) { sqlite3_finalize(stmtEvictImages_); stmtEvictImages_ = nullptr; }
 }
 
 // ========== 辅助方法 ==========
@@ -374,6 +1158,37 @@ ClipboardRecord ClipboardStore::rowToRecord(sqlite3_stmt* stmt) const {
     const char* imageFormat = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 6));
     record.imageFormat = imageFormat ? imageFormat : "";
     
+    record.imageWidth = sqlite3_column_int(stmt, 7);
+    record.imageHeight = sqlite3_column_int(stmt, 8);
+    record.fileSize = sqlite3_column_int64(stmt, 9);
+    record.createdAt = sqlite3_column_int64(stmt, 10);
+    record.lastUsedAt = sqlite3_column_int64(stmt, 11);
+    record.contentLength = sqlite3_column_int64(stmt, 12);
+    
+    const char* textChunks = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 13));
+    record.textChunks = textChunks ? textChunks : "";
+    
+    return record;
+}
+
+PreviewRecord ClipboardStore::rowToPreview(sqlite3_stmt* stmt) const {
+    PreviewRecord record;
+    record.id = sqlite3_column_int64(stmt, 0);
+    record.type = static_cast<ClipboardContentType>(sqlite3_column_int(stmt, 1));
+    
+    const char* preview = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
+    record.preview = preview ? preview : "";
+    record.contentLength = sqlite3_column_int64(stmt, 3);
+    
+    const char* sourceApp = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
+    record.sourceApp = sourceApp ? sourceApp : "";
+    
+    const char* thumbnailPath = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 5));
+    record.thumbnailPath = thumbnailPath ? thumbnailPath : "";
+    
+    const char* imageFormat = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 6));
+    record.imageFormat = imageFormat ? imageFormat : "";
+    
     record.imageWidth = sqlite3_column_int(stmt, 7);
     record.imageHeight = sqlite3_column_int(stmt, 8);
     record.fileSize = sqlite3_column_int64(stmt, 9);
@@ -394,32 +1209,41 @@ int64_t ClipboardStore::getCurrentTimestampMs() const {
 // ========== CRUD 操作 ==========
 
 AddRecordResult ClipboardStore::addRecord(const ClipboardRecord& record) {
+    std::lock_guard<std::recursive_mutex> lock(writeMutex_);
+
     AddRecordResult result;
     
     if (!initialized_) {
         return result;
     }
 
-    // 先检查是否已存在相同哈希的记录
-    auto existing = findByHash(record.contentHash);
-    if (existing) {
-        // 更新时间戳并返回已有 ID（不是新记录）
-        int64_t now = getCurrentTimestampMs();
-        sqlite3_reset(stmtUpdateTimestamp_);
-        sqlite3_bind_int64(stmtUpdateTimestamp_, 1, now);
-        sqlite3_bind_text(stmtUpdateTimestamp_, 2, record.contentHash.c_str(), -1, SQLITE_TRANSIENT);
-        
-        int rc = sqlite3_step(stmtUpdateTimestamp_);
-        if (rc != SQLITE_DONE) {
-            std::cerr << "ClipboardStore: 更新时间戳失败: " << sqlite3_errmsg(db_) << std::endl;
-        }
-        result.id = existing->id;
+    // 已存在相同哈希的记录：更新时间戳并返回已有 ID（不是新记录）
+    sqlite3_reset(stmtUpdateTimestamp_);
+    sqlite3_bind_int64(stmtUpdateTimestamp_, 1, getCurrentTimestampMs());
+    sqlite3_bind_text(stmtUpdateTimestamp_, 2, record.contentHash.c_str(), -1, SQLITE_TRANSIENT);
+
+    int rc = sqlite3_step(stmtUpdateTimestamp_);
+    int64_t existingId = rc == SQLITE_ROW ? sqlite3_column_int64(stmtUpdateTimestamp_, 0) : -1;
+    if (rc != SQLITE_ROW && rc != SQLITE_DONE) {
+        std::cerr << "ClipboardStore: 更新时间戳失败: " << sqlite3_errmsg(db_) << std::endl;
+    }
+    sqlite3_reset(stmtUpdateTimestamp_);    // 结束语句，提交更新
+    if (existingId > 0) {
+        result.id = existingId;
         result.isNew = false;
         return result;
     }
 
-    // 插入新记录
+    // 插入新记录（文本同时保存预览，列表查询不读取完整内容）
+    // 大文本的 content 只是开头部分，长度取调用方给出的原文大小
     int64_t now = getCurrentTimestampMs();
+    bool isText = record.type == ClipboardContentType::Text;
+    std::string preview = isText ? makePreview(record.content) : std::string();
+    int64_t contentLength = 0;
+    if (isText) {
+        contentLength = record.textChunks.empty() ? static_cast<int64_t>(record.content.size())
+                                                  : record.contentLength;
+    }
     
     sqlite3_reset(stmtInsert_);
     sqlite3_bind_int(stmtInsert_, 1, static_cast<int>(record.type));
@@ -433,8 +1257,11 @@ AddRecordResult ClipboardStore::addRecord(const ClipboardRecord& record) {
     sqlite3_bind_int64(stmtInsert_, 9, record.fileSize);
     sqlite3_bind_int64(stmtInsert_, 10, now);
     sqlite3_bind_int64(stmtInsert_, 11, now);
+    sqlite3_bind_text(stmtInsert_, 12, preview.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(stmtInsert_, 13, contentLength);
+    sqlite3_bind_text(stmtInsert_, 14, record.textChunks.c_str(), -1, SQLITE_TRANSIENT);
 
-    int rc = sqlite3_step(stmtInsert_);
+    rc = sqlite3_step(stmtInsert_);
     if (rc != SQLITE_DONE) {
         std::cerr << "ClipboardStore: 插入记录失败: " << sqlite3_errmsg(db_) << std::endl;
         return result;
@@ -450,12 +1277,17 @@ std::optional<ClipboardRecord> ClipboardStore::findByHash(const std::string& has
         return std::nullopt;
     }
 
-    sqlite3_reset(stmtFindByHash_);
-    sqlite3_bind_text(stmtFindByHash_, 1, hash.c_str(), -1, SQLITE_TRANSIENT);
+    ReaderLease reader(*this);
+    sqlite3_stmt* stmt = reader ? reader->statement(kFindByHashSQL) : nullptr;
+    if (!stmt) {
+        return std::nullopt;
+    }
+
+    sqlite3_bind_text(stmt, 1, hash.c_str(), -1, SQLITE_TRANSIENT);
 
-    int rc = sqlite3_step(stmtFindByHash_);
+    int rc = sqlite3_step(stmt);
     if (rc == SQLITE_ROW) {
-        return rowToRecord(stmtFindByHash_);
+        return rowToRecord(stmt);
     }
 
     return std::nullopt;
@@ -466,18 +1298,25 @@ std::optional<ClipboardRecord> ClipboardStore::getRecord(int64_t id) {
         return std::nullopt;
     }
 
-    sqlite3_reset(stmtGetById_);
-    sqlite3_bind_int64(stmtGetById_, 1, id);
+    ReaderLease reader(*this);
+    sqlite3_stmt* stmt = reader ? reader->statement(kGetByIdSQL) : nullptr;
+    if (!stmt) {
+        return std::nullopt;
+    }
+
+    sqlite3_bind_int64(stmt, 1, id);
 
-    int rc = sqlite3_step(stmtGetById_);
+    int rc = sqlite3_step(stmt);
     if (rc == SQLITE_ROW) {
-        return rowToRecord(stmtGetById_);
+        return rowToRecord(stmt);
     }
 
     return std::nullopt;
 }
 
 bool ClipboardStore::updateLastUsedTime(int64_t id) {
+    std::lock_guard<std::recursive_mutex> lock(writeMutex_);
+
     if (!initialized_ || id <= 0) {
         return false;
     }
@@ -497,103 +1336,291 @@ bool ClipboardStore::updateLastUsedTime(int64_t id) {
     return sqlite3_changes(db_) > 0;
 }
 
-std::vector<ClipboardRecord> ClipboardStore::getAllRecords(int limit, int offset) {
-    std::vector<ClipboardRecord> results;
+std::vector<PreviewRecord> ClipboardStore::getAllRecords(int limit, int offset) {
+    std::vector<PreviewRecord> results;
     
     if (!initialized_) {
         return results;
     }
 
-    sqlite3_reset(stmtGetAll_);
-    sqlite3_bind_int(stmtGetAll_, 1, limit);
-    sqlite3_bind_int(stmtGetAll_, 2, offset);
+    ReaderLease reader(*this);
+    sqlite3_stmt* stmt = reader ? reader->statement(kGetAllSQL) : nullptr;
+    if (!stmt) {
+        return results;
+    }
+
+    sqlite3_bind_int(stmt, 1, limit);
+    sqlite3_bind_int(stmt, 2, offset);
 
-    while (sqlite3_step(stmtGetAll_) == SQLITE_ROW) {
-        results.push_back(rowToRecord(stmtGetAll_));
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        results.push_back(rowToPreview(stmt));
     }
 
     return results;
 }
 
-std::vector<ClipboardRecord> ClipboardStore::searchText(const std::string& keyword, int limit) {
-    std::vector<ClipboardRecord> results;
+std::vector<PreviewRecord> ClipboardStore::getRecordsAfter(const RecordCursor& cursor, int limit) {
+    std::vector<PreviewRecord> results;
     
-    if (!initialized_ || keyword.empty()) {
+    if (!initialized_) {
         return results;
     }
 
-    // 优先使用预编译的 FTS 搜索语句
-    if (stmtSearchFts_) {
-        // 对关键词进行转义和处理
-        // 添加通配符支持模糊匹配
-        std::string searchQuery = "\"" + keyword + "\"*";
+    ReaderLease reader(*this);
+    sqlite3_stmt* stmt = reader ? reader->statement(kGetPageSQL) : nullptr;
+    if (!stmt) {
+        return results;
+    }
 
-        sqlite3_reset(stmtSearchFts_);
-        sqlite3_bind_text(stmtSearchFts_, 1, searchQuery.c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_int(stmtSearchFts_, 2, limit);
+    sqlite3_bind_int64(stmt, 1, cursor.lastUsedAt);
+    sqlite3_bind_int64(stmt, 2, cursor.id);
+    sqlite3_bind_int(stmt, 3, limit);
 
-        while (sqlite3_step(stmtSearchFts_) == SQLITE_ROW) {
-            results.push_back(rowToRecord(stmtSearchFts_));
-        }
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        results.push_back(rowToPreview(stmt));
+    }
 
-        // 如果 FTS 有结果，直接返回
-        if (!results.empty()) {
-            return results;
-        }
+    return results;
+}
+
+std::vector<PreviewRecord> ClipboardStore::searchText(const std::string& keyword, int limit,
+                                                      const SearchCancelCheck& isCancelled) {
+    std::vector<PreviewRecord> results;
+    
+    if (!initialized_ || keyword.empty()) {
+        return results;
+    }
+
+    // 在只读连接上搜索，不等待入库等写操作
+    ReaderLease reader(*this);
+    if (!reader) {
+        return results;
+    }
+    CancelScope cancelScope(reader->db, isCancelled);
+
+    // 优先使用预编译的 FTS 搜索语句
+    sqlite3_stmt* stmtSearchFts = reader->statement(kSearchFtsSQL);
+    if (stmtSearchFts) {
+        results = searchIndex(stmtSearchFts, reader->statement(kSearchFtsRecentSQL),
+                              reader->statement(kCountFtsSQL), buildFtsQuery(keyword), limit);
+    }
+
+    // 字母关键词同时按拼音和首字母搜索，与原文匹配合并
+    if (pinyinSearchEnabled_ && PinyinTokenizer::isPinyinQuery(keyword)) {
+        auto pinyinResults = searchIndex(reader->statement(kSearchPinyinSQL),
+                                         reader->statement(kSearchPinyinRecentSQL),
+                                         reader->statement(kCountPinyinSQL),
+                                         PinyinTokenizer::buildQuery(keyword), limit);
+        results = mergeByRecency(std::move(results), std::move(pinyinResults), limit);
+    }
+
+    // 如果 FTS 有结果，直接返回
+    // 纯中文关键词的所有匹配都在索引中，无需再扫描全表
+    if (!results.empty() || (stmtSearchFts && CjkTokenizer::isIndexedSubstring(keyword)) ||
+        cancelScope.cancelled()) {
+        return results;
     }
 
     // FTS 没有结果或不可用，降级到 LIKE 搜索
-    return searchTextFallback(keyword, limit);
+    return searchTextFallback(*reader, keyword, limit);
 }
 
-// 私有方法：LIKE 搜索降级
-std::vector<ClipboardRecord> ClipboardStore::searchTextFallback(const std::string& keyword, int limit) {
-    std::vector<ClipboardRecord> results;
-    
-    std::string likePattern = "%" + keyword + "%";
+std::optional<std::vector<PreviewRecord>> ClipboardStore::refineSearch(
+        const std::string& previousKeyword, const std::vector<PreviewRecord>& previousResults,
+        const std::string& keyword, const SearchCancelCheck& isCancelled) {
+    if (!initialized_ || previousKeyword.empty() || keyword.empty() ||
+        keyword.compare(0, previousKeyword.size(), previousKeyword) != 0) {
+        return std::nullopt;
+    }
+    if (keyword == previousKeyword) {
+        return previousResults;
+    }
+
+    // 拼音匹配：上一次也按拼音搜索，且继续输入没有改变之前的音节切分
+    bool pinyinQuery = pinyinSearchEnabled_ && PinyinTokenizer::isPinyinQuery(keyword);
+    if (pinyinQuery && (!PinyinTokenizer::isPinyinQuery(previousKeyword) ||
+                        !PinyinTokenizer::isQueryExtension(previousKeyword, keyword))) {
+        return std::nullopt;
+    }
 
-    // 优先使用预编译语句
-    if (stmtSearchLike_) {
-        sqlite3_reset(stmtSearchLike_);
-        sqlite3_bind_text(stmtSearchLike_, 1, likePattern.c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_int(stmtSearchLike_, 2, limit);
+    std::vector<PreviewRecord> results;
+    if (previousResults.empty()) {
+        return results;
+    }
 
-        while (sqlite3_step(stmtSearchLike_) == SQLITE_ROW) {
-            results.push_back(rowToRecord(stmtSearchLike_));
+    ReaderLease reader(*this);
+    if (!reader) {
+        return std::nullopt;
+    }
+    CancelScope cancelScope(reader->db, isCancelled);
+
+    sqlite3_stmt* stmtFtsIds = reader->statement(kMatchFtsIdsSQL);
+    if (!stmtFtsIds) {
+        return std::nullopt;
+    }
+
+    // 按索引取出新关键词匹配的 ID（匹配是上一次结果的子集，数量不超过上一次结果）
+    std::vector<int64_t> matchIds;
+    if (!collectMatchIds(stmtFtsIds, buildFtsQuery(keyword), matchIds)) {
+        return std::nullopt;
+    }
+    if (pinyinQuery && !collectMatchIds(reader->statement(kMatchPinyinIdsSQL),
+                                        PinyinTokenizer::buildQuery(keyword), matchIds)) {
+        return std::nullopt;
+    }
+
+    if (cancelScope.cancelled()) {
+        return std::nullopt;
+    }
+
+    if (!matchIds.empty()) {
+        std::sort(matchIds.begin(), matchIds.end());
+        for (const auto& record : previousResults) {
+            if (std::binary_search(matchIds.begin(), matchIds.end(), record.id)) {
+                results.push_back(record);
+            }
         }
+        // 索引有匹配时 searchText 直接返回索引结果
         return results;
     }
 
-    // 预编译语句不可用，使用临时语句
-    std::string sql = R"(
-        SELECT id, content_type, content, content_hash, source_app, 
-               thumbnail_path, image_format, image_width, image_height, 
-               file_size, created_at, last_used_at
-        FROM clipboard_history
-        WHERE content_type = 0 AND content LIKE ?
-        ORDER BY last_used_at DESC
-        LIMIT ?
-    )";
+    // 索引无匹配：纯中文关键词不退回 LIKE，结果为空
+    if (CjkTokenizer::isIndexedSubstring(keyword)) {
+        return results;
+    }
 
-    sqlite3_stmt* stmt = nullptr;
-    int rc = sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        std::cerr << "ClipboardStore: LIKE 搜索准备失败: " << sqlite3_errmsg(db_) << std::endl;
+    // searchText 会退回 LIKE 全表扫描。只有上一次结果同样来自 LIKE（上一次索引也无匹配）时，
+    // LIKE 的匹配才是上一次结果的子集，可以只检查上一次结果
+    std::vector<int64_t> previousMatchIds;
+    if (!collectMatchIds(stmtFtsIds, buildFtsQuery(previousKeyword), previousMatchIds)) {
+        return std::nullopt;
+    }
+    if (PinyinTokenizer::isPinyinQuery(previousKeyword) && pinyinSearchEnabled_ &&
+        !collectMatchIds(reader->statement(kMatchPinyinIdsSQL),
+                         PinyinTokenizer::buildQuery(previousKeyword), previousMatchIds)) {
+        return std::nullopt;
+    }
+    if (!previousMatchIds.empty()) {
+        return std::nullopt;
+    }
+
+    sqlite3_stmt* stmtLike = reader->statement(kMatchLikeByIdSQL);
+    if (!stmtLike) {
+        return std::nullopt;
+    }
+    std::string likePattern = "%" + keyword + "%";
+    for (const auto& record : previousResults) {
+        if (cancelScope.cancelled()) {
+            return std::nullopt;
+        }
+        sqlite3_reset(stmtLike);
+        sqlite3_bind_int64(stmtLike, 1, record.id);
+        sqlite3_bind_text(stmtLike, 2, likePattern.c_str(), -1, SQLITE_TRANSIENT);
+        int rc = sqlite3_step(stmtLike);
+        if (rc == SQLITE_ROW) {
+            results.push_back(record);
+        } else if (rc != SQLITE_DONE) {
+            return std::nullopt;
+        }
+    }
+    return results;
+}
+
+// 私有方法：取出 FTS 查询匹配的全部 ID（追加到 ids），查询出错或被中止时返回 false
+bool ClipboardStore::collectMatchIds(sqlite3_stmt* stmt, const std::string& query, std::vector<int64_t>& ids) {
+    if (!stmt) {
+        return false;
+    }
+
+    sqlite3_reset(stmt);
+    sqlite3_bind_text(stmt, 1, query.c_str(), -1, SQLITE_TRANSIENT);
+
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        ids.push_back(sqlite3_column_int64(stmt, 0));
+    }
+    return rc == SQLITE_DONE;
+}
+
+// 私有方法：按 FTS 查询搜索，匹配较少时取出全部匹配再排序，匹配很多时沿最后使用时间索引扫描
+std::vector<PreviewRecord> ClipboardStore::searchIndex(sqlite3_stmt* stmtJoin, sqlite3_stmt* stmtRecent,
+                                                       sqlite3_stmt* stmtCount, const std::string& query,
+                                                       int limit) {
+    std::vector<PreviewRecord> results;
+    if (!stmtJoin) {
         return results;
     }
 
-    sqlite3_bind_text(stmt, 1, likePattern.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_stmt* stmt = stmtJoin;
+    if (stmtCount && stmtRecent) {
+        sqlite3_reset(stmtCount);
+        sqlite3_bind_text(stmtCount, 1, query.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int(stmtCount, 2, kRecencyScanThreshold + 1);
+        if (sqlite3_step(stmtCount) == SQLITE_ROW &&
+            sqlite3_column_int(stmtCount, 0) > kRecencyScanThreshold) {
+            stmt = stmtRecent;
+        }
+    }
+
+    sqlite3_reset(stmt);
+    sqlite3_bind_text(stmt, 1, query.c_str(), -1, SQLITE_TRANSIENT);
     sqlite3_bind_int(stmt, 2, limit);
 
     while (sqlite3_step(stmt) == SQLITE_ROW) {
-        results.push_back(rowToRecord(stmt));
+        results.push_back(rowToPreview(stmt));
     }
+    return results;
+}
 
-    sqlite3_finalize(stmt);
+// 私有方法：合并两个按最后使用时间排序的结果，去除重复记录
+std::vector<PreviewRecord> ClipboardStore::mergeByRecency(std::vector<PreviewRecord> first,
+                                                          std::vector<PreviewRecord> second,
+                                                          int limit) {
+    if (second.empty()) {
+        return first;
+    }
+
+    std::vector<PreviewRecord> merged;
+    merged.reserve(std::min(first.size() + second.size(), static_cast<size_t>(std::max(limit, 0))));
+    size_t i = 0, j = 0;
+    while (static_cast<int>(merged.size()) < limit && (i < first.size() || j < second.size())) {
+        bool takeFirst = j >= second.size() ||
+                         (i < first.size() && first[i].lastUsedAt >= second[j].lastUsedAt);
+        PreviewRecord& next = takeFirst ? first[i++] : second[j++];
+        bool duplicate = std::any_of(merged.begin(), merged.end(), [&next](const PreviewRecord& r) {
+            return r.id == next.id;
+        });
+        if (!duplicate) {
+            merged.push_back(std::move(next));
+        }
+    }
+    return merged;
+}
+
+// 私有方法：LIKE 搜索降级
+std::vector<PreviewRecord> ClipboardStore::searchTextFallback(ReaderConnection& reader,
+                                                              const std::string& keyword, int limit) {
+    std::vector<PreviewRecord> results;
+
+    sqlite3_stmt* stmt = reader.statement(kSearchLikeSQL);
+    if (!stmt) {
+        return results;
+    }
+
+    std::string likePattern = "%" + keyword + "%";
+    sqlite3_reset(stmt);
+    sqlite3_bind_text(stmt, 1, likePattern.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(stmt, 2, limit);
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        results.push_back(rowToPreview(stmt));
+    }
     return results;
 }
 
 bool ClipboardStore::deleteRecord(int64_t id) {
+    std::lock_guard<std::recursive_mutex> lock(writeMutex_);
+
     if (!initialized_ || id <= 0) {
         return false;
     }
@@ -610,8 +1637,10 @@ bool ClipboardStore::deleteRecord(int64_t id) {
     return sqlite3_changes(db_) > 0;
 }
 
-std::vector<ClipboardRecord> ClipboardStore::deleteExpiredRecords(int maxAgeDays, int maxCount) {
-    std::vector<ClipboardRecord> deletedRecords;
+std::vector<DeletedRecord> ClipboardStore::deleteExpiredRecords(int maxAgeDays, int maxCount) {
+    std::lock_guard<std::recursive_mutex> lock(writeMutex_);
+
+    std::vector<DeletedRecord> deletedRecords;
     
     if (!initialized_) {
         return deletedRecords;
@@ -622,119 +1651,193 @@ std::vector<ClipboardRecord> ClipboardStore::deleteExpiredRecords(int maxAgeDays
         return deletedRecords;
     }
 
-    // 计算时间阈值（毫秒）
-    int64_t ageThreshold = 0;
+    // 删除同时满足以下条件的记录：
+    // 1. 超过时间限制（未设置时所有记录都满足）
+    // 2. 不在最近使用的 maxCount 条之内（未设置时所有记录都满足）
+    int64_t ageThreshold = INT64_MAX;
     if (maxAgeDays > 0) {
         int64_t now = getCurrentTimestampMs();
         ageThreshold = now - (static_cast<int64_t>(maxAgeDays) * 24 * 60 * 60 * 1000);
     }
-
-    // 构建查询条件
-    // 策略：删除同时满足以下条件的记录：
-    // 1. 超过时间限制（如果设置了）
-    // 2. 超过条数限制（如果设置了）
-    
-    std::string sql;
-    
-    if (maxAgeDays > 0 && maxCount > 0) {
-        // 两个条件都设置：删除超过时间限制 AND 超过条数限制的记录
-        // 先获取需要保留的记录 ID（最近的 maxCount 条）
-        sql = R"(
-            SELECT id, content_type, content, content_hash, source_app, 
-                   thumbnail_path, image_format, image_width, image_height, 
-                   file_size, created_at, last_used_at
-            FROM clipboard_history
-            WHERE created_at < ?
-              AND id NOT IN (
-                  SELECT id FROM clipboard_history 
-                  ORDER BY last_used_at DESC 
-                  LIMIT ?
-              )
-        )";
-    } else if (maxAgeDays > 0) {
-        // 只有时间限制
-        sql = R"(
-            SELECT id, content_type, content, content_hash, source_app, 
-                   thumbnail_path, image_format, image_width, image_height, 
-                   file_size, created_at, last_used_at
-            FROM clipboard_history
-            WHERE created_at < ?
-        )";
-    } else {
-        // 只有条数限制
-        sql = R"(
-            SELECT id, content_type, content, content_hash, source_app, 
-                   thumbnail_path, image_format, image_width, image_height, 
-                   file_size, created_at, last_used_at
-            FROM clipboard_history
-            WHERE id NOT IN (
-                SELECT id FROM clipboard_history 
-                ORDER BY last_used_at DESC 
-                LIMIT ?
-            )
-        )";
+    int keepCount = std::max(0, maxCount);
+
+    // 分批删除，直到某一批不满为止
+    while (true) {
+        sqlite3_reset(stmtDeleteExpired_);
+        sqlite3_bind_int64(stmtDeleteExpired_, 1, ageThreshold);
+        sqlite3_bind_int(stmtDeleteExpired_, 2, keepCount);
+        sqlite3_bind_int(stmtDeleteExpired_, 3, kExpiryBatchSize);
+
+        int batchCount = 0;
+        int rc;
+        while ((rc = sqlite3_step(stmtDeleteExpired_)) == SQLITE_ROW) {
+            DeletedRecord record;
+            record.id = sqlite3_column_int64(stmtDeleteExpired_, 0);
+            record.type = static_cast<ClipboardContentType>(sqlite3_column_int(stmtDeleteExpired_, 1));
+            const char* imagePath = reinterpret_cast<const char*>(sqlite3_column_text(stmtDeleteExpired_, 2));
+            record.imagePath = imagePath ? imagePath : "";
+            const char* thumbnailPath = reinterpret_cast<const char*>(sqlite3_column_text(stmtDeleteExpired_, 3));
+            record.thumbnailPath = thumbnailPath ? thumbnailPath : "";
+            const char* textChunks = reinterpret_cast<const char*>(sqlite3_column_text(stmtDeleteExpired_, 4));
+            record.textChunks = textChunks ? textChunks : "";
+            const char* contentHash = reinterpret_cast<const char*>(sqlite3_column_text(stmtDeleteExpired_, 5));
+            record.contentHash = contentHash ? contentHash : "";
+            deletedRecords.push_back(std::move(record));
+            ++batchCount;
+        }
+        if (rc != SQLITE_DONE) {
+            std::cerr << "ClipboardStore: 删除过期记录失败: " << sqlite3_errmsg(db_) << std::endl;
+            break;
+        }
+        if (batchCount < kExpiryBatchSize) {
+            break;
+        }
     }
+    sqlite3_reset(stmtDeleteExpired_);
 
-    sqlite3_stmt* stmt = nullptr;
-    int rc = sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        std::cerr << "ClipboardStore: 查询过期记录失败: " << sqlite3_errmsg(db_) << std::endl;
-        return deletedRecords;
-    }
+    return deletedRecords;
+}
 
-    if (maxAgeDays > 0 && maxCount > 0) {
-        sqlite3_bind_int64(stmt, 1, ageThreshold);
-        sqlite3_bind_int(stmt, 2, maxCount);
-    } else if (maxAgeDays > 0) {
-        sqlite3_bind_int64(stmt, 1, ageThreshold);
-    } else {
-        sqlite3_bind_int(stmt, 1, maxCount);
-    }
+std::vector<DeletedRecord> ClipboardStore::evictImagesOverQuota(int64_t maxBytes, int64_t keepId) {
+    std::lock_guard<std::recursive_mutex> lock(writeMutex_);
 
-    // 收集要删除的记录
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        deletedRecords.push_back(rowToRecord(stmt));
-    }
-    sqlite3_finalize(stmt);
+    std::vector<DeletedRecord> deletedRecords;
 
-    // 删除记录
-    if (!deletedRecords.empty()) {
-        char* errMsg = nullptr;
-        sqlite3_exec(db_, "BEGIN TRANSACTION;", nullptr, nullptr, &errMsg);
+    if (!initialized_ || maxBytes <= 0) {
+        return deletedRecords;
+    }
 
-        for (const auto& record : deletedRecords) {
-            deleteRecord(record.id);
+    // 每批重新读取计数器（触发器随删除更新），直到某一批不满为止
+    while (true) {
+        sqlite3_reset(stmtEvictImages_);
+        sqlite3_bind_int64(stmtEvictImages_, 1, maxBytes);
+        sqlite3_bind_int64(stmtEvictImages_, 2, keepId);
+        sqlite3_bind_int(stmtEvictImages_, 3, kEvictionBatchSize);
+
+        int batchCount = 0;
+        int rc;
+        while ((rc = sqlite3_step(stmtEvictImages_)) == SQLITE_ROW) {
+            DeletedRecord record;
+            record.id = sqlite3_column_int64(stmtEvictImages_, 0);
+            record.type = static_cast<ClipboardContentType>(sqlite3_column_int(stmtEvictImages_, 1));
+            const char* imagePath = reinterpret_cast<const char*>(sqlite3_column_text(stmtEvictImages_, 2));
+            record.imagePath = imagePath ? imagePath : "";
+            const char* thumbnailPath = reinterpret_cast<const char*>(sqlite3_column_text(stmtEvictImages_, 3));
+            record.thumbnailPath = thumbnailPath ? thumbnailPath : "";
+            const char* textChunks = reinterpret_cast<const char*>(sqlite3_column_text(stmtEvictImages_, 4));
+            record.textChunks = textChunks ? textChunks : "";
+            const char* contentHash = reinterpret_cast<const char*>(sqlite3_column_text(stmtEvictImages_, 5));
+            record.contentHash = contentHash ? contentHash : "";
+            deletedRecords.push_back(std::move(record));
+            ++batchCount;
+        }
+        if (rc != SQLITE_DONE) {
+            std::cerr << "ClipboardStore: 淘汰图片记录失败: " << sqlite3_errmsg(db_) << std::endl;
+            break;
+        }
+        if (batchCount < kEvictionBatchSize) {
+            break;
         }
-
-        sqlite3_exec(db_, "COMMIT;", nullptr, nullptr, &errMsg);
     }
+    sqlite3_reset(stmtEvictImages_);
 
     return deletedRecords;
 }
 
-std::vector<ClipboardRecord> ClipboardStore::clearAll() {
-    std::vector<ClipboardRecord> deletedRecords;
-    
+bool ClipboardStore::clearAll(std::vector<DeletedRecord>* fileRecords) {
+    std::lock_guard<std::recursive_mutex> lock(writeMutex_);
+
     if (!initialized_) {
-        return deletedRecords;
+        return false;
     }
 
-    // 先获取所有记录（用于返回，以便清理图片文件）
-    deletedRecords = getAllRecords(INT_MAX, 0);
-
-    // 清空表
     char* errMsg = nullptr;
-    int rc = sqlite3_exec(db_, "DELETE FROM clipboard_history;", nullptr, nullptr, &errMsg);
+    int rc = sqlite3_exec(db_, "BEGIN IMMEDIATE;", nullptr, nullptr, &errMsg);
     if (rc != SQLITE_OK) {
         std::cerr << "ClipboardStore: 清空记录失败: " << errMsg << std::endl;
         sqlite3_free(errMsg);
-        return {};
+        return false;
     }
 
-    // 清空 FTS 索引
-    sqlite3_exec(db_, "DELETE FROM clipboard_fts;", nullptr, nullptr, nullptr);
+    // 逐行读取关联文件的记录（不读取文本内容），只收集路径；
+    // 文件由调用方在提交成功后删除，回滚时记录和文件都保留
+    std::vector<DeletedRecord> records;
+    if (fileRecords) {
+        sqlite3_stmt* stmt = nullptr;
+        rc = sqlite3_prepare_v2(db_, R"(
+            SELECT id, content_type, CASE WHEN content_type = 1 THEN content END,
+                   thumbnail_path, text_chunks, content_hash
+            FROM clipboard_history WHERE content_type = 1 OR text_chunks != ''
+        )", -1, &stmt, nullptr);
+        if (rc == SQLITE_OK) {
+            while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+                DeletedRecord record;
+                record.id = sqlite3_column_int64(stmt, 0);
+                record.type = static_cast<ClipboardContentType>(sqlite3_column_int(stmt, 1));
+                const char* imagePath = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
+                record.imagePath = imagePath ? imagePath : "";
+                const char* thumbnailPath = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
+                record.thumbnailPath = thumbnailPath ? thumbnailPath : "";
+                const char* textChunks = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
+                record.textChunks = textChunks ? textChunks : "";
+                const char* contentHash = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 5));
+                record.contentHash = contentHash ? contentHash : "";
+                records.push_back(std::move(record));
+            }
+        }
+        sqlite3_finalize(stmt);
 
-    return deletedRecords;
+        // 读不全关联文件时不清空，否则未列出的文件再也无法清理
+        if (rc != SQLITE_DONE) {
+            std::cerr << "ClipboardStore: 读取关联文件的记录失败: " << sqlite3_errmsg(db_) << std::endl;
+            sqlite3_exec(db_, "ROLLBACK;", nullptr, nullptr, nullptr);
+            return false;
+        }
+    }
+
+    // 整表截断：先移除删除触发器，清空后再重建（均在同一事务中）
+    const char* truncateSQL = R"(
+        DROP TRIGGER IF EXISTS clipboard_ad;
+        DROP TRIGGER IF EXISTS clipboard_size_ad;
+        DELETE FROM clipboard_history;
+        INSERT INTO clipboard_fts(clipboard_fts) VALUES ('delete-all');
+        INSERT INTO clipboard_pinyin(clipboard_pinyin) VALUES ('delete-all');
+        UPDATE clipboard_meta SET value = 0 WHERE key = 'file_size_total';
+    )";
+    rc = sqlite3_exec(db_, truncateSQL, nullptr, nullptr, &errMsg);
+    if (rc == SQLITE_OK) {
+        std::string createTriggersSQL = std::string(kCreateDeleteTriggerSQL) + kCreateSizeDeleteTriggerSQL;
+        rc = sqlite3_exec(db_, createTriggersSQL.c_str(), nullptr, nullptr, &errMsg);
+    }
+    if (rc == SQLITE_OK) {
+        rc = sqlite3_exec(db_, "COMMIT;", nullptr, nullptr, &errMsg);
+    }
+    if (rc != SQLITE_OK) {
+        std::cerr << "ClipboardStore: 清空记录失败: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+        sqlite3_exec(db_, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return false;
+    }
+
+    if (fileRecords) {
+        *fileRecords = std::move(records);
+    }
+    return true;
+}
+
+bool ClipboardStore::isTextChunkReferenced(const std::string& chunkHash) {
+    if (!initialized_ || chunkHash.empty()) {
+        return false;
+    }
+
+    ReaderLease reader(*this);
+    sqlite3_stmt* stmt = reader ? reader->statement(kChunkReferencedSQL) : nullptr;
+    if (!stmt) {
+        return false;
+    }
+
+    sqlite3_bind_text(stmt, 1, chunkHash.c_str(), -1, SQLITE_TRANSIENT);
+    return sqlite3_step(stmt) == SQLITE_ROW;
 }
 
 int64_t ClipboardStore::getRecordCount() {
@@ -742,14 +1845,193 @@ int64_t ClipboardStore::getRecordCount() {
         return 0;
     }
 
-    sqlite3_reset(stmtCount_);
-    
-    int rc = sqlite3_step(stmtCount_);
+    ReaderLease reader(*this);
+    sqlite3_stmt* stmt = reader ? reader->statement(kCountSQL) : nullptr;
+    if (!stmt) {
+        return 0;
+    }
+
+    int rc = sqlite3_step(stmt);
     if (rc == SQLITE_ROW) {
-        return sqlite3_column_int64(stmtCount_, 0);
+        return sqlite3_column_int64(stmt, 0);
+    }
+
+    return 0;
+}
+
+// ========== 存储空间统计 ==========
+
+int64_t ClipboardStore::getTotalFileSize() {
+    if (!initialized_) {
+        return 0;
+    }
+
+    ReaderLease reader(*this);
+    sqlite3_stmt* stmt = reader ? reader->statement(kTotalFileSizeSQL) : nullptr;
+    if (!stmt) {
+        return 0;
+    }
+
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        return sqlite3_column_int64(stmt, 0);
+    }
+    return 0;
+}
+
+std::vector<ImageFileEntry> ClipboardStore::getImageFiles() {
+    if (!initialized_) {
+        return {};
+    }
+
+    ReaderLease reader(*this);
+    sqlite3_stmt* stmt = reader ? reader->statement(kImageFilesSQL) : nullptr;
+    return stmt ? readImageFiles(stmt) : std::vector<ImageFileEntry>();
+}
+
+std::optional<std::vector<ImageFileEntry>> ClipboardStore::getImageFilesAfterHash(
+    const std::string& afterHash, int limit) {
+    if (!initialized_ || limit <= 0) {
+        return std::nullopt;
+    }
+
+    ReaderLease reader(*this);
+    sqlite3_stmt* stmt = reader ? reader->statement(kImageFilesAfterHashSQL) : nullptr;
+    if (!stmt) {
+        return std::nullopt;
+    }
+
+    sqlite3_bind_text(stmt, 1, afterHash.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(stmt, 2, limit);
+    bool complete = false;
+    auto results = readImageFiles(stmt, &complete);
+    if (!complete) {
+        std::cerr << "ClipboardStore: 读取图片记录失败: " << sqlite3_errmsg(reader->db) << std::endl;
+        return std::nullopt;
+    }
+    return results;
+}
+
+bool ClipboardStore::updateFileSize(int64_t id, int64_t fileSize) {
+    std::lock_guard<std::recursive_mutex> lock(writeMutex_);
+
+    if (!initialized_ || id <= 0) {
+        return false;
+    }
+
+    sqlite3_stmt* stmt = nullptr;
+    int rc = sqlite3_prepare_v2(db_, "UPDATE clipboard_history SET file_size = ? WHERE id = ?;",
+                                -1, &stmt, nullptr);
+    if (rc == SQLITE_OK) {
+        sqlite3_bind_int64(stmt, 1, fileSize);
+        sqlite3_bind_int64(stmt, 2, id);
+        rc = sqlite3_step(stmt);
+    }
+    sqlite3_finalize(stmt);
+
+    if (rc != SQLITE_DONE) {
+        std::cerr << "ClipboardStore: 更新文件大小失败: " << sqlite3_errmsg(db_) << std::endl;
+        return false;
+    }
+    return sqlite3_changes(db_) > 0;
+}
+
+int64_t ClipboardStore::recalculateTotalFileSize() {
+    {
+        std::lock_guard<std::recursive_mutex> lock(writeMutex_);
+
+        if (!initialized_) {
+            return 0;
+        }
+
+        char* errMsg = nullptr;
+        int rc = sqlite3_exec(db_, kRecalculateFileSizeSQL, nullptr, nullptr, &errMsg);
+        if (rc != SQLITE_OK) {
+            std::cerr << "ClipboardStore: 重新计算存储空间失败: " << errMsg << std::endl;
+            sqlite3_free(errMsg);
+        }
+    }
+    return getTotalFileSize();
+}
+
+int64_t ClipboardStore::getLastReconcileTime() {
+    if (!initialized_) {
+        return 0;
     }
 
+    ReaderLease reader(*this);
+    sqlite3_stmt* stmt = reader ? reader->statement(kMetaIntegerSQL) : nullptr;
+    if (!stmt) {
+        return 0;
+    }
+
+    sqlite3_bind_text(stmt, 1, kLastReconcileKey, -1, SQLITE_STATIC);
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        return sqlite3_column_int64(stmt, 0);
+    }
     return 0;
 }
 
+bool ClipboardStore::setLastReconcileTime(int64_t timestampMs) {
+    std::lock_guard<std::recursive_mutex> lock(writeMutex_);
+
+    if (!initialized_) {
+        return false;
+    }
+
+    sqlite3_stmt* stmt = nullptr;
+    int rc = sqlite3_prepare_v2(db_, "INSERT OR REPLACE INTO clipboard_meta (key, value) VALUES (?, ?);",
+                                -1, &stmt, nullptr);
+    if (rc == SQLITE_OK) {
+        sqlite3_bind_text(stmt, 1, kLastReconcileKey, -1, SQLITE_STATIC);
+        sqlite3_bind_int64(stmt, 2, timestampMs);
+        rc = sqlite3_step(stmt);
+    }
+    sqlite3_finalize(stmt);
+
+    if (rc != SQLITE_DONE) {
+        std::cerr << "ClipboardStore: 记录校准时间失败: " << sqlite3_errmsg(db_) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// ========== 图片路径迁移 ==========
+
+std::vector<ImageFileEntry> ClipboardStore::getLegacyImageFiles() {
+    if (!initialized_) {
+        return {};
+    }
+
+    ReaderLease reader(*this);
+    sqlite3_stmt* stmt = reader ? reader->statement(kLegacyImageFilesSQL) : nullptr;
+    return stmt ? readImageFiles(stmt) : std::vector<ImageFileEntry>();
+}
+
+bool ClipboardStore::updateImagePaths(int64_t id, const std::string& imagePath,
+                                      const std::string& thumbnailPath) {
+    std::lock_guard<std::recursive_mutex> lock(writeMutex_);
+
+    if (!initialized_ || id <= 0) {
+        return false;
+    }
+
+    sqlite3_stmt* stmt = nullptr;
+    int rc = sqlite3_prepare_v2(db_,
+        "UPDATE clipboard_history SET content = ?, thumbnail_path = ? WHERE id = ? AND content_type = 1;",
+        -1, &stmt, nullptr);
+    if (rc == SQLITE_OK) {
+        sqlite3_bind_text(stmt, 1, imagePath.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 2, thumbnailPath.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int64(stmt, 3, id);
+        rc = sqlite3_step(stmt);
+    }
+    sqlite3_finalize(stmt);
+
+    if (rc != SQLITE_DONE) {
+        std::cerr << "ClipboardStore: 更新图片路径失败: " << sqlite3_errmsg(db_) << std::endl;
+        return false;
+    }
+    return sqlite3_changes(db_) > 0;
+}
+
 } // namespace suyan
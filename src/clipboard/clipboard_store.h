@@ -2,19 +2,32 @@
  * ClipboardStore - 剪贴板存储层
  *
  * 使用 SQLite 存储剪贴板历史记录的元数据。
- * 支持文本内容直接存储，图片内容存储路径引用。
+ * 支持文本内容直接存储，图片内容存储路径引用，
+ * 大文本存储预览和分块清单（分块文件由 TextStorage 管理）。
  * 提供 FTS5 全文搜索支持。
  *
  * 功能：
  * - 剪贴板记录的 CRUD 操作
- * - 基于 SHA-256 哈希的内容去重
- * - FTS5 全文搜索（仅文本）
+ * - 基于内容指纹的去重
+ * - FTS5 全文搜索（仅文本，中文按二元组索引，支持子串搜索）
+ * - 拼音和首字母搜索（入库时由触发器按读音建立拼音索引）
+ * - 列表和搜索只返回预览，完整内容在粘贴时按 ID 读取
  * - 过期记录清理
+ * - 存储空间统计（触发器累计 file_size 总量，查询为 O(1)）
+ *
+ * 线程安全：写操作串行使用唯一的写连接（主要来自后台入库线程）；
+ * 读操作（列表、搜索、按 ID 读取）从只读连接池借用 WAL 只读连接，
+ * 各连接有自己的预编译语句缓存，读取不等待正在进行的写事务，边输入边搜索不会被入库阻塞。
  */
 
 #ifndef SUYAN_CLIPBOARD_CLIPBOARD_STORE_H
 #define SUYAN_CLIPBOARD_CLIPBOARD_STORE_H
 
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <optional>
@@ -42,17 +55,86 @@ struct ClipboardRecord {
     int64_t id = 0;                     // 数据库 ID
     ClipboardContentType type = ClipboardContentType::Unknown;  // 内容类型
     std::string content;                // 文本内容或图片路径
-    std::string contentHash;            // SHA-256 哈希
+    std::string contentHash;            // 内容指纹（去重键）
+    std::string sourceApp;              // 来源应用 Bundle ID
+    std::string thumbnailPath;          // 缩略图路径（图片类型）
+    std::string imageFormat;            // 图片格式（图片类型）
+    int imageWidth = 0;                 // 图片宽度
+    int imageHeight = 0;                // 图片高度
+    int64_t fileSize = 0;               // 占用的存储空间（字节，图片含缩略图，大文本为压缩后的分块）
+    int64_t createdAt = 0;              // 创建时间戳（Unix 毫秒）
+    int64_t lastUsedAt = 0;             // 最后使用时间戳（Unix 毫秒）
+    int64_t contentLength = 0;          // 文本内容字节数（大文本为原文大小，普通文本由 content 得出）
+    std::string textChunks;             // 大文本的分块清单（为空表示 content 即完整内容）
+};
+
+/**
+ * 列表预览记录
+ *
+ * 列表和搜索结果只包含预览文本，不含完整内容（文本最长 64KB），
+ * 完整内容在粘贴时通过 getRecord() 读取。
+ */
+struct PreviewRecord {
+    int64_t id = 0;                     // 数据库 ID
+    ClipboardContentType type = ClipboardContentType::Unknown;  // 内容类型
+    std::string preview;                // 文本预览（空白折叠为单行，超长截断，图片为空）
+    int64_t contentLength = 0;          // 文本内容字节数（图片为 0）
     std::string sourceApp;              // 来源应用 Bundle ID
     std::string thumbnailPath;          // 缩略图路径（图片类型）
     std::string imageFormat;            // 图片格式（图片类型）
     int imageWidth = 0;                 // 图片宽度
     int imageHeight = 0;                // 图片高度
-    int64_t fileSize = 0;               // 文件大小（字节）
+    int64_t fileSize = 0;               // 占用的存储空间（字节）
     int64_t createdAt = 0;              // 创建时间戳（Unix 毫秒）
     int64_t lastUsedAt = 0;             // 最后使用时间戳（Unix 毫秒）
 };
 
+/**
+ * 分页游标
+ *
+ * 记录按最后使用时间降序排列（同一时间按 id 升序），
+ * 游标为上一页最后一条记录的 (lastUsedAt, id)。默认值表示从第一页开始。
+ */
+struct RecordCursor {
+    int64_t lastUsedAt = INT64_MAX;     // 上一页最后一条的最后使用时间
+    int64_t id = 0;                     // 上一页最后一条的 ID
+
+    RecordCursor() = default;
+    explicit RecordCursor(const PreviewRecord& last)
+        : lastUsedAt(last.lastUsedAt), id(last.id) {}
+};
+
+/**
+ * 搜索取消检查
+ *
+ * 查询执行期间定期调用（在执行查询的线程），返回 true 时中止查询，
+ * 此时返回的结果不完整，调用方应丢弃。
+ */
+using SearchCancelCheck = std::function<bool()>;
+
+/**
+ * 被删除的记录（只含清理关联文件所需的字段）
+ */
+struct DeletedRecord {
+    int64_t id = 0;                     // 数据库 ID
+    ClipboardContentType type = ClipboardContentType::Unknown;  // 内容类型
+    std::string imagePath;              // 图片路径（文本记录为空）
+    std::string thumbnailPath;          // 缩略图路径
+    std::string textChunks;             // 大文本的分块清单
+    std::string contentHash;            // 内容哈希（同一内容重新入库时文件路径相同）
+};
+
+/**
+ * 图片记录的文件（校准存储空间统计、迁移存储目录、回收孤儿文件用）
+ */
+struct ImageFileEntry {
+    int64_t id = 0;                     // 数据库 ID
+    std::string imagePath;              // 图片路径
+    std::string thumbnailPath;          // 缩略图路径
+    int64_t fileSize = 0;               // 记录的占用空间（字节）
+    std::string contentHash;            // 内容哈希（文件名，只有 getImageFilesAfterHash 填写）
+};
+
 /**
  * 添加记录的结果
  */
@@ -73,6 +155,28 @@ public:
      */
     static ClipboardStore& instance();
 
+    /**
+     * 预览文本的最大字符数
+     */
+    static constexpr size_t kPreviewLength = 100;
+
+    /**
+     * 默认只读连接数（UI 搜索与列表刷新可以同时进行）
+     */
+    static constexpr int kDefaultReaderCount = 2;
+
+    /**
+     * 生成文本预览
+     *
+     * 连续空白（含换行）折叠为一个空格并去掉首尾空白，
+     * 保留前 kPreviewLength 个字符，超出时以 "..." 结尾。
+     * 只扫描文本开头，耗时与文本长度无关。
+     *
+     * @param text UTF-8 文本
+     * @return 预览文本
+     */
+    static std::string makePreview(const std::string& text);
+
     // 禁止拷贝和移动
     ClipboardStore(const ClipboardStore&) = delete;
     ClipboardStore& operator=(const ClipboardStore&) = delete;
@@ -82,13 +186,18 @@ public:
     /**
      * 初始化数据库
      *
+     * 打开写连接并建表，然后打开 readerCount 个只读连接供查询使用。
+     *
      * @param dbPath 数据库文件路径
+     * @param readerCount 只读连接数（至少 1 个）
      * @return 是否成功
      */
-    bool initialize(const std::string& dbPath);
+    bool initialize(const std::string& dbPath, int readerCount = kDefaultReaderCount);
 
     /**
      * 关闭数据库
+     *
+     * 等待正在进行的查询归还只读连接后关闭所有连接。
      */
     void shutdown();
 
@@ -117,13 +226,13 @@ public:
     /**
      * 根据哈希查找记录
      *
-     * @param hash SHA-256 哈希值
+     * @param hash 内容指纹
      * @return 记录，不存在返回空 optional
      */
     std::optional<ClipboardRecord> findByHash(const std::string& hash);
 
     /**
-     * 根据 ID 获取记录
+     * 根据 ID 获取记录（含完整内容，用于粘贴）
      *
      * @param id 记录 ID
      * @return 记录，不存在返回空 optional
@@ -143,18 +252,58 @@ public:
      *
      * @param limit 最大返回数量
      * @param offset 偏移量（用于分页）
-     * @return 记录列表
+     * @return 预览记录列表
+     */
+    std::vector<PreviewRecord> getAllRecords(int limit = 100, int offset = 0);
+
+    /**
+     * 按游标获取下一页记录（按最后使用时间降序）
+     *
+     * 使用 (last_used_at, id) 键集分页，沿最后使用时间索引从游标处直接定位，
+     * 每页的耗时与页码无关（OFFSET 分页需要跳过之前的所有记录）。
+     *
+     * @param cursor 上一页最后一条记录的游标（默认从第一页开始）
+     * @param limit 最大返回数量
+     * @return 预览记录列表
      */
-    std::vector<ClipboardRecord> getAllRecords(int limit = 100, int offset = 0);
+    std::vector<PreviewRecord> getRecordsAfter(const RecordCursor& cursor, int limit = 100);
 
     /**
      * 搜索文本记录（使用 FTS5）
      *
+     * 中文关键词完全由索引匹配；含英文、数字的关键词在索引无结果时
+     * 退回 LIKE 子串匹配（以找到词中间的子串）。
+     * 只含字母的关键词同时按拼音索引匹配全拼和首字母（如 "huiyi"、"hyjy" 找到「会议纪要」），
+     * 结果与原文匹配按最后使用时间合并。拼音索引需要在初始化前加载 PinyinTable。
+     *
      * @param keyword 搜索关键词
      * @param limit 最大返回数量
-     * @return 匹配的记录列表
+     * @param isCancelled 取消检查（可选，返回 true 时中止查询，结果不完整）
+     * @return 匹配的预览记录列表
      */
-    std::vector<ClipboardRecord> searchText(const std::string& keyword, int limit = 100);
+    std::vector<PreviewRecord> searchText(const std::string& keyword, int limit = 100,
+                                          const SearchCancelCheck& isCancelled = {});
+
+    /**
+     * 在上一次搜索的结果中细化搜索
+     *
+     * 关键词在上一次关键词之后继续输入时（如 "meet" → "meeting"），匹配结果是上一次结果的子集：
+     * 只按索引取出新关键词匹配的 ID 与上一次结果求交，不重新读取记录、不扫描全表，
+     * 结果顺序与上一次相同。结果与 searchText(keyword) 一致，无法保证一致时返回 nullopt：
+     * - 关键词不是上一次关键词的延续
+     * - 拼音音节切分随输入改变（如 "fang" → "fange" 切分为 fan / ge）
+     * - 索引无匹配、需要退回 LIKE 全表扫描，而上一次结果来自索引
+     *
+     * @param previousKeyword 上一次搜索的关键词
+     * @param previousResults 上一次搜索的完整结果（须少于当时的 limit，即包含全部匹配）
+     * @param keyword 新关键词
+     * @param isCancelled 取消检查（可选）
+     * @return 细化后的结果；无法细化或查询失败、被取消时返回 nullopt
+     */
+    std::optional<std::vector<PreviewRecord>> refineSearch(const std::string& previousKeyword,
+                                                           const std::vector<PreviewRecord>& previousResults,
+                                                           const std::string& keyword,
+                                                           const SearchCancelCheck& isCancelled = {});
 
     /**
      * 删除记录
@@ -168,26 +317,136 @@ public:
      * 删除过期记录
      *
      * 根据时长限制和条数限制删除记录（取交集）。
+     * 按最后使用时间排名后直接 DELETE ... RETURNING，分批执行，
+     * 每批一个短事务，不读取文本内容。
      *
      * @param maxAgeDays 最大保留天数（0 表示不限制）
      * @param maxCount 最大保留条数（0 表示不限制）
-     * @return 被删除的记录列表（用于清理关联的图片文件）
+     * @return 被删除的记录（用于清理关联的图片文件）
+     */
+    std::vector<DeletedRecord> deleteExpiredRecords(int maxAgeDays, int maxCount);
+
+    /**
+     * 按存储空间上限淘汰图片记录
+     *
+     * 图片的 file_size 总量超过上限时，从最久未使用的图片记录开始删除，
+     * 直到图片总量回到上限以内。分批 DELETE ... RETURNING，每批一个短事务。
+     * 只淘汰图片，也只按图片的总量比较上限；大文本由条数和时长限制清理。
+     *
+     * @param maxBytes 存储空间上限（字节，<= 0 表示不限制）
+     * @param keepId 不淘汰的记录 ID（如刚写入的记录，0 表示无）
+     * @return 被删除的记录（用于清理图片文件）
      */
-    std::vector<ClipboardRecord> deleteExpiredRecords(int maxAgeDays, int maxCount);
+    std::vector<DeletedRecord> evictImagesOverQuota(int64_t maxBytes, int64_t keepId = 0);
 
     /**
      * 清空所有记录
      *
-     * @return 被删除的记录列表（用于清理关联的图片文件）
+     * 在同一事务中收集关联文件的记录（图片、大文本，只读取路径），然后清空主表和 FTS 索引。
+     * 只在提交成功后返回收集的记录，由调用方删除文件；失败时回滚，记录和文件都保留。
+     *
+     * @param fileRecords 输出关联文件的记录（为空时不收集）
+     * @return 是否成功
      */
-    std::vector<ClipboardRecord> clearAll();
+    bool clearAll(std::vector<DeletedRecord>* fileRecords = nullptr);
+
+    /**
+     * 检查大文本分块是否仍被记录引用
+     *
+     * 分块按内容寻址，可能被多条记录共享，删除记录后只清理不再引用的分块。
+     *
+     * @param chunkHash 块哈希
+     * @return 是否被引用
+     */
+    bool isTextChunkReferenced(const std::string& chunkHash);
 
     /**
      * 获取记录总数
      */
     int64_t getRecordCount();
 
+    // ========== 存储空间统计 ==========
+
+    /**
+     * 获取所有记录的 file_size 总量（字节）
+     *
+     * 总量由触发器随记录增删累计并持久化，读取一行即可，不扫描表或目录，
+     * 可以在每次入库时用于检查存储配额。
+     */
+    int64_t getTotalFileSize();
+
+    /**
+     * 获取所有图片记录的文件路径和记录的占用空间（校准用）
+     */
+    std::vector<ImageFileEntry> getImageFiles();
+
+    /**
+     * 按内容哈希顺序分页获取图片记录（回收孤儿文件用）
+     *
+     * 图片文件以内容哈希命名，沿哈希索引读取的顺序与分片目录的遍历顺序一致，
+     * 可以和目录中的文件逐一归并。
+     *
+     * @param afterHash 上一页最后一条记录的哈希（第一页为空）
+     * @param limit 每页条数
+     * @return 哈希大于 afterHash 的图片记录，按哈希升序；查询失败返回 std::nullopt
+     *         （调用方据此删除文件，不能把失败当作没有记录）
+     */
+    std::optional<std::vector<ImageFileEntry>> getImageFilesAfterHash(const std::string& afterHash, int limit);
+
+    // ========== 图片路径迁移 ==========
+
+    /**
+     * 获取仍使用绝对路径的图片记录（旧版本平铺目录，需要迁移到分片目录）
+     */
+    std::vector<ImageFileEntry> getLegacyImageFiles();
+
+    /**
+     * 更新图片记录的文件路径
+     *
+     * @param id 记录 ID
+     * @param imagePath 原图路径
+     * @param thumbnailPath 缩略图路径
+     * @return 是否更新了记录（记录已删除时返回 false）
+     */
+    bool updateImagePaths(int64_t id, const std::string& imagePath, const std::string& thumbnailPath);
+
+    /**
+     * 更新记录的占用空间（总量由触发器同步调整）
+     *
+     * @param id 记录 ID
+     * @param fileSize 占用空间（字节）
+     * @return 是否更新了记录
+     */
+    bool updateFileSize(int64_t id, int64_t fileSize);
+
+    /**
+     * 按所有记录重新累计 file_size 总量（校准，需要扫描全表）
+     *
+     * @return 重新计算后的总量
+     */
+    int64_t recalculateTotalFileSize();
+
+    /**
+     * 获取上次校准存储空间的时间
+     *
+     * 保存在数据库中（墙上时间），重启后仍按上次校准的时间判断是否到期。
+     *
+     * @return Unix 毫秒时间戳，从未校准返回 0
+     */
+    int64_t getLastReconcileTime();
+
+    /**
+     * 记录校准存储空间的时间
+     *
+     * @param timestampMs Unix 毫秒时间戳
+     * @return 是否成功
+     */
+    bool setLastReconcileTime(int64_t timestampMs);
+
 private:
+    struct ReaderConnection;    // 只读连接及其预编译语句缓存
+    class ReaderLease;          // 借出的只读连接（析构时归还）
+
     ClipboardStore() = default;
     ~ClipboardStore();
 
@@ -195,30 +454,50 @@ private:
     bool openDatabase();
     void closeDatabase();
     bool createTables();
+    bool migrateSchema();
+    bool syncPinyinIndex();
     bool prepareStatements();
     void finalizeStatements();
 
+    // 只读连接池
+    bool openReaders(int count);
+    void closeReaders();
+    ReaderConnection* acquireReader();
+    void releaseReader(ReaderConnection* reader);
+
     // 内部辅助
     ClipboardRecord rowToRecord(sqlite3_stmt* stmt) const;
+    PreviewRecord rowToPreview(sqlite3_stmt* stmt) const;
     int64_t getCurrentTimestampMs() const;
-    std::vector<ClipboardRecord> searchTextFallback(const std::string& keyword, int limit);
+    std::vector<PreviewRecord> searchTextFallback(ReaderConnection& reader,
+                                                  const std::string& keyword, int limit);
+    static bool collectMatchIds(sqlite3_stmt* stmt, const std::string& query, std::vector<int64_t>& ids);
+    std::vector<PreviewRecord> searchIndex(sqlite3_stmt* stmtJoin, sqlite3_stmt* stmtRecent,
+                                           sqlite3_stmt* stmtCount, const std::string& query, int limit);
+    static std::vector<PreviewRecord> mergeByRecency(std::vector<PreviewRecord> first,
+                                                     std::vector<PreviewRecord> second, int limit);
 
     // 成员变量
-    bool initialized_ = false;
+    std::atomic<bool> initialized_{false};
     std::string dbPath_;
-    sqlite3* db_ = nullptr;
+    sqlite3* db_ = nullptr;                     // 写连接
+    std::recursive_mutex writeMutex_;           // 串行化写连接和写语句（初始化和关闭也持有）
+    bool pinyinSearchEnabled_ = false;          // 拼音索引与读音表一致且读音表已加载
+
+    // 只读连接池
+    std::mutex readersMutex_;                   // 保护空闲连接列表
+    std::condition_variable readersAvailable_;  // 有连接归还或连接池关闭
+    std::vector<std::unique_ptr<ReaderConnection>> readers_;
+    std::vector<ReaderConnection*> idleReaders_;
+    bool readersOpen_ = false;
 
-    // 预编译语句
+    // 写连接的预编译语句（查询语句缓存在各只读连接中）
     sqlite3_stmt* stmtInsert_ = nullptr;
-    sqlite3_stmt* stmtFindByHash_ = nullptr;
-    sqlite3_stmt* stmtGetById_ = nullptr;
     sqlite3_stmt* stmtUpdateLastUsed_ = nullptr;
-    sqlite3_stmt* stmtGetAll_ = nullptr;
     sqlite3_stmt* stmtDelete_ = nullptr;
-    sqlite3_stmt* stmtCount_ = nullptr;
-    sqlite3_stmt* stmtUpdateTimestamp_ = nullptr;
-    sqlite3_stmt* stmtSearchFts_ = nullptr;      // FTS 搜索预编译语句
-    sqlite3_stmt* stmtSearchLike_ = nullptr;     // LIKE 搜索预编译语句（降级方案）
+    sqlite3_stmt* stmtUpdateTimestamp_ = nullptr;   // 已存在时更新时间戳并返回 ID
+    sqlite3_stmt* stmtDeleteExpired_ = nullptr;  // 分批删除过期记录
+    sqlite3_stmt* stmtEvictImages_ = nullptr;    // 分批淘汰超出存储空间上限的图片
 };
 
 } // namespace suyan
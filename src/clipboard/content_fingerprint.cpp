@@ -0,0 +1,244 @@
+/**
+ * ContentFingerprint 实现
+ *
+ * 快速哈希采用 xxh3 的结构：8 路 64 位累加器，每 64 字节一个条带，
+ * 每路做 32x32 位乘法并交叉累加原始数据（编译器可自动向量化）；
+ * 每 1KB 扰动一次累加器，最后用 128 位乘法合并各路并加入长度。
+ */
+
+#include "content_fingerprint.h"
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <cstring>
+
+namespace suyan {
+
+namespace {
+
+// 每个条带的字节数和累加器路数
+constexpr size_t kStripeSize = 64;
+constexpr size_t kLanes = kStripeSize / sizeof(uint64_t);
+
+// 每隔多少个条带扰动一次累加器
+constexpr size_t kStripesPerBlock = 16;
+
+// 预筛键的采样窗口数（不含开头和结尾）
+constexpr size_t kSampleWindows = 8;
+
+constexpr uint64_t kPrime32_1 = 0x9E3779B1U;
+constexpr uint64_t kPrime64_1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t kPrime64_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t kPrime64_3 = 0x165667B19E3779F9ULL;
+
+// 密钥：每个条带与其异或，合并时错位使用
+constexpr uint64_t kSecret[16] = {
+    0xbe4ba423396cfeb8ULL, 0x1cad21f72c81017cULL, 0xdb979083e96dd4deULL, 0x1f67b3b7a4a44072ULL,
+    0x78e5c0cc4ee679cbULL, 0x2172ffcc7dd05a82ULL, 0x8e2443f7744608b8ULL, 0x4c263a81e69035e0ULL,
+    0xcb00c391bb52283cULL, 0xa32e531b8b65d088ULL, 0x4ef90da297486471ULL, 0xd8acdea946ef1938ULL,
+    0x3f349ce33f76faa8ULL, 0x1d4f0bc7c7bbdcf9ULL, 0x3159b4cd4be0518aULL, 0x647378d9c97e9fc8ULL,
+};
+
+inline uint64_t read64(const uint8_t* p) {
+    uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+/**
+ * 64x64 位乘法，返回 128 位结果高低两半的异或
+ */
+inline uint64_t foldedMultiply(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+    return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#else
+    uint64_t aLow = a & 0xFFFFFFFFULL, aHigh = a >> 32;
+    uint64_t bLow = b & 0xFFFFFFFFULL, bHigh = b >> 32;
+    uint64_t lowLow = aLow * bLow;
+    uint64_t highLow = aHigh * bLow;
+    uint64_t lowHigh = aLow * bHigh;
+    uint64_t highHigh = aHigh * bHigh;
+    uint64_t cross = (lowLow >> 32) + (highLow & 0xFFFFFFFFULL) + lowHigh;
+    uint64_t high = highHigh + (highLow >> 32) + (cross >> 32);
+    uint64_t low = (cross << 32) | (lowLow & 0xFFFFFFFFULL);
+    return low ^ high;
+#endif
+}
+
+inline uint64_t avalanche(uint64_t h) {
+    h ^= h >> 37;
+    h *= kPrime64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+/**
+ * 累加一个条带
+ */
+inline void accumulateStripe(uint64_t* acc, const uint8_t* stripe, const uint64_t* secret) {
+    for (size_t i = 0; i < kLanes; ++i) {
+        uint64_t data = read64(stripe + i * sizeof(uint64_t));
+        uint64_t keyed = data ^ secret[i];
+        acc[i ^ 1] += data;
+        acc[i] += (keyed & 0xFFFFFFFFULL) * (keyed >> 32);
+    }
+}
+
+/**
+ * 扰动累加器，避免长输入中高位信息丢失
+ */
+inline void scramble(uint64_t* acc, const uint64_t* secret) {
+    for (size_t i = 0; i < kLanes; ++i) {
+        uint64_t a = acc[i];
+        a ^= a >> 47;
+        a ^= secret[i];
+        acc[i] = a * kPrime32_1;
+    }
+}
+
+inline uint64_t mergeAccumulators(const uint64_t* acc, const uint64_t* secret, uint64_t start) {
+    uint64_t result = start;
+    for (size_t i = 0; i < kLanes; i += 2) {
+        result += foldedMultiply(acc[i] ^ secret[i], acc[i + 1] ^ secret[i + 1]);
+    }
+    return avalanche(result);
+}
+
+const uint8_t* contentData(const ClipboardContent& content, size_t& size) {
+    if (content.isText()) {
+        size = content.textData.size();
+        return reinterpret_cast<const uint8_t*>(content.textData.data());
+    }
+    if (content.isImage()) {
+        size = content.imageData.size();
+        return content.imageData.data();
+    }
+    size = 0;
+    return nullptr;
+}
+
+} // anonymous namespace
+
+// ========== Hash128 ==========
+
+std::string Hash128::toHex() const {
+    static const char* kDigits = "0123456789abcdef";
+    std::string hex(32, '0');
+    for (int i = 0; i < 16; ++i) {
+        hex[15 - i] = kDigits[(high >> (i * 4)) & 0xF];
+        hex[31 - i] = kDigits[(low >> (i * 4)) & 0xF];
+    }
+    return hex;
+}
+
+// ========== 指纹算法 ==========
+
+std::string FastFingerprinter::fingerprint(const uint8_t* data, size_t size) const {
+    return ContentFingerprint::hash128(data, size).toHex();
+}
+
+std::string Sha256Fingerprinter::fingerprint(const uint8_t* data, size_t size) const {
+    QByteArray bytes = QByteArray::fromRawData(reinterpret_cast<const char*>(data),
+                                               static_cast<qsizetype>(size));
+    return QCryptographicHash::hash(bytes, QCryptographicHash::Sha256).toHex().toStdString();
+}
+
+// ========== ContentFingerprint ==========
+
+uint64_t ContentFingerprint::quickKey(const uint8_t* data, size_t size) {
+    uint64_t key = avalanche(size * kPrime64_1);
+    if (size == 0) {
+        return key;
+    }
+
+    if (size < 2 * sizeof(uint64_t) * (kSampleWindows + 2)) {
+        // 小数据直接完整哈希
+        Hash128 hash = hash128(data, size);
+        return key ^ hash.low;
+    }
+
+    // 开头、结尾和均匀分布的窗口各取 8 字节
+    size_t step = (size - sizeof(uint64_t)) / (kSampleWindows + 1);
+    key = foldedMultiply(key ^ read64(data), kPrime64_2);
+    for (size_t i = 1; i <= kSampleWindows; ++i) {
+        key = foldedMultiply(key ^ read64(data + i * step), kSecret[i]);
+    }
+    key = foldedMultiply(key ^ read64(data + size - sizeof(uint64_t)), kPrime64_2);
+    return avalanche(key);
+}
+
+Hash128 ContentFingerprint::hash128(const uint8_t* data, size_t size, uint64_t seed) {
+    uint64_t acc[kLanes] = {
+        kPrime32_1, kPrime64_1 ^ seed, kPrime64_2, kPrime64_3 ^ seed,
+        kPrime64_1, kPrime64_2 ^ seed, kPrime64_3, kPrime32_1 ^ seed,
+    };
+
+    // 完整的块：每块 16 个条带，条带错位使用密钥
+    const size_t blockSize = kStripeSize * kStripesPerBlock;
+    size_t offset = 0;
+    for (; offset + blockSize <= size; offset += blockSize) {
+        for (size_t s = 0; s < kStripesPerBlock; ++s) {
+            accumulateStripe(acc, data + offset + s * kStripeSize, kSecret + (s & 7));
+        }
+        scramble(acc, kSecret + 8);
+    }
+
+    // 剩余的完整条带
+    size_t stripe = 0;
+    for (; offset + kStripeSize <= size; offset += kStripeSize, ++stripe) {
+        accumulateStripe(acc, data + offset, kSecret + (stripe & 7));
+    }
+
+    // 末尾不足一个条带：补零后累加（长度参与合并，补零不会造成碰撞）
+    if (offset < size) {
+        uint8_t tail[kStripeSize] = {};
+        std::memcpy(tail, data + offset, size - offset);
+        accumulateStripe(acc, tail, kSecret + 3);
+    }
+
+    Hash128 result;
+    result.low = mergeAccumulators(acc, kSecret, size * kPrime64_1 ^ seed);
+    result.high = mergeAccumulators(acc, kSecret + 6, ~(size * kPrime64_2) ^ seed);
+    return result;
+}
+
+const IContentFingerprinter& ContentFingerprint::defaultFingerprinter() {
+    static const FastFingerprinter fingerprinter;
+    return fingerprinter;
+}
+
+void ContentFingerprint::prepare(ClipboardContent& content) {
+    size_t size = 0;
+    const uint8_t* data = contentData(content, size);
+    content.quickKey = quickKey(data, size);
+    content.contentHash.clear();
+}
+
+void ContentFingerprint::ensureHash(ClipboardContent& content,
+                                    const IContentFingerprinter& fingerprinter) {
+    if (!content.contentHash.empty()) {
+        return;
+    }
+    size_t size = 0;
+    const uint8_t* data = contentData(content, size);
+    content.contentHash = fingerprinter.fingerprint(data, size);
+}
+
+bool ContentFingerprint::isSameContent(ClipboardContent& a, ClipboardContent& b,
+                                       const IContentFingerprinter& fingerprinter) {
+    if (a.type != b.type) {
+        return false;
+    }
+    // 两边都已有完整指纹时直接比较
+    if (!a.contentHash.empty() && !b.contentHash.empty()) {
+        return a.contentHash == b.contentHash;
+    }
+    if (a.quickKey != b.quickKey) {
+        return false;
+    }
+    ensureHash(a, fingerprinter);
+    ensureHash(b, fingerprinter);
+    return a.contentHash == b.contentHash;
+}
+
+} // namespace suyan
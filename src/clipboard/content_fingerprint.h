@@ -0,0 +1,149 @@
+/**
+ * ContentFingerprint - 剪贴板内容指纹
+ *
+ * 剪贴板去重只需要区分内容，不需要抗碰撞攻击：对 30MB 的 TIFF 做 SHA-256
+ * 要几十毫秒，而且原先在主线程的轮询回调里执行。
+ *
+ * 指纹分两层：
+ * - 预筛键（quickKey）：长度 + 固定位置的采样字节，O(1)，监听器在主线程计算。
+ *   预筛键不同则内容一定不同；相同时才需要完整指纹确认。
+ * - 完整指纹（contentHash）：128 位快速哈希（xxh3 同类的乘加累加结构），
+ *   在入库线程按需计算，也可以换成 SHA-256 等其他实现（IContentFingerprinter）。
+ *
+ * 所有 IClipboardMonitor 实现读取内容后调用 ContentFingerprint::prepare() 即可。
+ */
+
+#ifndef SUYAN_CLIPBOARD_CONTENT_FINGERPRINT_H
+#define SUYAN_CLIPBOARD_CONTENT_FINGERPRINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "clipboard_monitor.h"
+
+namespace suyan {
+
+/**
+ * 128 位哈希值
+ */
+struct Hash128 {
+    uint64_t high = 0;
+    uint64_t low = 0;
+
+    bool operator==(const Hash128& other) const {
+        return high == other.high && low == other.low;
+    }
+    bool operator!=(const Hash128& other) const { return !(*this == other); }
+
+    /**
+     * 转为 32 位十六进制字符串
+     */
+    std::string toHex() const;
+};
+
+/**
+ * IContentFingerprinter - 完整指纹算法接口
+ */
+class IContentFingerprinter {
+public:
+    virtual ~IContentFingerprinter() = default;
+
+    /**
+     * 算法名称（用于日志和基准测试）
+     */
+    virtual const char* name() const = 0;
+
+    /**
+     * 计算指纹
+     *
+     * @param data 数据
+     * @param size 字节数
+     * @return 指纹（十六进制字符串，用作去重键和图片文件名）
+     */
+    virtual std::string fingerprint(const uint8_t* data, size_t size) const = 0;
+};
+
+/**
+ * 128 位快速哈希指纹（默认）
+ */
+class FastFingerprinter final : public IContentFingerprinter {
+public:
+    const char* name() const override { return "hash128"; }
+    std::string fingerprint(const uint8_t* data, size_t size) const override;
+};
+
+/**
+ * SHA-256 指纹
+ *
+ * 可传给 ClipboardIngestor 替换默认算法；目前入库流程不使用，只用于基准测试对比。
+ */
+class Sha256Fingerprinter final : public IContentFingerprinter {
+public:
+    const char* name() const override { return "sha256"; }
+    std::string fingerprint(const uint8_t* data, size_t size) const override;
+};
+
+/**
+ * ContentFingerprint - 指纹工具类
+ *
+ * 无状态工具类，所有方法均为静态方法，可在任意线程调用。
+ */
+class ContentFingerprint {
+public:
+    /**
+     * 计算预筛键：长度和采样字节（开头、结尾及均匀分布的 8 字节窗口）
+     *
+     * @param data 数据
+     * @param size 字节数
+     * @return 预筛键
+     */
+    static uint64_t quickKey(const uint8_t* data, size_t size);
+
+    /**
+     * 计算 128 位快速哈希
+     *
+     * @param data 数据
+     * @param size 字节数
+     * @param seed 种子
+     * @return 哈希值
+     */
+    static Hash128 hash128(const uint8_t* data, size_t size, uint64_t seed = 0);
+
+    /**
+     * 默认的完整指纹算法（FastFingerprinter）
+     */
+    static const IContentFingerprinter& defaultFingerprinter();
+
+    /**
+     * 准备剪贴板内容：计算预筛键，清空旧的完整指纹
+     *
+     * 监听器读取内容后在主线程调用，开销与内容大小无关。
+     *
+     * @param content 剪贴板内容
+     */
+    static void prepare(ClipboardContent& content);
+
+    /**
+     * 确保剪贴板内容已有完整指纹（没有时计算）
+     *
+     * @param content 剪贴板内容
+     * @param fingerprinter 指纹算法
+     */
+    static void ensureHash(ClipboardContent& content,
+                           const IContentFingerprinter& fingerprinter = defaultFingerprinter());
+
+    /**
+     * 判断两份内容是否相同
+     *
+     * 先比较类型和预筛键，相同时才计算并比较完整指纹。
+     *
+     * @return 是否相同
+     */
+    static bool isSameContent(ClipboardContent& a, ClipboardContent& b,
+                              const IContentFingerprinter& fingerprinter = defaultFingerprinter());
+};
+
+} // namespace suyan
+
+#endif // SUYAN_CLIPBOARD_CONTENT_FINGERPRINT_H
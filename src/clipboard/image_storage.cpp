@@ -2,10 +2,15 @@
  * ImageStorage 实现
  *
  * 使用 Qt QImage 进行图片处理和缩略图生成。
+ * 每张图片入库时最多解码一次：尺寸从文件头读取，缩略图由内存中已解码的图片生成。
+ * 原样保存的图片只按缩略图尺寸解码（JPEG 在 DCT 域缩小），大图先整数倍盒式滤波再平滑缩放。
+ * TIFF 等未压缩格式入库时无损转为 PNG（见 getStorageFormat）。
+ * 文件按哈希前缀分片存放，返回给记录的是相对基础目录的路径（见 resolvePath）。
  */
 
 #include "image_storage.h"
 #include <QImage>
+#include <QImageReader>
 #include <QFile>
 #include <QDir>
 #include <QFileInfo>
@@ -13,11 +18,141 @@
 #include <filesystem>
 #include <iostream>
 #include <algorithm>
+#include <vector>
 
 namespace fs = std::filesystem;
 
 namespace suyan {
 
+namespace {
+
+// 转存 PNG 的质量参数（Qt 换算为 zlib 压缩级别，50 约为 4 级）
+// 截图类图片在此级别的体积接近最高压缩，编码耗时只有其几分之一
+constexpr int kPngQuality = 50;
+
+// 原图和缩略图的子目录（也是相对路径的第一段）
+constexpr const char* kImagesDirName = "images";
+constexpr const char* kThumbnailsDirName = "thumbnails";
+
+/**
+ * 按哈希前缀分片的相对路径：images/ab/cd/<hash>.png
+ *
+ * 两级各最多 256 个子目录，十万张图片时每个目录平均只有几个文件。
+ */
+std::string shardedPath(const char* dirName, const std::string& hash, const std::string& format) {
+    std::string path = std::string(dirName) + "/";
+    if (hash.size() >= 4) {
+        path += hash.substr(0, 2) + "/" + hash.substr(2, 2) + "/";
+    }
+    return path + hash + "." + format;
+}
+
+/**
+ * 创建文件所在的分片目录
+ */
+bool createParentDirectory(const std::string& path) {
+    std::error_code ec;
+    fs::create_directories(fs::path(path).parent_path(), ec);
+    if (ec) {
+        std::cerr << "ImageStorage: 创建目录失败: " << ec.message() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * 可以原样保存的格式（QImageReader::format() 按文件头识别的格式名）
+ *
+ * GIF 原样保存以保留动画（Qt 也不能编码 GIF）。
+ */
+bool isStorableFormat(const QByteArray& format) {
+    return format == "png" || format == "jpeg" || format == "jpg" || format == "gif";
+}
+
+/**
+ * 原样写入图片数据，失败时删除不完整的文件
+ */
+bool writeImageFile(const std::string& path, const std::vector<uint8_t>& data) {
+    QFile file(QString::fromStdString(path));
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    qint64 written = file.write(reinterpret_cast<const char*>(data.data()),
+                                static_cast<qint64>(data.size()));
+    file.close();
+    if (written != static_cast<qint64>(data.size())) {
+        file.remove();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * 计算缩略图尺寸：保持宽高比缩放到最大尺寸以内，原图已经足够小时保持原尺寸
+ */
+QSize fitThumbnailSize(const QSize& size, int maxWidth, int maxHeight) {
+    if (size.width() <= maxWidth && size.height() <= maxHeight) {
+        return size;
+    }
+    return size.scaled(maxWidth, maxHeight, Qt::KeepAspectRatio).expandedTo(QSize(1, 1));
+}
+
+/**
+ * 按缩略图尺寸解码
+ *
+ * 解码器支持缩放解码时（如 JPEG 在 DCT 域按 1/2、1/4、1/8 缩小）直接得到缩略图，
+ * 不生成整张图片；不支持时解码整张图片，由 generateThumbnail 缩小。
+ */
+QImage decodeForThumbnail(QImageReader& reader, const QSize& thumbnailSize) {
+    if (thumbnailSize.isValid() && thumbnailSize != reader.size() &&
+        reader.supportsOption(QImageIOHandler::ScaledSize)) {
+        reader.setScaledSize(thumbnailSize);
+    }
+    return reader.read();
+}
+
+/**
+ * 整数倍盒式滤波缩小：每 factor×factor 个像素取平均
+ *
+ * 只读取每个像素一次，比对整张大图做平滑缩放快得多，用于平滑缩放前的预缩小。
+ */
+QImage boxDownscale(const QImage& source, int factor) {
+    QImage src = source;
+    if (src.format() != QImage::Format_RGB32 && src.format() != QImage::Format_ARGB32_Premultiplied) {
+        // 预乘格式下各通道可以直接平均
+        src = src.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    }
+
+    const int width = src.width() / factor;
+    const int height = src.height() / factor;
+    const uint32_t area = static_cast<uint32_t>(factor * factor);
+    QImage result(width, height, src.format());
+    std::vector<uint32_t> sums(static_cast<size_t>(width) * 4);
+
+    for (int y = 0; y < height; ++y) {
+        std::fill(sums.begin(), sums.end(), 0);
+        for (int dy = 0; dy < factor; ++dy) {
+            const uchar* pixel = src.constScanLine(y * factor + dy);
+            for (int x = 0; x < width; ++x) {
+                uint32_t* sum = &sums[static_cast<size_t>(x) * 4];
+                for (int dx = 0; dx < factor; ++dx, pixel += 4) {
+                    sum[0] += pixel[0];
+                    sum[1] += pixel[1];
+                    sum[2] += pixel[2];
+                    sum[3] += pixel[3];
+                }
+            }
+        }
+        uchar* out = result.scanLine(y);
+        for (size_t i = 0; i < sums.size(); ++i) {
+            out[i] = static_cast<uchar>(sums[i] / area);
+        }
+    }
+    return result;
+}
+
+} // anonymous namespace
+
 // ========== 单例实现 ==========
 
 ImageStorage& ImageStorage::instance() {
@@ -40,8 +175,8 @@ bool ImageStorage::initialize(const std::string& baseDir) {
     }
 
     baseDir_ = baseDir;
-    imagesDir_ = baseDir + "/images";
-    thumbnailsDir_ = baseDir + "/thumbnails";
+    imagesDir_ = baseDir + "/" + kImagesDirName;
+    thumbnailsDir_ = baseDir + "/" + kThumbnailsDirName;
 
     // 创建目录
     try {
@@ -92,64 +227,101 @@ ImageStorageResult ImageStorage::saveImage(const std::vector<uint8_t>& imageData
         return result;
     }
 
-    // 规范化格式
-    std::string normalizedFormat = normalizeFormat(format);
+    // 存储格式（TIFF 等转为 PNG）
+    std::string normalizedFormat = getStorageFormat(format);
     
-    // 构建文件路径
-    std::string imagePath = imagesDir_ + "/" + hash + "." + normalizedFormat;
-    std::string thumbnailPath = thumbnailsDir_ + "/" + hash + "." + normalizedFormat;
+    // 构建文件路径（记录中保存相对路径，读写文件使用绝对路径）
+    std::string relativeImagePath = shardedPath(kImagesDirName, hash, normalizedFormat);
+    std::string relativeThumbnailPath = shardedPath(kThumbnailsDirName, hash, normalizedFormat);
+    std::string imagePath = resolvePath(relativeImagePath);
+    std::string thumbnailPath = resolvePath(relativeThumbnailPath);
 
     // 检查是否已存在
     if (fs::exists(imagePath)) {
         // 文件已存在，直接返回成功
+        // 刷新修改时间：孤儿文件回收只删除一段时间未修改的文件，重新使用的文件在记录写入前不会被删除
+        std::error_code ec;
+        fs::last_write_time(imagePath, fs::file_time_type::clock::now(), ec);
+        fs::last_write_time(thumbnailPath, fs::file_time_type::clock::now(), ec);
+
         result.success = true;
-        result.imagePath = imagePath;
-        result.thumbnailPath = fs::exists(thumbnailPath) ? thumbnailPath : "";
+        result.imagePath = relativeImagePath;
+        result.thumbnailPath = fs::exists(thumbnailPath) ? relativeThumbnailPath : "";
+        result.format = normalizedFormat;
+        result.thumbnailSize = getImageFileSize("", result.thumbnailPath);
         
-        // 获取图片尺寸
-        QImage existingImage(QString::fromStdString(imagePath));
-        if (!existingImage.isNull()) {
-            result.width = existingImage.width();
-            result.height = existingImage.height();
+        // 从文件头读取图片尺寸，不解码整张图片
+        QSize existingSize = QImageReader(QString::fromStdString(imagePath)).size();
+        if (existingSize.isValid()) {
+            result.width = existingSize.width();
+            result.height = existingSize.height();
         }
         result.fileSize = static_cast<int64_t>(fs::file_size(imagePath));
         return result;
     }
 
-    // 从二进制数据加载图片
-    QImage image;
-    if (!image.loadFromData(imageData.data(), static_cast<int>(imageData.size()))) {
+    // 读取文件头（实际格式和尺寸），不解码图片
+    QByteArray bytes = QByteArray::fromRawData(reinterpret_cast<const char*>(imageData.data()),
+                                               static_cast<int>(imageData.size()));
+    QBuffer buffer(&bytes);
+    buffer.open(QIODevice::ReadOnly);
+    QImageReader reader(&buffer);
+    QByteArray actualFormat = reader.format();  // 按文件头识别的实际格式
+    QSize imageSize = reader.size();            // 文件头中的尺寸
+
+    // 保存原图：实际格式可以直接存储且与扩展名一致时原样写入，否则重新编码
+    bool keepOriginal = isStorableFormat(actualFormat) && imageSize.isValid() &&
+                        normalizeFormat(actualFormat.toStdString()) == normalizedFormat;
+
+    // 原样写入时只需要缩略图，按缩略图尺寸解码；重新编码时解码整张图片
+    QImage image = keepOriginal
+        ? decodeForThumbnail(reader, fitThumbnailSize(imageSize, thumbnailMaxWidth_, thumbnailMaxHeight_))
+        : reader.read();
+    if (image.isNull()) {
         result.errorMessage = "无法解析图片数据";
         return result;
     }
-
-    // 保存原图
-    QString qImagePath = QString::fromStdString(imagePath);
-    if (!image.save(qImagePath)) {
-        result.errorMessage = "保存原图失败";
+    if (!createParentDirectory(imagePath) || !createParentDirectory(thumbnailPath)) {
+        result.errorMessage = "创建存储目录失败";
         return result;
     }
-
-    // 获取文件大小
-    try {
-        result.fileSize = static_cast<int64_t>(fs::file_size(imagePath));
-    } catch (const std::exception& e) {
-        std::cerr << "ImageStorage: 获取文件大小失败: " << e.what() << std::endl;
+    if (keepOriginal) {
+        if (!writeImageFile(imagePath, imageData)) {
+            result.errorMessage = "保存原图失败";
+            return result;
+        }
         result.fileSize = static_cast<int64_t>(imageData.size());
+    } else {
+        imageSize = image.size();
+        int quality = normalizedFormat == "png" ? kPngQuality : -1;
+        if (!image.save(QString::fromStdString(imagePath), nullptr, quality)) {
+            result.errorMessage = "保存原图失败";
+            return result;
+        }
+
+        // 获取文件大小
+        try {
+            result.fileSize = static_cast<int64_t>(fs::file_size(imagePath));
+        } catch (const std::exception& e) {
+            std::cerr << "ImageStorage: 获取文件大小失败: " << e.what() << std::endl;
+            result.fileSize = static_cast<int64_t>(imageData.size());
+        }
     }
 
     // 生成缩略图
-    if (generateThumbnail(imagePath, thumbnailPath, thumbnailMaxWidth_, thumbnailMaxHeight_)) {
-        result.thumbnailPath = thumbnailPath;
+    if (generateThumbnail(image, thumbnailPath, thumbnailMaxWidth_, thumbnailMaxHeight_)) {
+        result.thumbnailPath = relativeThumbnailPath;
+        result.thumbnailSize = getImageFileSize("", thumbnailPath);
     } else {
         // 缩略图生成失败不是致命错误
         std::cerr << "ImageStorage: 缩略图生成失败，继续" << std::endl;
     }
 
     result.success = true;
-    result.imagePath = imagePath;
-    result.width = image.width();
-    result.height = image.height();
+    result.imagePath = relativeImagePath;
+    result.format = normalizedFormat;
+    result.width = imageSize.width();
+    result.height = imageSize.height();
 
     return result;
 }
@@ -161,13 +333,14 @@ std::vector<uint8_t> ImageStorage::loadImage(const std::string& path) {
         return data;
     }
 
-    if (path.empty() || !fs::exists(path)) {
+    std::string absolutePath = resolvePath(path);
+    if (absolutePath.empty() || !fs::exists(absolutePath)) {
         return data;
     }
 
-    QFile file(QString::fromStdString(path));
+    QFile file(QString::fromStdString(absolutePath));
     if (!file.open(QIODevice::ReadOnly)) {
-        std::cerr << "ImageStorage: 无法打开文件: " << path << std::endl;
+        std::cerr << "ImageStorage: 无法打开文件: " << absolutePath << std::endl;
         return data;
     }
 
@@ -190,9 +363,7 @@ bool ImageStorage::deleteImage(const std::string& imagePath, const std::string&
     // 删除原图
     if (!imagePath.empty()) {
         try {
-            if (fs::exists(imagePath)) {
-                fs::remove(imagePath);
-            }
+            fs::remove(resolvePath(imagePath));
         } catch (const std::exception& e) {
             std::cerr << "ImageStorage: 删除原图失败: " << e.what() << std::endl;
             success = false;
@@ -202,9 +373,7 @@ bool ImageStorage::deleteImage(const std::string& imagePath, const std::string&
     // 删除缩略图
     if (!thumbnailPath.empty()) {
         try {
-            if (fs::exists(thumbnailPath)) {
-                fs::remove(thumbnailPath);
-            }
+            fs::remove(resolvePath(thumbnailPath));
         } catch (const std::exception& e) {
             std::cerr << "ImageStorage: 删除缩略图失败: " << e.what() << std::endl;
             success = false;
@@ -219,7 +388,22 @@ bool ImageStorage::imageExists(const std::string& path) {
         return false;
     }
 
-    return fs::exists(path);
+    return fs::exists(resolvePath(path));
+}
+
+int64_t ImageStorage::getImageFileSize(const std::string& imagePath, const std::string& thumbnailPath) {
+    int64_t totalSize = 0;
+    std::error_code ec;
+    for (const std::string* path : {&imagePath, &thumbnailPath}) {
+        if (path->empty()) {
+            continue;
+        }
+        auto size = fs::file_size(resolvePath(*path), ec);
+        if (!ec) {
+            totalSize += static_cast<int64_t>(size);
+        }
+    }
+    return totalSize;
 }
 
 int64_t ImageStorage::getStorageSize() {
@@ -233,6 +417,139 @@ int64_t ImageStorage::getStorageSize() {
     return totalSize;
 }
 
+// ========== 孤儿文件回收 ==========
+
+std::vector<StoredImageFile> ImageStorage::listStoredFiles(const std::string& afterHash,
+                                                           const std::string& upToHash) {
+    std::vector<StoredImageFile> files;
+    if (!initialized_) {
+        return files;
+    }
+
+    // 目录名是哈希前缀：前缀小于下界的前缀或大于上界的前缀时，目录中没有范围内的文件
+    auto prefixInRange = [&afterHash, &upToHash](const std::string& prefix) {
+        return prefix >= afterHash.substr(0, prefix.size()) &&
+               (upToHash.empty() || prefix <= upToHash.substr(0, prefix.size()));
+    };
+
+    try {
+        std::error_code ec;
+        for (const char* dirName : {kImagesDirName, kThumbnailsDirName}) {
+            for (const auto& first : fs::directory_iterator(resolvePath(dirName), ec)) {
+                std::string firstName = first.path().filename().string();
+                if (firstName.size() != 2 || !first.is_directory(ec) || !prefixInRange(firstName)) {
+                    continue;
+                }
+                for (const auto& second : fs::directory_iterator(first.path(), ec)) {
+                    std::string secondName = second.path().filename().string();
+                    if (secondName.size() != 2 || !second.is_directory(ec) ||
+                        !prefixInRange(firstName + secondName)) {
+                        continue;
+                    }
+                    for (const auto& entry : fs::directory_iterator(second.path(), ec)) {
+                        std::string hash = entry.path().stem().string();
+                        if (hash <= afterHash || (!upToHash.empty() && hash > upToHash) ||
+                            !entry.is_regular_file(ec)) {
+                            continue;
+                        }
+                        StoredImageFile file;
+                        file.hash = std::move(hash);
+                        file.path = std::string(dirName) + "/" + firstName + "/" + secondName + "/" +
+                                    entry.path().filename().string();
+                        auto size = entry.file_size(ec);
+                        file.size = ec ? 0 : static_cast<int64_t>(size);
+                        file.modifiedAt = entry.last_write_time(ec);
+                        files.push_back(std::move(file));
+                    }
+                }
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "ImageStorage: 遍历分片目录失败: " << e.what() << std::endl;
+    }
+
+    std::sort(files.begin(), files.end(), [](const StoredImageFile& a, const StoredImageFile& b) {
+        return a.hash != b.hash ? a.hash < b.hash : a.path < b.path;
+    });
+    return files;
+}
+
+bool ImageStorage::deleteStoredFile(const StoredImageFile& file) {
+    if (!initialized_ || file.path.empty()) {
+        return false;
+    }
+
+    std::string path = resolvePath(file.path);
+    std::error_code ec;
+    auto modifiedAt = fs::last_write_time(path, ec);
+    if (ec || modifiedAt != file.modifiedAt) {
+        return false;
+    }
+    return fs::remove(path, ec);
+}
+
+std::string ImageStorage::resolvePath(const std::string& path) const {
+    if (path.empty() || fs::path(path).is_absolute()) {
+        return path;
+    }
+    return baseDir_ + "/" + path;
+}
+
+std::string ImageStorage::migrateLegacyFile(const std::string& legacyPath, bool isThumbnail) {
+    if (!initialized_ || legacyPath.empty()) {
+        return "";
+    }
+
+    fs::path fileName = fs::path(legacyPath).filename();
+    std::string format = fileName.extension().string();
+    if (!format.empty()) {
+        format.erase(0, 1);   // 去掉 "."
+    }
+    std::string relativePath = shardedPath(isThumbnail ? kThumbnailsDirName : kImagesDirName,
+                                           fileName.stem().string(), format);
+    std::string targetPath = resolvePath(relativePath);
+
+    // 旧路径不存在时按文件名在当前目录中查找（数据目录被移动过）
+    std::error_code ec;
+    fs::path sourcePath = legacyPath;
+    if (!fs::exists(sourcePath, ec)) {
+        sourcePath = fs::path(isThumbnail ? thumbnailsDir_ : imagesDir_) / fileName;
+    }
+
+    if (fs::exists(targetPath, ec)) {
+        // 上次迁移已移动过（或多条记录共用同一文件）
+        if (sourcePath != fs::path(targetPath)) {
+            fs::remove(sourcePath, ec);
+        }
+        return relativePath;
+    }
+    if (!fs::exists(sourcePath, ec)) {
+        // 文件已丢失，仍然改为新路径，避免每次启动重试
+        std::cerr << "ImageStorage: 迁移时文件不存在: " << legacyPath << std::endl;
+        return relativePath;
+    }
+
+    if (!createParentDirectory(targetPath)) {
+        return "";
+    }
+    fs::rename(sourcePath, targetPath, ec);
+    if (ec) {
+        std::cerr << "ImageStorage: 迁移文件失败: " << legacyPath << ": " << ec.message() << std::endl;
+        return "";
+    }
+    return relativePath;
+}
+
+std::string ImageStorage::getStorageFormat(const std::string& format) {
+    std::string normalized = normalizeFormat(format);
+
+    // 未压缩或不常用的格式无损转为 PNG（macOS 截图的 TIFF 可达数十 MB）
+    if (normalized == "png" || normalized == "jpg" || normalized == "gif") {
+        return normalized;
+    }
+    return "png";
+}
+
 // ========== 缩略图配置 ==========
 
 void ImageStorage::setThumbnailSize(int maxWidth, int maxHeight) {
@@ -246,29 +563,32 @@ void ImageStorage::setThumbnailSize(int maxWidth, int maxHeight) {
 
 // ========== 私有方法 ==========
 
-bool ImageStorage::generateThumbnail(const std::string& sourcePath,
+bool ImageStorage::generateThumbnail(const QImage& source,
                                       const std::string& thumbnailPath,
                                       int maxWidth,
                                       int maxHeight) {
-    QImage source(QString::fromStdString(sourcePath));
     if (source.isNull()) {
-        std::cerr << "ImageStorage: 无法加载源图片: " << sourcePath << std::endl;
+        std::cerr << "ImageStorage: 源图片为空" << std::endl;
         return false;
     }
 
-    // 计算缩放比例，保持宽高比
-    QSize targetSize = source.size();
-    targetSize.scale(maxWidth, maxHeight, Qt::KeepAspectRatio);
-
     // 如果原图已经小于目标尺寸，直接复制
     if (source.width() <= maxWidth && source.height() <= maxHeight) {
         return source.save(QString::fromStdString(thumbnailPath));
     }
 
+    // 计算缩放比例，保持宽高比
+    QSize targetSize = fitThumbnailSize(source.size(), maxWidth, maxHeight);
+
+    // 大图先盒式滤波缩小到目标尺寸的两倍左右，平滑缩放只处理少量像素
+    int factor = std::min(source.width() / (targetSize.width() * 2),
+                          source.height() / (targetSize.height() * 2));
+    QImage reduced = factor >= 2 ? boxDownscale(source, factor) : source;
+
     // 使用高质量缩放
-    QImage thumbnail = source.scaled(
+    QImage thumbnail = reduced.scaled(
         targetSize,
-        Qt::KeepAspectRatio,
+        Qt::IgnoreAspectRatio,
         Qt::SmoothTransformation
     );
 
@@ -5,10 +5,13 @@
  * 支持原图存储和缩略图生成。
  *
  * 功能：
- * - 图片文件存储（以哈希值命名）
+ * - 图片文件存储（以哈希值命名，TIFF 等未压缩格式转为 PNG）
+ * - 按哈希前缀两级分片存放（images/ab/cd/<hash>.png），单个目录的文件数保持在较小范围
+ * - 记录中保存相对基础目录的路径，数据目录移动后仍然有效
  * - 缩略图自动生成（120x80）
  * - 图片文件删除
  * - 存储空间统计
+ * - 按哈希范围列出分片目录中的文件（回收孤儿文件）
  */
 
 #ifndef SUYAN_CLIPBOARD_IMAGE_STORAGE_H
@@ -17,6 +20,10 @@
 #include <string>
 #include <vector>
 #include <cstdint>
+#include <filesystem>
+
+// 前向声明 Qt
+class QImage;
 
 namespace suyan {
 
@@ -25,14 +32,26 @@ namespace suyan {
  */
 struct ImageStorageResult {
     bool success = false;           // 是否成功
-    std::string imagePath;          // 原图路径
-    std::string thumbnailPath;      // 缩略图路径
+    std::string imagePath;          // 原图路径（相对基础目录）
+    std::string thumbnailPath;      // 缩略图路径（相对基础目录）
     int width = 0;                  // 图片宽度
     int height = 0;                 // 图片高度
     int64_t fileSize = 0;           // 文件大小（字节）
+    int64_t thumbnailSize = 0;      // 缩略图文件大小（字节，没有缩略图时为 0）
+    std::string format;             // 实际存储的格式（与文件扩展名一致，粘贴时按此设置剪贴板类型）
     std::string errorMessage;       // 错误信息（失败时）
 };
 
+/**
+ * 分片目录中的图片文件（回收孤儿文件用）
+ */
+struct StoredImageFile {
+    std::string hash;                               // 文件名中的内容哈希（不含扩展名）
+    std::string path;                               // 相对基础目录的路径（与记录中的路径一致）
+    int64_t size = 0;                               // 文件大小（字节）
+    std::filesystem::file_time_type modifiedAt;     // 修改时间
+};
+
 /**
  * ImageStorage - 图片存储类
  *
@@ -86,6 +105,28 @@ public:
      */
     std::string getThumbnailsDir() const { return thumbnailsDir_; }
 
+    /**
+     * 把记录中的图片路径解析为绝对路径
+     *
+     * 相对路径基于基础目录；旧版本记录中的绝对路径原样返回。
+     *
+     * @param path 记录中的路径
+     * @return 绝对路径，path 为空时返回空字符串
+     */
+    std::string resolvePath(const std::string& path) const;
+
+    /**
+     * 把旧版本平铺存放的文件移到分片目录
+     *
+     * 旧路径不存在时（数据目录被移动过）按文件名在当前的 images/、thumbnails/ 中查找。
+     * 目标文件已存在时（上次迁移中断）删除旧文件。
+     *
+     * @param legacyPath 旧记录中的绝对路径
+     * @param isThumbnail 是否为缩略图
+     * @return 新的相对路径，移动失败时返回空字符串（保留旧路径，下次重试）
+     */
+    std::string migrateLegacyFile(const std::string& legacyPath, bool isThumbnail);
+
     // ========== 存储操作 ==========
 
     /**
@@ -93,6 +134,10 @@ public:
      *
      * 保存原图并自动生成缩略图。
      * 文件名使用哈希值，避免重复存储。
+     * 图片只解码一次：PNG、JPEG 等可直接存储的格式原样写入，只按缩略图尺寸解码
+     * （JPEG 在 DCT 域缩小，不生成整张图片）；其他格式解码整张图片后按
+     * getStorageFormat 重新编码（TIFF 转为 PNG），实际格式见 ImageStorageResult::format。
+     * 缩略图由解码后的图片生成，已存在的文件只从文件头读取尺寸。
      *
      * @param imageData 图片二进制数据
      * @param format 图片格式（png, jpeg, gif 等）
@@ -103,10 +148,21 @@ public:
                                   const std::string& format,
                                   const std::string& hash);
 
+    /**
+     * 获取图片的存储格式
+     *
+     * PNG、JPEG、GIF 原样存储；TIFF、BMP 等未压缩或不常用的格式无损转为 PNG，
+     * 粘贴时以 PNG 类型写回剪贴板。
+     *
+     * @param format 剪贴板中的图片格式
+     * @return 存储格式（png、jpg、gif）
+     */
+    std::string getStorageFormat(const std::string& format);
+
     /**
      * 读取原图
      *
-     * @param path 图片路径
+     * @param path 图片路径（相对基础目录或绝对路径，下同）
      * @return 图片二进制数据，失败返回空 vector
      */
     std::vector<uint8_t> loadImage(const std::string& path);
@@ -130,13 +186,50 @@ public:
      */
     bool imageExists(const std::string& path);
 
+    /**
+     * 获取图片占用的存储空间
+     *
+     * 原图和缩略图的文件大小之和，文件不存在时按 0 计。
+     *
+     * @param imagePath 原图路径
+     * @param thumbnailPath 缩略图路径
+     * @return 占用空间（字节）
+     */
+    int64_t getImageFileSize(const std::string& imagePath, const std::string& thumbnailPath);
+
     /**
      * 获取存储目录总大小
      *
+     * 遍历目录逐个读取文件大小，耗时与文件数成正比。
+     * 日常查询使用 ClipboardStore::getTotalFileSize（持久化的累计值）。
+     *
      * @return 总大小（字节）
      */
     int64_t getStorageSize();
 
+    // ========== 孤儿文件回收 ==========
+
+    /**
+     * 列出分片目录中内容哈希在 (afterHash, upToHash] 范围内的原图和缩略图
+     *
+     * 分片目录名是哈希前缀，范围外的目录整个跳过；不在分片目录中的文件（旧版本平铺存放）不列出。
+     *
+     * @param afterHash 下界（不含，为空表示不设下界）
+     * @param upToHash 上界（含，为空表示不设上界）
+     * @return 按哈希、路径排序的文件
+     */
+    std::vector<StoredImageFile> listStoredFiles(const std::string& afterHash, const std::string& upToHash);
+
+    /**
+     * 删除列出的文件
+     *
+     * 列出之后文件被修改过（入库时重新使用了同名文件）时不删除。
+     *
+     * @param file listStoredFiles 返回的文件
+     * @return 是否删除
+     */
+    bool deleteStoredFile(const StoredImageFile& file);
+
     // ========== 缩略图配置 ==========
 
     /**
@@ -164,13 +257,15 @@ private:
     /**
      * 生成缩略图
      *
-     * @param sourcePath 原图路径
+     * 大图先按整数倍盒式滤波缩小到目标尺寸的两倍左右，再平滑缩放到目标尺寸。
+     *
+     * @param source 已解码的原图（可能已按缩略图尺寸解码）
      * @param thumbnailPath 缩略图保存路径
      * @param maxWidth 最大宽度
      * @param maxHeight 最大高度
      * @return 是否成功
      */
-    bool generateThumbnail(const std::string& sourcePath,
+    bool generateThumbnail(const QImage& source,
                            const std::string& thumbnailPath,
                            int maxWidth,
                            int maxHeight);
@@ -0,0 +1,165 @@
+/**
+ * PinyinTable 实现
+ */
+
+#include "pinyin_table.h"
+#include "cjk_tokenizer.h"
+#include "content_fingerprint.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+namespace suyan {
+
+namespace {
+
+// 多音字保留的读音：权重不低于最高读音的百分比
+constexpr int64_t kMinReadingPercent = 5;
+
+/**
+ * 字表中的一条读音
+ */
+struct ReadingEntry {
+    std::string pinyin;
+    int64_t weight;
+};
+
+bool isPinyinSyllable(const std::string& code) {
+    return !code.empty() && std::all_of(code.begin(), code.end(), [](char c) {
+        return c >= 'a' && c <= 'z';
+    });
+}
+
+} // anonymous namespace
+
+// ========== 单例实现 ==========
+
+PinyinTable& PinyinTable::instance() {
+    static PinyinTable instance;
+    return instance;
+}
+
+// ========== 加载 ==========
+
+bool PinyinTable::load(const std::string& dictPath) {
+    clear();
+
+    std::ifstream file(dictPath);
+    if (!file.is_open()) {
+        std::cerr << "PinyinTable: 打开字表失败: " << dictPath << std::endl;
+        return false;
+    }
+
+    // 按码位排序，保证版本指纹与文件中的条目顺序无关
+    std::map<uint32_t, std::vector<ReadingEntry>> entries;
+    std::string line;
+    bool inBody = false;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (!inBody) {
+            inBody = line == "...";
+            continue;
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        // 字\t拼音\t权重（权重可省略）
+        size_t tab = line.find('\t');
+        if (tab == std::string::npos || tab == 0) {
+            continue;
+        }
+        int pos = 0;
+        uint32_t codepoint = CjkTokenizer::decodeUtf8(line.data(), static_cast<int>(tab), pos);
+        if (pos != static_cast<int>(tab) || !CjkTokenizer::isCjk(codepoint)) {
+            continue;   // 词组或非汉字条目
+        }
+
+        size_t codeEnd = line.find('\t', tab + 1);
+        std::string code = line.substr(tab + 1, codeEnd == std::string::npos
+                                                    ? std::string::npos : codeEnd - tab - 1);
+        if (!isPinyinSyllable(code)) {
+            continue;
+        }
+        int64_t weight = 0;
+        if (codeEnd != std::string::npos) {
+            weight = std::strtoll(line.c_str() + codeEnd + 1, nullptr, 10);
+        }
+        entries[codepoint].push_back({code, weight});
+    }
+
+    std::ostringstream serialized;
+    for (auto& [codepoint, list] : entries) {
+        // 权重高的读音在前，权重相同时保持字表中的顺序
+        std::stable_sort(list.begin(), list.end(), [](const ReadingEntry& a, const ReadingEntry& b) {
+            return a.weight > b.weight;
+        });
+
+        std::vector<std::string> readings;
+        for (const auto& entry : list) {
+            bool common = entry.weight * 100 >= list.front().weight * kMinReadingPercent;
+            bool duplicate = std::find(readings.begin(), readings.end(), entry.pinyin) != readings.end();
+            if (common && !duplicate) {
+                readings.push_back(entry.pinyin);
+            }
+        }
+
+        serialized << codepoint;
+        for (const auto& reading : readings) {
+            serialized << ' ' << reading;
+            syllables_.insert(reading);
+            maxSyllableLength_ = std::max(maxSyllableLength_, reading.size());
+        }
+        serialized << '\n';
+        readings_.emplace(codepoint, std::move(readings));
+    }
+
+    if (readings_.empty()) {
+        std::cerr << "PinyinTable: 字表中没有单字读音: " << dictPath << std::endl;
+        return false;
+    }
+
+    std::string data = serialized.str();
+    version_ = ContentFingerprint::hash128(reinterpret_cast<const uint8_t*>(data.data()),
+                                           data.size()).toHex();
+    return true;
+}
+
+void PinyinTable::clear() {
+    readings_.clear();
+    syllables_.clear();
+    maxSyllableLength_ = 0;
+    version_.clear();
+}
+
+// ========== 查询 ==========
+
+const std::vector<std::string>* PinyinTable::getReadings(uint32_t codepoint) const {
+    auto it = readings_.find(codepoint);
+    return it != readings_.end() ? &it->second : nullptr;
+}
+
+std::vector<std::string> PinyinTable::splitSyllables(const std::string& letters) const {
+    std::vector<std::string> result;
+    size_t pos = 0;
+    while (pos < letters.size()) {
+        size_t length = std::min(maxSyllableLength_, letters.size() - pos);
+        for (; length > 1; --length) {
+            if (syllables_.count(letters.substr(pos, length))) {
+                break;
+            }
+        }
+        // 没有匹配的多字母音节时，单个字母作为首字母（或单字母音节 a、e、o）
+        length = std::max<size_t>(length, 1);
+        result.push_back(letters.substr(pos, length));
+        pos += length;
+    }
+    return result;
+}
+
+} // namespace suyan
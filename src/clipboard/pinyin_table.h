@@ -0,0 +1,107 @@
+/**
+ * PinyinTable - 剪贴板搜索使用的汉字读音表
+ *
+ * 从输入法自带的字表（cn_dicts/8105.dict.yaml）加载单字读音，
+ * 供拼音分词器（PinyinTokenizer）为剪贴板文本建立拼音索引，
+ * 使「huiyi」「hyjy」等拼音或首字母查询能找到「会议纪要」。
+ *
+ * 多音字保留权重不低于最高读音 5% 的读音（与字表注音的约定一致），
+ * 如「长」保留 chang、zhang，「会」只保留 hui。
+ *
+ * 读音表在打开剪贴板数据库之前加载，之后只读，可在多个线程中使用。
+ */
+
+#ifndef SUYAN_CLIPBOARD_PINYIN_TABLE_H
+#define SUYAN_CLIPBOARD_PINYIN_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace suyan {
+
+/**
+ * PinyinTable - 单例读音表
+ */
+class PinyinTable {
+public:
+    /**
+     * 获取单例实例
+     */
+    static PinyinTable& instance();
+
+    // 禁止拷贝和移动
+    PinyinTable(const PinyinTable&) = delete;
+    PinyinTable& operator=(const PinyinTable&) = delete;
+    PinyinTable(PinyinTable&&) = delete;
+    PinyinTable& operator=(PinyinTable&&) = delete;
+
+    /**
+     * 从 Rime 词典文件加载单字读音
+     *
+     * 只读取 "..." 之后的「字\t拼音\t权重」条目，词组和多音节编码忽略。
+     * 加载前清空已有读音；失败时读音表为空（拼音搜索不可用）。
+     *
+     * @param dictPath 词典文件路径（如 SharedSupport/rime/cn_dicts/8105.dict.yaml）
+     * @return 是否加载到读音
+     */
+    bool load(const std::string& dictPath);
+
+    /**
+     * 清空读音表
+     */
+    void clear();
+
+    /**
+     * 检查是否已加载读音
+     */
+    bool isLoaded() const { return !readings_.empty(); }
+
+    /**
+     * 获取收录的字数
+     */
+    size_t size() const { return readings_.size(); }
+
+    /**
+     * 获取读音表版本
+     *
+     * 由全部读音计算的指纹，读音表为空时为空字符串。
+     * 数据库记录建立索引时使用的版本，版本变化时需要重建拼音索引。
+     */
+    const std::string& getVersion() const { return version_; }
+
+    /**
+     * 获取字的读音（常用读音在前）
+     *
+     * @param codepoint Unicode 码位
+     * @return 读音列表，未收录时返回 nullptr
+     */
+    const std::vector<std::string>* getReadings(uint32_t codepoint) const;
+
+    /**
+     * 把连续的拼音字母切分为音节
+     *
+     * 从左到右取最长的合法音节，无法组成音节的字母单独作为首字母：
+     *   "huiyi" → hui / yi，"hyjy" → h / y / j / y，"huiy" → hui / y
+     *
+     * @param letters 小写拼音字母
+     * @return 音节和首字母列表
+     */
+    std::vector<std::string> splitSyllables(const std::string& letters) const;
+
+private:
+    PinyinTable() = default;
+    ~PinyinTable() = default;
+
+    std::unordered_map<uint32_t, std::vector<std::string>> readings_;
+    std::unordered_set<std::string> syllables_;     // 全部合法音节
+    size_t maxSyllableLength_ = 0;
+    std::string version_;
+};
+
+} // namespace suyan
+
+#endif // SUYAN_CLIPBOARD_PINYIN_TABLE_H
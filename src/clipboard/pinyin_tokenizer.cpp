@@ -0,0 +1,233 @@
+/**
+ * PinyinTokenizer 实现
+ */
+
+#include "pinyin_tokenizer.h"
+#include "pinyin_table.h"
+#include "cjk_tokenizer.h"
+#include <sqlite3.h>
+#include <algorithm>
+#include <iostream>
+#include <new>
+#include <vector>
+
+namespace suyan {
+
+namespace {
+
+/**
+ * 分词器实例：引用的读音表
+ */
+struct TokenizerInstance {
+    const PinyinTable* table = nullptr;
+};
+
+using TokenCallback = int (*)(void*, int, const char*, int, int, int);
+
+bool isAsciiLetter(char c) {
+    return (c | 0x20) >= 'a' && (c | 0x20) <= 'z';
+}
+
+int xCreate(void* userData, const char** args, int argCount, Fts5Tokenizer** out) {
+    (void)args;
+    (void)argCount;
+    auto* instance = new (std::nothrow) TokenizerInstance();
+    if (!instance) {
+        return SQLITE_NOMEM;
+    }
+    instance->table = static_cast<const PinyinTable*>(userData);
+    *out = reinterpret_cast<Fts5Tokenizer*>(instance);
+    return SQLITE_OK;
+}
+
+void xDelete(Fts5Tokenizer* tokenizer) {
+    delete reinterpret_cast<TokenizerInstance*>(tokenizer);
+}
+
+/**
+ * 文档分词：每个收录的汉字一个位置，同位置输出读音和首字母
+ */
+int tokenizeDocument(const PinyinTable& table, void* ctx, const char* text, int textLen,
+                     TokenCallback xToken) {
+    std::vector<std::string> tokens;
+    for (int pos = 0; pos < textLen;) {
+        int start = pos;
+        uint32_t cp = CjkTokenizer::decodeUtf8(text, textLen, pos);
+        if (!CjkTokenizer::isCjk(cp)) {
+            continue;
+        }
+        const auto* readings = table.getReadings(cp);
+        if (!readings) {
+            continue;
+        }
+
+        tokens.assign(readings->begin(), readings->end());
+        for (const auto& reading : *readings) {
+            std::string initial = reading.substr(0, 1);
+            if (std::find(tokens.begin(), tokens.end(), initial) == tokens.end()) {
+                tokens.push_back(initial);
+            }
+        }
+
+        int flags = 0;
+        for (const auto& token : tokens) {
+            int rc = xToken(ctx, flags, token.data(), static_cast<int>(token.size()), start, pos);
+            if (rc != SQLITE_OK) {
+                return rc;
+            }
+            flags = FTS5_TOKEN_COLOCATED;
+        }
+    }
+    return SQLITE_OK;
+}
+
+/**
+ * 查询分词：连续的字母切分为音节，其他字符作为分隔
+ */
+int tokenizeQuery(const PinyinTable& table, void* ctx, const char* text, int textLen,
+                  TokenCallback xToken) {
+    int pos = 0;
+    while (pos < textLen) {
+        if (!isAsciiLetter(text[pos])) {
+            ++pos;
+            continue;
+        }
+        int start = pos;
+        std::string letters;
+        while (pos < textLen && isAsciiLetter(text[pos])) {
+            letters += static_cast<char>(text[pos] | 0x20);
+            ++pos;
+        }
+
+        int offset = start;
+        for (const auto& syllable : table.splitSyllables(letters)) {
+            int end = offset + static_cast<int>(syllable.size());
+            int rc = xToken(ctx, 0, syllable.data(), static_cast<int>(syllable.size()), offset, end);
+            if (rc != SQLITE_OK) {
+                return rc;
+            }
+            offset = end;
+        }
+    }
+    return SQLITE_OK;
+}
+
+/**
+ * 按查询分词的方式切分关键词（连续的字母切分为音节，其他字符作为分隔）
+ */
+std::vector<std::string> splitQuery(const PinyinTable& table, const std::string& keyword) {
+    std::vector<std::string> syllables;
+    std::string letters;
+    for (size_t pos = 0; pos <= keyword.size(); ++pos) {
+        if (pos < keyword.size() && isAsciiLetter(keyword[pos])) {
+            letters += static_cast<char>(keyword[pos] | 0x20);
+            continue;
+        }
+        if (!letters.empty()) {
+            for (auto& syllable : table.splitSyllables(letters)) {
+                syllables.push_back(std::move(syllable));
+            }
+            letters.clear();
+        }
+    }
+    return syllables;
+}
+
+int xTokenize(Fts5Tokenizer* tokenizer, void* ctx, int flags, const char* text, int textLen,
+              TokenCallback xToken) {
+    auto* instance = reinterpret_cast<TokenizerInstance*>(tokenizer);
+    if (!text || textLen <= 0) {
+        return SQLITE_OK;
+    }
+    if (flags & FTS5_TOKENIZE_QUERY) {
+        return tokenizeQuery(*instance->table, ctx, text, textLen, xToken);
+    }
+    return tokenizeDocument(*instance->table, ctx, text, textLen, xToken);
+}
+
+/**
+ * 获取连接的 FTS5 API（SQLite 未启用 FTS5 时返回 nullptr）
+ */
+fts5_api* getFts5Api(sqlite3* db) {
+    fts5_api* api = nullptr;
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, "SELECT fts5(?1)", -1, &stmt, nullptr) == SQLITE_OK) {
+        sqlite3_bind_pointer(stmt, 1, &api, "fts5_api_ptr", nullptr);
+        sqlite3_step(stmt);
+    }
+    sqlite3_finalize(stmt);
+    return api;
+}
+
+} // anonymous namespace
+
+bool PinyinTokenizer::registerTokenizer(sqlite3* db) {
+    fts5_api* api = getFts5Api(db);
+    if (!api) {
+        std::cerr << "PinyinTokenizer: SQLite 未启用 FTS5" << std::endl;
+        return false;
+    }
+
+    fts5_tokenizer tokenizer{xCreate, xDelete, xTokenize};
+    int rc = api->xCreateTokenizer(api, kName, &PinyinTable::instance(), &tokenizer, nullptr);
+    if (rc != SQLITE_OK) {
+        std::cerr << "PinyinTokenizer: 注册分词器失败: " << sqlite3_errstr(rc) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool PinyinTokenizer::isPinyinQuery(const std::string& keyword) {
+    bool hasLetter = false;
+    for (char c : keyword) {
+        if (isAsciiLetter(c)) {
+            hasLetter = true;
+        } else if (c != ' ' && c != '\'') {
+            return false;
+        }
+    }
+    return hasLetter;
+}
+
+std::string PinyinTokenizer::buildQuery(const std::string& keyword) {
+    std::string initials;
+    for (char c : keyword) {
+        if (isAsciiLetter(c)) {
+            if (!initials.empty()) {
+                initials += ' ';
+            }
+            initials += c;
+        }
+    }
+
+    // 关键词只含字母、空格和隔音符，无需转义
+    std::string query = "\"" + keyword + "\"*";
+    if (initials.size() > 1) {
+        query += " OR \"" + initials + "\"*";
+    }
+    return query;
+}
+
+bool PinyinTokenizer::isQueryExtension(const std::string& previous, const std::string& keyword) {
+    if (keyword.compare(0, previous.size(), previous) != 0) {
+        return false;
+    }
+
+    const PinyinTable& table = PinyinTable::instance();
+    auto previousSyllables = splitQuery(table, previous);
+    auto syllables = splitQuery(table, keyword);
+    if (previousSyllables.empty() || previousSyllables.size() > syllables.size()) {
+        return false;
+    }
+
+    // 前面的音节完全相同，最后一个音节按前缀匹配
+    size_t last = previousSyllables.size() - 1;
+    for (size_t i = 0; i < last; ++i) {
+        if (previousSyllables[i] != syllables[i]) {
+            return false;
+        }
+    }
+    return syllables[last].compare(0, previousSyllables[last].size(), previousSyllables[last]) == 0;
+}
+
+} // namespace suyan
@@ -0,0 +1,84 @@
+/**
+ * PinyinTokenizer - 剪贴板拼音搜索的分词器
+ *
+ * 为剪贴板文本建立拼音索引（clipboard_pinyin 表），使拼音和首字母查询
+ * 与中文子串搜索一样由 FTS 索引完成，不需要逐条转换拼音。
+ *
+ * 文档中每个汉字输出一个位置，同位置（colocated）输出全部常用读音和首字母：
+ *   「会议纪要」 → {hui, h} / {yi, y} / {ji, j} / {yao, y}
+ *   「长」       → {chang, zhang, c, z}
+ * 非汉字和读音表未收录的字不输出。
+ *
+ * 查询时把连续的字母切分为音节（见 PinyinTable::splitSyllables），按短语匹配：
+ *   "huiyi" → hui yi，"hyjy" → h y j y，"huiyjy" → hui y j y
+ * 末尾加通配符时最后一个音节按前缀匹配（"huiy"* 可以命中「会议」）。
+ *
+ * 读音来自 PinyinTable，读音表变化后需要重建索引（见 ClipboardStore）。
+ */
+
+#ifndef SUYAN_CLIPBOARD_PINYIN_TOKENIZER_H
+#define SUYAN_CLIPBOARD_PINYIN_TOKENIZER_H
+
+#include <string>
+
+// 前向声明 SQLite
+struct sqlite3;
+
+namespace suyan {
+
+/**
+ * PinyinTokenizer - 分词器注册工具类
+ *
+ * 无状态工具类，所有方法均为静态方法。
+ */
+class PinyinTokenizer {
+public:
+    /**
+     * 分词器名称（建表时 tokenize='suyan_pinyin'）
+     */
+    static constexpr const char* kName = "suyan_pinyin";
+
+    /**
+     * 在数据库连接上注册分词器
+     *
+     * 分词器按连接注册，每次打开数据库后、访问 FTS 表之前都需要调用。
+     * 读音取自 PinyinTable::instance()。
+     *
+     * @param db 数据库连接
+     * @return 是否成功（SQLite 未启用 FTS5 时返回 false）
+     */
+    static bool registerTokenizer(sqlite3* db);
+
+    /**
+     * 判断关键词是否可能是拼音（只含英文字母、空格和隔音符 '）
+     */
+    static bool isPinyinQuery(const std::string& keyword);
+
+    /**
+     * 构造拼音索引的 FTS5 查询
+     *
+     * 同时按全拼切分和逐个首字母两种方式匹配（如 "ba" 既可能是「吧」也可能是「不安」），
+     * 最后一个音节按前缀匹配：
+     *   "hyjy" → "hyjy"* OR "h y j y"*
+     *
+     * @param keyword 拼音关键词（isPinyinQuery 为 true）
+     * @return FTS5 查询表达式
+     */
+    static std::string buildQuery(const std::string& keyword);
+
+    /**
+     * 判断拼音查询是否只是在上一次查询之后继续输入
+     *
+     * 两次查询切分出的音节，前面的完全相同，上一次的最后一个音节是新查询对应音节的前缀时，
+     * 新查询的匹配是上一次匹配的子集（"huiy" → "huiyi"：hui / y → hui / yi）。
+     * 继续输入可能改变之前的切分（"fang" → "fange"：fang → fan / ge），此时返回 false。
+     *
+     * @param previous 上一次的拼音关键词
+     * @param keyword 新的拼音关键词（以 previous 开头）
+     */
+    static bool isQueryExtension(const std::string& previous, const std::string& keyword);
+};
+
+} // namespace suyan
+
+#endif // SUYAN_CLIPBOARD_PINYIN_TOKENIZER_H
@@ -7,7 +7,7 @@
  * 实现细节：
  * - 使用 QTimer 进行定时轮询（默认 500ms 间隔）
  * - 通过 NSPasteboard changeCount 检测变化
- * - 使用 QCryptographicHash 计算 SHA-256 哈希
+ * - 读取后只计算预筛键（ContentFingerprint），完整指纹在入库线程计算
  * - 通过 NSWorkspace 获取前台应用信息
  */
 
@@ -77,16 +77,6 @@ private:
      */
     ClipboardContent readClipboard();
     
-    /**
-     * 计算内容哈希值
-     *
-     * 使用 SHA-256 算法计算内容的哈希值。
-     *
-     * @param content 剪贴板内容
-     * @return 哈希值（十六进制字符串）
-     */
-    std::string calculateHash(const ClipboardContent& content);
-    
     /**
      * 获取当前剪贴板 changeCount
      *
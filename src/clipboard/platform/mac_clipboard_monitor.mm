@@ -5,7 +5,7 @@
  */
 
 #include "mac_clipboard_monitor.h"
-#include <QCryptographicHash>
+#include "content_fingerprint.h"
 #include <QDebug>
 
 #import <AppKit/AppKit.h>
@@ -135,8 +135,8 @@ void MacClipboardMonitor::onPollTimer()
         ClipboardContent content = readClipboard();
         
         if (content.isValid()) {
-            // 计算哈希
-            content.contentHash = calculateHash(content);
+            // 计算预筛键（完整指纹在入库线程按需计算）
+            ContentFingerprint::prepare(content);
             
             // 获取来源应用
             content.sourceApp = getCurrentFrontApp();
@@ -194,23 +194,6 @@ ClipboardContent MacClipboardMonitor::readClipboard()
     return content;
 }
 
-std::string MacClipboardMonitor::calculateHash(const ClipboardContent& content)
-{
-    QCryptographicHash hash(QCryptographicHash::Sha256);
-    
-    if (content.type == MonitorContentType::Text) {
-        hash.addData(QByteArray::fromRawData(content.textData.data(), 
-                                              static_cast<int>(content.textData.size())));
-    } else if (content.type == MonitorContentType::Image) {
-        hash.addData(QByteArray::fromRawData(
-            reinterpret_cast<const char*>(content.imageData.data()),
-            static_cast<int>(content.imageData.size())
-        ));
-    }
-    
-    return hash.result().toHex().toStdString();
-}
-
 int MacClipboardMonitor::getChangeCount()
 {
     @autoreleasepool {
@@ -0,0 +1,208 @@
+/**
+ * TextStorage 实现
+ *
+ * 使用 Qt 的 qCompress（zlib）压缩分块，QCryptographicHash 计算块哈希。
+ */
+
+#include "text_storage.h"
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QFile>
+#include <filesystem>
+#include <iostream>
+#include <algorithm>
+
+namespace fs = std::filesystem;
+
+namespace suyan {
+
+namespace {
+
+// 分块文件扩展名
+constexpr const char* kChunkExtension = ".z";
+
+} // anonymous namespace
+
+// ========== 单例实现 ==========
+
+TextStorage& TextStorage::instance() {
+    static TextStorage instance;
+    return instance;
+}
+
+// ========== 初始化和关闭 ==========
+
+bool TextStorage::initialize(const std::string& baseDir) {
+    if (initialized_) {
+        // 如果已初始化且路径相同，直接返回成功
+        if (baseDir_ == baseDir) {
+            return true;
+        }
+        // 路径不同，先关闭
+        shutdown();
+    }
+
+    baseDir_ = baseDir;
+    textsDir_ = baseDir + "/texts";
+
+    // 创建目录
+    try {
+        fs::create_directories(textsDir_);
+    } catch (const std::exception& e) {
+        std::cerr << "TextStorage: 创建目录失败: " << e.what() << std::endl;
+        return false;
+    }
+
+    initialized_ = true;
+    return true;
+}
+
+void TextStorage::shutdown() {
+    initialized_ = false;
+    baseDir_.clear();
+    textsDir_.clear();
+}
+
+// ========== 存储操作 ==========
+
+TextStorageResult TextStorage::saveText(const std::string& text) {
+    TextStorageResult result;
+
+    if (!initialized_) {
+        result.errorMessage = "TextStorage 未初始化";
+        return result;
+    }
+
+    if (text.empty()) {
+        result.errorMessage = "文本为空";
+        return result;
+    }
+
+    for (size_t offset = 0; offset < text.size(); offset += kChunkSize) {
+        size_t length = std::min(kChunkSize, text.size() - offset);
+        QByteArray chunk = QByteArray::fromRawData(text.data() + offset, static_cast<qsizetype>(length));
+        std::string chunkHash = QCryptographicHash::hash(chunk, QCryptographicHash::Sha256)
+                                    .toHex().toStdString();
+        std::string chunkPath = getChunkPath(chunkHash);
+
+        // 内容寻址：相同的块已存在时直接复用
+        std::error_code ec;
+        auto existingSize = fs::file_size(chunkPath, ec);
+        if (!ec) {
+            result.compressedSize += static_cast<int64_t>(existingSize);
+        } else {
+            QByteArray compressed = qCompress(chunk);
+
+            // 先写临时文件再重命名，避免留下不完整的分块
+            std::string tempPath = chunkPath + ".tmp";
+            QFile file(QString::fromStdString(tempPath));
+            if (!file.open(QIODevice::WriteOnly) ||
+                file.write(compressed) != compressed.size()) {
+                file.close();
+                fs::remove(tempPath, ec);
+                result.errorMessage = "写入分块失败: " + tempPath;
+                return result;
+            }
+            file.close();
+
+            fs::rename(tempPath, chunkPath, ec);
+            if (ec) {
+                fs::remove(tempPath, ec);
+                result.errorMessage = "写入分块失败: " + chunkPath;
+                return result;
+            }
+            result.compressedSize += compressed.size();
+        }
+
+        if (!result.chunks.empty()) {
+            result.chunks += ',';
+        }
+        result.chunks += chunkHash;
+    }
+
+    result.success = true;
+    return result;
+}
+
+std::string TextStorage::loadText(const std::string& chunks) {
+    std::string text;
+
+    if (!initialized_) {
+        return text;
+    }
+
+    for (const auto& chunkHash : parseChunkList(chunks)) {
+        QFile file(QString::fromStdString(getChunkPath(chunkHash)));
+        if (!file.open(QIODevice::ReadOnly)) {
+            std::cerr << "TextStorage: 分块不存在: " << chunkHash << std::endl;
+            return std::string();
+        }
+
+        QByteArray chunk = qUncompress(file.readAll());
+        file.close();
+        if (chunk.isEmpty()) {
+            std::cerr << "TextStorage: 分块已损坏: " << chunkHash << std::endl;
+            return std::string();
+        }
+        text.append(chunk.constData(), static_cast<size_t>(chunk.size()));
+    }
+
+    return text;
+}
+
+bool TextStorage::deleteChunks(const std::vector<std::string>& chunkHashes) {
+    if (!initialized_) {
+        return false;
+    }
+
+    bool success = true;
+    for (const auto& chunkHash : chunkHashes) {
+        std::error_code ec;
+        fs::remove(getChunkPath(chunkHash), ec);
+        if (ec) {
+            std::cerr << "TextStorage: 删除分块失败: " << ec.message() << std::endl;
+            success = false;
+        }
+    }
+    return success;
+}
+
+std::string TextStorage::getChunkPath(const std::string& chunkHash) const {
+    return textsDir_ + "/" + chunkHash + kChunkExtension;
+}
+
+int64_t TextStorage::getStorageSize() {
+    if (!initialized_) {
+        return 0;
+    }
+
+    int64_t totalSize = 0;
+    try {
+        for (const auto& entry : fs::directory_iterator(textsDir_)) {
+            if (entry.is_regular_file()) {
+                totalSize += static_cast<int64_t>(entry.file_size());
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "TextStorage: 计算目录大小失败: " << e.what() << std::endl;
+    }
+    return totalSize;
+}
+
+std::vector<std::string> TextStorage::parseChunkList(const std::string& chunks) {
+    std::vector<std::string> hashes;
+    size_t start = 0;
+    while (start < chunks.size()) {
+        size_t end = chunks.find(',', start);
+        if (end == std::string::npos) {
+            end = chunks.size();
+        }
+        if (end > start) {
+            hashes.push_back(chunks.substr(start, end - start));
+        }
+        start = end + 1;
+    }
+    return hashes;
+}
+
+} // namespace suyan
@@ -0,0 +1,151 @@
+/**
+ * TextStorage - 大文本存储层
+ *
+ * 超过 MAX_TEXT_LENGTH 的文本（日志、大段代码等）不存入数据库，
+ * 按固定大小分块，每块 zlib 压缩后存为文件，文件名为块内容的 SHA-256（内容寻址）。
+ * 相同的块只存一份：不断追加的日志多次复制时，前面未变的块可以共享。
+ *
+ * 数据库记录只保存预览和分块清单（块哈希，逗号分隔），
+ * FTS 只索引预览，大文本不会增大主数据库，也不会拖慢搜索。
+ *
+ * 功能：
+ * - 文本分块压缩存储
+ * - 按分块清单读取完整文本
+ * - 分块文件删除
+ * - 存储空间统计
+ */
+
+#ifndef SUYAN_CLIPBOARD_TEXT_STORAGE_H
+#define SUYAN_CLIPBOARD_TEXT_STORAGE_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace suyan {
+
+/**
+ * 大文本存储结果
+ */
+struct TextStorageResult {
+    bool success = false;           // 是否成功
+    std::string chunks;             // 分块清单（块哈希，逗号分隔）
+    int64_t compressedSize = 0;     // 压缩后的总大小（字节，含与其他记录共享的块）
+    std::string errorMessage;       // 错误信息（失败时）
+};
+
+/**
+ * TextStorage - 大文本存储类
+ *
+ * 单例模式，管理大文本分块文件的存储。
+ */
+class TextStorage {
+public:
+    /**
+     * 获取单例实例
+     */
+    static TextStorage& instance();
+
+    /**
+     * 每块的原文大小（字节）
+     */
+    static constexpr size_t kChunkSize = 256 * 1024;
+
+    // 禁止拷贝和移动
+    TextStorage(const TextStorage&) = delete;
+    TextStorage& operator=(const TextStorage&) = delete;
+    TextStorage(TextStorage&&) = delete;
+    TextStorage& operator=(TextStorage&&) = delete;
+
+    /**
+     * 初始化存储目录
+     *
+     * 创建 texts/ 子目录。
+     *
+     * @param baseDir 基础目录路径（如 ~/Library/Application Support/SuYan/clipboard）
+     * @return 是否成功
+     */
+    bool initialize(const std::string& baseDir);
+
+    /**
+     * 关闭存储
+     */
+    void shutdown();
+
+    /**
+     * 检查是否已初始化
+     */
+    bool isInitialized() const { return initialized_; }
+
+    /**
+     * 获取分块目录
+     */
+    std::string getTextsDir() const { return textsDir_; }
+
+    // ========== 存储操作 ==========
+
+    /**
+     * 存储文本
+     *
+     * 按 kChunkSize 分块压缩，已存在的块不重复写入。
+     *
+     * @param text 文本内容
+     * @return 存储结果
+     */
+    TextStorageResult saveText(const std::string& text);
+
+    /**
+     * 读取文本
+     *
+     * @param chunks 分块清单
+     * @return 完整文本，任一分块缺失或损坏时返回空字符串
+     */
+    std::string loadText(const std::string& chunks);
+
+    /**
+     * 删除分块文件
+     *
+     * 分块可能被多条记录共享，调用方需先确认不再被引用。
+     *
+     * @param chunkHashes 块哈希列表
+     * @return 是否成功
+     */
+    bool deleteChunks(const std::vector<std::string>& chunkHashes);
+
+    /**
+     * 获取分块文件路径
+     *
+     * @param chunkHash 块哈希
+     * @return 文件路径
+     */
+    std::string getChunkPath(const std::string& chunkHash) const;
+
+    /**
+     * 获取存储目录总大小
+     *
+     * @return 总大小（字节）
+     */
+    int64_t getStorageSize();
+
+    /**
+     * 解析分块清单
+     *
+     * @param chunks 分块清单（块哈希，逗号分隔）
+     * @return 块哈希列表
+     */
+    static std::vector<std::string> parseChunkList(const std::string& chunks);
+
+private:
+    TextStorage() = default;
+    ~TextStorage() = default;
+
+    // 成员变量
+    bool initialized_ = false;
+    std::string baseDir_;
+    std::string textsDir_;
+};
+
+} // namespace suyan
+
+#endif // SUYAN_CLIPBOARD_TEXT_STORAGE_H
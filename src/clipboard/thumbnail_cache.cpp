@@ -0,0 +1,551 @@
+/**
+ * ThumbnailCache 实现
+ *
+ * 图集通过 QFile::map 映射，追加条目后重新映射整个文件。
+ * 读取条目时复制像素（几 KB），映射随时可以失效，QPixmap 不引用映射内存。
+ * 图集只追加，已写入的字节在替换或清空之前不变，compact 可以不持锁读取。
+ */
+
+#include "thumbnail_cache.h"
+#include "image_storage.h"
+#include <QImage>
+#include <QByteArray>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+namespace suyan {
+
+namespace {
+
+// 文件头：magic "SYTA" 和版本号，格式不符时丢弃重建
+constexpr uint32_t kAtlasMagic = 0x41545953;
+constexpr uint32_t kAtlasVersion = 1;
+constexpr qint64 kFileHeaderSize = 8;
+
+// 条目头：magic "SYTE"、键长、宽、高
+constexpr uint32_t kEntryMagic = 0x45545953;
+constexpr qint64 kEntryHeaderSize = 16;
+
+// 条目尺寸上限（扫描时用于识别损坏的条目头）
+constexpr uint32_t kMaxEntryDimension = 1024;
+
+// LRU 容量（像素字节数），约 400 张显示尺寸的缩略图
+constexpr int kPixmapCacheBytes = 4 * 1024 * 1024;
+
+struct EntryHeader {
+    uint32_t magic;
+    uint32_t keyLength;
+    uint32_t width;
+    uint32_t height;
+};
+static_assert(sizeof(EntryHeader) == kEntryHeaderSize, "EntryHeader 布局");
+
+qint64 paddedKeyLength(qint64 keyLength) {
+    return (keyLength + 3) & ~qint64(3);
+}
+
+qint64 pixelBytes(int width, int height) {
+    return static_cast<qint64>(width) * height * 4;
+}
+
+} // anonymous namespace
+
+// ========== 单例实现 ==========
+
+ThumbnailCache& ThumbnailCache::instance() {
+    static ThumbnailCache instance;
+    return instance;
+}
+
+ThumbnailCache::ThumbnailCache() {
+    pixmaps_.setMaxCost(kPixmapCacheBytes);
+}
+
+ThumbnailCache::~ThumbnailCache() {
+    stopLoader();
+}
+
+// ========== 初始化和关闭 ==========
+
+bool ThumbnailCache::initialize(const std::string& atlasPath) {
+    stopLoader();
+    pixmaps_.clear();
+
+    bool opened;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closeAtlas();
+        missing_.clear();
+        atlasPath_ = atlasPath;
+        opened = openAtlas();
+    }
+    startLoader();
+    return opened;
+}
+
+void ThumbnailCache::shutdown() {
+    stopLoader();
+    pixmaps_.clear();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    closeAtlas();
+    missing_.clear();
+    atlasPath_.clear();
+}
+
+bool ThumbnailCache::isInitialized() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return mapped_ != nullptr;
+}
+
+// ========== 查询 ==========
+
+QPixmap ThumbnailCache::pixmap(const std::string& thumbnailPath) {
+    if (thumbnailPath.empty()) {
+        return QPixmap();
+    }
+
+    // LRU 只在 UI 线程访问，不需要加锁
+    QString cacheKey = QString::fromStdString(thumbnailPath);
+    if (QPixmap* cached = pixmaps_.object(cacheKey)) {
+        return *cached;
+    }
+
+    QImage image;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(thumbnailPath);
+        if (it != index_.end()) {
+            image = readEntry(it->second);
+        } else if (missing_.count(thumbnailPath)) {
+            return QPixmap();
+        } else if (auto decoded = decoded_.find(thumbnailPath); decoded != decoded_.end()) {
+            image = std::move(decoded->second);
+            decoded_.erase(decoded);
+        } else {
+            // 图集中没有（后台同步之前的旧记录）：交给加载线程解码并写入图集，先显示占位
+            requestLoad(thumbnailPath);
+            return QPixmap();
+        }
+    }
+
+    auto* pixmap = new QPixmap(QPixmap::fromImage(image));
+    QPixmap result = *pixmap;
+    pixmaps_.insert(cacheKey, pixmap, static_cast<int>(pixelBytes(image.width(), image.height())));
+    return result;
+}
+
+bool ThumbnailCache::ensure(const std::string& thumbnailPath) {
+    if (thumbnailPath.empty()) {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!mapped_ || missing_.count(thumbnailPath)) {
+            return false;
+        }
+        if (index_.count(thumbnailPath)) {
+            return true;
+        }
+    }
+
+    // 解码时不持有锁，不阻塞 UI 线程读取其他条目
+    QImage image = loadDisplayImage(thumbnailPath);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (image.isNull()) {
+        missing_.insert(thumbnailPath);
+        return false;
+    }
+    if (!mapped_) {
+        return false;
+    }
+    return index_.count(thumbnailPath) > 0 || appendEntry(thumbnailPath, image);
+}
+
+void ThumbnailCache::setReadyHandler(ReadyHandler handler) {
+    std::lock_guard<std::mutex> lock(handlerMutex_);
+    readyHandler_ = std::move(handler);
+}
+
+void ThumbnailCache::waitForIdle() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idleCondition_.wait(lock, [this] {
+        return !loaderRunning_ || loading_.empty();
+    });
+}
+
+bool ThumbnailCache::contains(const std::string& thumbnailPath) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return index_.count(thumbnailPath) > 0;
+}
+
+size_t ThumbnailCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return index_.size();
+}
+
+int64_t ThumbnailCache::getAtlasSize() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return mappedSize_;
+}
+
+// ========== 维护 ==========
+
+bool ThumbnailCache::compact(const std::vector<std::string>& liveThumbnailPaths) {
+    // 持锁选出有效条目（去重）在图集中的范围：条目头、键、像素连续存放，整段复制
+    struct Range {
+        qint64 start;
+        qint64 length;
+    };
+    std::vector<Range> ranges;
+    std::string atlasPath;
+    qint64 snapshotSize;
+    uint64_t generation;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!mapped_) {
+            return false;
+        }
+
+        std::unordered_set<std::string> seen;
+        qint64 liveBytes = kFileHeaderSize;
+        for (const auto& path : liveThumbnailPaths) {
+            auto it = index_.find(path);
+            if (it == index_.end() || !seen.insert(path).second) {
+                continue;
+            }
+            const Entry& entry = it->second;
+            qint64 start = entry.offset - paddedKeyLength(static_cast<qint64>(path.size())) -
+                           kEntryHeaderSize;
+            qint64 length = entry.offset + pixelBytes(entry.width, entry.height) - start;
+            ranges.push_back(Range{start, length});
+            liveBytes += length;
+        }
+
+        // 无用条目不到一半时不重写
+        if (liveBytes * 2 > mappedSize_) {
+            return false;
+        }
+        atlasPath = atlasPath_;
+        snapshotSize = mappedSize_;
+        generation = atlasGeneration_;
+    }
+
+    // 不持锁写入临时文件：另开只读映射，快照范围内的字节在图集替换或清空之前不变
+    std::string tempPath = atlasPath + ".tmp";
+    QFile source(QString::fromStdString(atlasPath));
+    uchar* snapshot = source.open(QIODevice::ReadOnly) ? source.map(0, snapshotSize) : nullptr;
+    if (!snapshot) {
+        std::cerr << "ThumbnailCache: 映射图集失败: " << atlasPath << std::endl;
+        return false;
+    }
+    QFile temp(QString::fromStdString(tempPath));
+    if (!temp.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        std::cerr << "ThumbnailCache: 创建临时图集失败: " << tempPath << std::endl;
+        return false;
+    }
+    bool ok = temp.write(reinterpret_cast<const char*>(snapshot), kFileHeaderSize) == kFileHeaderSize;
+    for (const auto& range : ranges) {
+        if (!ok) {
+            break;
+        }
+        ok = temp.write(reinterpret_cast<const char*>(snapshot + range.start), range.length) == range.length;
+    }
+    source.unmap(snapshot);
+    source.close();
+
+    // 持锁替换：图集在写入期间被清空或替换时放弃，期间追加的条目接到末尾
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (ok && (generation != atlasGeneration_ || !mapped_)) {
+        temp.close();
+        temp.remove();
+        return false;
+    }
+    if (ok && mappedSize_ > snapshotSize) {
+        qint64 length = mappedSize_ - snapshotSize;
+        ok = temp.write(reinterpret_cast<const char*>(mapped_ + snapshotSize), length) == length;
+    }
+    temp.close();
+    if (!ok) {
+        std::cerr << "ThumbnailCache: 写入临时图集失败" << std::endl;
+        temp.remove();
+        return false;
+    }
+
+    closeAtlas();
+    std::error_code ec;
+    fs::rename(tempPath, atlasPath_, ec);
+    bool replaced = !ec;
+    if (!replaced) {
+        std::cerr << "ThumbnailCache: 替换图集失败: " << ec.message() << std::endl;
+        fs::remove(tempPath, ec);
+    }
+    openAtlas();
+    return replaced;
+}
+
+void ThumbnailCache::clear() {
+    pixmaps_.clear();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    missing_.clear();
+    decoded_.clear();
+    if (atlasPath_.empty()) {
+        return;
+    }
+    closeAtlas();
+    std::error_code ec;
+    fs::remove(atlasPath_, ec);
+    openAtlas();
+}
+
+// ========== 私有方法 ==========
+
+bool ThumbnailCache::openAtlas() {
+    atlasFile_.setFileName(QString::fromStdString(atlasPath_));
+    if (!atlasFile_.open(QIODevice::ReadWrite)) {
+        std::cerr << "ThumbnailCache: 打开图集失败: " << atlasPath_ << std::endl;
+        return false;
+    }
+    if (!mapAndIndex()) {
+        std::cerr << "ThumbnailCache: 映射图集失败: " << atlasPath_ << std::endl;
+        closeAtlas();
+        return false;
+    }
+    return true;
+}
+
+bool ThumbnailCache::mapAndIndex() {
+    index_.clear();
+
+    // 新文件或格式不符：重写文件头
+    auto resetAtlas = [this]() {
+        const uint32_t header[2] = {kAtlasMagic, kAtlasVersion};
+        return atlasFile_.resize(0) && atlasFile_.seek(0) &&
+               atlasFile_.write(reinterpret_cast<const char*>(header), kFileHeaderSize) == kFileHeaderSize &&
+               atlasFile_.flush();
+    };
+
+    if (atlasFile_.size() < kFileHeaderSize && !resetAtlas()) {
+        return false;
+    }
+    mappedSize_ = atlasFile_.size();
+    mapped_ = atlasFile_.map(0, mappedSize_);
+    if (!mapped_) {
+        return false;
+    }
+
+    uint32_t header[2];
+    std::memcpy(header, mapped_, sizeof(header));
+    if (header[0] != kAtlasMagic || header[1] != kAtlasVersion) {
+        atlasFile_.unmap(mapped_);
+        mapped_ = nullptr;
+        if (!resetAtlas()) {
+            return false;
+        }
+        mappedSize_ = kFileHeaderSize;
+        mapped_ = atlasFile_.map(0, mappedSize_);
+        return mapped_ != nullptr;
+    }
+
+    // 扫描条目头建立索引，同一键后写入的覆盖先写入的
+    qint64 pos = kFileHeaderSize;
+    while (pos + kEntryHeaderSize <= mappedSize_) {
+        EntryHeader entryHeader;
+        std::memcpy(&entryHeader, mapped_ + pos, sizeof(entryHeader));
+        if (entryHeader.magic != kEntryMagic ||
+            entryHeader.width == 0 || entryHeader.width > kMaxEntryDimension ||
+            entryHeader.height == 0 || entryHeader.height > kMaxEntryDimension) {
+            break;
+        }
+        qint64 keyBytes = paddedKeyLength(entryHeader.keyLength);
+        int width = static_cast<int>(entryHeader.width);
+        int height = static_cast<int>(entryHeader.height);
+        qint64 next = pos + kEntryHeaderSize + keyBytes + pixelBytes(width, height);
+        if (next > mappedSize_) {
+            break;
+        }
+        std::string key(reinterpret_cast<const char*>(mapped_ + pos + kEntryHeaderSize),
+                        entryHeader.keyLength);
+        index_[key] = Entry{pos + kEntryHeaderSize + keyBytes, width, height};
+        pos = next;
+    }
+
+    // 截掉末尾不完整的条目（写入时中断）
+    if (pos < mappedSize_) {
+        std::cerr << "ThumbnailCache: 截掉图集末尾 " << (mappedSize_ - pos) << " 字节" << std::endl;
+        atlasFile_.unmap(mapped_);
+        mapped_ = nullptr;
+        if (!atlasFile_.resize(pos)) {
+            return false;
+        }
+        mappedSize_ = pos;
+        mapped_ = atlasFile_.map(0, mappedSize_);
+    }
+    return mapped_ != nullptr;
+}
+
+void ThumbnailCache::closeAtlas() {
+    if (mapped_) {
+        atlasFile_.unmap(mapped_);
+        mapped_ = nullptr;
+    }
+    if (atlasFile_.isOpen()) {
+        atlasFile_.close();
+    }
+    mappedSize_ = 0;
+    index_.clear();
+    ++atlasGeneration_;
+}
+
+void ThumbnailCache::startLoader() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (loaderRunning_) {
+        return;
+    }
+
+    loaderStopping_ = false;
+    loaderRunning_ = true;
+    loader_ = std::thread(&ThumbnailCache::runLoader, this);
+}
+
+void ThumbnailCache::stopLoader() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!loaderRunning_) {
+            return;
+        }
+        loaderStopping_ = true;
+    }
+    loadCondition_.notify_one();
+
+    if (loader_.joinable()) {
+        loader_.join();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    loaderRunning_ = false;
+    loadQueue_.clear();
+    loading_.clear();
+    decoded_.clear();
+    idleCondition_.notify_all();
+}
+
+void ThumbnailCache::runLoader() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        loadCondition_.wait(lock, [this] {
+            return loaderStopping_ || !loadQueue_.empty();
+        });
+
+        if (loaderStopping_) {
+            break;
+        }
+
+        // 最近请求的先加载（快速滚动时当前可见的行优先）
+        std::string thumbnailPath = std::move(loadQueue_.back());
+        loadQueue_.pop_back();
+
+        lock.unlock();
+        QImage image = loadDisplayImage(thumbnailPath);
+        lock.lock();
+
+        bool loaded = !image.isNull();
+        if (!loaded) {
+            missing_.insert(thumbnailPath);
+        } else if (!index_.count(thumbnailPath) && (!mapped_ || !appendEntry(thumbnailPath, image))) {
+            decoded_[thumbnailPath] = std::move(image);
+        }
+
+        // 通知时不持有 mutex_，处理函数可以调用缓存的其他接口
+        lock.unlock();
+        if (loaded) {
+            std::lock_guard<std::mutex> handlerLock(handlerMutex_);
+            if (readyHandler_) {
+                readyHandler_(thumbnailPath);
+            }
+        }
+        lock.lock();
+
+        loading_.erase(thumbnailPath);
+        if (loading_.empty()) {
+            idleCondition_.notify_all();
+        }
+    }
+
+    // 唤醒停止期间仍在等待的调用方
+    idleCondition_.notify_all();
+}
+
+void ThumbnailCache::requestLoad(const std::string& thumbnailPath) {
+    if (!loaderRunning_ || loaderStopping_ || !loading_.insert(thumbnailPath).second) {
+        return;
+    }
+
+    // 队列已满：丢弃最早的请求（多半已滚出可见范围，重新显示时再次请求）
+    if (loadQueue_.size() >= kMaxPendingLoads) {
+        loading_.erase(loadQueue_.front());
+        loadQueue_.pop_front();
+    }
+    loadQueue_.push_back(thumbnailPath);
+    loadCondition_.notify_one();
+}
+
+QImage ThumbnailCache::loadDisplayImage(const std::string& thumbnailPath) {
+    QImage source(QString::fromStdString(ImageStorage::instance().resolvePath(thumbnailPath)));
+    if (source.isNull()) {
+        return QImage();
+    }
+    return source.scaled(kDisplayWidth, kDisplayHeight, Qt::KeepAspectRatio, Qt::SmoothTransformation)
+                 .convertToFormat(QImage::Format_ARGB32_Premultiplied);
+}
+
+bool ThumbnailCache::appendEntry(const std::string& key, const QImage& image) {
+    const int width = image.width();
+    const int height = image.height();
+    const qint64 keyBytes = paddedKeyLength(static_cast<qint64>(key.size()));
+    const qint64 rowBytes = static_cast<qint64>(width) * 4;
+
+    EntryHeader header{kEntryMagic, static_cast<uint32_t>(key.size()),
+                       static_cast<uint32_t>(width), static_cast<uint32_t>(height)};
+    QByteArray data;
+    data.reserve(static_cast<int>(kEntryHeaderSize + keyBytes + pixelBytes(width, height)));
+    data.append(reinterpret_cast<const char*>(&header), kEntryHeaderSize);
+    data.append(key.data(), static_cast<int>(key.size()));
+    data.append(QByteArray(static_cast<int>(keyBytes - static_cast<qint64>(key.size())), '\0'));
+    for (int y = 0; y < height; ++y) {
+        data.append(reinterpret_cast<const char*>(image.constScanLine(y)), static_cast<int>(rowBytes));
+    }
+
+    if (!atlasFile_.seek(mappedSize_) || atlasFile_.write(data) != data.size() || !atlasFile_.flush()) {
+        std::cerr << "ThumbnailCache: 写入图集失败" << std::endl;
+        atlasFile_.resize(mappedSize_);
+        return false;
+    }
+
+    // 重新映射整个文件（只在新缩略图写入时发生）
+    qint64 offset = mappedSize_ + kEntryHeaderSize + keyBytes;
+    atlasFile_.unmap(mapped_);
+    mappedSize_ += data.size();
+    mapped_ = atlasFile_.map(0, mappedSize_);
+    if (!mapped_) {
+        std::cerr << "ThumbnailCache: 重新映射图集失败" << std::endl;
+        closeAtlas();
+        return false;
+    }
+    index_[key] = Entry{offset, width, height};
+    return true;
+}
+
+QImage ThumbnailCache::readEntry(const Entry& entry) const {
+    // 复制像素，映射在追加条目后会失效
+    return QImage(mapped_ + entry.offset, entry.width, entry.height, entry.width * 4,
+                  QImage::Format_ARGB32_Premultiplied).copy();
+}
+
+} // namespace suyan
@@ -0,0 +1,247 @@
+/**
+ * ThumbnailCache - 剪贴板列表的缩略图缓存
+ *
+ * 列表项按显示尺寸绘制缩略图，滚动时不读取文件、不解码图片：
+ * - 图集文件（thumbnails.atlas）：只追加，按显示尺寸保存预乘 ARGB32 原始像素，
+ *   通过内存映射读取，条目头即索引，打开时扫描一遍建立内存索引
+ * - QPixmap LRU：最近显示的缩略图，命中时直接返回
+ *
+ * 新图片入库时在工作线程写入图集（见 ensure），旧记录在后台同步，
+ * 列表项绘制时调用 pixmap 只做一次内存拷贝；图集中还没有的缩略图交给加载线程解码，
+ * 先显示占位，加载完成后通知重绘（见 setReadyHandler）。
+ * 删除的记录在图集中留下无用条目，无用条目超过一半时由 compact 重写。
+ *
+ * 图集条目格式（本机字节序，文件头为 magic 和版本号）：
+ *   uint32 magic | uint32 键长 | uint32 宽 | uint32 高 | 键（补齐到 4 字节）| 宽×高×4 字节像素
+ */
+
+#ifndef SUYAN_CLIPBOARD_THUMBNAIL_CACHE_H
+#define SUYAN_CLIPBOARD_THUMBNAIL_CACHE_H
+
+#include <QCache>
+#include <QFile>
+#include <QImage>
+#include <QPixmap>
+#include <QString>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace suyan {
+
+/**
+ * ThumbnailCache - 单例缩略图缓存
+ *
+ * 图集读写可在任意线程调用（内部加锁）；pixmap、clear 涉及 QPixmap，只能在 UI 线程调用。
+ * 缓存键为记录中的缩略图路径（按内容哈希命名，同一路径的内容不变）。
+ */
+class ThumbnailCache {
+public:
+    /**
+     * 显示尺寸（与列表项缩略图区域一致）
+     */
+    static constexpr int kDisplayWidth = 60;
+    static constexpr int kDisplayHeight = 40;
+
+    /**
+     * 最多排队的后台加载数（快速滚动时丢弃最早的请求，重新显示时再次请求）
+     */
+    static constexpr size_t kMaxPendingLoads = 64;
+
+    /**
+     * 后台加载完成的通知（在加载线程调用，需要重绘时由调用方投递回 UI 线程）
+     */
+    using ReadyHandler = std::function<void(const std::string& thumbnailPath)>;
+
+    /**
+     * 获取单例实例
+     */
+    static ThumbnailCache& instance();
+
+    // 禁止拷贝和移动
+    ThumbnailCache(const ThumbnailCache&) = delete;
+    ThumbnailCache& operator=(const ThumbnailCache&) = delete;
+    ThumbnailCache(ThumbnailCache&&) = delete;
+    ThumbnailCache& operator=(ThumbnailCache&&) = delete;
+
+    /**
+     * 打开图集文件并建立索引，启动加载线程
+     *
+     * 文件不存在时创建；末尾不完整的条目（写入时中断）被截掉。
+     * 失败时缓存仍可使用，缩略图由加载线程从文件解码（不写图集）。
+     *
+     * @param atlasPath 图集文件路径（如 clipboard/thumbnails.atlas）
+     * @return 是否成功
+     */
+    bool initialize(const std::string& atlasPath);
+
+    /**
+     * 停止加载线程，关闭图集，清空索引和 LRU（UI 线程调用）
+     */
+    void shutdown();
+
+    /**
+     * 检查图集是否已打开
+     */
+    bool isInitialized() const;
+
+    /**
+     * 获取显示尺寸的缩略图（只在 UI 线程调用，不读取文件、不解码）
+     *
+     * 依次查找 LRU 和图集；图集中没有时返回空 QPixmap 并请求加载线程解码、追加到图集，
+     * 完成后通知 ReadyHandler，再次调用即可取得。
+     * 文件不存在或无法解码时返回空 QPixmap，之后不再重试。
+     *
+     * @param thumbnailPath 记录中的缩略图路径
+     * @return 缩略图，尚未加载或失败返回空 QPixmap
+     */
+    QPixmap pixmap(const std::string& thumbnailPath);
+
+    /**
+     * 设置后台加载完成的通知
+     *
+     * @param handler 通知函数（传空函数取消）
+     */
+    void setReadyHandler(ReadyHandler handler);
+
+    /**
+     * 等待排队的后台加载全部完成
+     */
+    void waitForIdle();
+
+    /**
+     * 确保图集中有该缩略图（可在工作线程调用，不创建 QPixmap）
+     *
+     * @param thumbnailPath 记录中的缩略图路径
+     * @return 图集中是否有该缩略图
+     */
+    bool ensure(const std::string& thumbnailPath);
+
+    /**
+     * 检查图集中是否有该缩略图
+     */
+    bool contains(const std::string& thumbnailPath) const;
+
+    /**
+     * 压缩图集：无用条目超过一半时只保留仍被引用的缩略图
+     *
+     * 不持锁从图集的只读映射写入临时文件，只在替换图集和重建索引时持锁；
+     * 耗时与有效条目数成正比，在后台线程调用。
+     *
+     * @param liveThumbnailPaths 仍被记录引用的缩略图路径
+     * @return 是否重写了图集
+     */
+    bool compact(const std::vector<std::string>& liveThumbnailPaths);
+
+    /**
+     * 清空图集和 LRU（清空历史时调用，只在 UI 线程调用）
+     */
+    void clear();
+
+    /**
+     * 获取图集中的条目数
+     */
+    size_t size() const;
+
+    /**
+     * 获取图集文件大小（字节）
+     */
+    int64_t getAtlasSize() const;
+
+private:
+    ThumbnailCache();
+    ~ThumbnailCache();
+
+    /**
+     * 图集中的一个条目
+     */
+    struct Entry {
+        qint64 offset = 0;      // 像素数据在图集中的偏移
+        int width = 0;
+        int height = 0;
+    };
+
+    /**
+     * 打开 atlasPath_ 并建立索引（调用方持有 mutex_）
+     */
+    bool openAtlas();
+
+    /**
+     * 映射整个图集文件并扫描条目头建立索引（调用方持有 mutex_）
+     */
+    bool mapAndIndex();
+
+    /**
+     * 解除映射并关闭图集文件（调用方持有 mutex_）
+     */
+    void closeAtlas();
+
+    /**
+     * 启动加载线程
+     */
+    void startLoader();
+
+    /**
+     * 停止加载线程，丢弃排队的请求
+     */
+    void stopLoader();
+
+    /**
+     * 加载线程主循环
+     */
+    void runLoader();
+
+    /**
+     * 请求加载线程解码缩略图（调用方持有 mutex_）
+     */
+    void requestLoad(const std::string& thumbnailPath);
+
+    /**
+     * 解码缩略图文件并缩放到显示尺寸（失败返回空 QImage）
+     */
+    static QImage loadDisplayImage(const std::string& thumbnailPath);
+
+    /**
+     * 追加条目并重新映射（调用方持有 mutex_）
+     */
+    bool appendEntry(const std::string& key, const QImage& image);
+
+    /**
+     * 从图集读取条目的像素副本（调用方持有 mutex_）
+     */
+    QImage readEntry(const Entry& entry) const;
+
+    mutable std::mutex mutex_;
+    std::string atlasPath_;
+    QFile atlasFile_;
+    uchar* mapped_ = nullptr;           // 整个图集的只读映射
+    qint64 mappedSize_ = 0;
+    std::unordered_map<std::string, Entry> index_;
+    std::unordered_set<std::string> missing_;   // 无法加载的缩略图，不再重试
+    uint64_t atlasGeneration_ = 0;              // 图集关闭（替换、清空）时递增
+    QCache<QString, QPixmap> pixmaps_;          // LRU，代价为像素字节数
+
+    // 加载线程（队列与图集共用 mutex_）
+    std::thread loader_;
+    std::condition_variable loadCondition_;     // 有新请求或加载线程停止
+    std::condition_variable idleCondition_;     // 排队的请求处理完成
+    std::deque<std::string> loadQueue_;         // 最近请求的在队尾，先加载
+    std::unordered_set<std::string> loading_;   // 排队或正在加载的缩略图
+    std::unordered_map<std::string, QImage> decoded_;   // 没有图集时解码的结果，显示时移入 LRU
+    bool loaderRunning_ = false;
+    bool loaderStopping_ = false;
+
+    std::mutex handlerMutex_;
+    ReadyHandler readyHandler_;
+};
+
+} // namespace suyan
+
+#endif // SUYAN_CLIPBOARD_THUMBNAIL_CACHE_H
@@ -0,0 +1,657 @@
+/**
+ * AssociationEngine - 联想引擎实现
+ */
+
+#include "association_engine.h"
+#include "rime_dict.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace suyan {
+
+namespace {
+
+// ========== 常量 ==========
+
+constexpr char kIndexMagic[4] = {'S', 'Y', 'A', 'S'};
+constexpr uint32_t kIndexVersion = 1;
+constexpr size_t kMaxKeyLength = 3;             // 前缀最多 3 字
+constexpr size_t kMaxEntriesPerKey = 6;         // 每个前缀保留的后续数量
+constexpr size_t kHistoryKeyLength = 2;         // 提交历史按前文末尾 2 字记录
+constexpr size_t kMaxHistoryPerKey = 16;        // 每个前文保留的历史后续数量
+constexpr size_t kMaxHistoryTextLength = 8;     // 超过 8 字的提交不作为历史后续
+constexpr int kHistorySaveInterval = 20;        // 每新增 20 条历史记录写回一次
+
+// ========== 索引文件格式 ==========
+//
+// [IndexHeader][IndexNode × nodeCount][IndexEntry × entryCount][字符串池]
+//
+// 节点按（前缀长度，前缀字典序）排列，0 号为根节点。
+// 同一节点的子节点在数组中连续，且按码位升序，查找时二分。
+
+struct IndexHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t nodeCount;
+    uint32_t entryCount;
+    uint32_t poolSize;
+    uint32_t reserved;
+};
+
+struct IndexNode {
+    uint32_t codepoint;     // 到达该节点的字（根节点为 0）
+    uint32_t firstChild;
+    uint32_t childCount;
+    uint32_t firstEntry;
+    uint32_t entryCount;    // 后续按权重降序排列
+};
+
+struct IndexEntry {
+    uint32_t offset;        // 后续文字在字符串池中的偏移
+    uint32_t length;        // 字节长度
+};
+
+static_assert(sizeof(IndexHeader) == 24, "IndexHeader layout");
+static_assert(sizeof(IndexNode) == 20, "IndexNode layout");
+static_assert(sizeof(IndexEntry) == 8, "IndexEntry layout");
+
+// ========== UTF-8 ==========
+
+/**
+ * 解码 UTF-8，同时记录每个字的起始字节偏移（末尾额外记录总长度）
+ */
+std::vector<uint32_t> decodeUtf8(const std::string& text, std::vector<uint32_t>* byteOffsets = nullptr) {
+    std::vector<uint32_t> codepoints;
+    size_t i = 0;
+    while (i < text.size()) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        uint32_t cp = 0;
+        size_t len = 1;
+        if (c < 0x80) {
+            cp = c;
+        } else if ((c & 0xE0) == 0xC0) {
+            cp = c & 0x1F;
+            len = 2;
+        } else if ((c & 0xF0) == 0xE0) {
+            cp = c & 0x0F;
+            len = 3;
+        } else if ((c & 0xF8) == 0xF0) {
+            cp = c & 0x07;
+            len = 4;
+        } else {
+            return {};  // 非法 UTF-8
+        }
+        if (i + len > text.size()) {
+            return {};
+        }
+        for (size_t j = 1; j < len; ++j) {
+            cp = (cp << 6) | (static_cast<unsigned char>(text[i + j]) & 0x3F);
+        }
+        if (byteOffsets) {
+            byteOffsets->push_back(static_cast<uint32_t>(i));
+        }
+        codepoints.push_back(cp);
+        i += len;
+    }
+    if (byteOffsets) {
+        byteOffsets->push_back(static_cast<uint32_t>(text.size()));
+    }
+    return codepoints;
+}
+
+std::string encodeUtf8(const std::vector<uint32_t>& codepoints, size_t begin) {
+    std::string out;
+    for (size_t i = begin; i < codepoints.size(); ++i) {
+        uint32_t cp = codepoints[i];
+        if (cp < 0x80) {
+            out += static_cast<char>(cp);
+        } else if (cp < 0x800) {
+            out += static_cast<char>(0xC0 | (cp >> 6));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            out += static_cast<char>(0xE0 | (cp >> 12));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (cp >> 18));
+            out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+    }
+    return out;
+}
+
+bool isHanzi(uint32_t cp) {
+    return (cp >= 0x4E00 && cp <= 0x9FFF) ||    // 基本区
+           (cp >= 0x3400 && cp <= 0x4DBF) ||    // 扩展 A
+           (cp >= 0x20000 && cp <= 0x323AF) ||  // 扩展 B-H
+           (cp >= 0xF900 && cp <= 0xFAFF);      // 兼容汉字
+}
+
+// ========== 索引生成 ==========
+
+/**
+ * 一个（前缀，后续）候选
+ *
+ * 后续即词条去掉前缀后的部分，直接引用原词条在字符串池中的位置。
+ */
+struct BuildRecord {
+    std::array<uint32_t, kMaxKeyLength> key;
+    uint32_t keyLength;
+    uint32_t wordOffset;        // 词条在源字符串池中的偏移
+    uint32_t wordLength;
+    uint32_t prefixBytes;       // 前缀占用的字节数
+    int64_t weight;
+};
+
+bool keyLess(const BuildRecord& a, const BuildRecord& b) {
+    if (a.keyLength != b.keyLength) {
+        return a.keyLength < b.keyLength;
+    }
+    return std::lexicographical_compare(a.key.begin(), a.key.begin() + a.keyLength,
+                                        b.key.begin(), b.key.begin() + b.keyLength);
+}
+
+bool sameKey(const BuildRecord& a, const BuildRecord& b) {
+    return a.keyLength == b.keyLength &&
+           std::equal(a.key.begin(), a.key.begin() + a.keyLength, b.key.begin());
+}
+
+/**
+ * 读取一个词库的词条，为每个 1..3 字前缀生成一条记录
+ */
+void readDictionary(const std::string& path, std::string& pool, std::vector<BuildRecord>& records) {
+    std::vector<uint32_t> byteOffsets;
+    RimeDict::forEachEntry(path, [&](const RimeDictEntry& entry) {
+        byteOffsets.clear();
+        auto codepoints = decodeUtf8(entry.text, &byteOffsets);
+        if (codepoints.size() < 2) {
+            return;  // 单字没有后续
+        }
+
+        uint32_t wordOffset = static_cast<uint32_t>(pool.size());
+        pool += entry.text;
+
+        size_t maxKey = std::min(kMaxKeyLength, codepoints.size() - 1);
+        for (size_t k = 1; k <= maxKey; ++k) {
+            BuildRecord record{};
+            std::copy(codepoints.begin(), codepoints.begin() + k, record.key.begin());
+            record.keyLength = static_cast<uint32_t>(k);
+            record.wordOffset = wordOffset;
+            record.wordLength = static_cast<uint32_t>(entry.text.size());
+            record.prefixBytes = byteOffsets[k];
+            record.weight = entry.weight;
+            records.push_back(record);
+        }
+    });
+}
+
+} // anonymous namespace
+
+// ========== 单例 ==========
+
+AssociationEngine& AssociationEngine::instance() {
+    static AssociationEngine instance;
+    return instance;
+}
+
+AssociationEngine::~AssociationEngine() {
+    shutdown();
+}
+
+// ========== 初始化与关闭 ==========
+
+bool AssociationEngine::initialize(const std::string& userDataDir, const std::string& sharedDataDir) {
+    if (initialized_) {
+        return true;
+    }
+
+    userDataDir_ = userDataDir;
+    indexPath_ = userDataDir + "/association.bin";
+    historyPath_ = userDataDir + "/association_history.txt";
+
+    std::error_code ec;
+    fs::create_directories(userDataDir, ec);
+
+    // 词库有更新时重新生成索引
+    auto dictPaths = collectDictionaries(userDataDir, sharedDataDir);
+    bool needsBuild = !dictPaths.empty();
+    if (needsBuild && fs::exists(indexPath_, ec)) {
+        auto indexTime = fs::last_write_time(indexPath_, ec);
+        needsBuild = std::any_of(dictPaths.begin(), dictPaths.end(), [&](const std::string& path) {
+            std::error_code sourceEc;
+            auto sourceTime = fs::last_write_time(path, sourceEc);
+            return sourceEc || sourceTime > indexTime;
+        });
+    }
+    if (needsBuild) {
+        buildIndex(dictPaths, indexPath_);
+    }
+
+    // 索引缺失时仍可使用提交历史
+    if (!loadIndex(indexPath_)) {
+        std::cerr << "AssociationEngine: Dictionary index unavailable, using history only" << std::endl;
+    }
+    loadHistory();
+
+    initialized_ = true;
+    return true;
+}
+
+void AssociationEngine::shutdown() {
+    if (!initialized_) {
+        return;
+    }
+
+    saveHistory();
+    unloadIndex();
+    history_.clear();
+    lastCommit_.clear();
+    initialized_ = false;
+}
+
+// ========== 查询 ==========
+
+int64_t AssociationEngine::findNode(const std::vector<uint32_t>& codepoints, size_t begin) const {
+    if (!index_.isOpen()) {
+        return -1;
+    }
+
+    const auto* nodes = reinterpret_cast<const IndexNode*>(index_.data() + sizeof(IndexHeader));
+    uint32_t current = 0;
+    for (size_t i = begin; i < codepoints.size(); ++i) {
+        const IndexNode& node = nodes[current];
+        const IndexNode* first = nodes + node.firstChild;
+        const IndexNode* last = first + node.childCount;
+        const IndexNode* child = std::lower_bound(first, last, codepoints[i],
+            [](const IndexNode& n, uint32_t cp) { return n.codepoint < cp; });
+        if (child == last || child->codepoint != codepoints[i]) {
+            return -1;
+        }
+        current = static_cast<uint32_t>(child - nodes);
+    }
+    return current;
+}
+
+std::vector<std::string> AssociationEngine::lookup(const std::string& committedText, size_t limit) const {
+    std::vector<std::string> results;
+    if (!initialized_ || limit == 0) {
+        return results;
+    }
+
+    auto codepoints = decodeUtf8(committedText);
+    if (codepoints.empty() || !isHanzi(codepoints.back())) {
+        return results;
+    }
+
+    auto addResult = [&](std::string text) {
+        if (std::find(results.begin(), results.end(), text) == results.end()) {
+            results.push_back(std::move(text));
+        }
+        return results.size() >= limit;
+    };
+
+    // 提交历史优先
+    size_t historyKeyLength = std::min(kHistoryKeyLength, codepoints.size());
+    auto it = history_.find(encodeUtf8(codepoints, codepoints.size() - historyKeyLength));
+    if (it != history_.end()) {
+        for (const auto& entry : it->second) {
+            if (addResult(entry.text)) {
+                return results;
+            }
+        }
+    }
+
+    if (!index_.isOpen()) {
+        return results;
+    }
+
+    // 词库：上下文越长越靠前
+    const auto* nodes = reinterpret_cast<const IndexNode*>(index_.data() + sizeof(IndexHeader));
+    const auto* entries = reinterpret_cast<const IndexEntry*>(nodes + nodeCount_);
+    const auto* pool = reinterpret_cast<const char*>(entries + entryCount_);
+
+    size_t maxKey = std::min(kMaxKeyLength, codepoints.size());
+    for (size_t keyLength = maxKey; keyLength >= 1; --keyLength) {
+        int64_t nodeIndex = findNode(codepoints, codepoints.size() - keyLength);
+        if (nodeIndex <= 0) {
+            continue;
+        }
+        const IndexNode& node = nodes[nodeIndex];
+        for (uint32_t i = 0; i < node.entryCount; ++i) {
+            const IndexEntry& entry = entries[node.firstEntry + i];
+            if (addResult(std::string(pool + entry.offset, entry.length))) {
+                return results;
+            }
+        }
+    }
+
+    return results;
+}
+
+// ========== 提交历史 ==========
+
+void AssociationEngine::recordCommit(const std::string& text) {
+    if (!initialized_) {
+        return;
+    }
+
+    auto codepoints = decodeUtf8(text);
+    if (!lastCommit_.empty() && !codepoints.empty() &&
+        codepoints.size() <= kMaxHistoryTextLength && isHanzi(codepoints.front())) {
+        auto previous = decodeUtf8(lastCommit_);
+        if (!previous.empty() && isHanzi(previous.back())) {
+            size_t keyLength = std::min(kHistoryKeyLength, previous.size());
+            auto& entries = history_[encodeUtf8(previous, previous.size() - keyLength)];
+
+            auto found = std::find_if(entries.begin(), entries.end(),
+                [&](const HistoryEntry& e) { return e.text == text; });
+            if (found == entries.end()) {
+                entries.push_back({text, 0});
+                found = entries.end() - 1;
+            }
+            found->count++;
+
+            // 保持按次数降序：只需把该条目向前移动
+            while (found != entries.begin() && (found - 1)->count <= found->count) {
+                std::iter_swap(found, found - 1);
+                --found;
+            }
+            if (entries.size() > kMaxHistoryPerKey) {
+                entries.pop_back();
+            }
+            historyDirty_ = true;
+
+            // 定期写回，避免异常退出时丢失全部历史；写回失败也重新计数，不在每次提交时重试
+            if (++unsavedCommits_ >= kHistorySaveInterval) {
+                unsavedCommits_ = 0;
+                saveHistory();
+            }
+        }
+    }
+
+    lastCommit_ = text;
+}
+
+bool AssociationEngine::loadHistory() {
+    history_.clear();
+
+    std::ifstream file(historyPath_);
+    if (!file.is_open()) {
+        return false;  // 首次使用时文件不存在
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream iss(line);
+        std::string key, text, countStr;
+        if (!std::getline(iss, key, '\t') || !std::getline(iss, text, '\t') ||
+            !std::getline(iss, countStr, '\t')) {
+            continue;
+        }
+        int count = 0;
+        try {
+            count = std::stoi(countStr);
+        } catch (...) {
+            continue;
+        }
+        if (key.empty() || text.empty() || count <= 0) {
+            continue;
+        }
+        auto& entries = history_[key];
+        if (entries.size() < kMaxHistoryPerKey) {
+            entries.push_back({text, count});
+        }
+    }
+
+    for (auto& [key, entries] : history_) {
+        std::stable_sort(entries.begin(), entries.end(),
+            [](const HistoryEntry& a, const HistoryEntry& b) { return a.count > b.count; });
+    }
+
+    historyDirty_ = false;
+    unsavedCommits_ = 0;
+    return true;
+}
+
+bool AssociationEngine::saveHistory() {
+    if (!historyDirty_ || historyPath_.empty()) {
+        return true;
+    }
+
+    std::string tempPath = historyPath_ + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "AssociationEngine: Failed to create " << tempPath << std::endl;
+            return false;
+        }
+        file << "# SuYan association history\n";
+        file << "# Format: context<TAB>continuation<TAB>count\n";
+        for (const auto& [key, entries] : history_) {
+            for (const auto& entry : entries) {
+                file << key << "\t" << entry.text << "\t" << entry.count << "\n";
+            }
+        }
+        if (!file.good()) {
+            std::cerr << "AssociationEngine: Failed to write " << tempPath << std::endl;
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(tempPath, historyPath_, ec);
+    if (ec) {
+        std::cerr << "AssociationEngine: Failed to rename " << tempPath
+                  << ": " << ec.message() << std::endl;
+        return false;
+    }
+
+    historyDirty_ = false;
+    unsavedCommits_ = 0;
+    return true;
+}
+
+void AssociationEngine::clearHistory() {
+    history_.clear();
+    lastCommit_.clear();
+    historyDirty_ = true;
+}
+
+// ========== 索引生成 ==========
+
+std::vector<std::string> AssociationEngine::collectDictionaries(const std::string& userDataDir,
+                                                                const std::string& sharedDataDir) {
+    return RimeDict::collectTables(userDataDir, sharedDataDir, "rime_ice");
+}
+
+bool AssociationEngine::buildIndex(const std::vector<std::string>& dictPaths, const std::string& outputPath) {
+    std::string sourcePool;
+    std::vector<BuildRecord> records;
+    for (const auto& path : dictPaths) {
+        readDictionary(path, sourcePool, records);
+    }
+
+    // 按（前缀长度，前缀）分组，组内权重降序，权重相同时靠前的词库优先
+    std::stable_sort(records.begin(), records.end(), [](const BuildRecord& a, const BuildRecord& b) {
+        if (!sameKey(a, b)) {
+            return keyLess(a, b);
+        }
+        return a.weight > b.weight;
+    });
+
+    std::vector<IndexNode> nodes;
+    std::vector<IndexEntry> entries;
+    std::vector<const BuildRecord*> nodeKeys;   // 每个节点对应的前缀（根节点为空）
+    std::string pool;
+    std::unordered_map<uint32_t, uint32_t> wordOffsets;  // 源池偏移 -> 输出池偏移
+
+    nodes.push_back({0, 0, 0, 0, 0});
+    nodeKeys.push_back(nullptr);
+
+    for (size_t i = 0; i < records.size();) {
+        size_t groupEnd = i;
+        while (groupEnd < records.size() && sameKey(records[groupEnd], records[i])) {
+            ++groupEnd;
+        }
+
+        IndexNode node{records[i].key[records[i].keyLength - 1], 0, 0,
+                       static_cast<uint32_t>(entries.size()), 0};
+        std::vector<std::string> seen;
+        for (size_t j = i; j < groupEnd && seen.size() < kMaxEntriesPerKey; ++j) {
+            const BuildRecord& r = records[j];
+            std::string continuation = sourcePool.substr(r.wordOffset + r.prefixBytes,
+                                                         r.wordLength - r.prefixBytes);
+            if (std::find(seen.begin(), seen.end(), continuation) != seen.end()) {
+                continue;  // 同一词条的多个读音
+            }
+            seen.push_back(continuation);
+
+            // 输出池中每个词条只存一次，后续引用其中的一段
+            auto [it, inserted] = wordOffsets.emplace(r.wordOffset, static_cast<uint32_t>(pool.size()));
+            if (inserted) {
+                pool.append(sourcePool, r.wordOffset, r.wordLength);
+            }
+            entries.push_back({it->second + r.prefixBytes, r.wordLength - r.prefixBytes});
+        }
+        node.entryCount = static_cast<uint32_t>(entries.size()) - node.firstEntry;
+        nodes.push_back(node);
+        nodeKeys.push_back(&records[i]);
+
+        i = groupEnd;
+    }
+
+    // 建立父子关系：节点已按层、字典序排列，子节点的前缀单调不减，
+    // 所以同一父节点的子节点连续，用双指针即可找到父节点
+    size_t parent = 0;
+    for (size_t child = 1; child < nodes.size(); ++child) {
+        const BuildRecord* key = nodeKeys[child];
+        uint32_t parentLength = key->keyLength - 1;
+        auto parentMatches = [&](size_t p) {
+            const BuildRecord* pk = nodeKeys[p];
+            uint32_t pkLength = pk ? pk->keyLength : 0;
+            return pkLength == parentLength &&
+                   std::equal(key->key.begin(), key->key.begin() + parentLength,
+                              pk ? pk->key.begin() : key->key.begin());
+        };
+        while (parent < child && !parentMatches(parent)) {
+            ++parent;
+        }
+        if (parent == child) {
+            // 词条至少 2 字才生成前缀，且 1..k 字前缀都会生成，不应出现
+            std::cerr << "AssociationEngine: Orphan prefix node, aborting build" << std::endl;
+            return false;
+        }
+        if (nodes[parent].childCount == 0) {
+            nodes[parent].firstChild = static_cast<uint32_t>(child);
+        }
+        nodes[parent].childCount++;
+    }
+
+    IndexHeader header{};
+    std::memcpy(header.magic, kIndexMagic, sizeof(header.magic));
+    header.version = kIndexVersion;
+    header.nodeCount = static_cast<uint32_t>(nodes.size());
+    header.entryCount = static_cast<uint32_t>(entries.size());
+    header.poolSize = static_cast<uint32_t>(pool.size());
+
+    std::error_code ec;
+    fs::create_directories(fs::path(outputPath).parent_path(), ec);
+
+    std::string tempPath = outputPath + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            std::cerr << "AssociationEngine: Failed to create " << tempPath << std::endl;
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(nodes.data()), nodes.size() * sizeof(IndexNode));
+        out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(IndexEntry));
+        out.write(pool.data(), static_cast<std::streamsize>(pool.size()));
+        if (!out.good()) {
+            std::cerr << "AssociationEngine: Failed to write " << tempPath << std::endl;
+            out.close();
+            fs::remove(tempPath, ec);
+            return false;
+        }
+    }
+
+    fs::rename(tempPath, outputPath, ec);
+    if (ec) {
+        std::cerr << "AssociationEngine: Failed to rename " << tempPath
+                  << ": " << ec.message() << std::endl;
+        return false;
+    }
+
+    std::cout << "AssociationEngine: Built index with " << nodes.size() << " prefixes, "
+              << entries.size() << " continuations" << std::endl;
+    return true;
+}
+
+// ========== 索引映射 ==========
+
+bool AssociationEngine::loadIndex(const std::string& indexPath) {
+    unloadIndex();
+
+    if (!index_.open(indexPath)) {
+        return false;
+    }
+
+    const uint8_t* data = index_.data();
+    size_t size = index_.size();
+    IndexHeader header{};
+    if (size >= sizeof(header)) {
+        std::memcpy(&header, data, sizeof(header));
+    }
+
+    // 校验文件头和各段大小，避免损坏的文件导致越界访问
+    bool valid = size >= sizeof(header) &&
+                 std::memcmp(header.magic, kIndexMagic, sizeof(header.magic)) == 0 &&
+                 header.version == kIndexVersion &&
+                 header.nodeCount >= 1 &&
+                 sizeof(IndexHeader) +
+                     static_cast<uint64_t>(header.nodeCount) * sizeof(IndexNode) +
+                     static_cast<uint64_t>(header.entryCount) * sizeof(IndexEntry) +
+                     header.poolSize == size;
+    if (valid) {
+        const auto* nodes = reinterpret_cast<const IndexNode*>(data + sizeof(IndexHeader));
+        const auto* entries = reinterpret_cast<const IndexEntry*>(nodes + header.nodeCount);
+        for (uint32_t i = 0; valid && i < header.nodeCount; ++i) {
+            valid = static_cast<uint64_t>(nodes[i].firstChild) + nodes[i].childCount <= header.nodeCount &&
+                    static_cast<uint64_t>(nodes[i].firstEntry) + nodes[i].entryCount <= header.entryCount;
+        }
+        for (uint32_t i = 0; valid && i < header.entryCount; ++i) {
+            valid = static_cast<uint64_t>(entries[i].offset) + entries[i].length <= header.poolSize;
+        }
+    }
+
+    if (!valid) {
+        std::cerr << "AssociationEngine: Invalid index file " << indexPath << std::endl;
+        index_.close();
+        return false;
+    }
+
+    nodeCount_ = header.nodeCount;
+    entryCount_ = header.entryCount;
+    return true;
+}
+
+void AssociationEngine::unloadIndex() {
+    index_.close();
+    nodeCount_ = 0;
+    entryCount_ = 0;
+}
+
+} // namespace suyan
@@ -0,0 +1,184 @@
+/**
+ * AssociationEngine - 联想引擎
+ *
+ * 提交文字后给出可能的后续短语（如提交「中华」后联想「人民共和国」）。
+ *
+ * 数据来源：
+ * - 词库：rime_ice.dict.yaml 中 import_tables 引用的词库，部署时按词条前缀
+ *   （1-3 字）建立前缀树，每个前缀只保留权重最高的若干后续，写入用户目录的
+ *   association.bin，运行时以 mmap 方式只读映射
+ * - 提交历史：记录相邻两次提交（前一次提交的末尾两字 → 后一次提交），
+ *   作为内存中的覆盖层优先于词库结果，定期及关闭时写回 association_history.txt
+ *
+ * 查询时按已提交文字的末尾 3、2、1 个字依次匹配，上下文越长越靠前，
+ * 单次查询只涉及几次二分查找，远低于 1ms。
+ */
+
+#ifndef SUYAN_CORE_ASSOCIATION_ENGINE_H
+#define SUYAN_CORE_ASSOCIATION_ENGINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "mapped_file.h"
+
+namespace suyan {
+
+/**
+ * AssociationEngine - 联想引擎类
+ *
+ * 单例模式。
+ */
+class AssociationEngine {
+public:
+    /**
+     * 获取单例实例
+     */
+    static AssociationEngine& instance();
+
+    // 禁止拷贝和移动
+    AssociationEngine(const AssociationEngine&) = delete;
+    AssociationEngine& operator=(const AssociationEngine&) = delete;
+    AssociationEngine(AssociationEngine&&) = delete;
+    AssociationEngine& operator=(AssociationEngine&&) = delete;
+
+    /**
+     * 初始化联想引擎
+     *
+     * 词库比索引文件新（或索引不存在）时重新生成索引，然后映射索引并加载提交历史。
+     *
+     * @param userDataDir 用户数据目录（存放 association.bin 和提交历史）
+     * @param sharedDataDir 共享数据目录（词库所在目录）
+     * @return 是否成功
+     */
+    bool initialize(const std::string& userDataDir, const std::string& sharedDataDir);
+
+    /**
+     * 关闭联想引擎（保存提交历史并解除映射）
+     */
+    void shutdown();
+
+    /**
+     * 检查是否已初始化
+     */
+    bool isInitialized() const { return initialized_; }
+
+    /**
+     * 获取索引文件路径
+     */
+    std::string getIndexPath() const { return indexPath_; }
+
+    // ========== 查询 ==========
+
+    /**
+     * 查询提交文字之后的联想短语
+     *
+     * 只在提交文字以汉字结尾时返回结果。
+     *
+     * @param committedText 刚提交的文字（UTF-8）
+     * @param limit 最多返回的数量
+     * @return 联想短语，提交历史在前、词库在后，已去重
+     */
+    std::vector<std::string> lookup(const std::string& committedText, size_t limit) const;
+
+    // ========== 提交历史 ==========
+
+    /**
+     * 记录一次提交
+     *
+     * 与上一次提交组成一条 前文 → 后续 的历史记录，累积一定数量后自动写回。
+     *
+     * @param text 提交的文字
+     */
+    void recordCommit(const std::string& text);
+
+    /**
+     * 清除提交上下文（切换应用、清空输入时调用，避免跨上下文记录）
+     */
+    void resetContext() { lastCommit_.clear(); }
+
+    /**
+     * 保存提交历史
+     *
+     * @return 是否成功
+     */
+    bool saveHistory();
+
+    /**
+     * 清空提交历史
+     */
+    void clearHistory();
+
+    // ========== 索引生成 ==========
+
+    /**
+     * 获取 rime_ice.dict.yaml 引用的词库文件
+     *
+     * 每个词库优先使用用户目录中的版本，其次是共享目录。
+     *
+     * @return 存在的词库文件路径（含 rime_ice.dict.yaml 本身）
+     */
+    static std::vector<std::string> collectDictionaries(const std::string& userDataDir,
+                                                        const std::string& sharedDataDir);
+
+    /**
+     * 从词库生成联想索引
+     *
+     * 先写入临时文件，成功后再替换目标文件。
+     *
+     * @param dictPaths 词库文件（*.dict.yaml）
+     * @param outputPath 索引文件路径
+     * @return 是否成功
+     */
+    static bool buildIndex(const std::vector<std::string>& dictPaths, const std::string& outputPath);
+
+    /**
+     * 映射索引文件
+     *
+     * @param indexPath 索引文件路径
+     * @return 是否成功（文件不存在或格式不符时返回 false）
+     */
+    bool loadIndex(const std::string& indexPath);
+
+    /**
+     * 解除索引映射
+     */
+    void unloadIndex();
+
+private:
+    AssociationEngine() = default;
+    ~AssociationEngine();
+
+    // 提交历史中的一条后续
+    struct HistoryEntry {
+        std::string text;
+        int count = 0;
+    };
+
+    // 在映射的前缀树中查找前缀对应的节点，未找到返回 -1
+    int64_t findNode(const std::vector<uint32_t>& codepoints, size_t begin) const;
+
+    bool loadHistory();
+
+    bool initialized_ = false;
+    std::string userDataDir_;
+    std::string indexPath_;
+    std::string historyPath_;
+
+    // 映射的索引
+    MappedFile index_;
+    uint32_t nodeCount_ = 0;
+    uint32_t entryCount_ = 0;
+
+    // 提交历史：前文末尾（最多 2 字）→ 后续（按次数降序）
+    std::unordered_map<std::string, std::vector<HistoryEntry>> history_;
+    std::string lastCommit_;
+    bool historyDirty_ = false;
+    int unsavedCommits_ = 0;  // 上次写回后新增的历史记录数
+};
+
+} // namespace suyan
+
+#endif // SUYAN_CORE_ASSOCIATION_ENGINE_H
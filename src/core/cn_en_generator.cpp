@@ -0,0 +1,554 @@
+/**
+ * CnEnGenerator 实现
+ */
+
+#include "cn_en_generator.h"
+#include <yaml-cpp/yaml.h>
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unordered_set>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace suyan {
+
+namespace {
+
+// ========== 生成器版本 ==========
+
+// 转换规则或文件格式变化时递增，已生成的变体随之失效
+constexpr int kGeneratorVersion = 2;
+
+// 写入变体文件头的版本行前缀
+constexpr const char* kVersionPrefix = "# generator_version: ";
+
+// 文件头结束标记（其后为词条）
+constexpr const char* kHeaderEnd = "# 此行之后不能写注释";
+
+/**
+ * 读取变体文件头中的生成器版本
+ *
+ * @return 版本号，文件不存在或没有版本行（旧版本生成）时返回 0
+ */
+int readGeneratorVersion(const fs::path& path) {
+    std::ifstream in(path);
+    std::string line;
+    std::string prefix = kVersionPrefix;
+    while (std::getline(in, line) && line.rfind(kHeaderEnd, 0) != 0) {
+        if (line.rfind(prefix, 0) == 0) {
+            try {
+                return std::stoi(line.substr(prefix.size()));
+            } catch (const std::exception&) {
+                return 0;
+            }
+        }
+    }
+    return 0;
+}
+
+// ========== 键位表 ==========
+
+struct KeyMapping {
+    const char* pinyin;
+    const char* key;
+};
+
+struct SchemeKeymap {
+    DoublePinyinScheme scheme;
+    const char* schemaId;               // RIME 方案 ID
+    const char* variant;                // 词库变体名（cn_en_<variant>.txt）
+    const char* displayName;            // 方案名称（写入文件头）
+    const char* zh;                     // 翘舌声母键位
+    const char* ch;
+    const char* sh;
+    std::vector<KeyMapping> finals;     // 韵母键位
+    std::vector<KeyMapping> zeroInitials;  // 零声母音节编码
+};
+
+// 自然码与小鹤的零声母规则相同：单韵母双写，复韵母取首尾字母
+const std::vector<KeyMapping> kZeroInitialsNatural = {
+    {"a", "aa"}, {"ai", "ai"}, {"an", "an"}, {"ang", "ah"}, {"ao", "ao"}, {"e", "ee"},
+    {"ei", "ei"}, {"en", "en"}, {"eng", "eg"}, {"er", "er"}, {"o", "oo"}, {"ou", "ou"},
+};
+
+const std::vector<SchemeKeymap>& keymaps() {
+    static const std::vector<SchemeKeymap> kKeymaps = {
+        {DoublePinyinScheme::Natural, "double_pinyin", "double_pinyin", "自然码双拼", "v", "i", "u",
+         {{"iu", "q"}, {"ia", "w"}, {"ua", "w"}, {"uan", "r"}, {"ue", "t"}, {"ve", "t"},
+          {"ing", "y"}, {"uai", "y"}, {"uo", "o"}, {"un", "p"}, {"iong", "s"}, {"ong", "s"},
+          {"iang", "d"}, {"uang", "d"}, {"en", "f"}, {"eng", "g"}, {"ang", "h"}, {"an", "j"},
+          {"ao", "k"}, {"ai", "l"}, {"ei", "z"}, {"ie", "x"}, {"iao", "c"}, {"ui", "v"},
+          {"ou", "b"}, {"in", "n"}, {"ian", "m"}},
+         kZeroInitialsNatural},
+        {DoublePinyinScheme::Abc, "double_pinyin_abc", "abc", "智能 ABC 双拼", "a", "e", "v",
+         {{"ai", "l"}, {"an", "j"}, {"ang", "h"}, {"ao", "k"}, {"ei", "q"}, {"en", "f"},
+          {"eng", "g"}, {"er", "r"}, {"ia", "d"}, {"ian", "w"}, {"iang", "t"}, {"iao", "z"},
+          {"ie", "x"}, {"in", "c"}, {"ing", "y"}, {"iong", "s"}, {"iu", "r"}, {"ong", "s"},
+          {"ou", "b"}, {"ua", "d"}, {"uai", "c"}, {"uan", "p"}, {"uang", "t"}, {"ue", "m"},
+          {"ve", "m"}, {"ui", "m"}, {"un", "n"}, {"uo", "o"}},
+         {{"a", "oa"}, {"ai", "ol"}, {"an", "oj"}, {"ang", "oh"}, {"ao", "ok"}, {"e", "oe"},
+          {"ei", "oq"}, {"en", "of"}, {"eng", "og"}, {"er", "or"}, {"o", "oo"}, {"ou", "ob"}}},
+        {DoublePinyinScheme::Flypy, "double_pinyin_flypy", "flypy", "小鹤双拼", "v", "i", "u",
+         {{"iu", "q"}, {"ei", "w"}, {"uan", "r"}, {"ue", "t"}, {"ve", "t"}, {"un", "y"},
+          {"uo", "o"}, {"ie", "p"}, {"ong", "s"}, {"iong", "s"}, {"ai", "d"}, {"en", "f"},
+          {"eng", "g"}, {"ang", "h"}, {"an", "j"}, {"uai", "k"}, {"ing", "k"}, {"uang", "l"},
+          {"iang", "l"}, {"ou", "z"}, {"ia", "x"}, {"ua", "x"}, {"ao", "c"}, {"ui", "v"},
+          {"in", "b"}, {"iao", "n"}, {"ian", "m"}},
+         kZeroInitialsNatural},
+        {DoublePinyinScheme::Mspy, "double_pinyin_mspy", "mspy", "微软双拼", "v", "i", "u",
+         {{"iu", "q"}, {"ia", "w"}, {"ua", "w"}, {"er", "r"}, {"uan", "r"}, {"ue", "t"},
+          {"ve", "v"}, {"uai", "y"}, {"uo", "o"}, {"un", "p"}, {"ong", "s"}, {"iong", "s"},
+          {"iang", "d"}, {"uang", "d"}, {"en", "f"}, {"eng", "g"}, {"ang", "h"}, {"an", "j"},
+          {"ao", "k"}, {"ai", "l"}, {"ing", ";"}, {"ei", "z"}, {"ie", "x"}, {"iao", "c"},
+          {"ui", "v"}, {"ou", "b"}, {"in", "n"}, {"ian", "m"}},
+         {{"a", "oa"}, {"ai", "ol"}, {"an", "oj"}, {"ang", "oh"}, {"ao", "ok"}, {"e", "oe"},
+          {"ei", "oz"}, {"en", "of"}, {"eng", "og"}, {"er", "or"}, {"o", "oo"}, {"ou", "ob"}}},
+        {DoublePinyinScheme::Sogou, "double_pinyin_sogou", "sogou", "搜狗双拼", "v", "i", "u",
+         {{"iu", "q"}, {"ia", "w"}, {"ua", "w"}, {"er", "r"}, {"uan", "r"}, {"ue", "t"},
+          {"ve", "t"}, {"uai", "y"}, {"uo", "o"}, {"un", "p"}, {"ong", "s"}, {"iong", "s"},
+          {"iang", "d"}, {"uang", "d"}, {"en", "f"}, {"eng", "g"}, {"ang", "h"}, {"an", "j"},
+          {"ao", "k"}, {"ai", "l"}, {"ing", ";"}, {"ei", "z"}, {"ie", "x"}, {"iao", "c"},
+          {"ui", "v"}, {"ou", "b"}, {"in", "n"}, {"ian", "m"}},
+         {{"a", "oa"}, {"ai", "ol"}, {"an", "oj"}, {"ang", "oh"}, {"ao", "ok"}, {"e", "oe"},
+          {"ei", "oz"}, {"en", "of"}, {"eng", "og"}, {"er", "or"}, {"o", "oo"}, {"ou", "ob"}}},
+        {DoublePinyinScheme::Ziguang, "double_pinyin_ziguang", "ziguang", "紫光双拼", "u", "a", "i",
+         {{"ai", "p"}, {"an", "r"}, {"ang", "s"}, {"ao", "q"}, {"ei", "k"}, {"en", "w"},
+          {"eng", "t"}, {"er", "j"}, {"ia", "x"}, {"ian", "f"}, {"iang", "g"}, {"iao", "b"},
+          {"ie", "d"}, {"in", "y"}, {"ing", ";"}, {"iong", "h"}, {"iu", "j"}, {"ong", "h"},
+          {"ou", "z"}, {"ua", "x"}, {"uai", "y"}, {"uan", "l"}, {"uang", "g"}, {"ue", "n"},
+          {"ve", "n"}, {"ui", "n"}, {"un", "m"}, {"uo", "o"}},
+         {{"a", "oa"}, {"ai", "op"}, {"an", "or"}, {"ang", "os"}, {"ao", "oq"}, {"e", "oe"},
+          {"ei", "ok"}, {"en", "ow"}, {"eng", "ot"}, {"er", "oj"}, {"o", "oo"}, {"ou", "oz"}}},
+        {DoublePinyinScheme::Jiajia, "double_pinyin_jiajia", "jiajia", "拼音加加双拼", "v", "u", "i",
+         {{"ai", "s"}, {"an", "f"}, {"ang", "g"}, {"ao", "d"}, {"ei", "w"}, {"en", "r"},
+          {"eng", "t"}, {"er", "q"}, {"ia", "b"}, {"ian", "j"}, {"iang", "h"}, {"iao", "k"},
+          {"ie", "m"}, {"in", "l"}, {"ing", "q"}, {"iong", "y"}, {"iu", "n"}, {"ong", "y"},
+          {"ou", "p"}, {"ua", "b"}, {"uai", "x"}, {"uan", "c"}, {"uang", "h"}, {"ue", "x"},
+          {"ve", "x"}, {"ui", "v"}, {"un", "z"}, {"uo", "o"}},
+         {{"a", "aa"}, {"ai", "as"}, {"an", "af"}, {"ang", "ag"}, {"ao", "ad"}, {"e", "ee"},
+          {"ei", "ew"}, {"en", "er"}, {"eng", "et"}, {"er", "eq"}, {"o", "oo"}, {"ou", "op"}}},
+    };
+    return kKeymaps;
+}
+
+const SchemeKeymap& keymapFor(DoublePinyinScheme scheme) {
+    for (const auto& keymap : keymaps()) {
+        if (keymap.scheme == scheme) {
+            return keymap;
+        }
+    }
+    return keymaps().front();
+}
+
+const char* lookup(const std::vector<KeyMapping>& table, const std::string& pinyin) {
+    for (const auto& mapping : table) {
+        if (pinyin == mapping.pinyin) {
+            return mapping.key;
+        }
+    }
+    return nullptr;
+}
+
+// ========== 音节表 ==========
+
+// 与 cn_dicts/8105.dict.yaml 中出现的全部读音一致
+const char* const kSyllables =
+    "a ai an ang ao ba bai ban bang bao bei ben beng bi bian biang biao bie bin bing bo bu "
+    "ca cai can cang cao ce cei cen ceng cha chai chan chang chao che chen cheng chi chong "
+    "chou chu chua chuai chuan chuang chui chun chuo ci cong cou cu cuan cui cun cuo da dai "
+    "dan dang dao de dei den deng di dia dian diao die ding diu dong dou du duan dui dun duo "
+    "e ei en eng er fa fan fang fei fen feng fiao fo fou fu ga gai gan gang gao ge gei gen "
+    "geng gong gou gu gua guai guan guang gui gun guo ha hai han hang hao he hei hen heng hm "
+    "hng hong hou hu hua huai huan huang hui hun huo ji jia jian jiang jiao jie jin jing "
+    "jiong jiu ju juan jue jun ka kai kan kang kao ke kei ken keng kong kou ku kua kuai kuan "
+    "kuang kui kun kuo la lai lan lang lao le lei leng li lia lian liang liao lie lin ling "
+    "liu lo long lou lu luan lun luo lv lve m ma mai man mang mao me mei men meng mi mian "
+    "miao mie min ming miu mo mou mu n na nai nan nang nao ne nei nen neng ng ni nian niang "
+    "niao nie nin ning niu nong nou nu nuan nuo nv nve o ou pa pai pan pang pao pei pen "
+    "peng pi pian piao pie pin ping po pou pu qi qia qian qiang qiao qie qin qing qiong qiu "
+    "qu quan que qun ran rang rao re ren reng ri rong rou ru rua ruan rui run ruo sa sai san "
+    "sang sao se sen seng sha shai shan shang shao she shei shen sheng shi shou shu shua "
+    "shuai shuan shuang shui shun shuo si song sou su suan sui sun suo ta tai tan tang tao "
+    "te tei teng ti tian tiao tie ting tong tou tu tuan tui tun tuo wa wai wan wang wei wen "
+    "weng wo wu xi xia xian xiang xiao xie xin xing xiong xiu xu xuan xue xun ya yan yang "
+    "yao ye yi yin ying yo yong you yu yuan yue yun za zai zan zang zao ze zei zen zeng zha "
+    "zhai zhan zhang zhao zhe zhei zhen zheng zhi zhong zhou zhu zhua zhuai zhuan zhuang "
+    "zhui zhun zhuo zi zong zou zu zuan zui zun zuo";
+
+constexpr size_t kMaxSyllableLength = 6;
+
+const std::unordered_set<std::string>& syllables() {
+    static const std::unordered_set<std::string> kSet = [] {
+        std::unordered_set<std::string> set;
+        std::istringstream iss(kSyllables);
+        std::string syllable;
+        while (iss >> syllable) {
+            set.insert(syllable);
+        }
+        return set;
+    }();
+    return kSet;
+}
+
+// ========== 文本对齐 ==========
+
+/**
+ * 词条文本单元
+ */
+struct TextUnit {
+    enum Kind {
+        Letter,     // 英文字母，与编码逐字对齐
+        Syllable    // 汉字或数字，对应一个拼音音节
+    };
+    Kind kind;
+    char letter;    // Letter 时为原字母
+};
+
+/**
+ * 将 UTF-8 文本拆分为对齐单元，标点与空白不占编码
+ */
+std::vector<TextUnit> splitTextUnits(const std::string& text) {
+    std::vector<TextUnit> units;
+    size_t i = 0;
+    while (i < text.size()) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c < 0x80) {
+            if (std::isalpha(c)) {
+                units.push_back({TextUnit::Letter, static_cast<char>(c)});
+            } else if (std::isdigit(c)) {
+                units.push_back({TextUnit::Syllable, 0});
+            }
+            ++i;
+            continue;
+        }
+
+        size_t length = 1;
+        if ((c & 0xE0) == 0xC0) length = 2;
+        else if ((c & 0xF0) == 0xE0) length = 3;
+        else if ((c & 0xF8) == 0xF0) length = 4;
+
+        // U+00B7 中间点（如 "乔治·R.R.马丁"）
+        bool isMiddleDot = (length == 2 && c == 0xC2 && i + 1 < text.size() &&
+                            static_cast<unsigned char>(text[i + 1]) == 0xB7);
+        if (!isMiddleDot) {
+            units.push_back({TextUnit::Syllable, 0});
+        }
+        i += length;
+    }
+    return units;
+}
+
+/**
+ * 回溯对齐编码，每个 Syllable 单元匹配一个合法全拼音节
+ */
+bool alignCode(const std::vector<TextUnit>& units, size_t unitIndex,
+               const std::string& code, size_t codeIndex,
+               std::vector<std::string>& pieces, std::vector<bool>& isSyllable) {
+    if (unitIndex == units.size()) {
+        return codeIndex == code.size();
+    }
+    if (codeIndex >= code.size()) {
+        return false;
+    }
+
+    if (units[unitIndex].kind == TextUnit::Letter) {
+        // 字母须与编码一致（忽略大小写，编码中保留原样）
+        if (std::tolower(static_cast<unsigned char>(code[codeIndex])) !=
+            std::tolower(static_cast<unsigned char>(units[unitIndex].letter))) {
+            return false;
+        }
+        pieces.emplace_back(1, code[codeIndex]);
+        isSyllable.push_back(false);
+        if (alignCode(units, unitIndex + 1, code, codeIndex + 1, pieces, isSyllable)) {
+            return true;
+        }
+        pieces.pop_back();
+        isSyllable.pop_back();
+        return false;
+    }
+
+    const auto& validSyllables = syllables();
+    size_t maxLength = std::min(kMaxSyllableLength, code.size() - codeIndex);
+    for (size_t length = maxLength; length > 0; --length) {
+        std::string candidate = code.substr(codeIndex, length);
+        if (validSyllables.count(candidate) == 0) {
+            continue;
+        }
+        pieces.push_back(candidate);
+        isSyllable.push_back(true);
+        if (alignCode(units, unitIndex + 1, code, codeIndex + length, pieces, isSyllable)) {
+            return true;
+        }
+        pieces.pop_back();
+        isSyllable.pop_back();
+    }
+    return false;
+}
+
+} // anonymous namespace
+
+// ========== 方案映射 ==========
+
+std::optional<DoublePinyinScheme> CnEnGenerator::schemeForSchemaId(const std::string& schemaId) {
+    for (const auto& keymap : keymaps()) {
+        if (schemaId == keymap.schemaId) {
+            return keymap.scheme;
+        }
+    }
+    return std::nullopt;
+}
+
+std::string CnEnGenerator::variantFileName(DoublePinyinScheme scheme) {
+    return std::string("cn_en_") + keymapFor(scheme).variant + ".txt";
+}
+
+// ========== 编码转换 ==========
+
+std::string CnEnGenerator::convertSyllable(const std::string& syllable,
+                                           DoublePinyinScheme scheme) {
+    if (syllable.empty() || syllables().count(syllable) == 0) {
+        return "";
+    }
+
+    const auto& keymap = keymapFor(scheme);
+
+    // 零声母音节
+    if (const char* key = lookup(keymap.zeroInitials, syllable)) {
+        return key;
+    }
+
+    // 单字母音节（m、n）保持不变
+    if (syllable.size() == 1) {
+        return syllable;
+    }
+
+    std::string initial;
+    std::string final;
+    if (syllable.compare(0, 2, "zh") == 0) {
+        initial = keymap.zh;
+        final = syllable.substr(2);
+    } else if (syllable.compare(0, 2, "ch") == 0) {
+        initial = keymap.ch;
+        final = syllable.substr(2);
+    } else if (syllable.compare(0, 2, "sh") == 0) {
+        initial = keymap.sh;
+        final = syllable.substr(2);
+    } else {
+        initial = syllable.substr(0, 1);
+        final = syllable.substr(1);
+    }
+
+    // 键位表中没有的韵母（a、o、e、i、u、v）与键位相同
+    if (const char* key = lookup(keymap.finals, final)) {
+        return initial + key;
+    }
+    return initial + final;
+}
+
+std::string CnEnGenerator::convertCode(const std::string& text, const std::string& code,
+                                       DoublePinyinScheme scheme) {
+    std::vector<TextUnit> units = splitTextUnits(text);
+    std::vector<std::string> pieces;
+    std::vector<bool> isSyllable;
+    if (!alignCode(units, 0, code, 0, pieces, isSyllable)) {
+        return "";
+    }
+
+    std::string result;
+    result.reserve(code.size());
+    for (size_t i = 0; i < pieces.size(); ++i) {
+        result += isSyllable[i] ? convertSyllable(pieces[i], scheme) : pieces[i];
+    }
+    return result;
+}
+
+// ========== 文件生成 ==========
+
+bool CnEnGenerator::generate(const std::string& sourcePath, const std::string& outputPath,
+                             DoublePinyinScheme scheme) {
+    std::ifstream in(sourcePath);
+    if (!in.is_open()) {
+        std::cerr << "CnEnGenerator: Failed to open " << sourcePath << std::endl;
+        return false;
+    }
+
+    // 先写临时文件，完成后再替换，避免 RIME 部署时读到半截文件
+    std::string tempPath = outputPath + ".tmp";
+    std::ofstream out(tempPath, std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "CnEnGenerator: Failed to create " << tempPath << std::endl;
+        return false;
+    }
+
+    const auto& keymap = keymapFor(scheme);
+    std::string fileName = variantFileName(scheme);
+    out << "# Rime table\n"
+        << "# coding: utf-8\n"
+        << "#@/db_name\t" << fileName << "\n"
+        << "#@/db_type\ttabledb\n"
+        << "#\n"
+        << "# https://github.com/iDvel/rime-ice\n"
+        << "# ------- 中英混输词库 for " << keymap.displayName << " -------\n"
+        << "# 由 cn_en.txt 在部署时自动生成，请勿手动修改\n"
+        << kVersionPrefix << kGeneratorVersion << "\n"
+        << "#\n"
+        << kHeaderEnd << "\n";
+
+    std::string line;
+    int skipped = 0;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        size_t tab = line.find('\t');
+        if (tab == std::string::npos) {
+            continue;
+        }
+
+        std::string text = line.substr(0, tab);
+        std::string code = line.substr(tab + 1);
+        size_t nextTab = code.find('\t');
+        std::string rest;
+        if (nextTab != std::string::npos) {
+            rest = code.substr(nextTab);
+            code = code.substr(0, nextTab);
+        }
+
+        std::string converted = convertCode(text, code, scheme);
+        if (converted.empty()) {
+            ++skipped;
+            continue;
+        }
+        out << text << '\t' << converted << rest << '\n';
+    }
+
+    out.close();
+    if (!out) {
+        std::cerr << "CnEnGenerator: Failed to write " << tempPath << std::endl;
+        return false;
+    }
+
+    std::error_code ec;
+    fs::rename(tempPath, outputPath, ec);
+    if (ec) {
+        std::cerr << "CnEnGenerator: Failed to rename " << tempPath
+                  << ": " << ec.message() << std::endl;
+        fs::remove(tempPath, ec);
+        return false;
+    }
+
+    if (skipped > 0) {
+        std::cerr << "CnEnGenerator: Skipped " << skipped
+                  << " unalignable entries in " << sourcePath << std::endl;
+    }
+    return true;
+}
+
+// ========== 部署 ==========
+
+std::string CnEnGenerator::detectActiveSchema(const std::string& userDataDir,
+                                              const std::string& sharedDataDir) {
+    try {
+        fs::path userYaml = fs::path(userDataDir) / "user.yaml";
+        if (fs::exists(userYaml)) {
+            YAML::Node root = YAML::LoadFile(userYaml.string());
+            YAML::Node selected = root["var"]["previously_selected_schema"];
+            if (selected && selected.IsScalar()) {
+                return selected.as<std::string>();
+            }
+        }
+
+        // 用户目录的 default.yaml 优先于共享目录
+        for (const auto& dir : {userDataDir, sharedDataDir}) {
+            fs::path defaultYaml = fs::path(dir) / "default.yaml";
+            if (!fs::exists(defaultYaml)) {
+                continue;
+            }
+            YAML::Node root = YAML::LoadFile(defaultYaml.string());
+            YAML::Node schemaList = root["schema_list"];
+            if (schemaList && schemaList.IsSequence() && schemaList.size() > 0) {
+                YAML::Node first = schemaList[0]["schema"];
+                if (first && first.IsScalar()) {
+                    return first.as<std::string>();
+                }
+            }
+        }
+    } catch (const YAML::Exception& e) {
+        std::cerr << "CnEnGenerator: Failed to read schema selection: " << e.what() << std::endl;
+    }
+    return "";
+}
+
+bool CnEnGenerator::deployActiveVariant(const std::string& userDataDir,
+                                        const std::string& sharedDataDir) {
+    return deployVariant(detectActiveSchema(userDataDir, sharedDataDir), userDataDir, sharedDataDir);
+}
+
+bool CnEnGenerator::deployVariant(const std::string& schemaId, const std::string& userDataDir,
+                                  const std::string& sharedDataDir, bool* regenerated) {
+    if (regenerated) {
+        *regenerated = false;
+    }
+    std::optional<DoublePinyinScheme> scheme = schemeForSchemaId(schemaId);
+
+    fs::path outputDir = fs::path(userDataDir) / "en_dicts";
+    std::string activeFileName = scheme ? variantFileName(*scheme) : "";
+
+    // 删除其他方案的过期变体
+    std::error_code ec;
+    for (const auto& keymap : keymaps()) {
+        std::string fileName = variantFileName(keymap.scheme);
+        if (fileName != activeFileName) {
+            fs::remove(outputDir / fileName, ec);
+        }
+    }
+
+    if (!scheme) {
+        return true;
+    }
+
+    // 全拼词库：优先用户目录，其次共享目录
+    fs::path source = fs::path(userDataDir) / "en_dicts" / "cn_en.txt";
+    if (!fs::exists(source)) {
+        source = fs::path(sharedDataDir) / "en_dicts" / "cn_en.txt";
+    }
+    if (!fs::exists(source)) {
+        std::cerr << "CnEnGenerator: cn_en.txt not found" << std::endl;
+        return false;
+    }
+
+    // 由当前版本的生成器生成、且比全拼词库新则无需重新生成
+    fs::path output = outputDir / activeFileName;
+    if (fs::exists(output) && readGeneratorVersion(output) == kGeneratorVersion) {
+        std::error_code outputEc;
+        std::error_code sourceEc;
+        auto outputTime = fs::last_write_time(output, outputEc);
+        auto sourceTime = fs::last_write_time(source, sourceEc);
+        if (!outputEc && !sourceEc && outputTime >= sourceTime) {
+            return true;
+        }
+    }
+
+    fs::create_directories(outputDir, ec);
+    if (ec) {
+        std::cerr << "CnEnGenerator: Failed to create " << outputDir
+                  << ": " << ec.message() << std::endl;
+        return false;
+    }
+
+    if (!generate(source.string(), output.string(), *scheme)) {
+        return false;
+    }
+    if (regenerated) {
+        *regenerated = true;
+    }
+    return true;
+}
+
+} // namespace suyan
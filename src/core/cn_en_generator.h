@@ -0,0 +1,123 @@
+/**
+ * CnEnGenerator - 中英混输词库生成器
+ *
+ * 仓库中只保留全拼版本的 en_dicts/cn_en.txt，各双拼方案的变体
+ * （cn_en_flypy.txt 等）在部署时按当前方案从全拼版本生成。
+ *
+ * 生成方式：
+ * - 按词条文本逐字对齐编码，英文字母原样保留
+ * - 每个汉字（或数字）对应一个全拼音节，经编译期键位表转换为双拼
+ * - 只生成当前方案对应的变体，并删除用户目录中过期的其他变体
+ */
+
+#ifndef SUYAN_CORE_CN_EN_GENERATOR_H
+#define SUYAN_CORE_CN_EN_GENERATOR_H
+
+#include <string>
+#include <optional>
+
+namespace suyan {
+
+/**
+ * 双拼方案
+ */
+enum class DoublePinyinScheme {
+    Natural,    // 自然码双拼（double_pinyin）
+    Abc,        // 智能 ABC 双拼
+    Flypy,      // 小鹤双拼
+    Mspy,       // 微软双拼
+    Sogou,      // 搜狗双拼
+    Ziguang,    // 紫光双拼
+    Jiajia      // 拼音加加双拼
+};
+
+/**
+ * CnEnGenerator - 中英混输词库生成器
+ *
+ * 无状态工具类，所有方法均为静态方法。
+ */
+class CnEnGenerator {
+public:
+    /**
+     * 根据方案 ID 获取双拼方案
+     *
+     * @param schemaId 方案 ID（如 "double_pinyin_flypy"）
+     * @return 双拼方案，非双拼方案（全拼等）返回空 optional
+     */
+    static std::optional<DoublePinyinScheme> schemeForSchemaId(const std::string& schemaId);
+
+    /**
+     * 获取方案对应的词库文件名（不含目录）
+     *
+     * @return 如 "cn_en_flypy.txt"，自然码为 "cn_en_double_pinyin.txt"
+     */
+    static std::string variantFileName(DoublePinyinScheme scheme);
+
+    /**
+     * 将单个全拼音节转换为双拼编码
+     *
+     * @param syllable 全拼音节（小写，ü 写作 v）
+     * @return 双拼编码，非法音节返回空字符串
+     */
+    static std::string convertSyllable(const std::string& syllable, DoublePinyinScheme scheme);
+
+    /**
+     * 将一条词条的全拼编码转换为双拼编码
+     *
+     * 词条文本中的英文字母与编码逐字对齐并原样保留，
+     * 标点（. - · 等）不占编码，其余字符各对应一个音节。
+     *
+     * @param text 词条文本（UTF-8）
+     * @param code 全拼编码
+     * @return 双拼编码，无法对齐时返回空字符串
+     */
+    static std::string convertCode(const std::string& text, const std::string& code,
+                                   DoublePinyinScheme scheme);
+
+    /**
+     * 从全拼词库生成双拼变体
+     *
+     * @param sourcePath 全拼词库路径（cn_en.txt）
+     * @param outputPath 输出路径
+     * @return 是否成功
+     */
+    static bool generate(const std::string& sourcePath, const std::string& outputPath,
+                         DoublePinyinScheme scheme);
+
+    /**
+     * 获取当前激活的方案 ID
+     *
+     * 优先读取 user.yaml 中的 var/previously_selected_schema，
+     * 否则取 default.yaml 中 schema_list 的第一项。
+     *
+     * @return 方案 ID，无法确定时返回空字符串
+     */
+    static std::string detectActiveSchema(const std::string& userDataDir,
+                                          const std::string& sharedDataDir);
+
+    /**
+     * 部署指定方案所需的变体
+     *
+     * 在 RIME 部署前、切换方案后调用。方案为双拼时生成对应变体到
+     * <userDataDir>/en_dicts/，并删除其他过期变体。变体由当前版本的
+     * 生成器生成且比全拼词库新时跳过生成。
+     *
+     * @param schemaId 方案 ID
+     * @param regenerated 可选，输出是否重新生成了变体（需强制 RIME 重新编译词库）
+     * @return 是否成功（方案无需变体也返回 true）
+     */
+    static bool deployVariant(const std::string& schemaId, const std::string& userDataDir,
+                              const std::string& sharedDataDir, bool* regenerated = nullptr);
+
+    /**
+     * 部署当前方案所需的变体
+     *
+     * 方案由 detectActiveSchema() 确定，其余同 deployVariant()。
+     */
+    static bool deployActiveVariant(const std::string& userDataDir,
+                                    const std::string& sharedDataDir);
+};
+
+} // namespace suyan
+
+#endif // SUYAN_CORE_CN_EN_GENERATOR_H
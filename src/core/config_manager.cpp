@@ -136,6 +136,9 @@ bool ConfigManager::loadConfig() {
             if (input["default_mode"]) {
                 config_.input.defaultMode = stringToDefaultInputMode(input["default_mode"].as<std::string>());
             }
+            if (input["association"]) {
+                config_.input.associationEnabled = input["association"].as<bool>();
+            }
         }
 
         // 读取词频配置
@@ -161,6 +164,9 @@ bool ConfigManager::loadConfig() {
             if (clipboard["max_count"]) {
                 config_.clipboard.maxCount = clipboard["max_count"].as<int>();
             }
+            if (clipboard["max_storage_mb"]) {
+                config_.clipboard.maxStorageMB = clipboard["max_storage_mb"].as<int>();
+            }
             if (clipboard["hotkey"]) {
                 config_.clipboard.hotkey = clipboard["hotkey"].as<std::string>();
             }
@@ -200,6 +206,7 @@ bool ConfigManager::saveConfig() {
         // 写入输入配置
         out << YAML::Key << "input" << YAML::Value << YAML::BeginMap;
         out << YAML::Key << "default_mode" << YAML::Value << defaultInputModeToString(config_.input.defaultMode);
+        out << YAML::Key << "association" << YAML::Value << config_.input.associationEnabled;
         out << YAML::EndMap;
 
         // 写入词频配置
@@ -213,6 +220,7 @@ bool ConfigManager::saveConfig() {
         out << YAML::Key << "enabled" << YAML::Value << config_.clipboard.enabled;
         out << YAML::Key << "max_age_days" << YAML::Value << config_.clipboard.maxAgeDays;
         out << YAML::Key << "max_count" << YAML::Value << config_.clipboard.maxCount;
+        out << YAML::Key << "max_storage_mb" << YAML::Value << config_.clipboard.maxStorageMB;
         out << YAML::Key << "hotkey" << YAML::Value << config_.clipboard.hotkey;
         out << YAML::EndMap;
 
@@ -247,6 +255,8 @@ void ConfigManager::notifyChange(const std::string& key) {
         emit layoutConfigChanged(config_.layout);
     } else if (key.find("theme") == 0) {
         emit themeConfigChanged(config_.theme);
+    } else if (key.find("input") == 0) {
+        emit inputConfigChanged(config_.input);
     } else if (key.find("clipboard") == 0) {
         emit clipboardConfigChanged(config_.clipboard);
     }
@@ -318,6 +328,13 @@ void ConfigManager::setDefaultInputMode(DefaultInputMode mode) {
     }
 }
 
+void ConfigManager::setAssociationEnabled(bool enabled) {
+    if (config_.input.associationEnabled != enabled) {
+        config_.input.associationEnabled = enabled;
+        notifyChange("input.association");
+    }
+}
+
 void ConfigManager::setFrequencyEnabled(bool enabled) {
     if (config_.frequency.enabled != enabled) {
         config_.frequency.enabled = enabled;
@@ -361,6 +378,16 @@ void ConfigManager::setClipboardMaxCount(int count) {
     }
 }
 
+void ConfigManager::setClipboardMaxStorageMB(int megabytes) {
+    if (megabytes < 100) megabytes = 100;
+    if (megabytes > 51200) megabytes = 51200;
+    
+    if (config_.clipboard.maxStorageMB != megabytes) {
+        config_.clipboard.maxStorageMB = megabytes;
+        notifyChange("clipboard.max_storage_mb");
+    }
+}
+
 void ConfigManager::setClipboardHotkey(const std::string& hotkey) {
     if (config_.clipboard.hotkey != hotkey) {
         config_.clipboard.hotkey = hotkey;
@@ -395,12 +422,16 @@ int ConfigManager::getInt(const std::string& key, int defaultValue) const {
         return config_.clipboard.maxAgeDays;
     } else if (key == "clipboard.max_count") {
         return config_.clipboard.maxCount;
+    } else if (key == "clipboard.max_storage_mb") {
+        return config_.clipboard.maxStorageMB;
     }
     return defaultValue;
 }
 
 bool ConfigManager::getBool(const std::string& key, bool defaultValue) const {
-    if (key == "frequency.enabled") {
+    if (key == "input.association") {
+        return config_.input.associationEnabled;
+    } else if (key == "frequency.enabled") {
         return config_.frequency.enabled;
     } else if (key == "clipboard.enabled") {
         return config_.clipboard.enabled;
@@ -431,11 +462,15 @@ void ConfigManager::setInt(const std::string& key, int value) {
         setClipboardMaxAgeDays(value);
     } else if (key == "clipboard.max_count") {
         setClipboardMaxCount(value);
+    } else if (key == "clipboard.max_storage_mb") {
+        setClipboardMaxStorageMB(value);
     }
 }
 
 void ConfigManager::setBool(const std::string& key, bool value) {
-    if (key == "frequency.enabled") {
+    if (key == "input.association") {
+        setAssociationEnabled(value);
+    } else if (key == "frequency.enabled") {
         setFrequencyEnabled(value);
     } else if (key == "clipboard.enabled") {
         setClipboardEnabled(value);
@@ -64,6 +64,7 @@ struct ThemeConfig {
  */
 struct InputConfig {
     DefaultInputMode defaultMode = DefaultInputMode::Chinese;
+    bool associationEnabled = false;  // 是否启用联想（提交后显示后续短语，数字键选择）
 };
 
 /**
@@ -81,6 +82,7 @@ struct ClipboardConfig {
     bool enabled = true;           // 是否启用剪贴板功能
     int maxAgeDays = 30;           // 保留天数（1-365）
     int maxCount = 1000;           // 最大保留条数（100-10000）
+    int maxStorageMB = 1024;       // 存储空间上限（MB，100-51200）
     std::string hotkey = "Cmd+Shift+V";  // 呼出快捷键
 };
 
@@ -206,6 +208,11 @@ public:
      */
     void setDefaultInputMode(DefaultInputMode mode);
 
+    /**
+     * 设置联想功能开关
+     */
+    void setAssociationEnabled(bool enabled);
+
     /**
      * 设置词频功能开关
      */
@@ -231,6 +238,11 @@ public:
      */
     void setClipboardMaxCount(int count);
 
+    /**
+     * 设置剪贴板存储空间上限（MB）
+     */
+    void setClipboardMaxStorageMB(int megabytes);
+
     /**
      * 设置剪贴板呼出快捷键
      */
@@ -311,6 +323,11 @@ signals:
      */
     void themeConfigChanged(const ThemeConfig& config);
 
+    /**
+     * 输入配置变更信号
+     */
+    void inputConfigChanged(const InputConfig& config);
+
     /**
      * 剪贴板配置变更信号
      */
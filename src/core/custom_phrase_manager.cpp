@@ -0,0 +1,635 @@
+/**
+ * CustomPhraseManager 实现
+ *
+ * 数据库保存 (code, phrase, position)，内存索引在初始化时一次性加载，
+ * 之后所有查询都只访问内存。
+ */
+
+#include "custom_phrase_manager.h"
+#include <sqlite3.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+namespace suyan {
+
+namespace {
+
+// 已导入 custom_phrase.txt 的标记（custom_phrase_meta 表的键）
+constexpr const char* kLegacyImportedKey = "legacy_file_imported";
+
+} // namespace
+
+// ========== 单例实现 ==========
+
+CustomPhraseManager& CustomPhraseManager::instance() {
+    static CustomPhraseManager instance;
+    return instance;
+}
+
+CustomPhraseManager::CustomPhraseManager() = default;
+
+CustomPhraseManager::~CustomPhraseManager() {
+    shutdown();
+}
+
+// ========== 初始化和关闭 ==========
+
+bool CustomPhraseManager::initialize(const std::string& dataDir) {
+    if (initialized_) {
+        if (dataDir_ == dataDir) {
+            return true;
+        }
+        shutdown();
+    }
+
+    dataDir_ = dataDir;
+    dbPath_ = dataDir + "/custom_phrase.db";
+
+    // 确保目录存在
+    try {
+        fs::create_directories(dataDir);
+    } catch (const std::exception& e) {
+        std::cerr << "CustomPhraseManager: 创建目录失败: " << e.what() << std::endl;
+        return false;
+    }
+
+    if (!openDatabase()) {
+        return false;
+    }
+
+    if (!createTables() || !prepareStatements() || !loadIndex()) {
+        finalizeStatements();
+        closeDatabase();
+        return false;
+    }
+
+    initialized_ = true;
+    return true;
+}
+
+void CustomPhraseManager::shutdown() {
+    if (!initialized_) {
+        return;
+    }
+
+    finalizeStatements();
+    closeDatabase();
+    phrasesByCode_.clear();
+    phraseCount_ = 0;
+    initialized_ = false;
+}
+
+// ========== 数据库操作 ==========
+
+bool CustomPhraseManager::openDatabase() {
+    int rc = sqlite3_open(dbPath_.c_str(), &db_);
+    if (rc != SQLITE_OK) {
+        std::cerr << "CustomPhraseManager: 打开数据库失败: " << sqlite3_errmsg(db_) << std::endl;
+        sqlite3_close(db_);
+        db_ = nullptr;
+        return false;
+    }
+
+    // 启用 WAL 模式提高性能
+    char* errMsg = nullptr;
+    rc = sqlite3_exec(db_, "PRAGMA journal_mode=WAL;", nullptr, nullptr, &errMsg);
+    if (rc != SQLITE_OK) {
+        std::cerr << "CustomPhraseManager: 设置 WAL 模式失败: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+    }
+
+    return true;
+}
+
+void CustomPhraseManager::closeDatabase() {
+    if (db_) {
+        sqlite3_close(db_);
+        db_ = nullptr;
+    }
+}
+
+bool CustomPhraseManager::createTables() {
+    const char* createTableSQL = R"(
+        CREATE TABLE IF NOT EXISTS custom_phrases (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            code TEXT NOT NULL,
+            phrase TEXT NOT NULL,
+            position INTEGER NOT NULL DEFAULT 0,
+            created_at INTEGER DEFAULT (strftime('%s', 'now')),
+            UNIQUE(code, phrase)
+        );
+
+        CREATE INDEX IF NOT EXISTS idx_custom_phrases_code
+            ON custom_phrases(code, position);
+
+        CREATE TABLE IF NOT EXISTS custom_phrase_meta (
+            key TEXT PRIMARY KEY,
+            value TEXT NOT NULL
+        );
+    )";
+
+    char* errMsg = nullptr;
+    int rc = sqlite3_exec(db_, createTableSQL, nullptr, nullptr, &errMsg);
+    if (rc != SQLITE_OK) {
+        std::cerr << "CustomPhraseManager: 创建表失败: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+        return false;
+    }
+
+    return true;
+}
+
+bool CustomPhraseManager::prepareStatements() {
+    const char* insertSQL = R"(
+        INSERT INTO custom_phrases (code, phrase, position)
+        VALUES (?, ?, ?)
+    )";
+
+    const char* deleteSQL = R"(
+        DELETE FROM custom_phrases
+        WHERE code = ? AND phrase = ?
+    )";
+
+    const char* updatePositionSQL = R"(
+        UPDATE custom_phrases SET position = ?
+        WHERE code = ? AND phrase = ?
+    )";
+
+    int rc;
+
+    rc = sqlite3_prepare_v2(db_, insertSQL, -1, &stmtInsert_, nullptr);
+    if (rc != SQLITE_OK) {
+        std::cerr << "CustomPhraseManager: 准备 INSERT 语句失败: " << sqlite3_errmsg(db_) << std::endl;
+        return false;
+    }
+
+    rc = sqlite3_prepare_v2(db_, deleteSQL, -1, &stmtDelete_, nullptr);
+    if (rc != SQLITE_OK) {
+        std::cerr << "CustomPhraseManager: 准备 DELETE 语句失败: " << sqlite3_errmsg(db_) << std::endl;
+        return false;
+    }
+
+    rc = sqlite3_prepare_v2(db_, updatePositionSQL, -1, &stmtUpdatePosition_, nullptr);
+    if (rc != SQLITE_OK) {
+        std::cerr << "CustomPhraseManager: 准备 UPDATE 语句失败: " << sqlite3_errmsg(db_) << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+void CustomPhraseManager::finalizeStatements() {
+    if (stmtInsert_) {
+        sqlite3_finalize(stmtInsert_);
+        stmtInsert_ = nullptr;
+    }
+    if (stmtDelete_) {
+        sqlite3_finalize(stmtDelete_);
+        stmtDelete_ = nullptr;
+    }
+    if (stmtUpdatePosition_) {
+        sqlite3_finalize(stmtUpdatePosition_);
+        stmtUpdatePosition_ = nullptr;
+    }
+}
+
+bool CustomPhraseManager::loadIndex() {
+    phrasesByCode_.clear();
+    phraseCount_ = 0;
+
+    sqlite3_stmt* stmt = nullptr;
+    int rc = sqlite3_prepare_v2(db_,
+        "SELECT code, phrase FROM custom_phrases ORDER BY code, position, id;",
+        -1, &stmt, nullptr);
+    if (rc != SQLITE_OK) {
+        std::cerr << "CustomPhraseManager: 加载短语失败: " << sqlite3_errmsg(db_) << std::endl;
+        return false;
+    }
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        const char* code = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        const char* phrase = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+        phrasesByCode_[code ? code : ""].push_back(phrase ? phrase : "");
+        phraseCount_++;
+    }
+
+    sqlite3_finalize(stmt);
+    return true;
+}
+
+// addPhrase 等操作使用 SAVEPOINT，可嵌套在 importFromFile 的外层事务中
+void CustomPhraseManager::beginSavepoint() {
+    sqlite3_exec(db_, "SAVEPOINT custom_phrase;", nullptr, nullptr, nullptr);
+}
+
+void CustomPhraseManager::releaseSavepoint() {
+    sqlite3_exec(db_, "RELEASE custom_phrase;", nullptr, nullptr, nullptr);
+}
+
+void CustomPhraseManager::rollbackSavepoint() {
+    sqlite3_exec(db_, "ROLLBACK TO custom_phrase;", nullptr, nullptr, nullptr);
+    sqlite3_exec(db_, "RELEASE custom_phrase;", nullptr, nullptr, nullptr);
+}
+
+bool CustomPhraseManager::writePositions(const std::string& code, size_t fromPosition) {
+    auto it = phrasesByCode_.find(code);
+    if (it == phrasesByCode_.end()) {
+        return true;
+    }
+
+    const auto& phrases = it->second;
+    for (size_t i = fromPosition; i < phrases.size(); ++i) {
+        sqlite3_reset(stmtUpdatePosition_);
+        sqlite3_bind_int(stmtUpdatePosition_, 1, static_cast<int>(i));
+        sqlite3_bind_text(stmtUpdatePosition_, 2, code.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmtUpdatePosition_, 3, phrases[i].c_str(), -1, SQLITE_TRANSIENT);
+        if (sqlite3_step(stmtUpdatePosition_) != SQLITE_DONE) {
+            std::cerr << "CustomPhraseManager: 更新顺序失败: " << sqlite3_errmsg(db_) << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// ========== 查询 ==========
+
+const std::vector<std::string>& CustomPhraseManager::lookup(const std::string& code) const {
+    static const std::vector<std::string> kEmpty;
+    auto it = phrasesByCode_.find(code);
+    return it != phrasesByCode_.end() ? it->second : kEmpty;
+}
+
+bool CustomPhraseManager::hasCode(const std::string& code) const {
+    return phrasesByCode_.count(code) > 0;
+}
+
+std::vector<CustomPhrase> CustomPhraseManager::getAllPhrases() const {
+    std::vector<CustomPhrase> result;
+    result.reserve(static_cast<size_t>(phraseCount_));
+    for (const auto& [code, phrases] : phrasesByCode_) {
+        for (size_t i = 0; i < phrases.size(); ++i) {
+            result.push_back({code, phrases[i], static_cast<int>(i)});
+        }
+    }
+    std::sort(result.begin(), result.end(), [](const CustomPhrase& a, const CustomPhrase& b) {
+        return a.code != b.code ? a.code < b.code : a.position < b.position;
+    });
+    return result;
+}
+
+// ========== 修改 ==========
+
+bool CustomPhraseManager::addPhrase(const std::string& code, const std::string& phrase,
+                                    int position) {
+    if (!initialized_ || code.empty() || phrase.empty()) {
+        return false;
+    }
+
+    auto& phrases = phrasesByCode_[code];
+    if (std::find(phrases.begin(), phrases.end(), phrase) != phrases.end()) {
+        return false;
+    }
+
+    size_t insertAt = (position < 0 || static_cast<size_t>(position) > phrases.size())
+                          ? phrases.size()
+                          : static_cast<size_t>(position);
+
+    beginSavepoint();
+
+    sqlite3_reset(stmtInsert_);
+    sqlite3_bind_text(stmtInsert_, 1, code.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmtInsert_, 2, phrase.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(stmtInsert_, 3, static_cast<int>(insertAt));
+    if (sqlite3_step(stmtInsert_) != SQLITE_DONE) {
+        std::cerr << "CustomPhraseManager: 添加短语失败: " << sqlite3_errmsg(db_) << std::endl;
+        rollbackSavepoint();
+        if (phrases.empty()) {
+            phrasesByCode_.erase(code);
+        }
+        return false;
+    }
+
+    phrases.insert(phrases.begin() + static_cast<std::ptrdiff_t>(insertAt), phrase);
+
+    // 追加到末尾时无需改动其他短语的顺序
+    if (insertAt + 1 < phrases.size() && !writePositions(code, insertAt + 1)) {
+        rollbackSavepoint();
+        phrases.erase(phrases.begin() + static_cast<std::ptrdiff_t>(insertAt));
+        if (phrases.empty()) {
+            phrasesByCode_.erase(code);
+        }
+        return false;
+    }
+
+    releaseSavepoint();
+    phraseCount_++;
+
+    emit phrasesChanged(QString::fromStdString(code));
+    return true;
+}
+
+bool CustomPhraseManager::removePhrase(const std::string& code, const std::string& phrase) {
+    if (!initialized_) {
+        return false;
+    }
+
+    auto it = phrasesByCode_.find(code);
+    if (it == phrasesByCode_.end()) {
+        return false;
+    }
+
+    auto& phrases = it->second;
+    auto pos = std::find(phrases.begin(), phrases.end(), phrase);
+    if (pos == phrases.end()) {
+        return false;
+    }
+    size_t removedAt = static_cast<size_t>(pos - phrases.begin());
+
+    beginSavepoint();
+
+    sqlite3_reset(stmtDelete_);
+    sqlite3_bind_text(stmtDelete_, 1, code.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmtDelete_, 2, phrase.c_str(), -1, SQLITE_TRANSIENT);
+    if (sqlite3_step(stmtDelete_) != SQLITE_DONE) {
+        std::cerr << "CustomPhraseManager: 删除短语失败: " << sqlite3_errmsg(db_) << std::endl;
+        rollbackSavepoint();
+        return false;
+    }
+
+    phrases.erase(pos);
+    if (!writePositions(code, removedAt)) {
+        rollbackSavepoint();
+        phrases.insert(phrases.begin() + static_cast<std::ptrdiff_t>(removedAt), phrase);
+        return false;
+    }
+
+    releaseSavepoint();
+    if (phrases.empty()) {
+        phrasesByCode_.erase(it);
+    }
+    phraseCount_--;
+
+    emit phrasesChanged(QString::fromStdString(code));
+    return true;
+}
+
+bool CustomPhraseManager::movePhrase(const std::string& code, const std::string& phrase,
+                                     int newPosition) {
+    if (!initialized_) {
+        return false;
+    }
+
+    auto it = phrasesByCode_.find(code);
+    if (it == phrasesByCode_.end()) {
+        return false;
+    }
+
+    auto& phrases = it->second;
+    auto pos = std::find(phrases.begin(), phrases.end(), phrase);
+    if (pos == phrases.end()) {
+        return false;
+    }
+
+    size_t from = static_cast<size_t>(pos - phrases.begin());
+    size_t to = (newPosition < 0 || static_cast<size_t>(newPosition) >= phrases.size())
+                    ? phrases.size() - 1
+                    : static_cast<size_t>(newPosition);
+    if (from == to) {
+        return true;
+    }
+
+    std::vector<std::string> previous = phrases;
+    phrases.erase(phrases.begin() + static_cast<std::ptrdiff_t>(from));
+    phrases.insert(phrases.begin() + static_cast<std::ptrdiff_t>(to), phrase);
+
+    beginSavepoint();
+    if (!writePositions(code, std::min(from, to))) {
+        rollbackSavepoint();
+        phrases = std::move(previous);
+        return false;
+    }
+    releaseSavepoint();
+
+    emit phrasesChanged(QString::fromStdString(code));
+    return true;
+}
+
+bool CustomPhraseManager::clearAll() {
+    if (!initialized_) {
+        return false;
+    }
+
+    char* errMsg = nullptr;
+    int rc = sqlite3_exec(db_, "DELETE FROM custom_phrases;", nullptr, nullptr, &errMsg);
+    if (rc != SQLITE_OK) {
+        std::cerr << "CustomPhraseManager: 清空数据失败: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+        return false;
+    }
+
+    phrasesByCode_.clear();
+    phraseCount_ = 0;
+
+    emit dataReloaded();
+    return true;
+}
+
+bool CustomPhraseManager::reload() {
+    if (!initialized_) {
+        return false;
+    }
+
+    if (!loadIndex()) {
+        return false;
+    }
+
+    emit dataReloaded();
+    return true;
+}
+
+// ========== 导入导出 ==========
+
+bool CustomPhraseManager::exportToFile(const std::string& filePath) const {
+    if (!initialized_) {
+        return false;
+    }
+
+    std::ofstream file(filePath);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    // 与 data/rime/custom_phrase.txt 相同的文件头，可直接替换使用
+    file << "# Rime table\n";
+    file << "# coding: utf-8\n";
+    file << "#@/db_name\tcustom_phrase.txt\n";
+    file << "#@/db_type\ttabledb\n";
+    file << "#\n";
+    file << "# SuYan Custom Phrase Export\n";
+    file << "# Format: phrase<TAB>code<TAB>weight\n";
+    file << "#\n";
+    file << "# 此行之后不能写注释\n";
+
+    for (const auto& item : getAllPhrases()) {
+        const auto& phrases = phrasesByCode_.at(item.code);
+        int weight = static_cast<int>(phrases.size()) - item.position;
+        file << item.phrase << "\t" << item.code << "\t" << weight << "\n";
+    }
+
+    file.close();
+    return !file.fail();
+}
+
+int CustomPhraseManager::importFromFile(const std::string& filePath, bool merge) {
+    if (!initialized_) {
+        return -1;
+    }
+
+    std::ifstream file(filePath);
+    if (!file.is_open()) {
+        return -1;
+    }
+
+    // 先按编码分组，组内按权重降序（稳定排序保持文件顺序）
+    struct Entry {
+        std::string phrase;
+        int weight;
+    };
+    std::vector<std::string> codeOrder;
+    std::unordered_map<std::string, std::vector<Entry>> entries;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        // 跳过注释和空行
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+
+        std::istringstream iss(line);
+        std::string phrase, code, weightStr;
+        if (!std::getline(iss, phrase, '\t') || !std::getline(iss, code, '\t')) {
+            continue;
+        }
+        if (phrase.empty() || code.empty()) {
+            continue;
+        }
+
+        int weight = 0;
+        if (std::getline(iss, weightStr, '\t')) {
+            try {
+                weight = std::stoi(weightStr);
+            } catch (...) {
+                weight = 0;
+            }
+        }
+
+        if (entries.find(code) == entries.end()) {
+            codeOrder.push_back(code);
+        }
+        entries[code].push_back({phrase, weight});
+    }
+
+    if (!merge) {
+        clearAll();
+    }
+
+    // 开始事务
+    sqlite3_exec(db_, "BEGIN TRANSACTION;", nullptr, nullptr, nullptr);
+
+    // 导入期间不逐条发出 phrasesChanged，结束后统一发出 dataReloaded
+    int importCount = 0;
+    blockSignals(true);
+    for (const auto& code : codeOrder) {
+        auto& list = entries[code];
+        std::stable_sort(list.begin(), list.end(), [](const Entry& a, const Entry& b) {
+            return a.weight > b.weight;
+        });
+        for (const auto& entry : list) {
+            if (addPhrase(code, entry.phrase)) {
+                importCount++;
+            }
+        }
+    }
+    blockSignals(false);
+
+    sqlite3_exec(db_, "COMMIT;", nullptr, nullptr, nullptr);
+
+    emit dataReloaded();
+    return importCount;
+}
+
+int CustomPhraseManager::importLegacyFileOnce(const std::vector<std::string>& filePaths) {
+    if (!initialized_) {
+        return -1;
+    }
+
+    if (readMeta(kLegacyImportedKey) == "1") {
+        return 0;
+    }
+
+    // 用户目录的文件优先于共享目录（与 RIME 查找 user_dict 的顺序一致）
+    int importCount = 0;
+    for (const auto& path : filePaths) {
+        std::error_code ec;
+        if (!fs::is_regular_file(path, ec)) {
+            continue;
+        }
+        importCount = importFromFile(path, true);
+        if (importCount < 0) {
+            std::cerr << "CustomPhraseManager: 导入 " << path << " 失败，下次启动时重试" << std::endl;
+            return -1;
+        }
+        break;
+    }
+
+    // 没有文件也记录标记：之后用户删除的短语不会被重新导入
+    if (!writeMeta(kLegacyImportedKey, "1")) {
+        return -1;
+    }
+    return importCount;
+}
+
+// ========== 元数据 ==========
+
+std::string CustomPhraseManager::readMeta(const std::string& key) const {
+    std::string value;
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db_, "SELECT value FROM custom_phrase_meta WHERE key = ?;",
+                           -1, &stmt, nullptr) == SQLITE_OK) {
+        sqlite3_bind_text(stmt, 1, key.c_str(), -1, SQLITE_TRANSIENT);
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+            value = text ? text : "";
+        }
+    }
+    sqlite3_finalize(stmt);
+    return value;
+}
+
+bool CustomPhraseManager::writeMeta(const std::string& key, const std::string& value) {
+    sqlite3_stmt* stmt = nullptr;
+    int rc = sqlite3_prepare_v2(db_, "INSERT OR REPLACE INTO custom_phrase_meta (key, value) VALUES (?, ?);",
+                                -1, &stmt, nullptr);
+    if (rc == SQLITE_OK) {
+        sqlite3_bind_text(stmt, 1, key.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 2, value.c_str(), -1, SQLITE_TRANSIENT);
+        rc = sqlite3_step(stmt);
+    }
+    sqlite3_finalize(stmt);
+
+    if (rc != SQLITE_DONE) {
+        std::cerr << "CustomPhraseManager: 写入元数据失败: " << sqlite3_errmsg(db_) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace suyan
@@ -0,0 +1,234 @@
+/**
+ * CustomPhraseManager - 自定义短语管理器
+ *
+ * 原生的自定义短语存储，替代需要重新部署的 custom_phrase.txt。
+ * 使用 SQLite 持久化，内存中维护 编码 -> 短语列表 的哈希表。
+ *
+ * 功能：
+ * - 运行时增删短语、调整顺序，立即生效，无需重新部署 RIME
+ * - 按编码 O(1) 查询（InputEngine 每次按键都会查询）
+ * - 增删、调序只改动该编码下的短语，与词库总量无关
+ * - 导入/导出 custom_phrase.txt 格式，保持与 RIME 的兼容
+ *
+ * 方案中不再启用 RIME 的 custom_phrase 翻译器，首次启动时把 custom_phrase.txt 导入本管理器，
+ * 之后只以数据库为准（见 importLegacyFileOnce）。
+ */
+
+#ifndef SUYAN_CORE_CUSTOM_PHRASE_MANAGER_H
+#define SUYAN_CORE_CUSTOM_PHRASE_MANAGER_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <QObject>
+
+// 前向声明 SQLite
+struct sqlite3;
+struct sqlite3_stmt;
+
+namespace suyan {
+
+/**
+ * 自定义短语记录结构
+ */
+struct CustomPhrase {
+    std::string code;           // 编码
+    std::string phrase;         // 短语文本
+    int position = 0;           // 在该编码下的顺序 (0-based)
+};
+
+/**
+ * CustomPhraseManager - 自定义短语管理器类
+ *
+ * 单例模式。所有修改先写数据库，成功后再更新内存索引。
+ */
+class CustomPhraseManager : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * 获取单例实例
+     */
+    static CustomPhraseManager& instance();
+
+    // 禁止拷贝和移动
+    CustomPhraseManager(const CustomPhraseManager&) = delete;
+    CustomPhraseManager& operator=(const CustomPhraseManager&) = delete;
+    CustomPhraseManager(CustomPhraseManager&&) = delete;
+    CustomPhraseManager& operator=(CustomPhraseManager&&) = delete;
+
+    /**
+     * 初始化管理器
+     *
+     * @param dataDir 数据目录（存放 custom_phrase.db）
+     * @return 是否成功
+     */
+    bool initialize(const std::string& dataDir);
+
+    /**
+     * 关闭管理器
+     */
+    void shutdown();
+
+    /**
+     * 检查是否已初始化
+     */
+    bool isInitialized() const { return initialized_; }
+
+    /**
+     * 获取数据库路径
+     */
+    std::string getDatabasePath() const { return dbPath_; }
+
+    // ========== 查询 ==========
+
+    /**
+     * 查询编码对应的短语（按顺序）
+     *
+     * 直接返回内存索引中的列表，不访问数据库。
+     *
+     * @param code 编码
+     * @return 短语列表，无匹配时返回空列表
+     */
+    const std::vector<std::string>& lookup(const std::string& code) const;
+
+    /**
+     * 检查编码是否有短语
+     */
+    bool hasCode(const std::string& code) const;
+
+    /**
+     * 获取所有短语（按编码、顺序排列）
+     */
+    std::vector<CustomPhrase> getAllPhrases() const;
+
+    /**
+     * 获取短语总数
+     */
+    int64_t getPhraseCount() const { return phraseCount_; }
+
+    // ========== 修改 ==========
+
+    /**
+     * 添加短语
+     *
+     * @param code 编码
+     * @param phrase 短语文本
+     * @param position 插入位置，-1 或超出范围时追加到末尾
+     * @return 是否成功（编码下已存在相同短语返回 false）
+     */
+    bool addPhrase(const std::string& code, const std::string& phrase, int position = -1);
+
+    /**
+     * 删除短语
+     *
+     * @return 是否成功（不存在返回 false）
+     */
+    bool removePhrase(const std::string& code, const std::string& phrase);
+
+    /**
+     * 调整短语在编码下的顺序
+     *
+     * @param newPosition 目标位置 (0-based)，超出范围时移到末尾
+     * @return 是否成功
+     */
+    bool movePhrase(const std::string& code, const std::string& phrase, int newPosition);
+
+    /**
+     * 清空所有短语
+     */
+    bool clearAll();
+
+    /**
+     * 从数据库重新加载内存索引（数据库被外部修改后调用）
+     */
+    bool reload();
+
+    // ========== 导入导出 ==========
+
+    /**
+     * 导出为 custom_phrase.txt 格式（短语<Tab>编码<Tab>权重）
+     *
+     * 权重按顺序递减，保证 table_translator 下的排序与本管理器一致。
+     *
+     * @param filePath 文件路径
+     * @return 是否成功
+     */
+    bool exportToFile(const std::string& filePath) const;
+
+    /**
+     * 从 custom_phrase.txt 格式导入
+     *
+     * 同一编码下按权重降序排列，权重相同保持文件顺序。
+     *
+     * @param filePath 文件路径
+     * @param merge 是否合并（true: 合并，false: 替换）
+     * @return 导入的短语数，-1 表示失败
+     */
+    int importFromFile(const std::string& filePath, bool merge = true);
+
+    /**
+     * 首次启动时导入 custom_phrase.txt（只执行一次）
+     *
+     * 按顺序导入 filePaths 中第一个存在的文件（合并），完成后在数据库中记录标记，
+     * 之后不再导入，用户删除的短语不会重新出现。没有文件时同样记录标记；导入失败时不记录，下次重试。
+     *
+     * @param filePaths 候选文件路径（如用户目录、共享目录下的 custom_phrase.txt）
+     * @return 导入的短语数，已导入过返回 0，-1 表示失败
+     */
+    int importLegacyFileOnce(const std::vector<std::string>& filePaths);
+
+signals:
+    /**
+     * 编码下的短语发生变化
+     */
+    void phrasesChanged(const QString& code);
+
+    /**
+     * 数据清空或重新加载
+     */
+    void dataReloaded();
+
+private:
+    CustomPhraseManager();
+    ~CustomPhraseManager();
+
+    // 数据库操作
+    bool openDatabase();
+    void closeDatabase();
+    bool createTables();
+    bool prepareStatements();
+    void finalizeStatements();
+
+    // 事务辅助（SAVEPOINT，可嵌套）
+    void beginSavepoint();
+    void releaseSavepoint();
+    void rollbackSavepoint();
+
+    // 将编码下的顺序写回数据库（从 fromPosition 开始）
+    bool writePositions(const std::string& code, size_t fromPosition);
+    bool loadIndex();
+
+    // 元数据（custom_phrase_meta 表），不存在时返回空字符串
+    std::string readMeta(const std::string& key) const;
+    bool writeMeta(const std::string& key, const std::string& value);
+
+    // 成员变量
+    bool initialized_ = false;
+    std::string dataDir_;
+    std::string dbPath_;
+    sqlite3* db_ = nullptr;
+
+    // 内存索引：编码 -> 按顺序排列的短语
+    std::unordered_map<std::string, std::vector<std::string>> phrasesByCode_;
+    int64_t phraseCount_ = 0;
+
+    // 预编译语句
+    sqlite3_stmt* stmtInsert_ = nullptr;
+    sqlite3_stmt* stmtDelete_ = nullptr;
+    sqlite3_stmt* stmtUpdatePosition_ = nullptr;
+};
+
+} // namespace suyan
+
+#endif // SUYAN_CORE_CUSTOM_PHRASE_MANAGER_H
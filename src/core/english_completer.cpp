@@ -0,0 +1,424 @@
+/**
+ * EnglishCompleter - 英文单词补全实现
+ */
+
+#include "english_completer.h"
+#include "rime_dict.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+
+namespace fs = std::filesystem;
+
+namespace suyan {
+
+namespace {
+
+// ========== 常量 ==========
+
+constexpr char kIndexMagic[4] = {'S', 'Y', 'E', 'N'};
+constexpr uint32_t kIndexVersion = 1;
+constexpr size_t kMaxEntriesPerPrefix = 8;      // 每个前缀保留的单词数量
+
+// ========== 索引文件格式 ==========
+//
+// [IndexHeader][IndexNode × nodeCount][uint32 单词序号 × entryCount]
+// [IndexWord × wordCount][字符串池]
+//
+// 节点按（前缀长度，前缀字典序）排列，0 号为根节点。
+// 同一节点的子节点在数组中连续，且按字节升序，查找时二分。
+
+struct IndexHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t nodeCount;
+    uint32_t entryCount;
+    uint32_t wordCount;
+    uint32_t poolSize;
+};
+
+struct IndexNode {
+    uint32_t byte;          // 到达该节点的字符（小写，根节点为 0）
+    uint32_t firstChild;
+    uint32_t childCount;
+    uint32_t firstEntry;
+    uint32_t entryCount;    // 单词按排名排列
+};
+
+struct IndexWord {
+    uint32_t offset;        // 单词在字符串池中的偏移
+    uint32_t length;
+};
+
+static_assert(sizeof(IndexHeader) == 24, "IndexHeader layout");
+static_assert(sizeof(IndexNode) == 20, "IndexNode layout");
+static_assert(sizeof(IndexWord) == 8, "IndexWord layout");
+
+// ========== 索引生成 ==========
+
+struct BuildWord {
+    std::string text;
+    std::string key;        // 小写编码
+    int64_t weight;
+    uint32_t order;         // 词库中的先后顺序
+};
+
+/**
+ * 一个（前缀，单词）候选，前缀为单词编码的前 keyLength 个字符
+ */
+struct BuildRecord {
+    uint32_t word;
+    uint32_t keyLength;
+};
+
+bool isKeyChar(unsigned char c) {
+    return std::islower(c) || std::isdigit(c);
+}
+
+std::string toLower(const std::string& s) {
+    std::string out = s;
+    std::transform(out.begin(), out.end(), out.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return out;
+}
+
+/**
+ * 按输入的大小写调整词库中的全小写单词
+ */
+std::string applyCase(const std::string& typed, const std::string& word) {
+    bool wordHasUpper = std::any_of(word.begin(), word.end(),
+                                    [](unsigned char c) { return std::isupper(c); });
+    if (wordHasUpper || typed.empty()) {
+        return word;
+    }
+
+    size_t letters = 0;
+    bool allUpper = true;
+    for (unsigned char c : typed) {
+        if (std::isalpha(c)) {
+            ++letters;
+            allUpper = allUpper && std::isupper(c);
+        }
+    }
+
+    std::string out = word;
+    if (letters >= 2 && allUpper) {
+        std::transform(out.begin(), out.end(), out.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    } else if (std::isupper(static_cast<unsigned char>(typed[0])) && !out.empty()) {
+        out[0] = static_cast<char>(std::toupper(static_cast<unsigned char>(out[0])));
+    }
+    return out;
+}
+
+} // anonymous namespace
+
+// ========== 单例 ==========
+
+EnglishCompleter& EnglishCompleter::instance() {
+    static EnglishCompleter instance;
+    return instance;
+}
+
+// ========== 初始化与关闭 ==========
+
+bool EnglishCompleter::initialize(const std::string& userDataDir, const std::string& sharedDataDir) {
+    if (isInitialized()) {
+        return true;
+    }
+
+    indexPath_ = userDataDir + "/english.bin";
+
+    // 词库有更新时重新生成索引
+    auto dictPaths = RimeDict::collectTables(userDataDir, sharedDataDir, "melt_eng");
+    std::error_code ec;
+    bool needsBuild = !dictPaths.empty();
+    if (needsBuild && fs::exists(indexPath_, ec)) {
+        auto indexTime = fs::last_write_time(indexPath_, ec);
+        needsBuild = std::any_of(dictPaths.begin(), dictPaths.end(), [&](const std::string& path) {
+            std::error_code sourceEc;
+            auto sourceTime = fs::last_write_time(path, sourceEc);
+            return sourceEc || sourceTime > indexTime;
+        });
+    }
+    if (needsBuild) {
+        buildIndex(dictPaths, indexPath_);
+    }
+
+    if (!loadIndex(indexPath_)) {
+        std::cerr << "EnglishCompleter: Index unavailable, completion disabled" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void EnglishCompleter::shutdown() {
+    index_.close();
+    nodeCount_ = 0;
+    entryCount_ = 0;
+    wordCount_ = 0;
+}
+
+// ========== 查询 ==========
+
+std::vector<std::string> EnglishCompleter::complete(const std::string& prefix, size_t limit) const {
+    std::vector<std::string> results;
+    if (!index_.isOpen() || prefix.empty() || limit == 0) {
+        return results;
+    }
+
+    const auto* nodes = reinterpret_cast<const IndexNode*>(index_.data() + sizeof(IndexHeader));
+    const auto* entries = reinterpret_cast<const uint32_t*>(nodes + nodeCount_);
+    const auto* words = reinterpret_cast<const IndexWord*>(entries + entryCount_);
+    const auto* pool = reinterpret_cast<const char*>(words + wordCount_);
+
+    uint32_t current = 0;
+    for (unsigned char c : prefix) {
+        uint32_t byte = static_cast<uint32_t>(std::tolower(c));
+        const IndexNode& node = nodes[current];
+        const IndexNode* first = nodes + node.firstChild;
+        const IndexNode* last = first + node.childCount;
+        const IndexNode* child = std::lower_bound(first, last, byte,
+            [](const IndexNode& n, uint32_t b) { return n.byte < b; });
+        if (child == last || child->byte != byte) {
+            return results;
+        }
+        current = static_cast<uint32_t>(child - nodes);
+    }
+
+    const IndexNode& node = nodes[current];
+    for (uint32_t i = 0; i < node.entryCount && results.size() < limit; ++i) {
+        const IndexWord& word = words[entries[node.firstEntry + i]];
+        std::string text = applyCase(prefix, std::string(pool + word.offset, word.length));
+        if (std::find(results.begin(), results.end(), text) == results.end()) {
+            results.push_back(std::move(text));
+        }
+    }
+    return results;
+}
+
+// ========== 索引生成 ==========
+
+bool EnglishCompleter::buildIndex(const std::vector<std::string>& dictPaths, const std::string& outputPath) {
+    // 读取单词，同一单词只保留第一次出现（靠前的词库优先）
+    std::vector<BuildWord> buildWords;
+    std::unordered_map<std::string, uint32_t> seenWords;   // 文字 + 编码 -> 序号
+    for (const auto& path : dictPaths) {
+        RimeDict::forEachEntry(path, [&](const RimeDictEntry& entry) {
+            std::string key = toLower(entry.code.empty() ? entry.text : entry.code);
+            // 临时英文模式只能输入字母和数字
+            if (key.empty() || !std::all_of(key.begin(), key.end(),
+                                            [](unsigned char c) { return isKeyChar(c); })) {
+                return;
+            }
+            auto [it, inserted] = seenWords.emplace(entry.text + '\t' + key,
+                                                    static_cast<uint32_t>(buildWords.size()));
+            if (!inserted) {
+                buildWords[it->second].weight = std::max(buildWords[it->second].weight, entry.weight);
+                return;
+            }
+            buildWords.push_back({entry.text, key, entry.weight, static_cast<uint32_t>(buildWords.size())});
+        });
+    }
+
+    // 每个单词的每个编码前缀生成一条记录
+    std::vector<BuildRecord> records;
+    for (uint32_t w = 0; w < buildWords.size(); ++w) {
+        for (size_t k = 1; k <= buildWords[w].key.size(); ++k) {
+            records.push_back({w, static_cast<uint32_t>(k)});
+        }
+    }
+
+    auto keyCompare = [&](const BuildRecord& a, const BuildRecord& b) {
+        if (a.keyLength != b.keyLength) {
+            return a.keyLength < b.keyLength ? -1 : 1;
+        }
+        return buildWords[a.word].key.compare(0, a.keyLength, buildWords[b.word].key, 0, b.keyLength);
+    };
+
+    // 按（前缀长度，前缀）分组，组内按排名排序
+    std::sort(records.begin(), records.end(), [&](const BuildRecord& a, const BuildRecord& b) {
+        int cmp = keyCompare(a, b);
+        if (cmp != 0) {
+            return cmp < 0;
+        }
+        const BuildWord& wa = buildWords[a.word];
+        const BuildWord& wb = buildWords[b.word];
+        if (wa.weight != wb.weight) {
+            return wa.weight > wb.weight;
+        }
+        if (wa.key.size() != wb.key.size()) {
+            return wa.key.size() < wb.key.size();
+        }
+        return wa.order < wb.order;
+    });
+
+    std::vector<IndexNode> nodes;
+    std::vector<uint32_t> entries;
+    std::vector<const BuildRecord*> nodeKeys;   // 每个节点对应的前缀（根节点为空）
+    std::vector<IndexWord> words;
+    std::string pool;
+    std::unordered_map<uint32_t, uint32_t> wordIndex;   // 源序号 -> 输出序号
+
+    nodes.push_back({0, 0, 0, 0, 0});
+    nodeKeys.push_back(nullptr);
+
+    for (size_t i = 0; i < records.size();) {
+        size_t groupEnd = i;
+        while (groupEnd < records.size() && keyCompare(records[groupEnd], records[i]) == 0) {
+            ++groupEnd;
+        }
+
+        const BuildRecord& first = records[i];
+        IndexNode node{static_cast<uint8_t>(buildWords[first.word].key[first.keyLength - 1]), 0, 0,
+                       static_cast<uint32_t>(entries.size()), 0};
+        std::vector<const std::string*> seen;
+        for (size_t j = i; j < groupEnd && seen.size() < kMaxEntriesPerPrefix; ++j) {
+            const BuildWord& word = buildWords[records[j].word];
+            if (std::any_of(seen.begin(), seen.end(), [&](const std::string* s) { return *s == word.text; })) {
+                continue;  // 同一单词的多个编码
+            }
+            seen.push_back(&word.text);
+
+            auto [it, inserted] = wordIndex.emplace(records[j].word, static_cast<uint32_t>(words.size()));
+            if (inserted) {
+                words.push_back({static_cast<uint32_t>(pool.size()), static_cast<uint32_t>(word.text.size())});
+                pool += word.text;
+            }
+            entries.push_back(it->second);
+        }
+        node.entryCount = static_cast<uint32_t>(entries.size()) - node.firstEntry;
+        nodes.push_back(node);
+        nodeKeys.push_back(&first);
+
+        i = groupEnd;
+    }
+
+    // 建立父子关系：节点已按层、字典序排列，同一父节点的子节点连续
+    size_t parent = 0;
+    for (size_t child = 1; child < nodes.size(); ++child) {
+        const BuildRecord* key = nodeKeys[child];
+        uint32_t parentLength = key->keyLength - 1;
+        auto parentMatches = [&](size_t p) {
+            const BuildRecord* pk = nodeKeys[p];
+            uint32_t pkLength = pk ? pk->keyLength : 0;
+            return pkLength == parentLength &&
+                   (parentLength == 0 ||
+                    buildWords[pk->word].key.compare(0, parentLength,
+                                                     buildWords[key->word].key, 0, parentLength) == 0);
+        };
+        while (parent < child && !parentMatches(parent)) {
+            ++parent;
+        }
+        if (parent == child) {
+            std::cerr << "EnglishCompleter: Orphan prefix node, aborting build" << std::endl;
+            return false;
+        }
+        if (nodes[parent].childCount == 0) {
+            nodes[parent].firstChild = static_cast<uint32_t>(child);
+        }
+        nodes[parent].childCount++;
+    }
+
+    IndexHeader header{};
+    std::memcpy(header.magic, kIndexMagic, sizeof(header.magic));
+    header.version = kIndexVersion;
+    header.nodeCount = static_cast<uint32_t>(nodes.size());
+    header.entryCount = static_cast<uint32_t>(entries.size());
+    header.wordCount = static_cast<uint32_t>(words.size());
+    header.poolSize = static_cast<uint32_t>(pool.size());
+
+    std::error_code ec;
+    fs::create_directories(fs::path(outputPath).parent_path(), ec);
+
+    std::string tempPath = outputPath + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            std::cerr << "EnglishCompleter: Failed to create " << tempPath << std::endl;
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(nodes.data()), nodes.size() * sizeof(IndexNode));
+        out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(uint32_t));
+        out.write(reinterpret_cast<const char*>(words.data()), words.size() * sizeof(IndexWord));
+        out.write(pool.data(), static_cast<std::streamsize>(pool.size()));
+        if (!out.good()) {
+            std::cerr << "EnglishCompleter: Failed to write " << tempPath << std::endl;
+            out.close();
+            fs::remove(tempPath, ec);
+            return false;
+        }
+    }
+
+    fs::rename(tempPath, outputPath, ec);
+    if (ec) {
+        std::cerr << "EnglishCompleter: Failed to rename " << tempPath
+                  << ": " << ec.message() << std::endl;
+        return false;
+    }
+
+    std::cout << "EnglishCompleter: Built index with " << words.size() << " words, "
+              << nodes.size() << " prefixes" << std::endl;
+    return true;
+}
+
+// ========== 索引映射 ==========
+
+bool EnglishCompleter::loadIndex(const std::string& indexPath) {
+    shutdown();
+
+    if (!index_.open(indexPath)) {
+        return false;
+    }
+
+    const uint8_t* data = index_.data();
+    size_t size = index_.size();
+    IndexHeader header{};
+    if (size >= sizeof(header)) {
+        std::memcpy(&header, data, sizeof(header));
+    }
+
+    // 校验文件头和各段大小，避免损坏的文件导致越界访问
+    bool valid = size >= sizeof(header) &&
+                 std::memcmp(header.magic, kIndexMagic, sizeof(header.magic)) == 0 &&
+                 header.version == kIndexVersion &&
+                 header.nodeCount >= 1 &&
+                 sizeof(IndexHeader) +
+                     static_cast<uint64_t>(header.nodeCount) * sizeof(IndexNode) +
+                     static_cast<uint64_t>(header.entryCount) * sizeof(uint32_t) +
+                     static_cast<uint64_t>(header.wordCount) * sizeof(IndexWord) +
+                     header.poolSize == size;
+    if (valid) {
+        const auto* nodes = reinterpret_cast<const IndexNode*>(data + sizeof(IndexHeader));
+        const auto* entries = reinterpret_cast<const uint32_t*>(nodes + header.nodeCount);
+        const auto* words = reinterpret_cast<const IndexWord*>(entries + header.entryCount);
+        for (uint32_t i = 0; valid && i < header.nodeCount; ++i) {
+            valid = static_cast<uint64_t>(nodes[i].firstChild) + nodes[i].childCount <= header.nodeCount &&
+                    static_cast<uint64_t>(nodes[i].firstEntry) + nodes[i].entryCount <= header.entryCount;
+        }
+        for (uint32_t i = 0; valid && i < header.entryCount; ++i) {
+            valid = entries[i] < header.wordCount;
+        }
+        for (uint32_t i = 0; valid && i < header.wordCount; ++i) {
+            valid = static_cast<uint64_t>(words[i].offset) + words[i].length <= header.poolSize;
+        }
+    }
+
+    if (!valid) {
+        std::cerr << "EnglishCompleter: Invalid index file " << indexPath << std::endl;
+        index_.close();
+        return false;
+    }
+
+    nodeCount_ = header.nodeCount;
+    entryCount_ = header.entryCount;
+    wordCount_ = header.wordCount;
+    return true;
+}
+
+} // namespace suyan
@@ -0,0 +1,114 @@
+/**
+ * EnglishCompleter - 英文单词补全
+ *
+ * 临时英文模式（大写字母开头）下，按已输入的前缀给出完整单词。
+ *
+ * 数据来源为 melt_eng.dict.yaml 引用的英文词库（en.dict.yaml、en_ext.dict.yaml）。
+ * 部署时按编码建立前缀树，每个前缀节点预先保存排名最高的若干单词，
+ * 写入用户目录的 english.bin，运行时以 mmap 方式只读映射。
+ * 查询只需沿前缀逐字节二分查找子节点，耗时在微秒级。
+ *
+ * 排序规则：权重降序，其次编码较短者优先，再其次按词库顺序。
+ * 英文词库大多没有权重，此时较短的单词排在前面。
+ */
+
+#ifndef SUYAN_CORE_ENGLISH_COMPLETER_H
+#define SUYAN_CORE_ENGLISH_COMPLETER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "mapped_file.h"
+
+namespace suyan {
+
+/**
+ * EnglishCompleter - 英文单词补全类
+ *
+ * 单例模式。
+ */
+class EnglishCompleter {
+public:
+    /**
+     * 获取单例实例
+     */
+    static EnglishCompleter& instance();
+
+    // 禁止拷贝和移动
+    EnglishCompleter(const EnglishCompleter&) = delete;
+    EnglishCompleter& operator=(const EnglishCompleter&) = delete;
+    EnglishCompleter(EnglishCompleter&&) = delete;
+    EnglishCompleter& operator=(EnglishCompleter&&) = delete;
+
+    /**
+     * 初始化
+     *
+     * 词库比索引文件新（或索引不存在）时重新生成索引，然后映射索引。
+     *
+     * @param userDataDir 用户数据目录（存放 english.bin）
+     * @param sharedDataDir 共享数据目录（词库所在目录）
+     * @return 是否成功（索引不可用时返回 false）
+     */
+    bool initialize(const std::string& userDataDir, const std::string& sharedDataDir);
+
+    /**
+     * 关闭（解除映射）
+     */
+    void shutdown();
+
+    /**
+     * 检查是否已初始化
+     */
+    bool isInitialized() const { return index_.isOpen(); }
+
+    /**
+     * 获取索引文件路径
+     */
+    std::string getIndexPath() const { return indexPath_; }
+
+    /**
+     * 查询前缀对应的单词
+     *
+     * 前缀不区分大小写。词库中全小写的单词按输入的大小写调整：
+     * 首字母大写时首字母大写，全部大写（至少两个字母）时整词大写；
+     * 词库中带大写的单词（如 iPhone、HTML）保持原样。
+     *
+     * @param prefix 已输入的前缀（字母和数字）
+     * @param limit 最多返回的数量
+     * @return 补全结果，按排名排列
+     */
+    std::vector<std::string> complete(const std::string& prefix, size_t limit) const;
+
+    /**
+     * 从词库生成补全索引
+     *
+     * 先写入临时文件，成功后再替换目标文件。
+     *
+     * @param dictPaths 词库文件（*.dict.yaml），靠前的词库优先
+     * @param outputPath 索引文件路径
+     * @return 是否成功
+     */
+    static bool buildIndex(const std::vector<std::string>& dictPaths, const std::string& outputPath);
+
+    /**
+     * 映射索引文件
+     *
+     * @return 是否成功（文件不存在或格式不符时返回 false）
+     */
+    bool loadIndex(const std::string& indexPath);
+
+private:
+    EnglishCompleter() = default;
+    ~EnglishCompleter() = default;
+
+    std::string indexPath_;
+    MappedFile index_;
+    uint32_t nodeCount_ = 0;
+    uint32_t entryCount_ = 0;
+    uint32_t wordCount_ = 0;
+};
+
+} // namespace suyan
+
+#endif // SUYAN_CORE_ENGLISH_COMPLETER_H
@@ -5,6 +5,7 @@
 // Qt 头文件必须在 rime_api.h 之前包含，因为 rime_api.h 定义了 #define Bool int
 // 这会与 Qt 的 qmetatype.h 冲突
 #include "frequency_manager.h"  // 包含 QObject，必须在 rime_api.h 之前
+#include "custom_phrase_manager.h"
 
 // 取消 Bool 宏定义（如果已定义）
 #ifdef Bool
@@ -12,9 +13,13 @@
 #endif
 
 #include "input_engine.h"
+#include "association_engine.h"
+#include "cn_en_generator.h"
+#include "english_completer.h"
 #include "config_manager.h"
 #include "platform_bridge.h"
 #include "rime_wrapper.h"
+#include <algorithm>
 #include <cctype>
 #include <iostream>
 
@@ -25,6 +30,16 @@
 
 namespace suyan {
 
+namespace {
+
+// 提交后最多显示的联想数量
+constexpr size_t kMaxAssociations = 5;
+
+// 临时英文模式最多显示的单词补全数量
+constexpr size_t kMaxEnglishCompletions = 6;
+
+} // anonymous namespace
+
 // ========== 构造与析构 ==========
 
 InputEngine::InputEngine() = default;
@@ -48,8 +63,19 @@ bool InputEngine::initialize(const std::string& userDataDir,
         return false;
     }
 
-    // 启动维护任务并等待完成
-    rime.startMaintenance(false);
+    userDataDir_ = userDataDir;
+    sharedDataDir_ = sharedDataDir;
+
+    // 生成当前双拼方案所需的中英混输词库，需在部署前完成
+    activeSchemaId_ = CnEnGenerator::detectActiveSchema(userDataDir, sharedDataDir);
+    bool variantRegenerated = false;
+    CnEnGenerator::deployVariant(activeSchemaId_, userDataDir, sharedDataDir, &variantRegenerated);
+
+    // 临时英文模式的单词补全索引（词库有更新时重新生成）
+    EnglishCompleter::instance().initialize(userDataDir, sharedDataDir);
+
+    // 启动维护任务并等待完成（变体重新生成时完整检查，见 applyPendingSchemaChange）
+    rime.startMaintenance(variantRegenerated);
     rime.joinMaintenanceThread();
 
     // 创建会话
@@ -59,6 +85,12 @@ bool InputEngine::initialize(const std::string& userDataDir,
         return false;
     }
 
+    // 方案切换（包括 RIME 方案选单中的切换）通过通知得知
+    rime.setNotificationCallback([this](RimeSessionId, const std::string& messageType,
+                                        const std::string& messageValue) {
+        handleRimeNotification(messageType, messageValue);
+    });
+
     initialized_ = true;
     mode_ = InputMode::Chinese;
     return true;
@@ -70,11 +102,19 @@ void InputEngine::shutdown() {
     }
 
     auto& rime = RimeWrapper::instance();
+    if (schemaReloadPending_) {
+        rime.joinMaintenanceThread();
+        schemaReloadPending_ = false;
+    }
+    rime.setNotificationCallback(nullptr);
+
     if (sessionId_ != 0) {
         rime.destroySession(sessionId_);
         sessionId_ = 0;
     }
 
+    EnglishCompleter::instance().shutdown();
+
     initialized_ = false;
 }
 
@@ -91,6 +131,8 @@ bool InputEngine::processKeyEvent(int keyCode, int modifiers) {
         return false;
     }
 
+    reloadSchemaIfDeployed();
+
     // 根据当前模式分发处理
     bool handled = false;
     switch (mode_) {
@@ -105,12 +147,80 @@ bool InputEngine::processKeyEvent(int keyCode, int modifiers) {
             break;
     }
 
+    // 联想发生变化但处理流程没有刷新状态时（如直接提交数字、按键关闭联想后未被处理），
+    // 补发一次通知，让 UI 关闭或更新联想
+    if (associationsChanged_) {
+        updateState();
+        notifyStateChanged();
+    }
+
+    // 方案在本次按键中切换时，按键处理完成、没有输入中的内容后再生成变体并部署
+    applyPendingSchemaChange();
+
     return handled;
 }
 
+KeySequenceResult InputEngine::processKeySequence(const KeyEvent* keys, size_t count,
+                                                  const UnhandledKeyCallback& onUnhandled) {
+    KeySequenceResult result;
+    if (!initialized_ || keys == nullptr || count == 0) {
+        return result;
+    }
+
+    // 批量处理期间 updateState/notifyStateChanged 只标记脏状态，
+    // notifyCommitText 只累积文字，避免每个按键都查询候选词并刷新 UI
+    batching_ = true;
+    stateDirty_ = false;
+    pendingCommitText_.clear();
+
+    // 提交累积的文字（未处理的按键之前、结束时）
+    auto flushCommit = [this, &result]() {
+        if (pendingCommitText_.empty()) {
+            return;
+        }
+        std::string text;
+        text.swap(pendingCommitText_);
+        if (commitTextCallback_) {
+            commitTextCallback_(text);
+        }
+        result.outputs.push_back(KeySequenceOutput{true, std::move(text), KeyEvent{0, 0}});
+    };
+
+    for (size_t i = 0; i < count; ++i) {
+        if (processKeyEvent(keys[i].keyCode, keys[i].modifiers)) {
+            ++result.handledCount;
+            continue;
+        }
+
+        // 未处理的按键由应用处理，之前提交的文字必须先到达应用
+        flushCommit();
+        result.outputs.push_back(KeySequenceOutput{false, std::string(), keys[i]});
+        if (onUnhandled) {
+            onUnhandled(keys[i]);
+        }
+    }
+
+    batching_ = false;
+    flushCommit();
+    applyPendingSchemaChange();
+
+    if (stateDirty_) {
+        stateDirty_ = false;
+        updateState();
+        notifyStateChanged();
+    }
+
+    return result;
+}
+
 bool InputEngine::handleChineseMode(int keyCode, int modifiers) {
     auto& rime = RimeWrapper::instance();
 
+    // 联想窗口显示时，数字键直接提交联想短语，其他按键关闭联想后按正常流程处理
+    if (handleAssociationKey(keyCode, modifiers)) {
+        return true;
+    }
+
     // 检查是否应该进入临时英文模式（大写字母开头）
     if (!isComposing() && shouldEnterTempEnglish(keyCode, modifiers)) {
         mode_ = InputMode::TempEnglish;
@@ -118,6 +228,7 @@ bool InputEngine::handleChineseMode(int keyCode, int modifiers) {
         // 添加首字母（大写）
         char c = static_cast<char>(keyCode);
         tempEnglishBuffer_ += c;
+        updateTempEnglishCandidates();
         notifyStateChanged();
         return true;
     }
@@ -273,6 +384,11 @@ bool InputEngine::handleChineseMode(int keyCode, int modifiers) {
         }
     }
     
+    // 自定义短语排在首页最前，其选择由引擎处理
+    if (handleCustomPhraseSelection(keyCode, modifiers)) {
+        return true;
+    }
+
     // 如果按了其他键，退出展开模式
     if (isExpanded_ && keyCode != KeyCode::BackSpace) {
         resetExpandedState();
@@ -359,8 +475,19 @@ bool InputEngine::handleEnglishMode(int keyCode, int modifiers) {
 }
 
 bool InputEngine::handleTempEnglishMode(int keyCode, int modifiers) {
-    // 空格或回车：提交临时英文并退出
-    if (keyCode == KeyCode::Space || keyCode == KeyCode::Return) {
+    // 空格：提交高亮的候选（默认为输入原文）并退出
+    if (keyCode == KeyCode::Space) {
+        if (tempEnglishHighlight_ > 0 &&
+            tempEnglishHighlight_ < static_cast<int>(tempEnglishCandidates_.size())) {
+            tempEnglishBuffer_ = tempEnglishCandidates_[tempEnglishHighlight_];
+        }
+        commitTempEnglishBuffer();
+        exitTempEnglishMode();
+        return true;
+    }
+
+    // 回车：提交输入原文并退出
+    if (keyCode == KeyCode::Return) {
         commitTempEnglishBuffer();
         exitTempEnglishMode();
         return true;
@@ -380,16 +507,32 @@ bool InputEngine::handleTempEnglishMode(int keyCode, int modifiers) {
             tempEnglishBuffer_.pop_back();
             if (tempEnglishBuffer_.empty()) {
                 exitTempEnglishMode();
+            } else {
+                updateTempEnglishCandidates();
             }
             notifyStateChanged();
         }
         return true;
     }
 
+    // Tab / 左右方向键：在补全候选间移动高亮（有补全时才处理）
+    if (tempEnglishCandidates_.size() > 1 && modifiers == 0 &&
+        (keyCode == KeyCode::Tab || keyCode == KeyCode::Left || keyCode == KeyCode::Right)) {
+        int count = static_cast<int>(tempEnglishCandidates_.size());
+        if (keyCode == KeyCode::Left) {
+            tempEnglishHighlight_ = (tempEnglishHighlight_ + count - 1) % count;
+        } else {
+            tempEnglishHighlight_ = (tempEnglishHighlight_ + 1) % count;
+        }
+        notifyStateChanged();
+        return true;
+    }
+
     // 字母和数字：添加到缓冲区
     if (isAlphaKey(keyCode) || isDigitKey(keyCode)) {
         char c = static_cast<char>(keyCode);
         tempEnglishBuffer_ += c;
+        updateTempEnglishCandidates();
         notifyStateChanged();
         return true;
     }
@@ -405,7 +548,32 @@ bool InputEngine::handleTempEnglishMode(int keyCode, int modifiers) {
 // ========== 候选词操作 ==========
 
 bool InputEngine::selectCandidate(int index) {
-    if (!initialized_ || !isComposing()) {
+    if (!initialized_) {
+        return false;
+    }
+
+    // 临时英文的补全候选
+    if (mode_ == InputMode::TempEnglish) {
+        if (index < 1 || index > static_cast<int>(tempEnglishCandidates_.size())) {
+            return false;
+        }
+        tempEnglishBuffer_ = tempEnglishCandidates_[index - 1];
+        commitTempEnglishBuffer();
+        exitTempEnglishMode();
+        notifyStateChanged();
+        return true;
+    }
+
+    // 联想候选（此时 RIME 不在输入状态）
+    if (!associations_.empty() && !isComposing()) {
+        if (index < 1 || index > static_cast<int>(associations_.size())) {
+            return false;
+        }
+        commitAssociation(static_cast<size_t>(index - 1));
+        return true;
+    }
+
+    if (!isComposing()) {
         return false;
     }
 
@@ -414,6 +582,11 @@ bool InputEngine::selectCandidate(int index) {
         return false;
     }
 
+    // 首页前插了自定义短语时，按显示顺序选择
+    if (handleCustomPhraseSelection('0' + index, 0)) {
+        return true;
+    }
+
     auto& rime = RimeWrapper::instance();
     
     // 在选择之前，获取当前候选词信息用于词频更新
@@ -517,6 +690,7 @@ void InputEngine::setMode(InputMode mode) {
     }
 
     mode_ = mode;
+    clearAssociations();
 
     // 同步到 RIME 的 ascii_mode 选项
     if (initialized_ && sessionId_ != 0) {
@@ -554,12 +728,31 @@ InputState InputEngine::getState() const {
         state.preedit = tempEnglishBuffer_;
         state.rawInput = tempEnglishBuffer_;
         state.isComposing = !tempEnglishBuffer_.empty();
+        for (size_t i = 0; i < tempEnglishCandidates_.size(); ++i) {
+            InputCandidate candidate;
+            candidate.text = tempEnglishCandidates_[i];
+            candidate.index = static_cast<int>(i + 1);  // 1-based
+            state.candidates.push_back(candidate);
+        }
+        state.highlightedIndex = tempEnglishHighlight_;
         return state;
     }
 
     // 中文模式：从 RIME 获取状态
     auto& rime = RimeWrapper::instance();
 
+    // 联想：提交后、开始新的输入之前显示
+    if (!associations_.empty() && !rime.getState(sessionId_).isComposing) {
+        for (size_t i = 0; i < associations_.size(); ++i) {
+            InputCandidate candidate;
+            candidate.text = associations_[i];
+            candidate.index = static_cast<int>(i + 1);  // 1-based
+            state.candidates.push_back(candidate);
+        }
+        state.isComposing = true;  // 让平台层显示候选词窗口
+        return state;
+    }
+
     // 获取组合信息
     auto composition = rime.getComposition(sessionId_);
     state.preedit = composition.preedit;
@@ -630,7 +823,35 @@ InputState InputEngine::getState() const {
 
         // 注意：不再在 UI 层面重新排序候选词，因为这会导致显示和实际选择不一致
         // RIME 自己会根据用户选择学习词频
-        state.candidates = originalCandidates;
+        // 自定义短语只在首页前插，选择时由 handleCustomPhraseSelection 对应处理
+        // 合并后不超过一页，数字键 1-9 都能选到
+        const auto& customPhrases = customPhrasesForCurrentInput();
+        if (!customPhrases.empty()) {
+            size_t pageSize = static_cast<size_t>(state.pageSize);
+            std::vector<InputCandidate> merged;
+            merged.reserve(pageSize);
+            for (const auto& phrase : customPhrases) {
+                if (merged.size() >= pageSize) {
+                    break;
+                }
+                InputCandidate candidate;
+                candidate.text = phrase;
+                candidate.index = static_cast<int>(merged.size() + 1);
+                merged.push_back(candidate);
+            }
+            for (auto candidate : originalCandidates) {
+                if (merged.size() >= pageSize) {
+                    break;
+                }
+                candidate.index = static_cast<int>(merged.size() + 1);
+                merged.push_back(candidate);
+            }
+            state.candidates = std::move(merged);
+            // 首个自定义短语为首选，空格上屏的就是它
+            state.highlightedIndex = 0;
+        } else {
+            state.candidates = originalCandidates;
+        }
     }
 
     // 检查是否正在输入
@@ -647,6 +868,7 @@ void InputEngine::reset() {
 
     // 清空临时英文缓冲区
     tempEnglishBuffer_.clear();
+    clearAssociations();
 
     // 清空 RIME 输入
     auto& rime = RimeWrapper::instance();
@@ -725,6 +947,112 @@ void InputEngine::setCommitTextCallback(CommitTextCallback callback) {
     commitTextCallback_ = std::move(callback);
 }
 
+// ========== 方案与部署 ==========
+
+bool InputEngine::selectSchema(const std::string& schemaId) {
+    if (!initialized_) {
+        return false;
+    }
+
+    if (!RimeWrapper::instance().selectSchema(sessionId_, schemaId)) {
+        return false;
+    }
+
+    // 通常已在方案通知中记录，不在按键处理中时立即生成变体并部署
+    onSchemaChanged(schemaId);
+    applyPendingSchemaChange();
+    return true;
+}
+
+bool InputEngine::deploy() {
+    if (!initialized_) {
+        return false;
+    }
+
+    auto& rime = RimeWrapper::instance();
+    if (schemaReloadPending_) {
+        rime.joinMaintenanceThread();
+    }
+
+    // 尚未处理的方案切换随本次部署一起完成
+    if (!pendingSchemaId_.empty()) {
+        activeSchemaId_.swap(pendingSchemaId_);
+        pendingSchemaId_.clear();
+    }
+    CnEnGenerator::deployVariant(activeSchemaId_, userDataDir_, sharedDataDir_);
+    if (!rime.startMaintenance(true)) {
+        std::cerr << "InputEngine: Failed to start deployment" << std::endl;
+        return false;
+    }
+    schemaReloadPending_ = true;
+    return true;
+}
+
+void InputEngine::handleRimeNotification(const std::string& messageType,
+                                         const std::string& messageValue) {
+    // 方案通知的值为 "方案ID/方案名称"；部署通知来自维护线程，不在这里处理
+    if (messageType != "schema") {
+        return;
+    }
+    onSchemaChanged(messageValue.substr(0, messageValue.find('/')));
+}
+
+void InputEngine::onSchemaChanged(const std::string& schemaId) {
+    // 通知在 RIME 处理按键期间发出，这里只记录，由 applyPendingSchemaChange 在按键处理完成后部署
+    if (schemaId.empty()) {
+        return;
+    }
+    pendingSchemaId_ = schemaId;
+}
+
+void InputEngine::applyPendingSchemaChange() {
+    if (pendingSchemaId_.empty() || batching_ || isComposing()) {
+        return;
+    }
+    std::string schemaId;
+    schemaId.swap(pendingSchemaId_);
+    if (schemaId == activeSchemaId_) {
+        return;
+    }
+    activeSchemaId_ = schemaId;
+
+    bool regenerated = false;
+    if (!CnEnGenerator::deployVariant(schemaId, userDataDir_, sharedDataDir_, &regenerated) ||
+        !regenerated) {
+        return;     // 变体已是最新，已编译的词库无需更新
+    }
+
+    // 上一次部署完成后才能开始新的部署
+    auto& rime = RimeWrapper::instance();
+    if (schemaReloadPending_) {
+        rime.joinMaintenanceThread();
+    }
+
+    // 变体位于 en_dicts/ 子目录，RIME 的修改检测只检查顶层文件，
+    // 需完整检查才能按词库校验和重新编译受影响的词典
+    if (rime.startMaintenance(true)) {
+        schemaReloadPending_ = true;
+    } else {
+        std::cerr << "InputEngine: Failed to start deployment for " << schemaId << std::endl;
+    }
+}
+
+void InputEngine::reloadSchemaIfDeployed() {
+    if (!schemaReloadPending_ || isComposing()) {
+        return;
+    }
+
+    auto& rime = RimeWrapper::instance();
+    if (rime.isMaintenanceMode()) {
+        return;     // 部署尚未完成
+    }
+    rime.joinMaintenanceThread();
+    schemaReloadPending_ = false;
+
+    // 重新选择方案，加载新编译的词库
+    rime.selectSchema(sessionId_, activeSchemaId_);
+}
+
 // ========== 激活/停用 ==========
 
 void InputEngine::activate() {
@@ -737,16 +1065,28 @@ void InputEngine::deactivate() {
     if (isComposing()) {
         reset();
     }
+    clearAssociations();
+    // 切换应用后的提交与之前的提交无关
+    AssociationEngine::instance().resetContext();
     active_ = false;
 }
 
 // ========== 内部方法 ==========
 
 void InputEngine::updateState() {
+    if (batching_) {
+        stateDirty_ = true;
+        return;
+    }
     cachedState_ = getState();
 }
 
 void InputEngine::notifyStateChanged() {
+    if (batching_) {
+        stateDirty_ = true;
+        return;
+    }
+    associationsChanged_ = false;
     if (stateChangedCallback_) {
         stateChangedCallback_(getState());
     }
@@ -757,6 +1097,11 @@ void InputEngine::notifyCommitText(const std::string& text) {
         // 记录最后提交的字符（用于数字后标点智能转换）
         lastCommittedChar_ = text.back();
     }
+    updateAssociations(text);
+    if (batching_) {
+        pendingCommitText_ += text;
+        return;
+    }
     if (commitTextCallback_) {
         commitTextCallback_(text);
     }
@@ -794,6 +1139,24 @@ bool InputEngine::shouldEnterTempEnglish(int keyCode, int modifiers) const {
 void InputEngine::exitTempEnglishMode() {
     mode_ = InputMode::Chinese;
     tempEnglishBuffer_.clear();
+    tempEnglishCandidates_.clear();
+    tempEnglishHighlight_ = 0;
+}
+
+void InputEngine::updateTempEnglishCandidates() {
+    tempEnglishCandidates_.clear();
+    tempEnglishHighlight_ = 0;
+
+    auto completions = EnglishCompleter::instance().complete(tempEnglishBuffer_, kMaxEnglishCompletions + 1);
+    for (auto& word : completions) {
+        if (word != tempEnglishBuffer_ && tempEnglishCandidates_.size() < kMaxEnglishCompletions) {
+            tempEnglishCandidates_.push_back(std::move(word));
+        }
+    }
+    // 输入原文始终作为第一项，空格默认提交原文
+    if (!tempEnglishCandidates_.empty()) {
+        tempEnglishCandidates_.insert(tempEnglishCandidates_.begin(), tempEnglishBuffer_);
+    }
 }
 
 void InputEngine::commitTempEnglishBuffer() {
@@ -1083,4 +1446,153 @@ void InputEngine::resetExpandedState() {
     }
 }
 
+// ========== 自定义短语 ==========
+
+const std::vector<std::string>& InputEngine::customPhrasesForCurrentInput() const {
+    static const std::vector<std::string> kEmpty;
+
+    // 只在未展开、未用方向键导航的中文模式首页显示
+    if (mode_ != InputMode::Chinese || isExpanded_ || !expandedCandidates_.empty() ||
+        sessionId_ == 0) {
+        return kEmpty;
+    }
+
+    auto& phraseMgr = CustomPhraseManager::instance();
+    if (!phraseMgr.isInitialized() || phraseMgr.getPhraseCount() == 0) {
+        return kEmpty;
+    }
+
+    auto& rime = RimeWrapper::instance();
+    const auto& phrases = phraseMgr.lookup(rime.getRawInput(sessionId_));
+    if (phrases.empty() || rime.getCandidateMenu(sessionId_).pageIndex != 0) {
+        return kEmpty;
+    }
+    return phrases;
+}
+
+bool InputEngine::handleCustomPhraseSelection(int keyCode, int modifiers) {
+    if (modifiers != 0 || !isComposing()) {
+        return false;
+    }
+
+    const auto& phrases = customPhrasesForCurrentInput();
+    if (phrases.empty()) {
+        return false;
+    }
+
+    auto& rime = RimeWrapper::instance();
+    std::string selectedText;
+
+    // 与 getState() 的显示一致：首个短语为首选，合并后不超过一页
+    int menuPageSize = rime.getCandidateMenu(sessionId_).pageSize;
+    size_t pageSize = static_cast<size_t>(menuPageSize > 0 ? menuPageSize : 9);
+    size_t phraseCount = std::min(phrases.size(), pageSize);
+
+    if (keyCode == KeyCode::Space) {
+        selectedText = phrases.front();
+    } else if (keyCode >= '1' && keyCode <= '9') {
+        size_t index = static_cast<size_t>(keyCode - '1');
+        if (index >= pageSize) {
+            return true;    // 超出当前页，与 RIME 一致不做处理
+        }
+        if (index < phraseCount) {
+            selectedText = phrases[index];
+        } else {
+            // 自定义短语之后的候选词整体后移，换算回 RIME 的页内索引
+            size_t rimeIndex = index - phraseCount;
+            if (rime.selectCandidateOnCurrentPage(sessionId_, rimeIndex)) {
+                std::string commitText = rime.getCommitText(sessionId_);
+                if (!commitText.empty()) {
+                    notifyCommitText(commitText);
+                }
+            }
+            updateState();
+            notifyStateChanged();
+            return true;
+        }
+    } else {
+        return false;
+    }
+
+    rime.clearComposition(sessionId_);
+    notifyCommitText(selectedText);
+    updateState();
+    notifyStateChanged();
+    return true;
+}
+
+// ========== 联想 ==========
+
+void InputEngine::setAssociationEnabled(bool enabled) {
+    associationEnabled_ = enabled;
+    if (!enabled) {
+        clearAssociations();
+    }
+}
+
+void InputEngine::updateAssociations(const std::string& committedText) {
+    auto& association = AssociationEngine::instance();
+    if (!association.isInitialized()) {
+        return;
+    }
+
+    association.recordCommit(committedText);
+
+    bool hadAssociations = !associations_.empty();
+    associations_.clear();
+    // 只在中文模式下、提交后没有剩余输入时联想；批量处理时用户仍在连续输入，联想不会显示
+    if (associationEnabled_ && !batching_ && mode_ == InputMode::Chinese && !isComposing()) {
+        associations_ = association.lookup(committedText, kMaxAssociations);
+    }
+    if (hadAssociations || !associations_.empty()) {
+        associationsChanged_ = true;
+    }
+}
+
+bool InputEngine::handleAssociationKey(int keyCode, int modifiers) {
+    if (associations_.empty()) {
+        return false;
+    }
+
+    // 批量处理中的按键是用户连续输入的，数字键按原样处理
+    if (batching_) {
+        clearAssociations();
+        return false;
+    }
+
+    if (modifiers == 0 && keyCode >= '1' && keyCode <= '9') {
+        size_t index = static_cast<size_t>(keyCode - '1');
+        if (index < associations_.size()) {
+            commitAssociation(index);
+            return true;
+        }
+    }
+
+    // Escape 只关闭联想
+    if (modifiers == 0 && keyCode == KeyCode::Escape) {
+        clearAssociations();
+        updateState();
+        notifyStateChanged();
+        return true;
+    }
+
+    clearAssociations();
+    return false;
+}
+
+void InputEngine::commitAssociation(size_t index) {
+    // 复制一份，notifyCommitText 会用新的联想替换 associations_
+    std::string text = associations_[index];
+    notifyCommitText(text);
+    updateState();
+    notifyStateChanged();
+}
+
+void InputEngine::clearAssociations() {
+    if (!associations_.empty()) {
+        associations_.clear();
+        associationsChanged_ = true;
+    }
+}
+
 } // namespace suyan
@@ -64,6 +64,36 @@ struct InputState {
     int totalCandidates;                    // 总候选词数量（用于多行显示）
 };
 
+/**
+ * 按键事件（批量处理使用）
+ */
+struct KeyEvent {
+    int keyCode;            // 键码
+    int modifiers;          // 修饰键掩码
+};
+
+/**
+ * 批量处理的一项输出：提交的文字或未处理的按键
+ */
+struct KeySequenceOutput {
+    bool isCommit = false;  // true: 提交的文字，false: 未处理的按键
+    std::string text;       // 提交的文字（isCommit 时有效，相邻的提交已合并）
+    KeyEvent key{0, 0};     // 未处理的按键（!isCommit 时有效）
+};
+
+/**
+ * 批量处理结果
+ */
+struct KeySequenceResult {
+    int handledCount = 0;                   // 引擎处理的按键数
+    std::vector<KeySequenceOutput> outputs; // 提交的文字与未处理的按键，按发生顺序交错
+};
+
+/**
+ * 未处理按键回调类型（批量处理时调用，应把按键交给应用）
+ */
+using UnhandledKeyCallback = std::function<void(const KeyEvent& key)>;
+
 /**
  * 状态变化回调类型
  */
@@ -177,6 +207,31 @@ public:
      */
     bool processKeyEvent(int keyCode, int modifiers);
 
+    /**
+     * 批量处理按键序列
+     *
+     * 用于粘贴拼音、宏展开、测试回放等场景。逐键交给 RIME 处理，
+     * 但期间不刷新状态：相邻的提交合并后一次性提交，结束时只发出一次状态变化通知。
+     *
+     * 遇到引擎不处理的按键时，先提交之前累积的文字，再调用 onUnhandled，
+     * 应用收到的文字和按键与逐键处理时的顺序一致。
+     *
+     * @param keys 按键数组
+     * @param count 按键数量
+     * @param onUnhandled 未处理按键回调（可为空）
+     * @return 处理的按键数，以及按顺序交错的提交文字和未处理按键
+     */
+    KeySequenceResult processKeySequence(const KeyEvent* keys, size_t count,
+                                         const UnhandledKeyCallback& onUnhandled = nullptr);
+
+    /**
+     * 批量处理按键序列（vector 版本）
+     */
+    KeySequenceResult processKeySequence(const std::vector<KeyEvent>& keys,
+                                         const UnhandledKeyCallback& onUnhandled = nullptr) {
+        return processKeySequence(keys.data(), keys.size(), onUnhandled);
+    }
+
     // ========== 候选词操作 ==========
 
     /**
@@ -280,6 +335,42 @@ public:
      */
     int getMinFrequencyForSorting() const { return minFrequencyForSorting_; }
 
+    // ========== 联想 ==========
+
+    /**
+     * 启用/禁用联想（提交后显示可能的后续短语），默认关闭，由配置 input.association 控制
+     *
+     * @param enabled 是否启用
+     */
+    void setAssociationEnabled(bool enabled);
+
+    /**
+     * 检查联想是否启用
+     */
+    bool isAssociationEnabled() const { return associationEnabled_; }
+
+    // ========== 方案与部署 ==========
+
+    /**
+     * 切换输入方案
+     *
+     * 切换后按新方案生成中英混输词库变体，变体有变化时在后台重新部署，
+     * 部署完成后的下一次按键重新加载方案。
+     *
+     * @param schemaId 方案 ID
+     * @return 是否成功
+     */
+    bool selectSchema(const std::string& schemaId);
+
+    /**
+     * 重新部署（用户修改配置或词库后调用）
+     *
+     * 先生成当前方案的中英混输词库变体，再在后台执行完整部署。
+     *
+     * @return 是否已开始部署
+     */
+    bool deploy();
+
     // ========== 激活/停用 ==========
 
     /**
@@ -307,8 +398,25 @@ private:
     bool shouldEnterTempEnglish(int keyCode, int modifiers) const;
     void exitTempEnglishMode();
     void commitTempEnglishBuffer();
+    void updateTempEnglishCandidates();
     void resetExpandedState();  // 重置展开状态
+
+    // 自定义短语相关
+    const std::vector<std::string>& customPhrasesForCurrentInput() const;
+    bool handleCustomPhraseSelection(int keyCode, int modifiers);
     
+    // 联想相关
+    void updateAssociations(const std::string& committedText);
+    bool handleAssociationKey(int keyCode, int modifiers);
+    void commitAssociation(size_t index);
+    void clearAssociations();
+
+    // 方案与部署相关
+    void handleRimeNotification(const std::string& messageType, const std::string& messageValue);
+    void onSchemaChanged(const std::string& schemaId);
+    void applyPendingSchemaChange();
+    void reloadSchemaIfDeployed();
+
     // 词频学习相关
     void updateFrequencyForSelectedCandidate(const std::string& text, const std::string& pinyin);
     std::vector<InputCandidate> applySortingWithUserFrequency(
@@ -322,8 +430,18 @@ private:
     RimeSessionId sessionId_ = 0;
     IPlatformBridge* platformBridge_ = nullptr;
 
+    // 数据目录与方案
+    std::string userDataDir_;
+    std::string sharedDataDir_;
+    std::string activeSchemaId_;        // 已生成词库变体的方案
+    bool schemaReloadPending_ = false;  // 后台部署完成后需重新加载方案
+    std::string pendingSchemaId_;       // 方案通知记录的新方案，按键处理完成后再部署
+
     // 临时英文模式缓冲区
     std::string tempEnglishBuffer_;
+    // 临时英文候选：第一项为缓冲区原文，其后为单词补全（无补全时为空）
+    std::vector<std::string> tempEnglishCandidates_;
+    int tempEnglishHighlight_ = 0;      // 当前高亮的候选 (0-based)
     
     // 词频学习设置
     // 注意：已禁用自定义词频学习，因为它会导致显示和实际选择不一致
@@ -338,9 +456,19 @@ private:
     int currentCol_ = 0;                // 当前选中的列 (0-based)
     std::vector<InputCandidate> expandedCandidates_;  // 展开模式下的所有候选词
     
+    // 联想（提交后、开始新的输入之前显示）
+    bool associationEnabled_ = false;
+    std::vector<std::string> associations_;     // 当前显示的联想短语
+    bool associationsChanged_ = false;          // 联想已变化但尚未通知 UI
+
     // 数字后标点智能转换
     char lastCommittedChar_ = 0;        // 上一个提交的字符（用于判断数字后的标点）
 
+    // 批量按键处理状态
+    bool batching_ = false;             // 是否处于 processKeySequence 中
+    bool stateDirty_ = false;           // 批量处理期间状态是否发生变化
+    std::string pendingCommitText_;     // 批量处理期间累积的提交文字
+
     // 回调
     StateChangedCallback stateChangedCallback_;
     CommitTextCallback commitTextCallback_;
@@ -0,0 +1,53 @@
+/**
+ * MappedFile - 只读内存映射文件实现
+ */
+
+#include "mapped_file.h"
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace suyan {
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    void* addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // 映射建立后即可关闭文件描述符
+    if (addr == MAP_FAILED) {
+        std::cerr << "MappedFile: Failed to map " << path << std::endl;
+        return false;
+    }
+
+    data_ = static_cast<const uint8_t*>(addr);
+    size_ = size;
+    return true;
+}
+
+void MappedFile::close() {
+    if (data_) {
+        ::munmap(const_cast<uint8_t*>(data_), size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+}
+
+} // namespace suyan
@@ -0,0 +1,66 @@
+/**
+ * MappedFile - 只读内存映射文件
+ *
+ * 部署时生成的索引（联想、英文补全等）运行时以只读方式映射，
+ * 由系统按需分页加载，多个进程间共享物理内存。
+ */
+
+#ifndef SUYAN_CORE_MAPPED_FILE_H
+#define SUYAN_CORE_MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace suyan {
+
+/**
+ * MappedFile - 只读内存映射文件类
+ *
+ * 析构时自动解除映射。
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    // 禁止拷贝
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * 映射文件（已映射时先解除之前的映射）
+     *
+     * @param path 文件路径
+     * @return 是否成功（文件不存在或为空时返回 false）
+     */
+    bool open(const std::string& path);
+
+    /**
+     * 解除映射
+     */
+    void close();
+
+    /**
+     * 检查是否已映射
+     */
+    bool isOpen() const { return data_ != nullptr; }
+
+    /**
+     * 获取映射的数据
+     */
+    const uint8_t* data() const { return data_; }
+
+    /**
+     * 获取映射的字节数
+     */
+    size_t size() const { return size_; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+} // namespace suyan
+
+#endif // SUYAN_CORE_MAPPED_FILE_H
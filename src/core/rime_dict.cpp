@@ -0,0 +1,129 @@
+/**
+ * RimeDict - RIME 词库文件读取实现
+ */
+
+#include "rime_dict.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+namespace suyan {
+
+namespace {
+
+std::string trim(const std::string& s) {
+    size_t start = s.find_first_not_of(" \t\r");
+    if (start == std::string::npos) {
+        return "";
+    }
+    size_t end = s.find_last_not_of(" \t\r");
+    return s.substr(start, end - start + 1);
+}
+
+} // anonymous namespace
+
+std::vector<std::string> RimeDict::collectTables(const std::string& userDataDir,
+                                                 const std::string& sharedDataDir,
+                                                 const std::string& dictName) {
+    std::vector<std::string> paths;
+
+    auto resolve = [&](const std::string& name) -> std::string {
+        for (const auto& dir : {userDataDir, sharedDataDir}) {
+            std::string path = dir + "/" + name + ".dict.yaml";
+            std::error_code ec;
+            if (!dir.empty() && fs::exists(path, ec)) {
+                return path;
+            }
+        }
+        return "";
+    };
+
+    std::string mainDict = resolve(dictName);
+    if (mainDict.empty()) {
+        return paths;
+    }
+    paths.push_back(mainDict);
+
+    // 只解析文件头中的 import_tables 列表（"..." 之前）
+    std::ifstream file(mainDict);
+    std::string line;
+    bool inImports = false;
+    while (std::getline(file, line)) {
+        if (trim(line) == "...") {
+            break;
+        }
+        std::string content = trim(line.substr(0, line.find('#')));
+        if (content.empty()) {
+            continue;
+        }
+        if (content == "import_tables:") {
+            inImports = true;
+            continue;
+        }
+        if (!inImports) {
+            continue;
+        }
+        if (content.size() < 2 || content[0] != '-') {
+            inImports = false;  // 列表结束
+            continue;
+        }
+        std::string path = resolve(trim(content.substr(1)));
+        if (!path.empty()) {
+            paths.push_back(path);
+        }
+    }
+
+    return paths;
+}
+
+bool RimeDict::forEachEntry(const std::string& path,
+                            const std::function<void(const RimeDictEntry&)>& callback) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "RimeDict: Failed to open " << path << std::endl;
+        return false;
+    }
+
+    bool inBody = false;
+    std::string line;
+    RimeDictEntry entry;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (!inBody) {
+            inBody = (line == "...");
+            continue;
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        size_t textEnd = line.find('\t');
+        entry.text = line.substr(0, textEnd);
+        entry.code.clear();
+        entry.weight = 0;
+        if (entry.text.empty()) {
+            continue;
+        }
+        if (textEnd != std::string::npos) {
+            size_t codeEnd = line.find('\t', textEnd + 1);
+            entry.code = line.substr(textEnd + 1, codeEnd == std::string::npos
+                                                      ? std::string::npos
+                                                      : codeEnd - textEnd - 1);
+            if (codeEnd != std::string::npos) {
+                try {
+                    entry.weight = std::stoll(line.substr(codeEnd + 1));
+                } catch (...) {
+                    entry.weight = 0;  // 百分比等其他权重写法按 0 处理
+                }
+            }
+        }
+        callback(entry);
+    }
+    return true;
+}
+
+} // namespace suyan
@@ -0,0 +1,60 @@
+/**
+ * RimeDict - RIME 词库文件读取
+ *
+ * 部署时生成索引（联想、英文补全等）需要直接读取 *.dict.yaml，
+ * 这里只解析生成索引用到的部分：文件头的 import_tables 和 "..." 之后的词条。
+ */
+
+#ifndef SUYAN_CORE_RIME_DICT_H
+#define SUYAN_CORE_RIME_DICT_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace suyan {
+
+/**
+ * 词条（按 RIME 默认列顺序：文字<Tab>编码<Tab>权重）
+ */
+struct RimeDictEntry {
+    std::string text;           // 文字
+    std::string code;           // 编码（省略时为空）
+    int64_t weight = 0;         // 权重（省略时为 0）
+};
+
+/**
+ * RimeDict - 词库读取工具类
+ *
+ * 无状态工具类，所有方法均为静态方法。
+ */
+class RimeDict {
+public:
+    /**
+     * 获取词库及其 import_tables 引用的词库文件
+     *
+     * 每个词库优先使用用户目录中的版本，其次是共享目录。
+     * 被注释掉的和不存在的词库会被跳过。
+     *
+     * @param dictName 词库名（如 "rime_ice"，对应 rime_ice.dict.yaml）
+     * @return 存在的词库文件路径，主词库在前，其后按 import_tables 顺序
+     */
+    static std::vector<std::string> collectTables(const std::string& userDataDir,
+                                                  const std::string& sharedDataDir,
+                                                  const std::string& dictName);
+
+    /**
+     * 逐条读取词库中的词条
+     *
+     * @param path 词库文件路径
+     * @param callback 每个词条调用一次
+     * @return 是否成功打开文件
+     */
+    static bool forEachEntry(const std::string& path,
+                             const std::function<void(const RimeDictEntry&)>& callback);
+};
+
+} // namespace suyan
+
+#endif // SUYAN_CORE_RIME_DICT_H
@@ -44,6 +44,8 @@
 #include "layout_manager.h"
 #include "config_manager.h"
 #include "frequency_manager.h"
+#include "custom_phrase_manager.h"
+#include "association_engine.h"
 #include "suyan_ui_init.h"
 
 // 剪贴板模块
@@ -240,6 +242,33 @@ static bool initializeInputEngine() {
         }
     }
     
+    // 初始化 CustomPhraseManager（自定义短语，修改后无需重新部署）
+    auto& phraseMgr = CustomPhraseManager::instance();
+    if (!phraseMgr.isInitialized()) {
+        if (phraseMgr.initialize(userDir.toStdString())) {
+            qDebug() << "SuYan: CustomPhraseManager initialized";
+            // 方案已不启用 RIME 的 custom_phrase 翻译器，首次启动时导入原有的 custom_phrase.txt
+            int imported = phraseMgr.importLegacyFileOnce({
+                (userDir + "/custom_phrase.txt").toStdString(),
+                (sharedDir + "/custom_phrase.txt").toStdString()});
+            if (imported > 0) {
+                qDebug() << "SuYan: Imported" << imported << "custom phrases from custom_phrase.txt";
+            }
+        } else {
+            qWarning() << "SuYan: Failed to initialize CustomPhraseManager";
+        }
+    }
+    
+    // 初始化 AssociationEngine（联想，词库更新后重新生成索引）
+    auto& association = AssociationEngine::instance();
+    if (!association.isInitialized()) {
+        if (association.initialize(userDir.toStdString(), sharedDir.toStdString())) {
+            qDebug() << "SuYan: AssociationEngine initialized";
+        } else {
+            qWarning() << "SuYan: Failed to initialize AssociationEngine";
+        }
+    }
+    
     g_inputEngine = new InputEngine();
     
     if (!g_inputEngine->initialize(userDir.toStdString(), sharedDir.toStdString())) {
@@ -269,6 +298,17 @@ static bool initializeUIComponents() {
         // ConfigManager::initialize 期望的是配置目录，不是配置文件路径
         configMgr.initialize(userDir.toStdString());
     }
+
+    // 联想开关由配置决定，默认关闭
+    if (g_inputEngine) {
+        g_inputEngine->setAssociationEnabled(configMgr.getInputConfig().associationEnabled);
+        QObject::connect(&configMgr, &ConfigManager::inputConfigChanged,
+                         [](const InputConfig& newConfig) {
+            if (g_inputEngine) {
+                g_inputEngine->setAssociationEnabled(newConfig.associationEnabled);
+            }
+        });
+    }
     
     // 使用 UI 初始化器
     UIInitConfig config;
@@ -345,9 +385,10 @@ static bool initializeClipboard() {
         return true;
     }
     
-    // 1. 初始化 ClipboardManager
+    // 1. 初始化 ClipboardManager（字表用于拼音搜索剪贴板历史）
+    QString pinyinDictPath = getSharedDataDir() + "/cn_dicts/8105.dict.yaml";
     auto& clipboardMgr = ClipboardManager::instance();
-    if (!clipboardMgr.initialize(userDir.toStdString())) {
+    if (!clipboardMgr.initialize(userDir.toStdString(), pinyinDictPath.toStdString())) {
         qWarning() << "SuYan: Failed to initialize ClipboardManager";
         return false;
     }
@@ -355,6 +396,7 @@ static bool initializeClipboard() {
     // 应用配置
     clipboardMgr.setMaxAgeDays(clipboardConfig.maxAgeDays);
     clipboardMgr.setMaxCount(clipboardConfig.maxCount);
+    clipboardMgr.setMaxStorageMB(clipboardConfig.maxStorageMB);
     
     qDebug() << "SuYan: ClipboardManager initialized";
     
@@ -440,6 +482,7 @@ static bool initializeClipboard() {
         clipboardMgr.setEnabled(newConfig.enabled);
         clipboardMgr.setMaxAgeDays(newConfig.maxAgeDays);
         clipboardMgr.setMaxCount(newConfig.maxCount);
+        clipboardMgr.setMaxStorageMB(newConfig.maxStorageMB);
         
         // 更新快捷键
         if (hotkeyMgr.isInitialized()) {
@@ -561,6 +604,12 @@ static void cleanup() {
     // 清理 FrequencyManager
     FrequencyManager::instance().shutdown();
     
+    // 清理 CustomPhraseManager
+    CustomPhraseManager::instance().shutdown();
+    
+    // 清理 AssociationEngine（保存提交历史）
+    AssociationEngine::instance().shutdown();
+    
     // 清理 RIME
     RimeWrapper::instance().finalize();
     
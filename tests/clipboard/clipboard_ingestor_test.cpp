@@ -0,0 +1,360 @@
+/**
+ * ClipboardIngestor 单元测试
+ *
+ * 测试后台入库队列的顺序处理、相同内容合并、容量限制和停止行为。
+ */
+
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <QCoreApplication>
+#include "clipboard_ingestor.h"
+
+// 测试辅助宏
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "✗ 断言失败: " << message << std::endl; \
+            std::cerr << "  位置: " << __FILE__ << ":" << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define TEST_PASS(message) \
+    std::cout << "✓ " << message << std::endl
+
+/**
+ * 记录处理顺序的处理函数，可让第一项阻塞在工作线程中
+ */
+class RecordingHandler {
+public:
+    explicit RecordingHandler(bool blockFirst = false) {
+        if (!blockFirst) {
+            release_.set_value();
+        }
+        releaseFuture_ = release_.get_future().share();
+    }
+
+    void operator()(const suyan::ClipboardContent& content) {
+        if (!firstStarted_) {
+            firstStarted_ = true;
+            started_.set_value();
+            releaseFuture_.wait();
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        processed_.push_back(content.contentHash);
+        threadId_ = std::this_thread::get_id();
+    }
+
+    // 等待第一项开始处理
+    void waitFirstStarted() { started_.get_future().wait(); }
+
+    // 放行被阻塞的第一项
+    void releaseFirst() { release_.set_value(); }
+
+    std::vector<std::string> processed() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return processed_;
+    }
+
+    std::thread::id threadId() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return threadId_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<std::string> processed_;
+    std::thread::id threadId_;
+    bool firstStarted_ = false;
+    std::promise<void> started_;
+    std::promise<void> release_;
+    std::shared_future<void> releaseFuture_;
+};
+
+/**
+ * 记录调用线程的指纹算法（委托给默认算法）
+ */
+class CountingFingerprinter final : public suyan::IContentFingerprinter {
+public:
+    const char* name() const override { return "counting"; }
+
+    std::string fingerprint(const uint8_t* data, size_t size) const override {
+        if (std::this_thread::get_id() == mainThread_) {
+            ++mainThreadCalls_;
+        }
+        return suyan::ContentFingerprint::defaultFingerprinter().fingerprint(data, size);
+    }
+
+    int mainThreadCalls() const { return mainThreadCalls_.load(); }
+
+private:
+    std::thread::id mainThread_ = std::this_thread::get_id();
+    mutable std::atomic<int> mainThreadCalls_{0};
+};
+
+class ClipboardIngestorTest {
+public:
+    bool runAllTests() {
+        std::cout << "=== ClipboardIngestor 单元测试 ===" << std::endl;
+        std::cout << std::endl;
+
+        bool allPassed = true;
+
+        allPassed &= testProcessInOrder();
+        allPassed &= testRunsOnWorkerThread();
+        allPassed &= testCoalesceSameContent();
+        allPassed &= testCoalesceByFingerprint();
+        allPassed &= testKeepQuickKeyCollisions();
+        allPassed &= testBoundedQueue();
+        allPassed &= testEnqueueDoesNotBlock();
+        allPassed &= testStopDrainsQueue();
+
+        std::cout << std::endl;
+        if (allPassed) {
+            std::cout << "=== 所有测试通过 ===" << std::endl;
+        } else {
+            std::cout << "=== 部分测试失败 ===" << std::endl;
+        }
+
+        return allPassed;
+    }
+
+private:
+    // 创建测试文本内容
+    suyan::ClipboardContent createContent(const std::string& hash) {
+        suyan::ClipboardContent content;
+        content.type = suyan::MonitorContentType::Text;
+        content.textData = "内容 " + hash;
+        content.contentHash = hash;
+        return content;
+    }
+
+    bool testProcessInOrder() {
+        RecordingHandler handler;
+        suyan::ClipboardIngestor ingestor([&handler](const suyan::ClipboardContent& content) {
+            handler(content);
+        });
+
+        TEST_ASSERT(!ingestor.enqueue(createContent("a")), "未启动时不接受内容");
+
+        ingestor.start();
+        TEST_ASSERT(ingestor.isRunning(), "已启动");
+        ingestor.enqueue(createContent("a"));
+        ingestor.enqueue(createContent("b"));
+        ingestor.enqueue(createContent("c"));
+        ingestor.waitForIdle();
+
+        auto processed = handler.processed();
+        TEST_ASSERT(processed == std::vector<std::string>({"a", "b", "c"}), "按入队顺序处理");
+        TEST_ASSERT(ingestor.getPendingCount() == 0, "队列已清空");
+
+        TEST_PASS("testProcessInOrder: 顺序处理正常");
+        return true;
+    }
+
+    bool testRunsOnWorkerThread() {
+        RecordingHandler handler;
+        suyan::ClipboardIngestor ingestor([&handler](const suyan::ClipboardContent& content) {
+            handler(content);
+        });
+        ingestor.start();
+        ingestor.enqueue(createContent("a"));
+        ingestor.waitForIdle();
+
+        TEST_ASSERT(handler.threadId() != std::this_thread::get_id(), "在工作线程处理");
+
+        TEST_PASS("testRunsOnWorkerThread: 后台线程处理正常");
+        return true;
+    }
+
+    bool testCoalesceSameContent() {
+        RecordingHandler handler(true);
+        suyan::ClipboardIngestor ingestor([&handler](const suyan::ClipboardContent& content) {
+            handler(content);
+        });
+        ingestor.start();
+
+        // 第一项阻塞在工作线程，其余内容留在队列中
+        ingestor.enqueue(createContent("x"));
+        handler.waitFirstStarted();
+        ingestor.enqueue(createContent("a"));
+        ingestor.enqueue(createContent("b"));
+        ingestor.enqueue(createContent("a"));
+        TEST_ASSERT(ingestor.getPendingCount() == 2, "相同内容合并为一项");
+        TEST_ASSERT(ingestor.getCoalescedCount() == 1, "合并计数");
+
+        handler.releaseFirst();
+        ingestor.waitForIdle();
+        auto processed = handler.processed();
+        TEST_ASSERT(processed == std::vector<std::string>({"x", "b", "a"}), "合并后按最新一次的位置处理");
+
+        TEST_PASS("testCoalesceSameContent: 相同内容合并正常");
+        return true;
+    }
+
+    // 监听器只计算预筛键，完整指纹由入库线程补齐
+    static suyan::ClipboardContent preparedContent(const std::string& text) {
+        suyan::ClipboardContent content;
+        content.type = suyan::MonitorContentType::Text;
+        content.textData = text;
+        suyan::ContentFingerprint::prepare(content);
+        return content;
+    }
+
+    static std::string fingerprintOf(const std::string& text) {
+        return suyan::ContentFingerprint::hash128(
+            reinterpret_cast<const uint8_t*>(text.data()), text.size()).toHex();
+    }
+
+    bool testCoalesceByFingerprint() {
+        RecordingHandler handler(true);
+        CountingFingerprinter fingerprinter;
+        suyan::ClipboardIngestor ingestor([&handler](const suyan::ClipboardContent& content) {
+            handler(content);
+        }, suyan::ClipboardIngestor::kDefaultCapacity, fingerprinter);
+        ingestor.start();
+
+        // 没有完整指纹的内容不合并（由存储去重），也不在入队时计算指纹
+        ingestor.enqueue(preparedContent("x"));
+        handler.waitFirstStarted();
+        ingestor.enqueue(preparedContent("重复内容"));
+        ingestor.enqueue(preparedContent("其他内容"));
+        ingestor.enqueue(preparedContent("重复内容"));
+        TEST_ASSERT(ingestor.getPendingCount() == 3, "没有完整指纹时不合并");
+        TEST_ASSERT(ingestor.getCoalescedCount() == 0, "合并计数");
+        TEST_ASSERT(fingerprinter.mainThreadCalls() == 0, "入队时不计算完整指纹");
+
+        handler.releaseFirst();
+        ingestor.waitForIdle();
+        auto processed = handler.processed();
+        TEST_ASSERT(processed.size() == 4, "处理数量");
+        TEST_ASSERT(processed[0] == fingerprintOf("x"), "处理前补齐完整指纹");
+        TEST_ASSERT(processed[1] == fingerprintOf("重复内容") && processed[2] == fingerprintOf("其他内容") &&
+                    processed[3] == fingerprintOf("重复内容"), "按入队顺序处理");
+
+        TEST_PASS("testCoalesceByFingerprint: 只按完整指纹合并");
+        return true;
+    }
+
+    bool testKeepQuickKeyCollisions() {
+        // 相同长度、只在采样窗口之外不同的两份内容，预筛键相同
+        std::string original(200, '0');
+        for (size_t i = 0; i < original.size(); ++i) {
+            original[i] = static_cast<char>('0' + i % 10);
+        }
+        std::string edited;
+        for (size_t i = 0; i < original.size() && edited.empty(); ++i) {
+            std::string candidate = original;
+            candidate[i] = candidate[i] == '9' ? '8' : '9';
+            if (preparedContent(candidate).quickKey == preparedContent(original).quickKey) {
+                edited = candidate;
+            }
+        }
+        TEST_ASSERT(!edited.empty(), "找到预筛键相同的编辑");
+
+        RecordingHandler handler(true);
+        suyan::ClipboardIngestor ingestor([&handler](const suyan::ClipboardContent& content) {
+            handler(content);
+        });
+        ingestor.start();
+
+        ingestor.enqueue(preparedContent("x"));
+        handler.waitFirstStarted();
+        ingestor.enqueue(preparedContent(original));
+        ingestor.enqueue(preparedContent(edited));
+        TEST_ASSERT(ingestor.getPendingCount() == 2, "预筛键相同的不同内容都保留");
+
+        handler.releaseFirst();
+        ingestor.waitForIdle();
+        auto processed = handler.processed();
+        TEST_ASSERT(processed.size() == 3, "处理数量");
+        TEST_ASSERT(processed[1] == fingerprintOf(original) && processed[2] == fingerprintOf(edited),
+                    "两份内容都入库");
+
+        TEST_PASS("testKeepQuickKeyCollisions: 预筛键相同的不同内容不被丢弃");
+        return true;
+    }
+
+    bool testBoundedQueue() {
+        RecordingHandler handler(true);
+        suyan::ClipboardIngestor ingestor([&handler](const suyan::ClipboardContent& content) {
+            handler(content);
+        }, 2);
+        ingestor.start();
+
+        ingestor.enqueue(createContent("x"));
+        handler.waitFirstStarted();
+        ingestor.enqueue(createContent("a"));
+        ingestor.enqueue(createContent("b"));
+        ingestor.enqueue(createContent("c"));
+        TEST_ASSERT(ingestor.getPendingCount() == 2, "队列不超过容量");
+        TEST_ASSERT(ingestor.getDroppedCount() == 1, "丢弃计数");
+
+        handler.releaseFirst();
+        ingestor.waitForIdle();
+        auto processed = handler.processed();
+        TEST_ASSERT(processed == std::vector<std::string>({"x", "b", "c"}), "丢弃最旧的待处理内容");
+
+        TEST_PASS("testBoundedQueue: 容量限制正常");
+        return true;
+    }
+
+    bool testEnqueueDoesNotBlock() {
+        suyan::ClipboardIngestor ingestor([](const suyan::ClipboardContent&) {
+            // 模拟大截图的解码和缩略图生成
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        });
+        ingestor.start();
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < 5; i++) {
+            ingestor.enqueue(createContent("slow_" + std::to_string(i)));
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start);
+        std::cout << "  入队 5 项耗时: " << elapsed.count() << "ms" << std::endl;
+        TEST_ASSERT(elapsed.count() < 50, "入队不等待处理完成");
+
+        TEST_PASS("testEnqueueDoesNotBlock: 入队不阻塞");
+        return true;
+    }
+
+    bool testStopDrainsQueue() {
+        RecordingHandler handler;
+        suyan::ClipboardIngestor ingestor([&handler](const suyan::ClipboardContent& content) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            handler(content);
+        });
+        ingestor.start();
+        ingestor.enqueue(createContent("a"));
+        ingestor.enqueue(createContent("b"));
+        ingestor.enqueue(createContent("c"));
+
+        ingestor.stop();
+        TEST_ASSERT(!ingestor.isRunning(), "已停止");
+        TEST_ASSERT(handler.processed().size() == 3, "停止前处理完剩余内容");
+        TEST_ASSERT(!ingestor.enqueue(createContent("d")), "停止后不接受内容");
+
+        // 可以再次启动
+        ingestor.start();
+        TEST_ASSERT(ingestor.enqueue(createContent("d")), "重新启动后接受内容");
+        ingestor.waitForIdle();
+        TEST_ASSERT(handler.processed().size() == 4, "重新启动后继续处理");
+
+        TEST_PASS("testStopDrainsQueue: 停止时处理完队列");
+        return true;
+    }
+};
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+
+    ClipboardIngestorTest test;
+    return test.runAllTests() ? 0 : 1;
+}
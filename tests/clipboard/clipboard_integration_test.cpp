@@ -114,7 +114,7 @@ private:
         record.contentHash = "test_hash_text_" + std::to_string(std::time(nullptr));
         record.sourceApp = "com.test.integration";
 
-        int64_t id = suyan::ClipboardStore::instance().addRecord(record);
+        int64_t id = suyan::ClipboardStore::instance().addRecord(record).id;
 
         if (id <= 0) {
             std::cout << "✗ 添加文本记录失败" << std::endl;
@@ -130,7 +130,7 @@ private:
 
         // 验证记录内容
         auto history = manager.getHistory(1);
-        if (history.empty() || history[0].content != record.content) {
+        if (history.empty() || history[0].preview != record.content) {
             std::cout << "✗ 记录内容不匹配" << std::endl;
             return false;
         }
@@ -152,7 +152,7 @@ private:
         record1.contentHash = testHash;
         record1.sourceApp = "com.test.dedup";
 
-        int64_t id1 = suyan::ClipboardStore::instance().addRecord(record1);
+        int64_t id1 = suyan::ClipboardStore::instance().addRecord(record1).id;
         if (id1 <= 0) {
             std::cout << "✗ 添加第一条记录失败" << std::endl;
             return false;
@@ -177,7 +177,7 @@ private:
         record2.contentHash = testHash;  // 相同哈希
         record2.sourceApp = "com.test.dedup2";
 
-        int64_t id2 = suyan::ClipboardStore::instance().addRecord(record2);
+        int64_t id2 = suyan::ClipboardStore::instance().addRecord(record2).id;
 
         // 应该返回相同的 ID
         if (id2 != id1) {
@@ -235,12 +235,13 @@ private:
         std::cout << "  尺寸: " << result.width << "x" << result.height << std::endl;
 
         // 验证文件存在
-        if (!fs::exists(result.imagePath)) {
+        auto& imageStorage = suyan::ImageStorage::instance();
+        if (!fs::exists(imageStorage.resolvePath(result.imagePath))) {
             std::cout << "✗ 原图文件不存在" << std::endl;
             return false;
         }
 
-        if (!fs::exists(result.thumbnailPath)) {
+        if (!fs::exists(imageStorage.resolvePath(result.thumbnailPath))) {
             std::cout << "✗ 缩略图文件不存在" << std::endl;
             return false;
         }
@@ -257,14 +258,14 @@ private:
         record.imageHeight = result.height;
         record.fileSize = result.fileSize;
 
-        int64_t id = suyan::ClipboardStore::instance().addRecord(record);
+        int64_t id = suyan::ClipboardStore::instance().addRecord(record).id;
         if (id <= 0) {
             std::cout << "✗ 添加图片记录失败" << std::endl;
             return false;
         }
 
         // 验证缩略图尺寸
-        QImage thumbnail(QString::fromStdString(result.thumbnailPath));
+        QImage thumbnail(QString::fromStdString(imageStorage.resolvePath(result.thumbnailPath)));
         if (thumbnail.isNull()) {
             std::cout << "✗ 无法加载缩略图" << std::endl;
             return false;
@@ -297,7 +298,7 @@ private:
         record.contentHash = testHash;
         record.sourceApp = "com.test.paste";
 
-        int64_t id = suyan::ClipboardStore::instance().addRecord(record);
+        int64_t id = suyan::ClipboardStore::instance().addRecord(record).id;
         if (id <= 0) {
             std::cout << "✗ 添加测试记录失败" << std::endl;
             return false;
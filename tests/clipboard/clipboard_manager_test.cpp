@@ -84,6 +84,9 @@ public:
         allPassed &= testPasteTextRecord();
         allPassed &= testPasteNonexistentRecord();
         
+        // 孤儿文件回收测试（须在清理测试之前：清理会启动后台校准）
+        allPassed &= testCollectOrphans();
+        
         // 清理测试
         allPassed &= testPerformCleanup();
         allPassed &= testPerformCleanupWithImages();
@@ -130,7 +133,7 @@ private:
         record.content = content;
         record.contentHash = hash;
         record.sourceApp = "com.test.app";
-        return suyan::ClipboardStore::instance().addRecord(record);
+        return suyan::ClipboardStore::instance().addRecord(record).id;
     }
     
     // ========== 基础测试 ==========
@@ -346,8 +349,8 @@ private:
         // 获取历史
         auto history = manager.getHistory();
         TEST_ASSERT(history.size() == 3, "应该有 3 条记录");
-        TEST_ASSERT(history[0].content == "Record 3", "第一条应该是最新的");
-        TEST_ASSERT(history[2].content == "Record 1", "最后一条应该是最旧的");
+        TEST_ASSERT(history[0].preview == "Record 3", "第一条应该是最新的");
+        TEST_ASSERT(history[2].preview == "Record 1", "最后一条应该是最旧的");
         
         // 测试分页
         auto page = manager.getHistory(2, 0);
@@ -527,7 +530,7 @@ private:
         
         // 验证保留的是最新的
         auto history = manager.getHistory();
-        TEST_ASSERT(history[0].content == "Cleanup 5", "最新的应该保留");
+        TEST_ASSERT(history[0].preview == "Cleanup 5", "最新的应该保留");
         
         TEST_PASS("testPerformCleanup: 清理功能正常");
         return true;
@@ -564,8 +567,10 @@ private:
             auto result = suyan::ImageStorage::instance().saveImage(pngData, "png", hash);
             TEST_ASSERT(result.success, "保存图片应该成功");
             
-            imagePaths.push_back(result.imagePath);
-            thumbnailPaths.push_back(result.thumbnailPath);
+            // 记录中是相对路径，检查文件时使用绝对路径
+            auto& imageStorage = suyan::ImageStorage::instance();
+            imagePaths.push_back(imageStorage.resolvePath(result.imagePath));
+            thumbnailPaths.push_back(imageStorage.resolvePath(result.thumbnailPath));
             
             // 添加图片记录到数据库
             suyan::ClipboardRecord record;
@@ -579,7 +584,7 @@ private:
             record.imageHeight = result.height;
             record.fileSize = result.fileSize;
             
-            int64_t id = suyan::ClipboardStore::instance().addRecord(record);
+            int64_t id = suyan::ClipboardStore::instance().addRecord(record).id;
             TEST_ASSERT(id > 0, "添加图片记录应该成功");
             
             std::this_thread::sleep_for(std::chrono::milliseconds(5));
@@ -634,6 +639,85 @@ private:
         return true;
     }
     
+    // ========== 孤儿文件回收测试 ==========
+    
+    bool testCollectOrphans() {
+        if (!ensureInitialized()) {
+            TEST_ASSERT(false, "初始化失败");
+        }
+        resetTestEnvironment();
+        
+        auto& manager = suyan::ClipboardManager::instance();
+        auto& imageStorage = suyan::ImageStorage::instance();
+        auto& store = suyan::ClipboardStore::instance();
+        
+        // 1x1 PNG，不同哈希保存为不同文件
+        const std::vector<uint8_t> pngData = {
+            0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A,
+            0x00, 0x00, 0x00, 0x0D, 0x49, 0x48, 0x44, 0x52,
+            0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01,
+            0x08, 0x02, 0x00, 0x00, 0x00, 0x90, 0x77, 0x53,
+            0xDE, 0x00, 0x00, 0x00, 0x0C, 0x49, 0x44, 0x41,
+            0x54, 0x08, 0xD7, 0x63, 0xF8, 0xFF, 0xFF, 0x3F,
+            0x00, 0x05, 0xFE, 0x02, 0xFE, 0xDC, 0xCC, 0x59,
+            0xE7, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4E,
+            0x44, 0xAE, 0x42, 0x60, 0x82
+        };
+        auto saveImage = [&](const std::string& hash, bool withRecord) {
+            auto result = imageStorage.saveImage(pngData, "png", hash);
+            if (withRecord) {
+                suyan::ClipboardRecord record;
+                record.type = suyan::ClipboardContentType::Image;
+                record.content = result.imagePath;
+                record.contentHash = hash;
+                record.thumbnailPath = result.thumbnailPath;
+                record.imageFormat = "png";
+                record.fileSize = result.fileSize + result.thumbnailSize;
+                store.addRecord(record);
+            }
+            return result;
+        };
+        // 让文件看起来是很久以前写入的
+        auto age = [&](const std::string& path) {
+            fs::last_write_time(imageStorage.resolvePath(path),
+                                fs::file_time_type::clock::now() - std::chrono::hours(2));
+        };
+        
+        auto kept = saveImage("0a1b2c3d", true);            // 正常记录
+        auto lost = saveImage("1b2c3d4e", true);            // 原图已丢失的记录
+        auto orphan = saveImage("2c3d4e5f", false);         // 没有记录的旧文件
+        auto pending = saveImage("3d4e5f6a", false);        // 刚保存、记录还未写入
+        addTestTextRecord("Orphan text", "4e5f6a7b");
+        for (const auto* result : {&kept, &lost, &orphan}) {
+            age(result->imagePath);
+            age(result->thumbnailPath);
+        }
+        fs::remove(imageStorage.resolvePath(lost.imagePath));
+        TEST_ASSERT(manager.getRecordCount() == 3, "应该有 3 条记录");
+        
+        auto result = manager.collectOrphans();
+        TEST_ASSERT(result.deletedFiles == 2, "删除无记录的原图和缩略图");
+        TEST_ASSERT(result.deletedRecords == 1, "删除原图丢失的记录");
+        TEST_ASSERT(result.bytesReclaimed == orphan.fileSize + orphan.thumbnailSize + lost.thumbnailSize,
+                    "回收的空间含孤儿文件和丢失记录的缩略图");
+        
+        TEST_ASSERT(!imageStorage.imageExists(orphan.imagePath) &&
+                    !imageStorage.imageExists(orphan.thumbnailPath), "孤儿文件已删除");
+        TEST_ASSERT(!imageStorage.imageExists(lost.thumbnailPath), "丢失记录的缩略图已删除");
+        TEST_ASSERT(imageStorage.imageExists(kept.imagePath) &&
+                    imageStorage.imageExists(kept.thumbnailPath), "正常记录的文件保留");
+        TEST_ASSERT(imageStorage.imageExists(pending.imagePath), "刚保存的文件保留");
+        TEST_ASSERT(manager.getRecordCount() == 2, "剩下正常图片记录和文本记录");
+        TEST_ASSERT(!store.findByHash("1b2c3d4e"), "原图丢失的记录已删除");
+        
+        // 再次回收没有可删除的内容
+        result = manager.collectOrphans();
+        TEST_ASSERT(result.deletedFiles == 0 && result.deletedRecords == 0, "第二次回收没有孤儿");
+        
+        TEST_PASS("testCollectOrphans: 孤儿文件和孤儿记录回收正常");
+        return true;
+    }
+    
     // ========== 信号测试 ==========
     
     bool testRecordDeletedSignal() {
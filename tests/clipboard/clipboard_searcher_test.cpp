@@ -0,0 +1,305 @@
+/**
+ * ClipboardSearcher 单元测试
+ *
+ * 测试后台搜索的前缀细化、第一页先送达、过时请求的取代和缓存失效。
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <filesystem>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <QCoreApplication>
+#include "clipboard_searcher.h"
+#include "clipboard_store.h"
+
+namespace fs = std::filesystem;
+
+// 测试辅助宏
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "✗ 断言失败: " << message << std::endl; \
+            std::cerr << "  位置: " << __FILE__ << ":" << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define TEST_PASS(message) \
+    std::cout << "✓ " << message << std::endl
+
+/**
+ * 记录送达的结果，可让第一次送达阻塞在工作线程中
+ */
+class RecordingHandler {
+public:
+    explicit RecordingHandler(bool blockFirst = false) {
+        if (!blockFirst) {
+            release_.set_value();
+        }
+        releaseFuture_ = release_.get_future().share();
+    }
+
+    void operator()(suyan::SearchResult result) {
+        if (!firstStarted_) {
+            firstStarted_ = true;
+            started_.set_value();
+            releaseFuture_.wait();
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        results_.push_back(std::move(result));
+    }
+
+    // 等待第一次送达
+    void waitFirstStarted() { started_.get_future().wait(); }
+
+    // 放行被阻塞的第一次送达
+    void releaseFirst() { release_.set_value(); }
+
+    std::vector<suyan::SearchResult> results() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return results_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<suyan::SearchResult> results_;
+    bool firstStarted_ = false;
+    std::promise<void> started_;
+    std::promise<void> release_;
+    std::shared_future<void> releaseFuture_;
+};
+
+class ClipboardSearcherTest {
+public:
+    ClipboardSearcherTest() {
+        testDataDir_ = fs::temp_directory_path().string() + "/suyan_clipboard_searcher_test";
+        fs::remove_all(testDataDir_);
+        fs::create_directories(testDataDir_);
+    }
+
+    ~ClipboardSearcherTest() {
+        suyan::ClipboardStore::instance().shutdown();
+        fs::remove_all(testDataDir_);
+    }
+
+    bool runAllTests() {
+        std::cout << "=== ClipboardSearcher 单元测试 ===" << std::endl;
+        std::cout << std::endl;
+
+        if (!suyan::ClipboardStore::instance().initialize(testDataDir_ + "/clipboard.db")) {
+            std::cerr << "✗ 初始化存储失败" << std::endl;
+            return false;
+        }
+
+        bool allPassed = true;
+
+        allPassed &= testRefineWhileTyping();
+        allPassed &= testFirstPageFirst();
+        allPassed &= testLatestRequestWins();
+        allPassed &= testInvalidateCache();
+        allPassed &= testStop();
+
+        std::cout << std::endl;
+        if (allPassed) {
+            std::cout << "=== 所有测试通过 ===" << std::endl;
+        } else {
+            std::cout << "=== 部分测试失败 ===" << std::endl;
+        }
+
+        return allPassed;
+    }
+
+private:
+    std::string testDataDir_;
+
+    int64_t addText(const std::string& content, const std::string& hash) {
+        suyan::ClipboardRecord record;
+        record.type = suyan::ClipboardContentType::Text;
+        record.content = content;
+        record.contentHash = hash;
+        record.sourceApp = "com.test.app";
+        return suyan::ClipboardStore::instance().addRecord(record).id;
+    }
+
+    static std::vector<int64_t> ids(const std::vector<suyan::PreviewRecord>& records) {
+        std::vector<int64_t> result;
+        for (const auto& record : records) {
+            result.push_back(record.id);
+        }
+        return result;
+    }
+
+    bool testRefineWhileTyping() {
+        auto& store = suyan::ClipboardStore::instance();
+        store.clearAll();
+        addText("meeting notes", "searcher_001");
+        addText("meet at noon", "searcher_002");
+        addText("Team meeting 会议纪要", "searcher_003");
+        addText("memo", "searcher_004");
+
+        RecordingHandler handler;
+        suyan::ClipboardSearcher searcher([&handler](suyan::SearchResult result) {
+            handler(std::move(result));
+        });
+        searcher.start();
+
+        // 逐字输入 "meeting"：只有第一个字执行完整查询，之后都在上一次结果中细化
+        std::string keyword;
+        for (char c : std::string("meeting")) {
+            keyword += c;
+            TEST_ASSERT(searcher.search(keyword) > 0, "提交请求");
+            searcher.waitForIdle();
+        }
+        TEST_ASSERT(searcher.getQueryCount() == 1, "只执行一次完整查询");
+        TEST_ASSERT(searcher.getRefinedCount() == 6, "其余 6 次细化");
+
+        auto results = handler.results();
+        TEST_ASSERT(results.size() == 7, "每次输入送达一次结果");
+        TEST_ASSERT(results.back().keyword == "meeting" && results.back().complete, "最后的结果");
+        TEST_ASSERT(ids(results.back().records) == ids(store.searchText("meeting")), "细化结果与重新搜索一致");
+
+        // 删字：从更短的前缀细化
+        searcher.search("meet");
+        searcher.waitForIdle();
+        TEST_ASSERT(searcher.getRefinedCount() == 7, "删字后从缓存的前缀细化");
+        TEST_ASSERT(ids(handler.results().back().records) == ids(store.searchText("meet")), "删字后的结果");
+
+        // 不同的关键词重新查询
+        searcher.search("noon");
+        searcher.waitForIdle();
+        TEST_ASSERT(searcher.getQueryCount() == 2, "不同关键词重新查询");
+
+        TEST_PASS("testRefineWhileTyping: 继续输入时在上一次结果中细化");
+        return true;
+    }
+
+    bool testFirstPageFirst() {
+        auto& store = suyan::ClipboardStore::instance();
+        store.clearAll();
+        for (int i = 0; i < 30; ++i) {
+            addText("page item " + std::to_string(i), "searcher_page_" + std::to_string(i));
+        }
+
+        RecordingHandler handler;
+        suyan::ClipboardSearcher searcher([&handler](suyan::SearchResult result) {
+            handler(std::move(result));
+        }, 100, 10);
+        searcher.start();
+
+        uint64_t generation = searcher.search("page");
+        searcher.waitForIdle();
+
+        auto results = handler.results();
+        TEST_ASSERT(results.size() == 2, "先送达第一页，再送达完整结果");
+        TEST_ASSERT(!results[0].complete && results[0].records.size() == 10, "第一页");
+        TEST_ASSERT(results[1].complete && results[1].records.size() == 30, "完整结果");
+        TEST_ASSERT(results[0].generation == generation && results[1].generation == generation, "同一请求");
+
+        auto firstPage = ids(results[0].records);
+        auto all = ids(results[1].records);
+        TEST_ASSERT(std::equal(firstPage.begin(), firstPage.end(), all.begin()), "完整结果以第一页开头");
+
+        // 结果少于一页时只送达一次
+        searcher.search("item 5");
+        searcher.waitForIdle();
+        TEST_ASSERT(handler.results().size() == 3 && handler.results().back().complete, "少于一页时只送达一次");
+
+        TEST_PASS("testFirstPageFirst: 第一页先送达");
+        return true;
+    }
+
+    bool testLatestRequestWins() {
+        auto& store = suyan::ClipboardStore::instance();
+        store.clearAll();
+        addText("alpha", "searcher_latest_001");
+        addText("beta", "searcher_latest_002");
+        addText("gamma", "searcher_latest_003");
+
+        RecordingHandler handler(true);
+        suyan::ClipboardSearcher searcher([&handler](suyan::SearchResult result) {
+            handler(std::move(result));
+        });
+        searcher.start();
+
+        // 第一次送达阻塞期间连续提交，排队的 beta 被 gamma 取代
+        uint64_t first = searcher.search("alpha");
+        handler.waitFirstStarted();
+        uint64_t second = searcher.search("beta");
+        uint64_t third = searcher.search("gamma");
+        TEST_ASSERT(first < second && second < third, "请求序号递增");
+        handler.releaseFirst();
+        searcher.waitForIdle();
+
+        auto results = handler.results();
+        TEST_ASSERT(results.size() == 2, "被取代的请求不执行");
+        TEST_ASSERT(results[0].keyword == "alpha" && results[1].keyword == "gamma", "只执行最新的请求");
+        TEST_ASSERT(results[1].generation == third, "结果带有请求序号");
+        TEST_ASSERT(searcher.getCancelledCount() == 1, "执行中被取代的请求计为取消");
+
+        // 取消后不再送达
+        searcher.search("alpha");
+        searcher.cancel();
+        searcher.waitForIdle();
+        TEST_ASSERT(handler.results().size() <= 3, "取消后不再送达新结果");
+
+        TEST_PASS("testLatestRequestWins: 只执行最新的请求");
+        return true;
+    }
+
+    bool testInvalidateCache() {
+        auto& store = suyan::ClipboardStore::instance();
+        store.clearAll();
+        addText("meeting notes", "searcher_cache_001");
+
+        RecordingHandler handler;
+        suyan::ClipboardSearcher searcher([&handler](suyan::SearchResult result) {
+            handler(std::move(result));
+        });
+        searcher.start();
+
+        searcher.search("meet");
+        searcher.waitForIdle();
+
+        // 新增记录后清除缓存，继续输入时重新查询
+        addText("meeting agenda", "searcher_cache_002");
+        searcher.invalidateCache();
+        searcher.search("meeti");
+        searcher.waitForIdle();
+
+        TEST_ASSERT(searcher.getQueryCount() == 2 && searcher.getRefinedCount() == 0, "缓存失效后重新查询");
+        TEST_ASSERT(handler.results().back().records.size() == 2, "包含新增的记录");
+
+        TEST_PASS("testInvalidateCache: 缓存失效后重新查询");
+        return true;
+    }
+
+    bool testStop() {
+        RecordingHandler handler;
+        suyan::ClipboardSearcher searcher([&handler](suyan::SearchResult result) {
+            handler(std::move(result));
+        });
+
+        TEST_ASSERT(searcher.search("meeting") == 0, "未启动时不接受请求");
+        searcher.start();
+        TEST_ASSERT(searcher.isRunning(), "已启动");
+        TEST_ASSERT(searcher.search("") == 0, "空关键词不接受");
+
+        searcher.stop();
+        TEST_ASSERT(!searcher.isRunning(), "已停止");
+        TEST_ASSERT(searcher.search("meeting") == 0, "停止后不接受请求");
+
+        TEST_PASS("testStop: 停止正常");
+        return true;
+    }
+};
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+
+    ClipboardSearcherTest test;
+    return test.runAllTests() ? 0 : 1;
+}
@@ -5,12 +5,17 @@
  */
 
 #include <iostream>
+#include <algorithm>
 #include <cassert>
 #include <filesystem>
 #include <thread>
 #include <chrono>
+#include <atomic>
+#include <future>
 #include <QCoreApplication>
+#include <sqlite3.h>
 #include "clipboard_store.h"
+#include "cjk_tokenizer.h"
 
 namespace fs = std::filesystem;
 
@@ -65,20 +70,36 @@ public:
         allPassed &= testUpdateLastUsedTime();
         allPassed &= testGetAllRecords();
         allPassed &= testGetAllRecordsPagination();
+        allPassed &= testGetRecordsAfter();
+        allPassed &= testTextPreview();
+        allPassed &= testLargeTextRecord();
         allPassed &= testDeleteRecord();
         
         // 搜索测试
         allPassed &= testSearchText();
         allPassed &= testSearchTextNoMatch();
+        allPassed &= testSearchChineseSubstring();
+        allPassed &= testRefineSearch();
+        allPassed &= testFtsMigration();
         
         // 清理测试
         allPassed &= testDeleteExpiredByAge();
         allPassed &= testDeleteExpiredByCount();
         allPassed &= testDeleteExpiredByCombined();
+        allPassed &= testDeleteExpiredInBatches();
         allPassed &= testClearAll();
         
         // 计数测试
         allPassed &= testGetRecordCount();
+        allPassed &= testTotalFileSize();
+        allPassed &= testLastReconcileTime();
+        allPassed &= testEvictImagesOverQuota();
+        allPassed &= testLegacyImagePaths();
+        allPassed &= testImageFilesAfterHash();
+        
+        // 并发测试
+        allPassed &= testReadsDuringWrite();
+        allPassed &= testConcurrentSearches();
         
         std::cout << std::endl;
         if (allPassed) {
@@ -173,7 +194,7 @@ private:
         auto& store = suyan::ClipboardStore::instance();
         
         auto record = createTextRecord("Hello, World!", "hash_text_001");
-        int64_t id = store.addRecord(record);
+        int64_t id = store.addRecord(record).id;
         
         TEST_ASSERT(id > 0, "添加记录应该返回有效 ID");
         
@@ -196,7 +217,7 @@ private:
         
         auto record = createImageRecord("/path/to/image.png", "hash_image_001", 
                                         "/path/to/thumb.png", "png");
-        int64_t id = store.addRecord(record);
+        int64_t id = store.addRecord(record).id;
         
         TEST_ASSERT(id > 0, "添加记录应该返回有效 ID");
         
@@ -221,7 +242,7 @@ private:
         
         // 添加第一条记录
         auto record1 = createTextRecord("Duplicate content", "hash_dup_001");
-        int64_t id1 = store.addRecord(record1);
+        int64_t id1 = store.addRecord(record1).id;
         TEST_ASSERT(id1 > 0, "第一条记录应该添加成功");
         
         // 获取第一条记录的时间戳
@@ -233,7 +254,7 @@ private:
         
         // 添加相同哈希的记录
         auto record2 = createTextRecord("Duplicate content", "hash_dup_001");
-        int64_t id2 = store.addRecord(record2);
+        int64_t id2 = store.addRecord(record2).id;
         
         // 应该返回相同的 ID
         TEST_ASSERT(id2 == id1, "重复哈希应该返回相同 ID");
@@ -280,7 +301,7 @@ private:
         
         // 添加记录
         auto record = createTextRecord("Get record test", "hash_get_001");
-        int64_t id = store.addRecord(record);
+        int64_t id = store.addRecord(record).id;
         
         // 查找存在的 ID
         auto found = store.getRecord(id);
@@ -297,7 +318,7 @@ private:
         
         // 添加记录
         auto record = createTextRecord("Update time test", "hash_update_001");
-        int64_t id = store.addRecord(record);
+        int64_t id = store.addRecord(record).id;
         
         auto original = store.getRecord(id);
         int64_t originalTime = original->lastUsedAt;
@@ -341,8 +362,8 @@ private:
         TEST_ASSERT(all.size() == 3, "应该返回 3 条记录");
         
         // 验证按最后使用时间降序排列
-        TEST_ASSERT(all[0].content == "Record 3", "第一条应该是最新的");
-        TEST_ASSERT(all[2].content == "Record 1", "最后一条应该是最旧的");
+        TEST_ASSERT(all[0].preview == "Record 3", "第一条应该是最新的");
+        TEST_ASSERT(all[2].preview == "Record 1", "最后一条应该是最旧的");
         
         TEST_PASS("testGetAllRecords: 获取所有记录正常");
         return true;
@@ -362,11 +383,11 @@ private:
         // 测试分页
         auto page1 = store.getAllRecords(2, 0);
         TEST_ASSERT(page1.size() == 2, "第一页应该有 2 条记录");
-        TEST_ASSERT(page1[0].content == "Record 5", "第一页第一条应该是最新的");
+        TEST_ASSERT(page1[0].preview == "Record 5", "第一页第一条应该是最新的");
         
         auto page2 = store.getAllRecords(2, 2);
         TEST_ASSERT(page2.size() == 2, "第二页应该有 2 条记录");
-        TEST_ASSERT(page2[0].content == "Record 3", "第二页第一条应该正确");
+        TEST_ASSERT(page2[0].preview == "Record 3", "第二页第一条应该正确");
         
         auto page3 = store.getAllRecords(2, 4);
         TEST_ASSERT(page3.size() == 1, "第三页应该有 1 条记录");
@@ -375,13 +396,146 @@ private:
         return true;
     }
     
+    bool testGetRecordsAfter() {
+        resetTestEnvironment();
+        auto& store = suyan::ClipboardStore::instance();
+        
+        // 连续添加，部分记录的最后使用时间相同
+        for (int i = 1; i <= 7; i++) {
+            store.addRecord(createTextRecord("Keyset " + std::to_string(i), 
+                                             "hash_keyset_" + std::to_string(i)));
+            if (i % 3 == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+        }
+        
+        // 逐页读取，结果与一次性读取的顺序一致，不重复不遗漏
+        auto all = store.getAllRecords(100, 0);
+        TEST_ASSERT(all.size() == 7, "应该有 7 条记录");
+        
+        std::vector<suyan::PreviewRecord> paged;
+        suyan::RecordCursor cursor;
+        while (true) {
+            auto page = store.getRecordsAfter(cursor, 2);
+            if (page.empty()) {
+                break;
+            }
+            TEST_ASSERT(page.size() <= 2, "每页最多 2 条");
+            paged.insert(paged.end(), page.begin(), page.end());
+            cursor = suyan::RecordCursor(page.back());
+        }
+        TEST_ASSERT(paged.size() == all.size(), "分页读取的总数一致");
+        for (size_t i = 0; i < all.size(); i++) {
+            TEST_ASSERT(paged[i].id == all[i].id, "分页顺序与整体顺序一致");
+        }
+        TEST_ASSERT(paged[0].preview == "Keyset 7", "第一条是最新的");
+        
+        // 翻页过程中插入新记录，不影响后续页
+        auto page1 = store.getRecordsAfter(suyan::RecordCursor(), 3);
+        store.addRecord(createTextRecord("Keyset 8", "hash_keyset_8"));
+        auto page2 = store.getRecordsAfter(suyan::RecordCursor(page1.back()), 3);
+        TEST_ASSERT(page2.size() == 3 && page2[0].id == all[3].id, "新记录不影响后续页");
+        
+        TEST_PASS("testGetRecordsAfter: 键集分页正常");
+        return true;
+    }
+    
+    bool testTextPreview() {
+        resetTestEnvironment();
+        using suyan::ClipboardStore;
+        
+        // 空白折叠为单个空格，去掉首尾空白
+        TEST_ASSERT(ClipboardStore::makePreview("  第一行\n\n  second\tline \r\n") == "第一行 second line",
+                    "空白折叠");
+        TEST_ASSERT(ClipboardStore::makePreview(" \n\t").empty(), "全空白");
+        
+        // 按字符（而非字节）截断
+        std::string exact(ClipboardStore::kPreviewLength, 'a');
+        TEST_ASSERT(ClipboardStore::makePreview(exact) == exact, "恰好达到上限不截断");
+        TEST_ASSERT(ClipboardStore::makePreview(exact + "  \n") == exact, "末尾空白不算超出");
+        TEST_ASSERT(ClipboardStore::makePreview(exact + "b") == exact + "...", "超出上限截断");
+        std::string hanzi;
+        for (size_t i = 0; i < ClipboardStore::kPreviewLength + 20; ++i) {
+            hanzi += "中";
+        }
+        auto preview = ClipboardStore::makePreview(hanzi);
+        TEST_ASSERT(preview == hanzi.substr(0, ClipboardStore::kPreviewLength * 3) + "...", "多字节字符截断");
+        
+        // 列表只返回预览，完整内容按 ID 读取
+        std::string longText;
+        while (longText.size() < 64 * 1024) {
+            longText += "第一行内容\n    缩进的第二行 line\n";
+        }
+        auto& store = ClipboardStore::instance();
+        auto added = store.addRecord(createTextRecord(longText, "hash_preview_001"));
+        TEST_ASSERT(added.id > 0, "添加长文本");
+        store.addRecord(createImageRecord("/path/preview.png", "hash_preview_002"));
+        
+        auto all = store.getAllRecords();
+        TEST_ASSERT(all.size() == 2, "记录数");
+        TEST_ASSERT(all[0].type == suyan::ClipboardContentType::Image && all[0].preview.empty() &&
+                    all[0].contentLength == 0, "图片没有文本预览");
+        TEST_ASSERT(all[1].preview == ClipboardStore::makePreview(longText), "文本预览");
+        TEST_ASSERT(all[1].preview.find('\n') == std::string::npos, "预览为单行");
+        TEST_ASSERT(all[1].contentLength == static_cast<int64_t>(longText.size()), "内容字节数");
+        
+        auto found = store.searchText("缩进");
+        TEST_ASSERT(found.size() == 1 && found[0].preview == all[1].preview, "搜索结果为预览");
+        
+        auto full = store.getRecord(added.id);
+        TEST_ASSERT(full && full->content == longText, "完整内容按 ID 读取");
+        
+        TEST_PASS("testTextPreview: 列表预览正常");
+        return true;
+    }
+    
+    bool testLargeTextRecord() {
+        resetTestEnvironment();
+        auto& store = suyan::ClipboardStore::instance();
+        
+        // 大文本只在数据库中保存预览和分块清单
+        suyan::ClipboardRecord record = createTextRecord("大文本预览 preview", "hash_large_001");
+        record.contentLength = 8 * 1024 * 1024;
+        record.textChunks = "chunk_aaa,chunk_bbb";
+        record.fileSize = 512 * 1024;
+        auto added = store.addRecord(record);
+        TEST_ASSERT(added.id > 0, "添加大文本记录");
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        store.addRecord(createTextRecord("普通文本 chunk_aaa", "hash_large_002"));
+        
+        auto full = store.getRecord(added.id);
+        TEST_ASSERT(full.has_value(), "按 ID 读取");
+        TEST_ASSERT(full->content == "大文本预览 preview", "content 为预览");
+        TEST_ASSERT(full->textChunks == "chunk_aaa,chunk_bbb", "分块清单");
+        TEST_ASSERT(full->contentLength == 8 * 1024 * 1024, "原文字节数");
+        TEST_ASSERT(full->fileSize == 512 * 1024, "压缩后大小");
+        
+        auto all = store.getAllRecords();
+        TEST_ASSERT(all.size() == 2 && all[1].contentLength == 8 * 1024 * 1024, "列表返回原文字节数");
+        TEST_ASSERT(store.searchText("preview").size() == 1, "FTS 索引预览");
+        
+        // 分块引用检查只看分块清单，不看文本内容
+        TEST_ASSERT(store.isTextChunkReferenced("chunk_aaa"), "分块被引用");
+        TEST_ASSERT(store.isTextChunkReferenced("chunk_bbb"), "分块被引用");
+        TEST_ASSERT(!store.isTextChunkReferenced("chunk_ccc"), "分块未被引用");
+        
+        // 过期清理返回分块清单，供调用方删除文件
+        auto deleted = store.deleteExpiredRecords(0, 1);
+        TEST_ASSERT(deleted.size() == 1 && deleted[0].id == added.id, "删除大文本记录");
+        TEST_ASSERT(deleted[0].textChunks == "chunk_aaa,chunk_bbb", "返回分块清单");
+        TEST_ASSERT(!store.isTextChunkReferenced("chunk_aaa"), "删除后不再被引用");
+        
+        TEST_PASS("testLargeTextRecord: 大文本记录正常");
+        return true;
+    }
+    
     bool testDeleteRecord() {
         resetTestEnvironment();
         auto& store = suyan::ClipboardStore::instance();
         
         // 添加记录
         auto record = createTextRecord("Delete test", "hash_delete_001");
-        int64_t id = store.addRecord(record);
+        int64_t id = store.addRecord(record).id;
         
         // 验证记录存在
         TEST_ASSERT(store.getRecord(id).has_value(), "记录应该存在");
@@ -424,7 +578,7 @@ private:
         // 搜索 "China"
         results = store.searchText("China");
         TEST_ASSERT(results.size() == 1, "搜索 China 应该返回 1 条结果");
-        TEST_ASSERT(results[0].content == "Hello China", "内容应该正确");
+        TEST_ASSERT(results[0].preview == "Hello China", "内容应该正确");
         
         TEST_PASS("testSearchText: 文本搜索正常");
         return true;
@@ -449,6 +603,176 @@ private:
         return true;
     }
     
+    bool testSearchChineseSubstring() {
+        resetTestEnvironment();
+        auto& store = suyan::ClipboardStore::instance();
+        
+        store.addRecord(createTextRecord("明天下午的会议纪要", "hash_cjk_001"));
+        store.addRecord(createTextRecord("会议室已预订，Room 302", "hash_cjk_002"));
+        store.addRecord(createTextRecord("今天开会", "hash_cjk_003"));
+        
+        // 中文子串
+        auto results = store.searchText("会议");
+        TEST_ASSERT(results.size() == 2, "搜索 会议 应该返回 2 条结果");
+        results = store.searchText("下午的会");
+        TEST_ASSERT(results.size() == 1 && results[0].preview == "明天下午的会议纪要", "多字子串");
+        results = store.searchText("纪要");
+        TEST_ASSERT(results.size() == 1, "段末子串");
+        
+        // 单字：段首、段中、段末
+        TEST_ASSERT(store.searchText("明").size() == 1, "单字（段首）");
+        TEST_ASSERT(store.searchText("会").size() == 3, "单字（段中和段末）");
+        TEST_ASSERT(store.searchText("要").size() == 1, "单字（段末）");
+        
+        // 中英混合，标点不影响匹配
+        TEST_ASSERT(store.searchText("预订，Room").size() == 1, "中英混合");
+        TEST_ASSERT(store.searchText("room").size() == 1, "英文不区分大小写");
+        
+        // 不连续的字不匹配
+        TEST_ASSERT(store.searchText("会纪").empty(), "不连续的字不匹配");
+        TEST_ASSERT(store.searchText("议室已").size() == 1, "跨二元组的子串");
+        
+        // 英文词中间的子串仍可匹配（LIKE 降级）
+        TEST_ASSERT(store.searchText("oom").size() == 1, "英文词中子串");
+        
+        // 关键词中的双引号被转义，作为标点忽略，不破坏查询
+        TEST_ASSERT(store.searchText("\"会议").size() == 2, "双引号被转义");
+        
+        TEST_PASS("testSearchChineseSubstring: 中文子串搜索正常");
+        return true;
+    }
+    
+    bool testRefineSearch() {
+        resetTestEnvironment();
+        auto& store = suyan::ClipboardStore::instance();
+        
+        store.addRecord(createTextRecord("meeting notes", "hash_refine_001"));
+        store.addRecord(createTextRecord("meet at noon", "hash_refine_002"));
+        store.addRecord(createTextRecord("Team meeting 会议纪要", "hash_refine_003"));
+        store.addRecord(createTextRecord("会议室", "hash_refine_004"));
+        store.addRecord(createTextRecord("greeting card", "hash_refine_005"));
+        
+        auto sameIds = [](const std::vector<suyan::PreviewRecord>& a, const std::vector<suyan::PreviewRecord>& b) {
+            return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(),
+                [](const suyan::PreviewRecord& x, const suyan::PreviewRecord& y) { return x.id == y.id; });
+        };
+        
+        // 逐字输入：每一步细化的结果与重新搜索一致
+        std::string previous = "m";
+        auto results = store.searchText(previous);
+        for (const std::string keyword : {"me", "mee", "meet", "meeti", "meeting", "meeting n"}) {
+            auto refined = store.refineSearch(previous, results, keyword);
+            TEST_ASSERT(refined.has_value(), "继续输入可以细化: " + keyword);
+            TEST_ASSERT(sameIds(*refined, store.searchText(keyword)), "细化结果与重新搜索一致: " + keyword);
+            previous = keyword;
+            results = std::move(*refined);
+        }
+        TEST_ASSERT(results.size() == 1, "meeting n 只匹配 1 条");
+        
+        // 中文
+        results = store.searchText("会");
+        auto refined = store.refineSearch("会", results, "会议纪");
+        TEST_ASSERT(refined && sameIds(*refined, store.searchText("会议纪")), "中文细化");
+        
+        // 不是继续输入
+        TEST_ASSERT(!store.refineSearch("meet", store.searchText("meet"), "mee"), "删字不能细化");
+        TEST_ASSERT(!store.refineSearch("meet", store.searchText("meet"), "greet"), "不同关键词不能细化");
+        
+        // 上一次来自索引、新关键词需要 LIKE 全表扫描（词中子串）时不能细化
+        results = store.searchText("t");
+        TEST_ASSERT(!results.empty(), "t 有索引匹配");
+        TEST_ASSERT(!store.refineSearch("t", results, "ti"), "需要 LIKE 时不能只检查上一次结果");
+        
+        // 上一次同样来自 LIKE：在上一次结果中逐条检查
+        results = store.searchText("eet");
+        TEST_ASSERT(results.size() == 4, "eet 由 LIKE 匹配 4 条");
+        refined = store.refineSearch("eet", results, "eeti");
+        TEST_ASSERT(refined && sameIds(*refined, store.searchText("eeti")), "LIKE 结果中细化");
+        
+        // 取消的查询不返回结果
+        TEST_ASSERT(!store.refineSearch("eet", results, "eeti", [] { return true; }), "取消后不返回结果");
+        TEST_ASSERT(store.refineSearch("eet", results, "eeti").has_value(), "取消后语句可以继续使用");
+        
+        TEST_PASS("testRefineSearch: 细化搜索正常");
+        return true;
+    }
+    
+    bool testFtsMigration() {
+        auto& store = suyan::ClipboardStore::instance();
+        store.shutdown();
+        
+        // 构造旧版本数据库：FTS 使用默认分词器，user_version 为 0
+        std::string legacyPath = testDataDir_ + "/legacy.db";
+        sqlite3* db = nullptr;
+        TEST_ASSERT(sqlite3_open(legacyPath.c_str(), &db) == SQLITE_OK, "创建旧版本数据库");
+        const char* legacySQL = R"(
+            CREATE TABLE clipboard_history (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                content_type INTEGER NOT NULL,
+                content TEXT NOT NULL,
+                content_hash TEXT NOT NULL UNIQUE,
+                source_app TEXT,
+                thumbnail_path TEXT,
+                image_format TEXT,
+                image_width INTEGER DEFAULT 0,
+                image_height INTEGER DEFAULT 0,
+                file_size INTEGER DEFAULT 0,
+                created_at INTEGER NOT NULL,
+                last_used_at INTEGER NOT NULL
+            );
+            CREATE VIRTUAL TABLE clipboard_fts USING fts5(
+                content, content='clipboard_history', content_rowid='id'
+            );
+            INSERT INTO clipboard_history (content_type, content, content_hash, created_at, last_used_at)
+                VALUES (0, '明天下午的会议纪要', 'legacy_001', 1, 1),
+                       (1, '/path/会议.png', 'legacy_002', 1, 1);
+            INSERT INTO clipboard_fts(rowid, content) VALUES (1, '明天下午的会议纪要');
+            UPDATE clipboard_history SET file_size = 2048 WHERE id = 2;
+        )";
+        TEST_ASSERT(sqlite3_exec(db, legacySQL, nullptr, nullptr, nullptr) == SQLITE_OK, "写入旧数据");
+        sqlite3_close(db);
+        
+        // 初始化时重建索引，已有记录可按中文子串搜索
+        TEST_ASSERT(store.initialize(legacyPath), "打开旧版本数据库");
+        auto results = store.searchText("会议");
+        TEST_ASSERT(results.size() == 1 && results[0].id == 1, "旧记录已重建索引（图片不索引）");
+        TEST_ASSERT(results[0].preview == "明天下午的会议纪要" && results[0].contentLength == 27,
+                    "旧记录已生成预览");
+        TEST_ASSERT(store.getTotalFileSize() == 2048, "按旧记录计算存储空间总量");
+        
+        // 新记录通过触发器进入新索引，删除同步
+        auto added = store.addRecord(createTextRecord("会议改期", "legacy_003"));
+        TEST_ASSERT(store.searchText("会议").size() == 2, "新记录可搜索");
+        TEST_ASSERT(store.deleteRecord(added.id), "删除记录");
+        TEST_ASSERT(store.searchText("改期").empty(), "删除后不再匹配");
+        store.shutdown();
+        
+        // 再次打开不重复迁移
+        TEST_ASSERT(store.initialize(legacyPath), "再次打开");
+        TEST_ASSERT(store.searchText("纪要").size() == 1, "索引保持可用");
+        store.shutdown();
+        
+        // FTS 重建曾经失败（索引仍是默认分词器）时，其余升级照常完成，再次打开时重试重建
+        TEST_ASSERT(sqlite3_open(legacyPath.c_str(), &db) == SQLITE_OK, "打开数据库");
+        suyan::CjkTokenizer::registerTokenizer(db);    // 删除现有索引需要分词器
+        const char* staleFtsSQL = R"(
+            DROP TABLE clipboard_fts;
+            CREATE VIRTUAL TABLE clipboard_fts USING fts5(
+                content, content='clipboard_history', content_rowid='id'
+            );
+        )";
+        TEST_ASSERT(sqlite3_exec(db, staleFtsSQL, nullptr, nullptr, nullptr) == SQLITE_OK, "还原为旧索引");
+        sqlite3_close(db);
+        TEST_ASSERT(store.initialize(legacyPath), "打开旧索引的数据库");
+        TEST_ASSERT(store.searchText("会议").size() == 1, "重试重建索引");
+        store.shutdown();
+        
+        TEST_ASSERT(store.initialize(testDbPath_), "恢复测试数据库");
+        
+        TEST_PASS("testFtsMigration: 旧版本数据库迁移正常");
+        return true;
+    }
+    
     // ========== 清理测试 ==========
     
     bool testDeleteExpiredByAge() {
@@ -487,8 +811,8 @@ private:
         
         // 验证保留的是最新的 3 条
         auto remaining = store.getAllRecords();
-        TEST_ASSERT(remaining[0].content == "Record 5", "最新的应该保留");
-        TEST_ASSERT(remaining[2].content == "Record 3", "第三新的应该保留");
+        TEST_ASSERT(remaining[0].preview == "Record 5", "最新的应该保留");
+        TEST_ASSERT(remaining[2].preview == "Record 3", "第三新的应该保留");
         
         TEST_PASS("testDeleteExpiredByCount: 按条数清理正常");
         return true;
@@ -519,6 +843,58 @@ private:
         return true;
     }
     
+    bool testDeleteExpiredInBatches() {
+        resetTestEnvironment();
+        auto& store = suyan::ClipboardStore::instance();
+        
+        // 超过一批（500 条）的过期记录，其中包含图片
+        const int total = 1200;
+        for (int i = 0; i < total; i++) {
+            if (i % 100 == 0) {
+                store.addRecord(createImageRecord("/path/batch_" + std::to_string(i) + ".png",
+                                                  "hash_batch_" + std::to_string(i),
+                                                  "/path/batch_" + std::to_string(i) + "_thumb.png"));
+            } else {
+                store.addRecord(createTextRecord("批量记录 " + std::to_string(i),
+                                                 "hash_batch_" + std::to_string(i)));
+            }
+        }
+        auto kept = store.getAllRecords(100, 0);
+        int keptImages = 0;
+        for (const auto& record : kept) {
+            keptImages += record.type == suyan::ClipboardContentType::Image ? 1 : 0;
+        }
+        
+        auto deleted = store.deleteExpiredRecords(0, 100);
+        TEST_ASSERT(deleted.size() == total - 100, "应该分批删除 1100 条记录");
+        TEST_ASSERT(store.getRecordCount() == 100, "应该剩余 100 条记录");
+        TEST_ASSERT(store.getAllRecords(100, 0).size() == kept.size() &&
+                    store.getAllRecords(1, 0)[0].id == kept[0].id, "保留的是最近使用的记录");
+        
+        // 只返回清理图片所需的字段：图片带路径，文本不带内容
+        int imageCount = 0;
+        for (const auto& record : deleted) {
+            if (record.type == suyan::ClipboardContentType::Image) {
+                TEST_ASSERT(record.imagePath.find("/path/batch_") == 0, "图片路径");
+                TEST_ASSERT(!record.thumbnailPath.empty(), "缩略图路径");
+                ++imageCount;
+            } else {
+                TEST_ASSERT(record.imagePath.empty(), "文本记录不返回内容");
+            }
+        }
+        TEST_ASSERT(imageCount == total / 100 - keptImages, "被删除的图片数量");
+        
+        // FTS 索引同步删除
+        TEST_ASSERT(static_cast<int>(store.searchText("批量记录", 2000).size()) == 100 - keptImages,
+                    "FTS 只匹配剩余的文本记录");
+        
+        // 再次清理没有可删除的记录
+        TEST_ASSERT(store.deleteExpiredRecords(0, 100).empty(), "没有更多过期记录");
+        
+        TEST_PASS("testDeleteExpiredInBatches: 分批清理正常");
+        return true;
+    }
+    
     bool testClearAll() {
         resetTestEnvironment();
         auto& store = suyan::ClipboardStore::instance();
@@ -526,31 +902,60 @@ private:
         // 添加记录
         store.addRecord(createTextRecord("Clear 1", "hash_clear_001"));
         store.addRecord(createTextRecord("Clear 2", "hash_clear_002"));
-        store.addRecord(createImageRecord("/path/img.png", "hash_clear_003"));
-        
-        TEST_ASSERT(store.getRecordCount() == 3, "应该有 3 条记录");
-        
-        // 清空
-        auto deleted = store.clearAll();
-        TEST_ASSERT(deleted.size() == 3, "应该返回 3 条被删除的记录");
-        TEST_ASSERT(store.getRecordCount() == 0, "清空后应该没有记录");
-        
-        // 验证返回的记录包含图片记录（用于清理文件）
-        bool hasImage = false;
-        for (const auto& r : deleted) {
-            if (r.type == suyan::ClipboardContentType::Image) {
-                hasImage = true;
-                break;
-            }
+        store.addRecord(createImageRecord("/path/img.png", "hash_clear_003", "/path/img_thumb.png"));
+        auto largeText = createTextRecord("Clear large", "hash_clear_006");
+        largeText.textChunks = "chunk_clear";
+        store.addRecord(largeText);
+        
+        TEST_ASSERT(store.getRecordCount() == 4, "应该有 4 条记录");
+        
+        // 清空，只返回带文件的记录（图片和大文本，用于清理文件）
+        std::vector<suyan::DeletedRecord> fileRecords;
+        bool result = store.clearAll(&fileRecords);
+        TEST_ASSERT(result, "清空应该成功");
+        std::vector<suyan::DeletedRecord> images;
+        std::vector<suyan::DeletedRecord> largeTexts;
+        for (const auto& record : fileRecords) {
+            (record.textChunks.empty() ? images : largeTexts).push_back(record);
         }
-        TEST_ASSERT(hasImage, "返回的记录应该包含图片记录");
+        TEST_ASSERT(store.getRecordCount() == 0, "清空后应该没有记录");
+        TEST_ASSERT(largeTexts.size() == 1 && largeTexts[0].textChunks == "chunk_clear", "大文本记录的分块清单");
+        TEST_ASSERT(images.size() == 1, "回调应该只收到 1 条图片记录");
+        TEST_ASSERT(images[0].type == suyan::ClipboardContentType::Image, "回调记录类型为图片");
+        TEST_ASSERT(images[0].imagePath == "/path/img.png", "图片路径");
+        TEST_ASSERT(images[0].thumbnailPath == "/path/img_thumb.png", "缩略图路径");
+        TEST_ASSERT(images[0].contentHash == "hash_clear_003", "内容哈希");
+        TEST_ASSERT(store.searchText("Clear").empty(), "FTS 索引已清空");
+        
+        // 清空后删除触发器恢复，索引继续同步
+        auto added = store.addRecord(createTextRecord("Clear 3", "hash_clear_004"));
+        TEST_ASSERT(store.searchText("Clear").size() == 1, "新记录可搜索");
+        TEST_ASSERT(store.deleteRecord(added.id), "删除记录");
+        TEST_ASSERT(store.searchText("Clear").empty(), "删除后不再匹配");
+        
+        // 不收集文件记录也可以清空
+        store.addRecord(createTextRecord("Clear 4", "hash_clear_005"));
+        TEST_ASSERT(store.clearAll(), "不收集文件记录清空");
+        TEST_ASSERT(store.getRecordCount() == 0, "清空后应该没有记录");
+
+        // 清空失败（其他连接持有写锁）时回滚，不返回文件记录
+        store.addRecord(createImageRecord("/path/img_locked.png", "hash_clear_007"));
+        sqlite3* other = nullptr;
+        TEST_ASSERT(sqlite3_open(testDbPath_.c_str(), &other) == SQLITE_OK, "打开第二个连接");
+        TEST_ASSERT(sqlite3_exec(other, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) == SQLITE_OK, "持有写锁");
+        fileRecords.clear();
+        bool locked = store.clearAll(&fileRecords);
+        sqlite3_exec(other, "ROLLBACK;", nullptr, nullptr, nullptr);
+        sqlite3_close(other);
+        TEST_ASSERT(!locked, "写锁被占用时清空失败");
+        TEST_ASSERT(fileRecords.empty(), "失败时不返回文件记录");
+        TEST_ASSERT(store.getRecordCount() == 1, "失败时记录保留");
+        TEST_ASSERT(store.clearAll(), "释放写锁后清空");
         
         TEST_PASS("testClearAll: 清空所有记录正常");
         return true;
     }
     
-    // ========== 计数测试 ==========
-    
     bool testGetRecordCount() {
         resetTestEnvironment();
         auto& store = suyan::ClipboardStore::instance();
@@ -572,6 +977,243 @@ private:
         TEST_PASS("testGetRecordCount: 获取记录数正常");
         return true;
     }
+    
+    bool testTotalFileSize() {
+        resetTestEnvironment();
+        auto& store = suyan::ClipboardStore::instance();
+        
+        TEST_ASSERT(store.getTotalFileSize() == 0, "初始总量应该是 0");
+        
+        // 添加记录时累加，重复哈希不重复累加
+        auto image = createImageRecord("/path/size.png", "hash_size_001");
+        image.fileSize = 1000;
+        auto imageId = store.addRecord(image).id;
+        auto large = createTextRecord("Large preview", "hash_size_002");
+        large.fileSize = 300;
+        large.textChunks = "chunk_size";
+        store.addRecord(large);
+        store.addRecord(createTextRecord("Plain", "hash_size_003"));
+        store.addRecord(image);
+        TEST_ASSERT(store.getTotalFileSize() == 1300, "添加后累加");
+        
+        // 更新占用空间时调整总量
+        TEST_ASSERT(store.updateFileSize(imageId, 1500), "更新占用空间");
+        TEST_ASSERT(store.getTotalFileSize() == 1800, "更新后调整");
+        auto files = store.getImageFiles();
+        TEST_ASSERT(files.size() == 1 && files[0].imagePath == "/path/size.png" && files[0].fileSize == 1500,
+                    "图片文件列表");
+        
+        // 删除时扣减
+        TEST_ASSERT(store.deleteRecord(imageId), "删除图片记录");
+        TEST_ASSERT(store.getTotalFileSize() == 300, "删除后扣减");
+        
+        // 重新累计与触发器结果一致
+        TEST_ASSERT(store.recalculateTotalFileSize() == 300, "重新累计");
+        
+        // 清空后归零，之后继续累计
+        TEST_ASSERT(store.clearAll(), "清空");
+        TEST_ASSERT(store.getTotalFileSize() == 0, "清空后归零");
+        image.contentHash = "hash_size_004";
+        store.addRecord(image);
+        TEST_ASSERT(store.getTotalFileSize() == 1000, "清空后继续累计");
+        
+        TEST_PASS("testTotalFileSize: 存储空间统计正常");
+        return true;
+    }
+    
+    bool testLastReconcileTime() {
+        resetTestEnvironment();
+        auto& store = suyan::ClipboardStore::instance();
+        
+        TEST_ASSERT(store.getLastReconcileTime() == 0, "从未校准时为 0");
+        TEST_ASSERT(store.setLastReconcileTime(1700000000123LL), "记录校准时间");
+        TEST_ASSERT(store.getLastReconcileTime() == 1700000000123LL, "读取校准时间");
+        
+        // 保存在数据库中：重新打开和清空历史后仍然保留
+        TEST_ASSERT(store.clearAll(), "清空");
+        store.shutdown();
+        TEST_ASSERT(store.initialize(testDbPath_), "重新打开");
+        TEST_ASSERT(store.getLastReconcileTime() == 1700000000123LL, "重新打开后保留");
+        
+        TEST_PASS("testLastReconcileTime: 校准时间持久化正常");
+        return true;
+    }
+    
+    bool testEvictImagesOverQuota() {
+        resetTestEnvironment();
+        auto& store = suyan::ClipboardStore::instance();
+        
+        // 4 张图片各 1000 字节，加一条 500 字节的大文本
+        std::vector<int64_t> imageIds;
+        for (int i = 1; i <= 4; i++) {
+            auto image = createImageRecord("/path/quota_" + std::to_string(i) + ".png",
+                                           "hash_quota_" + std::to_string(i));
+            image.fileSize = 1000;
+            imageIds.push_back(store.addRecord(image).id);
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        auto large = createTextRecord("Large quota", "hash_quota_text");
+        large.fileSize = 500;
+        large.textChunks = "chunk_quota";
+        auto largeId = store.addRecord(large).id;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        TEST_ASSERT(store.getTotalFileSize() == 4500, "初始总量应该是 4500");
+        
+        // 未超出上限时不删除
+        TEST_ASSERT(store.evictImagesOverQuota(5000).empty(), "未超出上限不应该删除");
+        TEST_ASSERT(store.evictImagesOverQuota(0).empty(), "上限为 0 表示不限制");
+        
+        // 使用第 1 张后，最久未使用的是第 2、3 张
+        store.updateLastUsedTime(imageIds[0]);
+        auto evicted = store.evictImagesOverQuota(2600, imageIds[3]);
+        TEST_ASSERT(evicted.size() == 2, "应该淘汰 2 张图片");
+        TEST_ASSERT(evicted[0].id == imageIds[1] && evicted[1].id == imageIds[2], "按最后使用时间从旧到新淘汰");
+        TEST_ASSERT(evicted[0].imagePath == "/path/quota_2.png", "返回图片路径");
+        TEST_ASSERT(store.getTotalFileSize() == 2500, "淘汰后回到上限以内");
+        
+        // 文本和保留的记录不淘汰，即使仍超出上限
+        evicted = store.evictImagesOverQuota(100, imageIds[3]);
+        TEST_ASSERT(evicted.size() == 1 && evicted[0].id == imageIds[0], "只淘汰可淘汰的图片");
+        TEST_ASSERT(store.getRecord(imageIds[3]).has_value(), "保留的图片不应该被淘汰");
+        TEST_ASSERT(store.getRecord(largeId).has_value(), "大文本不应该被淘汰");
+        TEST_ASSERT(store.getTotalFileSize() == 1500, "剩余总量");
+        
+        // 只按图片总量比较：大文本使总量超出上限时不淘汰图片
+        TEST_ASSERT(store.evictImagesOverQuota(1200).empty(), "图片总量未超出上限不应该淘汰");
+        TEST_ASSERT(store.getRecord(imageIds[3]).has_value(), "图片保留");
+        
+        TEST_PASS("testEvictImagesOverQuota: 按存储空间淘汰图片正常");
+        return true;
+    }
+    
+    bool testLegacyImagePaths() {
+        resetTestEnvironment();
+        auto& store = suyan::ClipboardStore::instance();
+        
+        // 旧版本记录使用绝对路径，新记录使用相对路径
+        auto legacyId = store.addRecord(createImageRecord("/data/clipboard/images/abcd1234.png",
+                                                          "hash_legacy_001",
+                                                          "/data/clipboard/thumbnails/abcd1234.png")).id;
+        store.addRecord(createImageRecord("images/ef/gh/efgh5678.png", "hash_legacy_002",
+                                          "thumbnails/ef/gh/efgh5678.png"));
+        store.addRecord(createTextRecord("/not/an/image", "hash_legacy_003"));
+        
+        auto legacy = store.getLegacyImageFiles();
+        TEST_ASSERT(legacy.size() == 1 && legacy[0].id == legacyId, "只返回使用绝对路径的图片记录");
+        TEST_ASSERT(legacy[0].thumbnailPath == "/data/clipboard/thumbnails/abcd1234.png", "返回缩略图路径");
+        
+        // 更新为相对路径后不再需要迁移
+        TEST_ASSERT(store.updateImagePaths(legacyId, "images/ab/cd/abcd1234.png",
+                                           "thumbnails/ab/cd/abcd1234.png"), "更新图片路径");
+        TEST_ASSERT(store.getLegacyImageFiles().empty(), "迁移后没有旧路径记录");
+        auto record = store.getRecord(legacyId);
+        TEST_ASSERT(record && record->content == "images/ab/cd/abcd1234.png", "原图路径已更新");
+        TEST_ASSERT(record->thumbnailPath == "thumbnails/ab/cd/abcd1234.png", "缩略图路径已更新");
+        
+        // 记录不存在时返回 false
+        TEST_ASSERT(!store.updateImagePaths(999999, "images/x.png", ""), "不存在的记录返回 false");
+        
+        TEST_PASS("testLegacyImagePaths: 图片路径迁移查询正常");
+        return true;
+    }
+    
+    bool testImageFilesAfterHash() {
+        resetTestEnvironment();
+        auto& store = suyan::ClipboardStore::instance();
+        
+        // 插入顺序与哈希顺序不同，文本记录不返回
+        store.addRecord(createImageRecord("images/cc/00/cc00.png", "cc00", "thumbnails/cc/00/cc00.png"));
+        store.addRecord(createImageRecord("images/aa/00/aa00.png", "aa00", "thumbnails/aa/00/aa00.png"));
+        store.addRecord(createTextRecord("Text between", "bb00"));
+        store.addRecord(createImageRecord("images/bb/11/bb11.png", "bb11", ""));
+        
+        auto page = store.getImageFilesAfterHash("", 2);
+        TEST_ASSERT(page && page->size() == 2, "第一页 2 条");
+        TEST_ASSERT((*page)[0].contentHash == "aa00" && (*page)[1].contentHash == "bb11", "按哈希升序");
+        TEST_ASSERT((*page)[0].imagePath == "images/aa/00/aa00.png" &&
+                    (*page)[0].thumbnailPath == "thumbnails/aa/00/aa00.png", "返回文件路径");
+        
+        page = store.getImageFilesAfterHash(page->back().contentHash, 2);
+        TEST_ASSERT(page && page->size() == 1 && (*page)[0].contentHash == "cc00", "下一页从上一页的哈希之后开始");
+        page = store.getImageFilesAfterHash("cc00", 2);
+        TEST_ASSERT(page && page->empty(), "最后一页之后为空（不是查询失败）");
+        TEST_ASSERT(store.getImageFiles()[0].contentHash.empty(), "getImageFiles 不读取哈希");
+        
+        TEST_PASS("testImageFilesAfterHash: 按哈希分页读取图片记录正常");
+        return true;
+    }
+    
+    // ========== 并发测试 ==========
+    
+    bool testReadsDuringWrite() {
+        resetTestEnvironment();
+        auto& store = suyan::ClipboardStore::instance();
+        
+        store.addRecord(createTextRecord("Concurrent read 会议纪要", "hash_concurrent_001"));
+        store.addRecord(createImageRecord("/path/concurrent.png", "hash_concurrent_002"));
+        
+        // 另一个连接持有未提交的写事务（不触发需要分词器的 FTS 触发器）
+        int64_t totalBefore = store.getTotalFileSize();
+        sqlite3* writer = nullptr;
+        TEST_ASSERT(sqlite3_open(testDbPath_.c_str(), &writer) == SQLITE_OK, "打开写连接");
+        TEST_ASSERT(sqlite3_exec(writer, R"(
+            BEGIN IMMEDIATE;
+            UPDATE clipboard_meta SET value = value + 1 WHERE key = 'file_size_total';
+        )", nullptr, nullptr, nullptr) == SQLITE_OK, "开始写事务");
+        
+        // 查询在只读连接上执行，不等待写事务，读到写事务开始前的数据
+        auto reads = std::async(std::launch::async, [&] {
+            return std::make_pair(store.searchText("会议").size(), store.getAllRecords().size());
+        });
+        bool finished = reads.wait_for(std::chrono::seconds(2)) == std::future_status::ready;
+        sqlite3_exec(writer, "COMMIT;", nullptr, nullptr, nullptr);
+        sqlite3_close(writer);
+        
+        TEST_ASSERT(finished, "写事务期间查询不应该阻塞");
+        auto [searchCount, listCount] = reads.get();
+        TEST_ASSERT(searchCount == 1, "写事务期间可以搜索");
+        TEST_ASSERT(listCount == 2, "写事务期间可以列出记录");
+        TEST_ASSERT(store.getTotalFileSize() == totalBefore + 1, "写事务提交后读到新数据");
+        
+        TEST_PASS("testReadsDuringWrite: 写入期间查询不阻塞");
+        return true;
+    }
+    
+    bool testConcurrentSearches() {
+        resetTestEnvironment();
+        auto& store = suyan::ClipboardStore::instance();
+        
+        for (int i = 0; i < 50; ++i) {
+            store.addRecord(createTextRecord("Parallel item " + std::to_string(i) + (i % 2 ? " 奇数" : " 偶数"),
+                                             "hash_parallel_" + std::to_string(i)));
+        }
+        
+        // 查询线程多于只读连接数，连接轮流借用；同时有写入
+        std::atomic<bool> wrong{false};
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 4; ++t) {
+            readers.emplace_back([&] {
+                for (int i = 0; i < 100; ++i) {
+                    if (store.searchText("奇数").size() != 25 || store.searchText("Parallel").size() < 50) {
+                        wrong = true;
+                    }
+                }
+            });
+        }
+        for (int i = 0; i < 20; ++i) {
+            store.addRecord(createTextRecord("Parallel extra " + std::to_string(i),
+                                             "hash_parallel_extra_" + std::to_string(i)));
+        }
+        for (auto& reader : readers) {
+            reader.join();
+        }
+        
+        TEST_ASSERT(!wrong, "并发查询结果应该正确");
+        TEST_ASSERT(store.searchText("Parallel").size() == 70, "写入后可以查到新记录");
+        
+        TEST_PASS("testConcurrentSearches: 并发查询正常");
+        return true;
+    }
 };
 
 int main(int argc, char* argv[]) {
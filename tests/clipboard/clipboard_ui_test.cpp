@@ -21,12 +21,14 @@
 #include <QTimer>
 #include <QImage>
 #include <QBuffer>
-#include <QListWidget>
+#include <QListView>
 #include <QLineEdit>
+#include <QScrollBar>
 
 #include "clipboard_window.h"
 #include "clipboard_list.h"
-#include "clipboard_item_widget.h"
+#include "clipboard_list_model.h"
+#include "clipboard_item_delegate.h"
 #include "clipboard_manager.h"
 #include "clipboard_store.h"
 #include "image_storage.h"
@@ -84,6 +86,9 @@ public:
         allPassed &= testListRenderTextRecords();
         allPassed &= testListRenderImageRecords();
         allPassed &= testListEmptyHint();
+        allPassed &= testListPagination();
+        allPassed &= testListPaintsWithoutItemWidgets();
+        allPassed &= testListKeyboardNavigation();
 
         // 搜索过滤测试
         allPassed &= testSearchFilter();
@@ -143,7 +148,7 @@ private:
         record.content = content;
         record.contentHash = hash;
         record.sourceApp = "com.test.ui";
-        return suyan::ClipboardStore::instance().addRecord(record);
+        return suyan::ClipboardStore::instance().addRecord(record).id;
     }
 
     // 添加测试图片记录
@@ -178,7 +183,7 @@ private:
         record.imageHeight = result.height;
         record.fileSize = result.fileSize;
 
-        return suyan::ClipboardStore::instance().addRecord(record);
+        return suyan::ClipboardStore::instance().addRecord(record).id;
     }
 
     // 处理事件循环
@@ -377,6 +382,117 @@ private:
         return true;
     }
 
+    bool testListPagination() {
+        std::cout << std::endl << "--- 测试列表分页加载 ---" << std::endl;
+
+        resetTestData();
+
+        // 添加超过两页的记录
+        const int total = suyan::ClipboardListModel::kPageSize * 2 + 20;
+        for (int i = 0; i < total; i++) {
+            addTestTextRecord("分页测试 " + std::to_string(i), "ui_page_hash_" + std::to_string(i));
+        }
+
+        window_->showWindow();
+        processEvents(200);
+
+        auto* clipboardList = window_->findChild<suyan::ClipboardList*>();
+        auto* listView = window_->findChild<QListView*>();
+        TEST_ASSERT(clipboardList != nullptr && listView != nullptr, "应该能找到列表组件");
+
+        // 初始只加载第一页
+        int count = clipboardList->recordCount();
+        std::cout << "  初始记录数: " << count << std::endl;
+        TEST_ASSERT(count == suyan::ClipboardListModel::kPageSize, "初始应该只加载一页");
+
+        // 滚动到底部，逐页加载直到全部加载
+        for (int i = 0; i < 10 && clipboardList->recordCount() < total; i++) {
+            listView->verticalScrollBar()->setValue(listView->verticalScrollBar()->maximum());
+            processEvents(50);
+        }
+        std::cout << "  滚动后记录数: " << clipboardList->recordCount() << std::endl;
+        TEST_ASSERT(clipboardList->recordCount() == total, "滚动到底部后应该加载全部记录");
+
+        window_->hideWindow();
+        processEvents();
+
+        TEST_PASS("列表分页加载正常");
+        return true;
+    }
+
+    bool testListPaintsWithoutItemWidgets() {
+        std::cout << std::endl << "--- 测试列表项直接绘制 ---" << std::endl;
+
+        resetTestData();
+
+        for (int i = 0; i < 30; i++) {
+            addTestTextRecord("绘制测试 " + std::to_string(i), "ui_paint_hash_" + std::to_string(i));
+        }
+        addTestImageRecord("ui_paint_image_001");
+
+        window_->showWindow();
+        processEvents(200);
+
+        auto* listView = window_->findChild<QListView*>();
+        TEST_ASSERT(listView != nullptr, "应该能找到列表视图");
+
+        // 列表项由委托绘制，视图中没有任何子 widget
+        TEST_ASSERT(listView->viewport()->findChildren<QWidget*>().isEmpty(), "列表项不应该创建 widget");
+
+        // 固定行高
+        QModelIndex first = listView->model()->index(0, 0);
+        TEST_ASSERT(listView->visualRect(first).height() == suyan::ClipboardItemDelegate::ITEM_HEIGHT,
+                    "行高应该固定");
+
+        // 滚动时同样不创建 widget
+        listView->verticalScrollBar()->setValue(listView->verticalScrollBar()->maximum());
+        processEvents(50);
+        TEST_ASSERT(listView->viewport()->findChildren<QWidget*>().isEmpty(), "滚动后也不应该创建 widget");
+
+        // 模型角色
+        auto* model = listView->model();
+        TEST_ASSERT(model->data(first, Qt::DisplayRole).toString() == "[图片]", "最新的图片记录显示 [图片]");
+        TEST_ASSERT(model->data(first, suyan::ClipboardListModel::ContentTypeRole).toInt() ==
+                    static_cast<int>(suyan::ClipboardContentType::Image), "内容类型角色");
+
+        window_->hideWindow();
+        processEvents();
+
+        TEST_PASS("列表项直接绘制正常");
+        return true;
+    }
+
+    bool testListKeyboardNavigation() {
+        std::cout << std::endl << "--- 测试键盘导航 ---" << std::endl;
+
+        resetTestData();
+
+        int64_t olderId = addTestTextRecord("导航测试 1", "ui_nav_hash_001");
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        int64_t newerId = addTestTextRecord("导航测试 2", "ui_nav_hash_002");
+
+        window_->showWindow();
+        processEvents(200);
+
+        auto* clipboardList = window_->findChild<suyan::ClipboardList*>();
+        TEST_ASSERT(clipboardList != nullptr, "应该能找到 ClipboardList 组件");
+        TEST_ASSERT(clipboardList->selectedRecordId() == -1, "初始没有选中项");
+
+        // 下键依次选中
+        QTest::keyClick(clipboardList, Qt::Key_Down);
+        TEST_ASSERT(clipboardList->selectedRecordId() == newerId, "下键选中第一项");
+        QTest::keyClick(clipboardList, Qt::Key_Down);
+        TEST_ASSERT(clipboardList->selectedRecordId() == olderId, "再按下键选中第二项");
+        QTest::keyClick(clipboardList, Qt::Key_Up);
+        TEST_ASSERT(clipboardList->selectedRecordId() == newerId, "上键回到第一项");
+
+        window_->hideWindow();
+        processEvents();
+
+        TEST_PASS("键盘导航正常");
+        return true;
+    }
+
     // ========== 搜索过滤测试 ==========
 
     bool testSearchFilter() {
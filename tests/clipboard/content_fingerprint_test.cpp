@@ -0,0 +1,245 @@
+/**
+ * ContentFingerprint 单元测试
+ *
+ * 测试预筛键、128 位快速哈希和可替换的指纹算法。
+ */
+
+#include <iostream>
+#include <bitset>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include <QCoreApplication>
+#include "content_fingerprint.h"
+
+// 测试辅助宏
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "✗ 断言失败: " << message << std::endl; \
+            std::cerr << "  位置: " << __FILE__ << ":" << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define TEST_PASS(message) \
+    std::cout << "✓ " << message << std::endl
+
+using suyan::ContentFingerprint;
+
+class ContentFingerprintTest {
+public:
+    bool runAllTests() {
+        std::cout << "=== ContentFingerprint 单元测试 ===" << std::endl;
+        std::cout << std::endl;
+
+        bool allPassed = true;
+
+        allPassed &= testHashDeterministic();
+        allPassed &= testHashLengths();
+        allPassed &= testHashBitFlips();
+        allPassed &= testHashAvalanche();
+        allPassed &= testQuickKey();
+        allPassed &= testPrepareAndEnsureHash();
+        allPassed &= testIsSameContent();
+        allPassed &= testSha256Fingerprinter();
+
+        std::cout << std::endl;
+        if (allPassed) {
+            std::cout << "=== 所有测试通过 ===" << std::endl;
+        } else {
+            std::cout << "=== 部分测试失败 ===" << std::endl;
+        }
+
+        return allPassed;
+    }
+
+private:
+    std::vector<uint8_t> randomBytes(size_t size, uint64_t seed = 1) {
+        std::mt19937_64 gen(seed);
+        std::vector<uint8_t> data(size);
+        for (auto& byte : data) {
+            byte = static_cast<uint8_t>(gen());
+        }
+        return data;
+    }
+
+    suyan::ClipboardContent createImageContent(std::vector<uint8_t> data) {
+        suyan::ClipboardContent content;
+        content.type = suyan::MonitorContentType::Image;
+        content.imageData = std::move(data);
+        content.imageFormat = "tiff";
+        return content;
+    }
+
+    bool testHashDeterministic() {
+        auto data = randomBytes(100000);
+        auto first = ContentFingerprint::hash128(data.data(), data.size());
+        auto second = ContentFingerprint::hash128(data.data(), data.size());
+        TEST_ASSERT(first == second, "相同输入得到相同哈希");
+        TEST_ASSERT(first != ContentFingerprint::hash128(data.data(), data.size(), 1), "种子影响哈希");
+        TEST_ASSERT(first.high != first.low, "高低两半独立");
+
+        std::string hex = first.toHex();
+        TEST_ASSERT(hex.size() == 32, "十六进制长度");
+        TEST_ASSERT(hex.find_first_not_of("0123456789abcdef") == std::string::npos, "十六进制字符");
+
+        TEST_PASS("testHashDeterministic: 哈希确定性正常");
+        return true;
+    }
+
+    bool testHashLengths() {
+        // 全零数据的不同长度（覆盖补零的末尾条带和整块边界）
+        std::vector<uint8_t> zeros(5000, 0);
+        std::set<std::string> hashes;
+        for (size_t size = 0; size <= 2100; ++size) {
+            hashes.insert(ContentFingerprint::hash128(zeros.data(), size).toHex());
+        }
+        TEST_ASSERT(hashes.size() == 2101, "不同长度的全零数据哈希互不相同");
+
+        TEST_PASS("testHashLengths: 长度区分正常");
+        return true;
+    }
+
+    bool testHashBitFlips() {
+        auto data = randomBytes(3000);
+        std::set<std::string> hashes;
+        hashes.insert(ContentFingerprint::hash128(data.data(), data.size()).toHex());
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] ^= 0x01;
+            hashes.insert(ContentFingerprint::hash128(data.data(), data.size()).toHex());
+            data[i] ^= 0x01;
+        }
+        TEST_ASSERT(hashes.size() == data.size() + 1, "任意位置改动一位，哈希都不同");
+
+        TEST_PASS("testHashBitFlips: 单比特改动可区分");
+        return true;
+    }
+
+    bool testHashAvalanche() {
+        auto data = randomBytes(4096, 7);
+        auto base = ContentFingerprint::hash128(data.data(), data.size());
+        double totalChanged = 0;
+        int samples = 0;
+        for (size_t i = 0; i < data.size(); i += 37) {
+            data[i] ^= 0x80;
+            auto changed = ContentFingerprint::hash128(data.data(), data.size());
+            data[i] ^= 0x80;
+            totalChanged += std::bitset<64>(base.high ^ changed.high).count() +
+                            std::bitset<64>(base.low ^ changed.low).count();
+            ++samples;
+        }
+        double average = totalChanged / samples;
+        std::cout << "  改动一位平均翻转 " << average << " / 128 位" << std::endl;
+        TEST_ASSERT(average > 56 && average < 72, "雪崩效应接近一半");
+
+        TEST_PASS("testHashAvalanche: 雪崩效应正常");
+        return true;
+    }
+
+    bool testQuickKey() {
+        auto data = randomBytes(1024 * 1024);
+        uint64_t key = ContentFingerprint::quickKey(data.data(), data.size());
+        TEST_ASSERT(key == ContentFingerprint::quickKey(data.data(), data.size()), "相同输入得到相同预筛键");
+        TEST_ASSERT(key != ContentFingerprint::quickKey(data.data(), data.size() - 1), "长度参与预筛键");
+
+        data.front() ^= 1;
+        TEST_ASSERT(key != ContentFingerprint::quickKey(data.data(), data.size()), "开头参与预筛键");
+        data.front() ^= 1;
+        data.back() ^= 1;
+        TEST_ASSERT(key != ContentFingerprint::quickKey(data.data(), data.size()), "结尾参与预筛键");
+        data.back() ^= 1;
+
+        // 小数据完整参与
+        std::string small = "hello";
+        std::string other = "hellp";
+        TEST_ASSERT(ContentFingerprint::quickKey(reinterpret_cast<const uint8_t*>(small.data()), small.size()) !=
+                    ContentFingerprint::quickKey(reinterpret_cast<const uint8_t*>(other.data()), other.size()),
+                    "小数据完整参与预筛键");
+
+        TEST_PASS("testQuickKey: 预筛键正常");
+        return true;
+    }
+
+    bool testPrepareAndEnsureHash() {
+        auto content = createImageContent(randomBytes(200000));
+        content.contentHash = "stale";
+        ContentFingerprint::prepare(content);
+        TEST_ASSERT(content.quickKey != 0, "已计算预筛键");
+        TEST_ASSERT(content.contentHash.empty(), "准备时不计算完整指纹");
+
+        ContentFingerprint::ensureHash(content);
+        std::string expected = ContentFingerprint::hash128(content.imageData.data(),
+                                                           content.imageData.size()).toHex();
+        TEST_ASSERT(content.contentHash == expected, "按需计算完整指纹");
+
+        // 已有指纹时不重复计算
+        content.contentHash = "kept";
+        ContentFingerprint::ensureHash(content);
+        TEST_ASSERT(content.contentHash == "kept", "已有指纹不覆盖");
+
+        TEST_PASS("testPrepareAndEnsureHash: 指纹按需计算正常");
+        return true;
+    }
+
+    bool testIsSameContent() {
+        auto data = randomBytes(1024 * 1024, 3);
+        auto a = createImageContent(data);
+        auto b = createImageContent(data);
+        ContentFingerprint::prepare(a);
+        ContentFingerprint::prepare(b);
+        TEST_ASSERT(ContentFingerprint::isSameContent(a, b), "相同内容");
+        TEST_ASSERT(!a.contentHash.empty() && a.contentHash == b.contentHash, "预筛键相同时计算完整指纹");
+
+        // 中间改动：预筛键相同，由完整指纹区分
+        data[data.size() / 2 + 3] ^= 1;
+        auto c = createImageContent(data);
+        ContentFingerprint::prepare(c);
+        TEST_ASSERT(!ContentFingerprint::isSameContent(a, c), "中间改动由完整指纹区分");
+
+        // 长度不同：预筛键直接区分，不计算完整指纹
+        data.pop_back();
+        auto d = createImageContent(data);
+        auto e = createImageContent(randomBytes(4096));
+        ContentFingerprint::prepare(d);
+        ContentFingerprint::prepare(e);
+        TEST_ASSERT(!ContentFingerprint::isSameContent(d, e), "不同内容");
+        TEST_ASSERT(d.contentHash.empty() && e.contentHash.empty(), "预筛键不同时不计算完整指纹");
+
+        // 类型不同
+        suyan::ClipboardContent text;
+        text.type = suyan::MonitorContentType::Text;
+        text.textData = std::string(data.begin(), data.end());
+        ContentFingerprint::prepare(text);
+        TEST_ASSERT(!ContentFingerprint::isSameContent(text, d), "类型不同");
+
+        TEST_PASS("testIsSameContent: 内容比较正常");
+        return true;
+    }
+
+    bool testSha256Fingerprinter() {
+        suyan::Sha256Fingerprinter sha256;
+        std::string text = "abc";
+        std::string hash = sha256.fingerprint(reinterpret_cast<const uint8_t*>(text.data()), text.size());
+        TEST_ASSERT(hash == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad", "SHA-256 结果");
+
+        // 可替换默认算法
+        suyan::ClipboardContent content;
+        content.type = suyan::MonitorContentType::Text;
+        content.textData = text;
+        ContentFingerprint::prepare(content);
+        ContentFingerprint::ensureHash(content, sha256);
+        TEST_ASSERT(content.contentHash == hash, "使用指定的指纹算法");
+
+        TEST_PASS("testSha256Fingerprinter: SHA-256 指纹正常");
+        return true;
+    }
+};
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+
+    ContentFingerprintTest test;
+    return test.runAllTests() ? 0 : 1;
+}
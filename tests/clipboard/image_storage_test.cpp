@@ -7,9 +7,12 @@
 #include <iostream>
 #include <cassert>
 #include <filesystem>
+#include <fstream>
+#include <chrono>
 #include <QCoreApplication>
 #include <QImage>
 #include <QBuffer>
+#include <QImageWriter>
 #include "image_storage.h"
 
 namespace fs = std::filesystem;
@@ -62,10 +65,16 @@ public:
         allPassed &= testSaveImageDuplicate();
         allPassed &= testSaveImageEmptyData();
         allPassed &= testSaveImageEmptyHash();
+        allPassed &= testSaveImageKeepsOriginalBytes();
+        allPassed &= testSaveImageReencodesOtherFormats();
+        allPassed &= testSaveImageTiffAsPng();
+        allPassed &= testSaveImageShardedPath();
+        allPassed &= testMigrateLegacyFile();
         
         // 缩略图测试
         allPassed &= testThumbnailGeneration();
         allPassed &= testThumbnailSmallImage();
+        allPassed &= testThumbnailLargeImage();
         allPassed &= testSetThumbnailSize();
         
         // 读取测试
@@ -82,6 +91,10 @@ public:
         // 存储大小测试
         allPassed &= testGetStorageSize();
         
+        // 孤儿文件回收测试
+        allPassed &= testListStoredFiles();
+        allPassed &= testDeleteStoredFile();
+        
         std::cout << std::endl;
         if (allPassed) {
             std::cout << "=== 所有测试通过 ===" << std::endl;
@@ -189,7 +202,7 @@ private:
         
         TEST_ASSERT(result.success, "保存 PNG 应该成功");
         TEST_ASSERT(!result.imagePath.empty(), "图片路径不应为空");
-        TEST_ASSERT(fs::exists(result.imagePath), "图片文件应该存在");
+        TEST_ASSERT(fs::exists(storage.resolvePath(result.imagePath)), "图片文件应该存在");
         TEST_ASSERT(result.width == 200, "宽度应该是 200");
         TEST_ASSERT(result.height == 150, "高度应该是 150");
         TEST_ASSERT(result.fileSize > 0, "文件大小应该大于 0");
@@ -210,7 +223,7 @@ private:
         
         TEST_ASSERT(result.success, "保存 JPEG 应该成功");
         TEST_ASSERT(!result.imagePath.empty(), "图片路径不应为空");
-        TEST_ASSERT(fs::exists(result.imagePath), "图片文件应该存在");
+        TEST_ASSERT(fs::exists(storage.resolvePath(result.imagePath)), "图片文件应该存在");
         TEST_ASSERT(result.width == 300, "宽度应该是 300");
         TEST_ASSERT(result.height == 200, "高度应该是 200");
         
@@ -268,6 +281,166 @@ private:
         return true;
     }
     
+    bool testSaveImageKeepsOriginalBytes() {
+        resetTestEnvironment();
+        auto& storage = suyan::ImageStorage::instance();
+        
+        // PNG、JPEG 原样写入，不重新编码
+        auto pngData = createTestPngImage(120, 90);
+        auto pngResult = storage.saveImage(pngData, "png", "test_hash_verbatim_png");
+        TEST_ASSERT(pngResult.success, "保存 PNG 应该成功");
+        TEST_ASSERT(storage.loadImage(pngResult.imagePath) == pngData, "PNG 文件内容应该与原始数据相同");
+        TEST_ASSERT(pngResult.fileSize == static_cast<int64_t>(pngData.size()), "文件大小为原始数据大小");
+        
+        auto jpegData = createTestJpegImage(160, 120);
+        auto jpegResult = storage.saveImage(jpegData, "jpeg", "test_hash_verbatim_jpeg");
+        TEST_ASSERT(jpegResult.success, "保存 JPEG 应该成功");
+        TEST_ASSERT(storage.loadImage(jpegResult.imagePath) == jpegData, "JPEG 文件内容应该与原始数据相同");
+        
+        // 已存在的文件从文件头读取尺寸
+        auto existing = storage.saveImage(pngData, "png", "test_hash_verbatim_png");
+        TEST_ASSERT(existing.success && existing.width == 120 && existing.height == 90, "已存在文件的尺寸");
+        
+        TEST_PASS("testSaveImageKeepsOriginalBytes: 可直接存储的格式原样写入");
+        return true;
+    }
+    
+    bool testSaveImageReencodesOtherFormats() {
+        resetTestEnvironment();
+        auto& storage = suyan::ImageStorage::instance();
+        
+        // 格式名与实际内容不一致：按扩展名重新编码
+        auto pngData = createTestPngImage(100, 80);
+        auto result = storage.saveImage(pngData, "jpeg", "test_hash_mismatch");
+        TEST_ASSERT(result.success, "保存应该成功");
+        auto saved = storage.loadImage(result.imagePath);
+        TEST_ASSERT(saved.size() > 2 && saved[0] == 0xFF && saved[1] == 0xD8, "文件内容应该是 JPEG");
+        TEST_ASSERT(result.width == 100 && result.height == 80, "尺寸应该正确");
+        
+        // 其他格式（BMP）重新编码
+        QImage image(64, 48, QImage::Format_RGB32);
+        image.fill(Qt::green);
+        QByteArray byteArray;
+        QBuffer buffer(&byteArray);
+        buffer.open(QIODevice::WriteOnly);
+        image.save(&buffer, "BMP");
+        std::vector<uint8_t> bmpData(byteArray.begin(), byteArray.end());
+        
+        auto bmpResult = storage.saveImage(bmpData, "bmp", "test_hash_bmp");
+        TEST_ASSERT(bmpResult.success, "保存 BMP 应该成功");
+        TEST_ASSERT(bmpResult.width == 64 && bmpResult.height == 48, "BMP 尺寸应该正确");
+        TEST_ASSERT(fs::exists(storage.resolvePath(bmpResult.thumbnailPath)), "BMP 缩略图应该存在");
+        
+        TEST_PASS("testSaveImageReencodesOtherFormats: 其他格式重新编码");
+        return true;
+    }
+    
+    bool testSaveImageTiffAsPng() {
+        resetTestEnvironment();
+        auto& storage = suyan::ImageStorage::instance();
+        
+        TEST_ASSERT(storage.getStorageFormat("tiff") == "png", "TIFF 存储为 PNG");
+        TEST_ASSERT(storage.getStorageFormat("jpeg") == "jpg", "JPEG 原样存储");
+        TEST_ASSERT(storage.getStorageFormat("gif") == "gif", "GIF 原样存储");
+        
+        if (!QImageWriter::supportedImageFormats().contains("tiff")) {
+            TEST_PASS("testSaveImageTiffAsPng: 未安装 TIFF 插件，跳过转存测试");
+            return true;
+        }
+        
+        // 模拟截图：大块纯色区域，未压缩 TIFF
+        QImage image(1440, 900, QImage::Format_ARGB32);
+        image.fill(Qt::white);
+        for (int y = 100; y < 400; ++y) {
+            for (int x = 200; x < 900; ++x) {
+                image.setPixelColor(x, y, QColor(30, 144, 255));
+            }
+        }
+        QByteArray byteArray;
+        QBuffer buffer(&byteArray);
+        buffer.open(QIODevice::WriteOnly);
+        image.save(&buffer, "TIFF");
+        std::vector<uint8_t> tiffData(byteArray.begin(), byteArray.end());
+        
+        auto result = storage.saveImage(tiffData, "tiff", "test_hash_tiff_001");
+        TEST_ASSERT(result.success, "保存 TIFF 应该成功");
+        TEST_ASSERT(result.format == "png", "存储格式应该是 PNG");
+        TEST_ASSERT(result.imagePath.size() > 4 &&
+                    result.imagePath.compare(result.imagePath.size() - 4, 4, ".png") == 0, "文件扩展名应该是 .png");
+        TEST_ASSERT(result.width == 1440 && result.height == 900, "尺寸应该正确");
+        TEST_ASSERT(result.fileSize * 10 < static_cast<int64_t>(tiffData.size()), "PNG 应该远小于 TIFF");
+        
+        // 无损：像素与原图一致
+        QImage saved(QString::fromStdString(storage.resolvePath(result.imagePath)));
+        TEST_ASSERT(saved.pixelColor(500, 200) == QColor(30, 144, 255), "像素应该无损");
+        TEST_ASSERT(saved.pixelColor(50, 50) == QColor(Qt::white), "背景应该无损");
+        
+        std::cout << "  TIFF 大小: " << tiffData.size() << " bytes, PNG 大小: " << result.fileSize << " bytes" << std::endl;
+        
+        TEST_PASS("testSaveImageTiffAsPng: TIFF 无损转存为 PNG");
+        return true;
+    }
+    
+    bool testSaveImageShardedPath() {
+        resetTestEnvironment();
+        auto& storage = suyan::ImageStorage::instance();
+        
+        auto result = storage.saveImage(createTestPngImage(200, 150), "png", "a1b2c3d4e5f6");
+        TEST_ASSERT(result.success, "保存图片应该成功");
+        
+        // 返回相对路径，按哈希前缀两级分片
+        TEST_ASSERT(result.imagePath == "images/a1/b2/a1b2c3d4e5f6.png", "原图应该存放在分片目录");
+        TEST_ASSERT(result.thumbnailPath == "thumbnails/a1/b2/a1b2c3d4e5f6.png", "缩略图应该存放在分片目录");
+        TEST_ASSERT(storage.resolvePath(result.imagePath) == testBaseDir_ + "/images/a1/b2/a1b2c3d4e5f6.png",
+                    "相对路径基于基础目录解析");
+        TEST_ASSERT(storage.resolvePath("/abs/legacy.png") == "/abs/legacy.png", "绝对路径原样返回");
+        TEST_ASSERT(storage.resolvePath("").empty(), "空路径返回空字符串");
+        
+        // 读取、检查、统计和删除都接受相对路径
+        TEST_ASSERT(storage.imageExists(result.imagePath), "相对路径的文件应该存在");
+        TEST_ASSERT(!storage.loadImage(result.imagePath).empty(), "可以按相对路径读取");
+        TEST_ASSERT(storage.getImageFileSize(result.imagePath, result.thumbnailPath) ==
+                    result.fileSize + result.thumbnailSize, "可以按相对路径统计大小");
+        TEST_ASSERT(storage.deleteImage(result.imagePath, result.thumbnailPath), "可以按相对路径删除");
+        TEST_ASSERT(!storage.imageExists(result.imagePath), "删除后不存在");
+        
+        TEST_PASS("testSaveImageShardedPath: 图片按哈希前缀分片存放");
+        return true;
+    }
+    
+    bool testMigrateLegacyFile() {
+        resetTestEnvironment();
+        auto& storage = suyan::ImageStorage::instance();
+        
+        // 模拟旧版本平铺存放的文件
+        auto imageData = createTestPngImage(50, 50);
+        std::string legacyImage = storage.getImagesDir() + "/0f1e2d3c.png";
+        std::string legacyThumb = storage.getThumbnailsDir() + "/0f1e2d3c.png";
+        std::ofstream(legacyImage, std::ios::binary).write(reinterpret_cast<const char*>(imageData.data()),
+                                                          static_cast<std::streamsize>(imageData.size()));
+        fs::copy_file(legacyImage, legacyThumb);
+        
+        std::string imagePath = storage.migrateLegacyFile(legacyImage, false);
+        std::string thumbPath = storage.migrateLegacyFile(legacyThumb, true);
+        TEST_ASSERT(imagePath == "images/0f/1e/0f1e2d3c.png", "原图迁移到分片目录");
+        TEST_ASSERT(thumbPath == "thumbnails/0f/1e/0f1e2d3c.png", "缩略图迁移到分片目录");
+        TEST_ASSERT(!fs::exists(legacyImage) && !fs::exists(legacyThumb), "旧文件已移走");
+        TEST_ASSERT(storage.loadImage(imagePath) == imageData, "迁移后内容不变");
+        
+        // 重复迁移（上次中断）返回同一路径
+        TEST_ASSERT(storage.migrateLegacyFile(legacyImage, false) == imagePath, "重复迁移返回同一路径");
+        
+        // 数据目录移动后，旧绝对路径不存在时按文件名在当前目录中查找
+        std::string movedImage = storage.getImagesDir() + "/5a6b7c8d.png";
+        fs::copy_file(storage.resolvePath(imagePath), movedImage);
+        std::string movedPath = storage.migrateLegacyFile("/old/data/dir/images/5a6b7c8d.png", false);
+        TEST_ASSERT(movedPath == "images/5a/6b/5a6b7c8d.png", "按文件名找到移动后的文件");
+        TEST_ASSERT(storage.imageExists(movedPath) && !fs::exists(movedImage), "文件已移到分片目录");
+        
+        TEST_PASS("testMigrateLegacyFile: 旧版本图片迁移到分片目录");
+        return true;
+    }
+    
     // ========== 缩略图测试 ==========
     
     bool testThumbnailGeneration() {
@@ -280,10 +453,10 @@ private:
         
         TEST_ASSERT(result.success, "保存应该成功");
         TEST_ASSERT(!result.thumbnailPath.empty(), "缩略图路径不应为空");
-        TEST_ASSERT(fs::exists(result.thumbnailPath), "缩略图文件应该存在");
+        TEST_ASSERT(fs::exists(storage.resolvePath(result.thumbnailPath)), "缩略图文件应该存在");
         
         // 验证缩略图尺寸
-        QImage thumbnail(QString::fromStdString(result.thumbnailPath));
+        QImage thumbnail(QString::fromStdString(storage.resolvePath(result.thumbnailPath)));
         TEST_ASSERT(!thumbnail.isNull(), "缩略图应该能加载");
         TEST_ASSERT(thumbnail.width() <= 120, "缩略图宽度应该 <= 120");
         TEST_ASSERT(thumbnail.height() <= 80, "缩略图高度应该 <= 80");
@@ -307,7 +480,7 @@ private:
         TEST_ASSERT(!result.thumbnailPath.empty(), "缩略图路径不应为空");
         
         // 验证缩略图尺寸（应该保持原尺寸）
-        QImage thumbnail(QString::fromStdString(result.thumbnailPath));
+        QImage thumbnail(QString::fromStdString(storage.resolvePath(result.thumbnailPath)));
         TEST_ASSERT(thumbnail.width() == 50, "小图片缩略图宽度应该保持原尺寸");
         TEST_ASSERT(thumbnail.height() == 40, "小图片缩略图高度应该保持原尺寸");
         
@@ -315,6 +488,45 @@ private:
         return true;
     }
     
+    bool testThumbnailLargeImage() {
+        resetTestEnvironment();
+        auto& storage = suyan::ImageStorage::instance();
+        
+        // Retina 截图尺寸：JPEG 按缩略图尺寸解码，PNG 整张解码后盒式滤波预缩小
+        auto jpegData = createTestJpegImage(5120, 2880, Qt::blue);
+        auto pngData = createTestPngImage(6016, 3384, Qt::red);
+        
+        auto start = std::chrono::steady_clock::now();
+        auto jpegResult = storage.saveImage(jpegData, "jpeg", "test_hash_large_jpeg");
+        auto jpegMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        start = std::chrono::steady_clock::now();
+        auto pngResult = storage.saveImage(pngData, "png", "test_hash_large_png");
+        auto pngMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        
+        TEST_ASSERT(jpegResult.success && pngResult.success, "保存大图应该成功");
+        TEST_ASSERT(jpegResult.width == 5120 && jpegResult.height == 2880, "JPEG 尺寸为原图尺寸");
+        TEST_ASSERT(pngResult.width == 6016 && pngResult.height == 3384, "PNG 尺寸为原图尺寸");
+        
+        QImage jpegThumb(QString::fromStdString(storage.resolvePath(jpegResult.thumbnailPath)));
+        QImage pngThumb(QString::fromStdString(storage.resolvePath(pngResult.thumbnailPath)));
+        TEST_ASSERT(jpegThumb.width() == 120 && jpegThumb.height() <= 80, "JPEG 缩略图尺寸");
+        TEST_ASSERT(pngThumb.width() == 120 && pngThumb.height() <= 80, "PNG 缩略图尺寸");
+        
+        // 缩小后颜色不变
+        QColor jpegColor = jpegThumb.pixelColor(jpegThumb.width() / 2, jpegThumb.height() / 2);
+        QColor pngColor = pngThumb.pixelColor(pngThumb.width() / 2, pngThumb.height() / 2);
+        TEST_ASSERT(jpegColor.blue() > 200 && jpegColor.red() < 50, "JPEG 缩略图颜色");
+        TEST_ASSERT(pngColor.red() > 200 && pngColor.blue() < 50 && pngColor.alpha() == 255, "PNG 缩略图颜色");
+        
+        std::cout << "  5120x2880 JPEG 入库耗时: " << jpegMs << "ms" << std::endl;
+        std::cout << "  6016x3384 PNG 入库耗时: " << pngMs << "ms" << std::endl;
+        
+        TEST_PASS("testThumbnailLargeImage: 大图缩略图生成正常");
+        return true;
+    }
+    
     bool testSetThumbnailSize() {
         resetTestEnvironment();
         auto& storage = suyan::ImageStorage::instance();
@@ -328,7 +540,7 @@ private:
         auto imageData = createTestPngImage(1000, 800);
         auto result = storage.saveImage(imageData, "png", "test_hash_custom_size");
         
-        QImage thumbnail(QString::fromStdString(result.thumbnailPath));
+        QImage thumbnail(QString::fromStdString(storage.resolvePath(result.thumbnailPath)));
         TEST_ASSERT(thumbnail.width() <= 200, "缩略图宽度应该 <= 200");
         TEST_ASSERT(thumbnail.height() <= 150, "缩略图高度应该 <= 150");
         
@@ -389,14 +601,14 @@ private:
         auto imageData = createTestPngImage(100, 100);
         auto result = storage.saveImage(imageData, "png", "test_hash_delete_001");
         TEST_ASSERT(result.success, "保存应该成功");
-        TEST_ASSERT(fs::exists(result.imagePath), "原图应该存在");
-        TEST_ASSERT(fs::exists(result.thumbnailPath), "缩略图应该存在");
+        TEST_ASSERT(fs::exists(storage.resolvePath(result.imagePath)), "原图应该存在");
+        TEST_ASSERT(fs::exists(storage.resolvePath(result.thumbnailPath)), "缩略图应该存在");
         
         // 删除图片
         bool deleted = storage.deleteImage(result.imagePath, result.thumbnailPath);
         TEST_ASSERT(deleted, "删除应该成功");
-        TEST_ASSERT(!fs::exists(result.imagePath), "原图应该已删除");
-        TEST_ASSERT(!fs::exists(result.thumbnailPath), "缩略图应该已删除");
+        TEST_ASSERT(!fs::exists(storage.resolvePath(result.imagePath)), "原图应该已删除");
+        TEST_ASSERT(!fs::exists(storage.resolvePath(result.thumbnailPath)), "缩略图应该已删除");
         
         TEST_PASS("testDeleteImage: 删除图片正常");
         return true;
@@ -413,13 +625,13 @@ private:
         // 只删除原图
         bool deleted = storage.deleteImage(result.imagePath, "");
         TEST_ASSERT(deleted, "部分删除应该成功");
-        TEST_ASSERT(!fs::exists(result.imagePath), "原图应该已删除");
-        TEST_ASSERT(fs::exists(result.thumbnailPath), "缩略图应该仍存在");
+        TEST_ASSERT(!fs::exists(storage.resolvePath(result.imagePath)), "原图应该已删除");
+        TEST_ASSERT(fs::exists(storage.resolvePath(result.thumbnailPath)), "缩略图应该仍存在");
         
         // 删除缩略图
         deleted = storage.deleteImage("", result.thumbnailPath);
         TEST_ASSERT(deleted, "删除缩略图应该成功");
-        TEST_ASSERT(!fs::exists(result.thumbnailPath), "缩略图应该已删除");
+        TEST_ASSERT(!fs::exists(storage.resolvePath(result.thumbnailPath)), "缩略图应该已删除");
         
         TEST_PASS("testDeleteImagePartial: 部分删除正常");
         return true;
@@ -473,6 +685,66 @@ private:
         TEST_PASS("testGetStorageSize: 存储大小统计正常");
         return true;
     }
+    
+    // ========== 孤儿文件回收测试 ==========
+    
+    bool testListStoredFiles() {
+        resetTestEnvironment();
+        auto& storage = suyan::ImageStorage::instance();
+        
+        auto imageData = createTestPngImage(50, 50);
+        for (const char* hash : {"3c4d5e6f", "1a2b3c4d", "2b3c4d5e"}) {
+            TEST_ASSERT(storage.saveImage(imageData, "png", hash).success, "保存图片应该成功");
+        }
+        // 旧版本平铺存放的文件不列出
+        fs::copy_file(storage.resolvePath("images/1a/2b/1a2b3c4d.png"), storage.getImagesDir() + "/0a0b0c0d.png");
+        
+        auto files = storage.listStoredFiles("", "");
+        TEST_ASSERT(files.size() == 6, "应该列出 3 张原图和 3 张缩略图");
+        TEST_ASSERT(files[0].hash == "1a2b3c4d" && files[0].path == "images/1a/2b/1a2b3c4d.png", "按哈希排序，原图在前");
+        TEST_ASSERT(files[1].path == "thumbnails/1a/2b/1a2b3c4d.png", "同一哈希的缩略图");
+        TEST_ASSERT(files[5].hash == "3c4d5e6f", "最大的哈希在最后");
+        TEST_ASSERT(files[0].size == static_cast<int64_t>(imageData.size()), "文件大小");
+        
+        // 按哈希范围 (afterHash, upToHash]
+        files = storage.listStoredFiles("1a2b3c4d", "2b3c4d5e");
+        TEST_ASSERT(files.size() == 2 && files[0].hash == "2b3c4d5e", "只列出范围内的文件");
+        files = storage.listStoredFiles("2b3c4d5e", "");
+        TEST_ASSERT(files.size() == 2 && files[0].hash == "3c4d5e6f", "没有上界时列出之后的所有文件");
+        
+        TEST_PASS("testListStoredFiles: 按哈希范围列出分片目录中的文件");
+        return true;
+    }
+    
+    bool testDeleteStoredFile() {
+        resetTestEnvironment();
+        auto& storage = suyan::ImageStorage::instance();
+        
+        auto imageData = createTestPngImage(50, 50);
+        auto result = storage.saveImage(imageData, "png", "4d5e6f7a");
+        TEST_ASSERT(result.success, "保存图片应该成功");
+        
+        // 列出后被重新使用（修改时间变化）的文件不删除
+        auto files = storage.listStoredFiles("", "");
+        TEST_ASSERT(files.size() == 2, "应该列出原图和缩略图");
+        fs::last_write_time(storage.resolvePath(files[0].path),
+                            files[0].modifiedAt + std::chrono::seconds(10));
+        TEST_ASSERT(!storage.deleteStoredFile(files[0]), "列出后被修改的文件不应该删除");
+        TEST_ASSERT(storage.imageExists(files[0].path), "原图应该还在");
+        
+        TEST_ASSERT(storage.deleteStoredFile(files[1]), "未修改的文件应该删除");
+        TEST_ASSERT(!storage.imageExists(files[1].path), "缩略图应该已删除");
+        
+        // 入库时重新使用已有文件会刷新修改时间
+        auto before = storage.listStoredFiles("", "")[0].modifiedAt;
+        fs::last_write_time(storage.resolvePath(result.imagePath), before - std::chrono::hours(2));
+        TEST_ASSERT(storage.saveImage(imageData, "png", "4d5e6f7a").success, "重复保存应该成功");
+        TEST_ASSERT(storage.listStoredFiles("", "")[0].modifiedAt > before - std::chrono::hours(1),
+                    "重新使用的文件修改时间应该刷新");
+        
+        TEST_PASS("testDeleteStoredFile: 删除未修改的孤儿文件");
+        return true;
+    }
 };
 
 int main(int argc, char* argv[]) {
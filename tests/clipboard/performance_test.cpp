@@ -3,6 +3,12 @@
  *
  * 验证 Task 20 的性能优化目标：
  * - 搜索性能：大数据量下搜索响应 < 100ms
+ * - 中文子串搜索：由 FTS 索引完成，响应 < 10ms
+ * - 拼音搜索：由拼音索引完成，响应与中文子串搜索相当（< 10ms）
+ * - 过期清理：10000 条历史下清理 < 100ms
+ * - 键集分页：第 200 页与第 1 页耗时相当
+ * - 列表预览：1000 条长文本的列表只读取预览（KB 级）
+ * - 内容指纹：30MB 图片的预筛键 < 1ms，快速指纹比 SHA-256 快 2 倍以上
  * - 窗口显示性能：首次显示延迟 < 100ms（需要 GUI 环境）
  * - 列表滚动性能：虚拟化渲染优化
  */
@@ -10,11 +16,17 @@
 #include <iostream>
 #include <cassert>
 #include <filesystem>
+#include <fstream>
 #include <chrono>
 #include <random>
 #include <string>
+#include <vector>
+#include <cstring>
+#include <functional>
 #include <QCoreApplication>
 #include "clipboard_store.h"
+#include "content_fingerprint.h"
+#include "pinyin_table.h"
 
 namespace fs = std::filesystem;
 
@@ -52,6 +64,12 @@ public:
         bool allPassed = true;
         
         allPassed &= testSearchPerformance();
+        allPassed &= testChineseSearchPerformance();
+        allPassed &= testPinyinSearchPerformance();
+        allPassed &= testCleanupPerformance();
+        allPassed &= testKeysetPaginationPerformance();
+        allPassed &= testListPreviewPerformance();
+        allPassed &= testFingerprintPerformance();
         allPassed &= testBulkInsertPerformance();
         allPassed &= testPaginationPerformance();
         
@@ -166,6 +184,309 @@ private:
         return true;
     }
     
+    /**
+     * 测试中文子串搜索性能
+     * 目标：10000 条中文记录下搜索响应 < 10ms（不退回 LIKE 全表扫描）
+     */
+    bool testChineseSearchPerformance() {
+        std::cout << "--- 中文搜索性能测试 ---" << std::endl;
+        
+        auto& store = suyan::ClipboardStore::instance();
+        store.initialize(testDbPath_);
+        store.clearAll();
+        
+        const int RECORD_COUNT = 10000;
+        const int SEARCH_ITERATIONS = 10;
+        
+        // 常用字随机组成的文本，每 100 条包含一次关键词
+        static const char* kChars[] = {
+            "的", "一", "是", "在", "不", "了", "有", "和", "人", "这",
+            "中", "大", "为", "上", "个", "国", "我", "以", "要", "他",
+            "时", "来", "用", "们", "生", "到", "作", "地", "于", "出",
+        };
+        std::mt19937 gen(42);
+        std::uniform_int_distribution<> charDis(0, sizeof(kChars) / sizeof(kChars[0]) - 1);
+        
+        std::cout << "  插入 " << RECORD_COUNT << " 条中文记录..." << std::endl;
+        for (int i = 0; i < RECORD_COUNT; ++i) {
+            std::string content;
+            for (int j = 0; j < 60; ++j) {
+                content += kChars[charDis(gen)];
+            }
+            if (i % 100 == 0) {
+                content += "明天下午的会议纪要";
+            }
+            store.addRecord(createTextRecord(content, generateHash(100000 + i)));
+        }
+        
+        // 罕见子串、常见二元组、常见单字
+        for (const char* keyword : {"会议", "下午的会", "的一", "的"}) {
+            long long maxSearchTime = 0;
+            size_t resultCount = 0;
+            for (int i = 0; i < SEARCH_ITERATIONS; ++i) {
+                auto searchStart = std::chrono::high_resolution_clock::now();
+                auto results = store.searchText(keyword, 100);
+                auto searchEnd = std::chrono::high_resolution_clock::now();
+                
+                auto searchDuration = std::chrono::duration_cast<std::chrono::milliseconds>(searchEnd - searchStart);
+                maxSearchTime = std::max(maxSearchTime, static_cast<long long>(searchDuration.count()));
+                resultCount = results.size();
+            }
+            std::cout << "  搜索「" << keyword << "」: " << resultCount << " 条，最大耗时 "
+                      << maxSearchTime << "ms" << std::endl;
+            
+            TEST_ASSERT(resultCount > 0, "搜索应该返回结果");
+            TEST_ASSERT(maxSearchTime < 10, "中文搜索响应应该 < 10ms");
+        }
+        
+        TEST_PASS("testChineseSearchPerformance: 中文搜索性能达标 (< 10ms)");
+        return true;
+    }
+    
+    /**
+     * 测试拼音搜索性能
+     * 目标：沿用中文搜索测试的 10000 条记录，拼音和首字母搜索响应 < 10ms
+     */
+    bool testPinyinSearchPerformance() {
+        std::cout << "--- 拼音搜索性能测试 ---" << std::endl;
+        
+        // 中文搜索测试用到的字及其读音
+        static const char* kDict = "---\n...\n"
+            "的\tde\t100\n一\tyi\t100\n是\tshi\t100\n在\tzai\t100\n不\tbu\t100\n"
+            "了\tle\t100\n有\tyou\t100\n和\the\t100\n人\tren\t100\n这\tzhe\t100\n"
+            "中\tzhong\t100\n大\tda\t100\n为\twei\t100\n上\tshang\t100\n个\tge\t100\n"
+            "国\tguo\t100\n我\two\t100\n以\tyi\t100\n要\tyao\t100\n他\tta\t100\n"
+            "时\tshi\t100\n来\tlai\t100\n用\tyong\t100\n们\tmen\t100\n生\tsheng\t100\n"
+            "到\tdao\t100\n作\tzuo\t100\n地\tdi\t100\n于\tyu\t100\n出\tchu\t100\n"
+            "明\tming\t100\n天\ttian\t100\n下\txia\t100\n午\twu\t100\n会\thui\t100\n"
+            "议\tyi\t100\n纪\tji\t100\n";
+        std::string dictPath = testDataDir_ + "/pinyin.dict.yaml";
+        std::ofstream(dictPath) << kDict;
+        
+        // 加载读音表后重新打开数据库，为已有记录建立拼音索引
+        auto& store = suyan::ClipboardStore::instance();
+        store.shutdown();
+        suyan::PinyinTable::instance().load(dictPath);
+        auto rebuildStart = std::chrono::high_resolution_clock::now();
+        TEST_ASSERT(store.initialize(testDbPath_), "重新打开数据库");
+        auto rebuildDuration = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::high_resolution_clock::now() - rebuildStart);
+        std::cout << "  为 " << store.getRecordCount() << " 条记录建立拼音索引: "
+                  << rebuildDuration.count() << "ms" << std::endl;
+        
+        const int SEARCH_ITERATIONS = 10;
+        bool passed = true;
+        
+        // 罕见全拼、首字母、常见音节、单个首字母
+        for (const char* keyword : {"huiyijiyao", "hyjy", "mingtian", "de", "s"}) {
+            long long maxSearchTime = 0;
+            size_t resultCount = 0;
+            for (int i = 0; i < SEARCH_ITERATIONS; ++i) {
+                auto searchStart = std::chrono::high_resolution_clock::now();
+                auto results = store.searchText(keyword, 100);
+                auto searchEnd = std::chrono::high_resolution_clock::now();
+                
+                auto searchDuration = std::chrono::duration_cast<std::chrono::milliseconds>(searchEnd - searchStart);
+                maxSearchTime = std::max(maxSearchTime, static_cast<long long>(searchDuration.count()));
+                resultCount = results.size();
+            }
+            std::cout << "  搜索 \"" << keyword << "\": " << resultCount << " 条，最大耗时 "
+                      << maxSearchTime << "ms" << std::endl;
+            
+            passed = passed && resultCount > 0 && maxSearchTime < 10;
+        }
+        
+        // 恢复无读音表的状态，不影响后续测试
+        store.shutdown();
+        suyan::PinyinTable::instance().clear();
+        store.initialize(testDbPath_);
+        
+        TEST_ASSERT(passed, "拼音搜索应该返回结果且响应 < 10ms");
+        TEST_PASS("testPinyinSearchPerformance: 拼音搜索性能达标 (< 10ms)");
+        return true;
+    }
+    
+    /**
+     * 测试过期清理性能
+     * 目标：10000 条历史中清理超出条数限制的记录 < 100ms，无需清理时 < 10ms
+     */
+    bool testCleanupPerformance() {
+        std::cout << "--- 过期清理性能测试 ---" << std::endl;
+        
+        auto& store = suyan::ClipboardStore::instance();
+        store.initialize(testDbPath_);
+        store.clearAll();
+        
+        const int RECORD_COUNT = 10000;
+        const int KEEP_COUNT = 9000;
+        
+        std::cout << "  插入 " << RECORD_COUNT << " 条测试记录..." << std::endl;
+        for (int i = 0; i < RECORD_COUNT; ++i) {
+            store.addRecord(createTextRecord("Cleanup record " + std::to_string(i) + " " + generateRandomText(200),
+                                             generateHash(200000 + i)));
+        }
+        
+        auto cleanupStart = std::chrono::high_resolution_clock::now();
+        auto deleted = store.deleteExpiredRecords(0, KEEP_COUNT);
+        auto cleanupEnd = std::chrono::high_resolution_clock::now();
+        auto cleanupDuration = std::chrono::duration_cast<std::chrono::milliseconds>(cleanupEnd - cleanupStart);
+        std::cout << "  清理 " << deleted.size() << " 条耗时: " << cleanupDuration.count() << "ms" << std::endl;
+        
+        TEST_ASSERT(deleted.size() == RECORD_COUNT - KEEP_COUNT, "应该删除超出条数限制的记录");
+        TEST_ASSERT(cleanupDuration.count() < 100, "清理应该 < 100ms");
+        
+        // 定时清理的常见情况：没有需要删除的记录
+        auto idleStart = std::chrono::high_resolution_clock::now();
+        deleted = store.deleteExpiredRecords(30, KEEP_COUNT);
+        auto idleEnd = std::chrono::high_resolution_clock::now();
+        auto idleDuration = std::chrono::duration_cast<std::chrono::milliseconds>(idleEnd - idleStart);
+        std::cout << "  无需清理时耗时: " << idleDuration.count() << "ms" << std::endl;
+        
+        TEST_ASSERT(deleted.empty(), "没有需要删除的记录");
+        TEST_ASSERT(idleDuration.count() < 10, "无需清理时应该 < 10ms");
+        
+        TEST_PASS("testCleanupPerformance: 过期清理性能达标");
+        return true;
+    }
+    
+    /**
+     * 测试键集分页性能
+     * 目标：9000 条记录下翻到最后一页（第 200 页）与第 1 页耗时相当
+     */
+    bool testKeysetPaginationPerformance() {
+        std::cout << "--- 键集分页性能测试 ---" << std::endl;
+        
+        auto& store = suyan::ClipboardStore::instance();
+        // 使用上一个测试的数据
+        
+        const int PAGE_SIZE = 45;
+        
+        // 逐页翻到最后，记录每页耗时
+        suyan::RecordCursor cursor;
+        std::vector<double> pageTimes;
+        while (true) {
+            auto start = std::chrono::high_resolution_clock::now();
+            auto records = store.getRecordsAfter(cursor, PAGE_SIZE);
+            auto end = std::chrono::high_resolution_clock::now();
+            if (records.empty()) {
+                break;
+            }
+            pageTimes.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+            cursor = suyan::RecordCursor(records.back());
+        }
+        TEST_ASSERT(pageTimes.size() >= 200, "应该至少有 200 页");
+        
+        // 对比 OFFSET 分页的最后一页
+        auto offsetStart = std::chrono::high_resolution_clock::now();
+        store.getAllRecords(PAGE_SIZE, 199 * PAGE_SIZE);
+        auto offsetEnd = std::chrono::high_resolution_clock::now();
+        double offsetTime = std::chrono::duration<double, std::milli>(offsetEnd - offsetStart).count();
+        
+        double firstPage = pageTimes[1];    // 跳过首次查询的缓存预热
+        double lastPage = pageTimes[199];
+        std::cout << "  第 2 页耗时: " << firstPage << "ms" << std::endl;
+        std::cout << "  第 200 页耗时: " << lastPage << "ms" << std::endl;
+        std::cout << "  OFFSET 第 200 页耗时: " << offsetTime << "ms" << std::endl;
+        
+        TEST_ASSERT(lastPage < 5, "第 200 页应该 < 5ms");
+        TEST_ASSERT(lastPage < firstPage * 3 + 1, "第 200 页耗时应该与前几页相当");
+        
+        TEST_PASS("testKeysetPaginationPerformance: 键集分页性能达标");
+        return true;
+    }
+    
+    /**
+     * 测试列表预览性能
+     * 目标：1000 条 32KB 文本，列表读取的数据量 < 128KB，耗时 < 20ms
+     */
+    bool testListPreviewPerformance() {
+        std::cout << "--- 列表预览性能测试 ---" << std::endl;
+        
+        auto& store = suyan::ClipboardStore::instance();
+        store.clearAll();
+        
+        const int RECORD_COUNT = 1000;
+        const int TEXT_LENGTH = 32 * 1024;
+        
+        std::cout << "  插入 " << RECORD_COUNT << " 条 " << TEXT_LENGTH / 1024 << "KB 文本..." << std::endl;
+        for (int i = 0; i < RECORD_COUNT; ++i) {
+            auto record = createTextRecord(generateRandomText(TEXT_LENGTH), generateHash(50000 + i));
+            store.addRecord(record);
+        }
+        
+        auto start = std::chrono::high_resolution_clock::now();
+        auto records = store.getRecordsAfter(suyan::RecordCursor(), RECORD_COUNT);
+        auto end = std::chrono::high_resolution_clock::now();
+        double listTime = std::chrono::duration<double, std::milli>(end - start).count();
+        
+        size_t previewBytes = 0;
+        int64_t contentBytes = 0;
+        for (const auto& record : records) {
+            previewBytes += record.preview.size();
+            contentBytes += record.contentLength;
+        }
+        std::cout << "  列表耗时: " << listTime << "ms" << std::endl;
+        std::cout << "  预览总大小: " << previewBytes / 1024 << "KB（完整内容 "
+                  << contentBytes / 1024 / 1024 << "MB）" << std::endl;
+        
+        TEST_ASSERT(records.size() == RECORD_COUNT, "应该返回全部记录");
+        TEST_ASSERT(previewBytes < 128 * 1024, "预览总大小应该 < 128KB");
+        TEST_ASSERT(listTime < 20, "列表应该 < 20ms");
+        
+        TEST_PASS("testListPreviewPerformance: 列表预览性能达标");
+        return true;
+    }
+    
+    /**
+     * 测试内容指纹性能
+     * 目标：30MB 图片的预筛键 < 1ms，快速指纹比 SHA-256 快 2 倍以上
+     */
+    bool testFingerprintPerformance() {
+        std::cout << "--- 内容指纹性能测试 ---" << std::endl;
+        
+        // 模拟 30MB 的 TIFF 截图
+        const size_t DATA_SIZE = 30 * 1024 * 1024;
+        std::vector<uint8_t> data(DATA_SIZE);
+        std::mt19937_64 gen(42);
+        for (size_t i = 0; i + 8 <= DATA_SIZE; i += 8) {
+            uint64_t value = gen();
+            std::memcpy(data.data() + i, &value, sizeof(value));
+        }
+        
+        auto measure = [&](const std::function<void()>& fn) {
+            double best = 1e9;
+            for (int round = 0; round < 3; ++round) {
+                auto start = std::chrono::high_resolution_clock::now();
+                fn();
+                auto end = std::chrono::high_resolution_clock::now();
+                best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+            }
+            return best;
+        };
+        
+        uint64_t quickKey = 0;
+        std::string fastHash;
+        std::string shaHash;
+        suyan::FastFingerprinter fast;
+        suyan::Sha256Fingerprinter sha256;
+        double quickTime = measure([&] { quickKey = suyan::ContentFingerprint::quickKey(data.data(), data.size()); });
+        double fastTime = measure([&] { fastHash = fast.fingerprint(data.data(), data.size()); });
+        double shaTime = measure([&] { shaHash = sha256.fingerprint(data.data(), data.size()); });
+        
+        std::cout << "  预筛键: " << quickTime << "ms" << std::endl;
+        std::cout << "  " << fast.name() << ": " << fastTime << "ms ("
+                  << DATA_SIZE / 1024.0 / 1024.0 / (fastTime / 1000.0) << " MB/s)" << std::endl;
+        std::cout << "  " << sha256.name() << ": " << shaTime << "ms ("
+                  << DATA_SIZE / 1024.0 / 1024.0 / (shaTime / 1000.0) << " MB/s)" << std::endl;
+        
+        TEST_ASSERT(quickKey != 0 && fastHash.size() == 32 && shaHash.size() == 64, "指纹格式");
+        TEST_ASSERT(quickTime < 1, "预筛键应该 < 1ms");
+        TEST_ASSERT(fastTime * 2 < shaTime, "快速指纹应该比 SHA-256 快 2 倍以上");
+        
+        TEST_PASS("testFingerprintPerformance: 内容指纹性能达标");
+        return true;
+    }
+    
     /**
      * 测试批量插入性能
      */
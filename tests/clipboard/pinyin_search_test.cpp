@@ -0,0 +1,328 @@
+/**
+ * 拼音搜索单元测试
+ *
+ * 测试读音表加载、音节切分，以及剪贴板历史的全拼和首字母搜索。
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <QCoreApplication>
+#include "clipboard_store.h"
+#include "pinyin_table.h"
+#include "pinyin_tokenizer.h"
+
+namespace fs = std::filesystem;
+
+// 测试辅助宏
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "✗ 断言失败: " << message << std::endl; \
+            std::cerr << "  位置: " << __FILE__ << ":" << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define TEST_PASS(message) \
+    std::cout << "✓ " << message << std::endl
+
+// 测试字表（格式与 cn_dicts/8105.dict.yaml 相同）
+constexpr const char* kTestDict = R"(# Rime dictionary
+---
+name: test
+version: "1"
+sort: by_weight
+...
+# 注释行
+会	hui	6824927
+会	kuai	6824
+议	yi	1200000
+纪	ji	800000
+要	yao	3000000
+明	ming	1500000
+天	tian	2500000
+下	xia	2400000
+午	wu	300000
+的	de	76938354
+的	di	106917
+长	chang	3100060
+长	zhang	3100060
+城	cheng	600000
+会议	hui yi	100000
+)";
+
+class PinyinSearchTest {
+public:
+    PinyinSearchTest() {
+        testDataDir_ = fs::temp_directory_path().string() + "/suyan_pinyin_search_test";
+        testDbPath_ = testDataDir_ + "/clipboard.db";
+        dictPath_ = testDataDir_ + "/8105.dict.yaml";
+
+        fs::remove_all(testDataDir_);
+        fs::create_directories(testDataDir_);
+        writeDict(kTestDict);
+    }
+
+    ~PinyinSearchTest() {
+        suyan::ClipboardStore::instance().shutdown();
+        suyan::PinyinTable::instance().clear();
+        fs::remove_all(testDataDir_);
+    }
+
+    bool runAllTests() {
+        std::cout << "=== 拼音搜索单元测试 ===" << std::endl;
+        std::cout << std::endl;
+
+        bool allPassed = true;
+
+        allPassed &= testLoadTable();
+        allPassed &= testSplitSyllables();
+        allPassed &= testQueryHelpers();
+        allPassed &= testPinyinSearch();
+        allPassed &= testPolyphoneSearch();
+        allPassed &= testRefinePinyinSearch();
+        allPassed &= testIndexFollowsRecords();
+        allPassed &= testRebuildOnTableChange();
+
+        std::cout << std::endl;
+        if (allPassed) {
+            std::cout << "=== 所有测试通过 ===" << std::endl;
+        } else {
+            std::cout << "=== 部分测试失败 ===" << std::endl;
+        }
+
+        return allPassed;
+    }
+
+private:
+    std::string testDataDir_;
+    std::string testDbPath_;
+    std::string dictPath_;
+
+    void writeDict(const std::string& content) {
+        std::ofstream file(dictPath_, std::ios::trunc);
+        file << content;
+    }
+
+    suyan::ClipboardRecord createTextRecord(const std::string& content, const std::string& hash) {
+        suyan::ClipboardRecord record;
+        record.type = suyan::ClipboardContentType::Text;
+        record.content = content;
+        record.contentHash = hash;
+        record.sourceApp = "com.test.app";
+        return record;
+    }
+
+    // 搜索结果是否包含指定记录
+    bool containsId(const std::vector<suyan::PreviewRecord>& results, int64_t id) {
+        return std::any_of(results.begin(), results.end(),
+                           [id](const suyan::PreviewRecord& r) { return r.id == id; });
+    }
+
+    // 加载读音表后重新打开数据库
+    bool reopenStore(bool loadTable) {
+        auto& store = suyan::ClipboardStore::instance();
+        store.shutdown();
+        if (loadTable) {
+            suyan::PinyinTable::instance().load(dictPath_);
+        } else {
+            suyan::PinyinTable::instance().clear();
+        }
+        return store.initialize(testDbPath_);
+    }
+
+    bool testLoadTable() {
+        auto& table = suyan::PinyinTable::instance();
+        TEST_ASSERT(table.load(dictPath_), "加载字表");
+        TEST_ASSERT(table.isLoaded() && table.size() == 11, "只收录单字条目");
+
+        const auto* hui = table.getReadings(U'会');
+        TEST_ASSERT(hui && *hui == std::vector<std::string>({"hui"}), "罕用读音被过滤");
+        const auto* chang = table.getReadings(U'长');
+        TEST_ASSERT(chang && *chang == std::vector<std::string>({"chang", "zhang"}), "常用多音字保留全部读音");
+        const auto* de = table.getReadings(U'的');
+        TEST_ASSERT(de && de->front() == "de", "常用读音在前");
+        TEST_ASSERT(table.getReadings(U'鑫') == nullptr, "未收录的字");
+
+        std::string version = table.getVersion();
+        TEST_ASSERT(!version.empty(), "版本指纹");
+        TEST_ASSERT(table.load(dictPath_) && table.getVersion() == version, "相同字表版本相同");
+
+        TEST_ASSERT(!table.load(testDataDir_ + "/missing.dict.yaml"), "字表不存在");
+        TEST_ASSERT(!table.isLoaded() && table.getVersion().empty(), "加载失败时读音表为空");
+
+        TEST_PASS("testLoadTable: 读音表加载正常");
+        return true;
+    }
+
+    bool testSplitSyllables() {
+        auto& table = suyan::PinyinTable::instance();
+        table.load(dictPath_);
+
+        using Syllables = std::vector<std::string>;
+        TEST_ASSERT(table.splitSyllables("huiyi") == Syllables({"hui", "yi"}), "全拼");
+        TEST_ASSERT(table.splitSyllables("hyjy") == Syllables({"h", "y", "j", "y"}), "首字母");
+        TEST_ASSERT(table.splitSyllables("huiyjy") == Syllables({"hui", "y", "j", "y"}), "全拼和首字母混合");
+        TEST_ASSERT(table.splitSyllables("huiy") == Syllables({"hui", "y"}), "末尾不完整的音节");
+        TEST_ASSERT(table.splitSyllables("mingtian") == Syllables({"ming", "tian"}), "取最长音节");
+
+        TEST_PASS("testSplitSyllables: 音节切分正常");
+        return true;
+    }
+
+    bool testQueryHelpers() {
+        using suyan::PinyinTokenizer;
+        TEST_ASSERT(PinyinTokenizer::isPinyinQuery("huiyi"), "字母");
+        TEST_ASSERT(PinyinTokenizer::isPinyinQuery("xi'an"), "隔音符");
+        TEST_ASSERT(PinyinTokenizer::isPinyinQuery("hui yi"), "空格");
+        TEST_ASSERT(!PinyinTokenizer::isPinyinQuery("hui1"), "含数字");
+        TEST_ASSERT(!PinyinTokenizer::isPinyinQuery("会议"), "中文");
+        TEST_ASSERT(!PinyinTokenizer::isPinyinQuery("'"), "没有字母");
+
+        TEST_ASSERT(PinyinTokenizer::buildQuery("hyjy") == "\"hyjy\"* OR \"h y j y\"*", "全拼或首字母");
+        TEST_ASSERT(PinyinTokenizer::buildQuery("h") == "\"h\"*", "单个字母");
+
+        TEST_PASS("testQueryHelpers: 查询构造正常");
+        return true;
+    }
+
+    bool testPinyinSearch() {
+        TEST_ASSERT(reopenStore(true), "初始化存储");
+        auto& store = suyan::ClipboardStore::instance();
+        store.clearAll();
+
+        int64_t meeting = store.addRecord(createTextRecord("明天下午的会议纪要", "pinyin_1")).id;
+        int64_t hello = store.addRecord(createTextRecord("Hello world", "pinyin_2")).id;
+        TEST_ASSERT(meeting > 0 && hello > 0, "添加记录");
+
+        for (const char* keyword : {"huiyi", "hyjy", "huiyjy", "HuiYi", "jiyao", "huiy", "mtxw", "hui yi"}) {
+            auto results = store.searchText(keyword);
+            TEST_ASSERT(results.size() == 1 && results[0].id == meeting,
+                        std::string("拼音搜索: ") + keyword);
+        }
+
+        TEST_ASSERT(store.searchText("yihui").empty(), "顺序不同不匹配");
+        TEST_ASSERT(store.searchText("huiyiming").empty(), "不连续不匹配");
+
+        // 原文匹配不受影响
+        auto results = store.searchText("hello");
+        TEST_ASSERT(results.size() == 1 && results[0].id == hello, "英文原文匹配");
+        results = store.searchText("会议");
+        TEST_ASSERT(results.size() == 1 && results[0].id == meeting, "中文原文匹配");
+
+        TEST_PASS("testPinyinSearch: 全拼和首字母搜索正常");
+        return true;
+    }
+
+    bool testPolyphoneSearch() {
+        auto& store = suyan::ClipboardStore::instance();
+        store.clearAll();
+
+        int64_t wall = store.addRecord(createTextRecord("长城", "pinyin_3")).id;
+        TEST_ASSERT(containsId(store.searchText("changcheng"), wall), "多音字常用读音");
+        TEST_ASSERT(containsId(store.searchText("zhangcheng"), wall), "多音字其他读音");
+        TEST_ASSERT(containsId(store.searchText("zc"), wall), "多音字首字母");
+
+        // 原文和拼音都匹配的记录只返回一次
+        int64_t mixed = store.addRecord(createTextRecord("cc 长城", "pinyin_4")).id;
+        auto results = store.searchText("cc");
+        TEST_ASSERT(results.size() == 2 && containsId(results, wall) && containsId(results, mixed),
+                    "原文和拼音结果合并去重");
+        TEST_ASSERT(results[0].id == mixed, "合并后按最后使用时间排序");
+
+        TEST_PASS("testPolyphoneSearch: 多音字搜索正常");
+        return true;
+    }
+
+    bool testRefinePinyinSearch() {
+        using suyan::PinyinTokenizer;
+        TEST_ASSERT(PinyinTokenizer::isQueryExtension("huiy", "huiyi"), "补全最后一个音节");
+        TEST_ASSERT(PinyinTokenizer::isQueryExtension("hui", "huiyjy"), "追加音节");
+        TEST_ASSERT(PinyinTokenizer::isQueryExtension("hui", "hui yi"), "空格分隔");
+        TEST_ASSERT(!PinyinTokenizer::isQueryExtension("hu", "hui"), "切分改变（h / u → hui）");
+        TEST_ASSERT(!PinyinTokenizer::isQueryExtension("hui", "yi"), "不是继续输入");
+
+        auto& store = suyan::ClipboardStore::instance();
+        store.clearAll();
+        int64_t meeting = store.addRecord(createTextRecord("明天下午的会议纪要", "pinyin_5")).id;
+        store.addRecord(createTextRecord("会员", "pinyin_6"));
+
+        auto results = store.searchText("hui");
+        TEST_ASSERT(results.size() == 2, "hui 匹配 2 条");
+        auto refined = store.refineSearch("hui", results, "huiyi");
+        TEST_ASSERT(refined && refined->size() == 1 && (*refined)[0].id == meeting, "拼音细化");
+        refined = store.refineSearch("hui", results, "hyj");
+        TEST_ASSERT(!refined, "不是继续输入不能细化");
+        TEST_ASSERT(!store.refineSearch("hu", store.searchText("hu"), "hui"), "切分改变时不能细化");
+
+        TEST_PASS("testRefinePinyinSearch: 拼音细化搜索正常");
+        return true;
+    }
+
+    bool testIndexFollowsRecords() {
+        auto& store = suyan::ClipboardStore::instance();
+        store.clearAll();
+
+        int64_t id = store.addRecord(createTextRecord("会议纪要", "pinyin_5")).id;
+        TEST_ASSERT(!store.searchText("hyjy").empty(), "新增记录建立拼音索引");
+
+        TEST_ASSERT(store.deleteRecord(id), "删除记录");
+        TEST_ASSERT(store.searchText("hyjy").empty(), "删除记录同步删除拼音索引");
+
+        store.addRecord(createTextRecord("会议纪要", "pinyin_6"));
+        TEST_ASSERT(store.clearAll(), "清空记录");
+        TEST_ASSERT(store.searchText("hyjy").empty(), "清空记录同步清空拼音索引");
+
+        // 图片记录不建立拼音索引
+        suyan::ClipboardRecord image;
+        image.type = suyan::ClipboardContentType::Image;
+        image.content = "/tmp/会议纪要.png";
+        image.contentHash = "pinyin_7";
+        store.addRecord(image);
+        TEST_ASSERT(store.searchText("hyjy").empty(), "图片路径不参与拼音搜索");
+
+        TEST_PASS("testIndexFollowsRecords: 拼音索引与记录同步");
+        return true;
+    }
+
+    bool testRebuildOnTableChange() {
+        auto& store = suyan::ClipboardStore::instance();
+        store.clearAll();
+
+        // 没有读音表时写入的记录
+        TEST_ASSERT(reopenStore(false), "无读音表打开");
+        int64_t id = store.addRecord(createTextRecord("会议纪要", "pinyin_8")).id;
+        TEST_ASSERT(store.searchText("hyjy").empty(), "没有读音表时拼音搜索不可用");
+
+        // 加载读音表后重新打开：按新读音重建索引
+        TEST_ASSERT(reopenStore(true), "加载读音表后打开");
+        TEST_ASSERT(containsId(store.searchText("hyjy"), id), "重建后可按拼音搜索已有记录");
+
+        // 读音变化：「要」的读音改为 yue
+        std::string changed = kTestDict;
+        changed.replace(changed.find("要\tyao"), std::string("要\tyao").size(), "要\tyue");
+        writeDict(changed);
+        TEST_ASSERT(reopenStore(true), "读音变化后打开");
+        TEST_ASSERT(store.searchText("huiyijiyao").empty(), "旧读音不再匹配");
+        TEST_ASSERT(containsId(store.searchText("huiyijiyue"), id), "按新读音匹配");
+
+        // 重建后删除记录，索引保持一致
+        TEST_ASSERT(store.deleteRecord(id), "删除记录");
+        TEST_ASSERT(store.searchText("hyjy").empty(), "删除后索引一致");
+
+        writeDict(kTestDict);
+        TEST_PASS("testRebuildOnTableChange: 读音表变化时重建索引");
+        return true;
+    }
+};
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+
+    PinyinSearchTest test;
+    return test.runAllTests() ? 0 : 1;
+}
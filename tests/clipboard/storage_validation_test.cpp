@@ -292,7 +292,7 @@ private:
             }
             
             // 验证缩略图
-            QImage thumbnail(QString::fromStdString(result.thumbnailPath));
+            QImage thumbnail(QString::fromStdString(imageStorage.resolvePath(result.thumbnailPath)));
             if (thumbnail.isNull()) {
                 std::cout << "    " << tc.name << ": 缩略图加载失败 ✗" << std::endl;
                 continue;
@@ -329,7 +329,7 @@ private:
         std::cout << "    4000x3000 图片处理耗时: " << duration.count() << "ms";
         
         if (result.success) {
-            QImage thumbnail(QString::fromStdString(result.thumbnailPath));
+            QImage thumbnail(QString::fromStdString(imageStorage.resolvePath(result.thumbnailPath)));
             std::cout << ", 缩略图 " << thumbnail.width() << "x" << thumbnail.height();
         }
         
@@ -0,0 +1,251 @@
+/**
+ * TextStorage 单元测试
+ *
+ * 测试大文本存储层的分块压缩、内容寻址去重、读取和删除功能。
+ */
+
+#include <iostream>
+#include <filesystem>
+#include <fstream>
+#include <QCoreApplication>
+#include "text_storage.h"
+
+namespace fs = std::filesystem;
+
+// 测试辅助宏
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "✗ 断言失败: " << message << std::endl; \
+            std::cerr << "  位置: " << __FILE__ << ":" << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define TEST_PASS(message) \
+    std::cout << "✓ " << message << std::endl
+
+class TextStorageTest {
+public:
+    TextStorageTest() {
+        // 使用临时目录进行测试
+        testBaseDir_ = fs::temp_directory_path().string() + "/suyan_text_storage_test";
+
+        // 清理之前的测试数据
+        fs::remove_all(testBaseDir_);
+    }
+
+    ~TextStorageTest() {
+        // 关闭存储
+        suyan::TextStorage::instance().shutdown();
+        // 清理测试数据
+        fs::remove_all(testBaseDir_);
+    }
+
+    bool runAllTests() {
+        std::cout << "=== TextStorage 单元测试 ===" << std::endl;
+        std::cout << "测试数据目录: " << testBaseDir_ << std::endl;
+        std::cout << std::endl;
+
+        bool allPassed = true;
+
+        allPassed &= testInitialize();
+        allPassed &= testSaveAndLoad();
+        allPassed &= testCompression();
+        allPassed &= testChunkDeduplication();
+        allPassed &= testSharedChunks();
+        allPassed &= testMissingChunk();
+        allPassed &= testCorruptedChunk();
+        allPassed &= testDeleteChunks();
+        allPassed &= testParseChunkList();
+
+        std::cout << std::endl;
+        if (allPassed) {
+            std::cout << "=== 所有测试通过 ===" << std::endl;
+        } else {
+            std::cout << "=== 部分测试失败 ===" << std::endl;
+        }
+
+        return allPassed;
+    }
+
+private:
+    std::string testBaseDir_;
+
+    // 重置测试环境
+    void resetTestEnvironment() {
+        auto& storage = suyan::TextStorage::instance();
+        storage.shutdown();
+        fs::remove_all(testBaseDir_);
+        storage.initialize(testBaseDir_);
+    }
+
+    // 生成类似日志的文本
+    std::string createLogText(size_t size, const std::string& tag = "INFO") {
+        std::string text;
+        int line = 0;
+        while (text.size() < size) {
+            text += "2024-05-01 12:00:" + std::to_string(line % 60) + " [" + tag + "] 请求处理完成 request_id=" +
+                    std::to_string(line) + " latency=" + std::to_string(line * 7 % 1000) + "ms\n";
+            ++line;
+        }
+        return text;
+    }
+
+    size_t countChunkFiles() {
+        size_t count = 0;
+        for (const auto& entry : fs::directory_iterator(suyan::TextStorage::instance().getTextsDir())) {
+            count += entry.is_regular_file() ? 1 : 0;
+        }
+        return count;
+    }
+
+    bool testInitialize() {
+        auto& storage = suyan::TextStorage::instance();
+        storage.shutdown();
+        fs::remove_all(testBaseDir_);
+
+        auto result = storage.saveText("未初始化");
+        TEST_ASSERT(!result.success, "未初始化时存储失败");
+
+        TEST_ASSERT(storage.initialize(testBaseDir_), "初始化成功");
+        TEST_ASSERT(storage.isInitialized(), "已初始化");
+        TEST_ASSERT(fs::is_directory(testBaseDir_ + "/texts"), "分块目录已创建");
+
+        TEST_PASS("testInitialize: 初始化正常");
+        return true;
+    }
+
+    bool testSaveAndLoad() {
+        resetTestEnvironment();
+        auto& storage = suyan::TextStorage::instance();
+
+        // 跨越多个分块，且分块边界落在多字节字符中间
+        std::string text = createLogText(suyan::TextStorage::kChunkSize * 3 + 1234);
+        auto result = storage.saveText(text);
+        TEST_ASSERT(result.success, "存储成功");
+        TEST_ASSERT(suyan::TextStorage::parseChunkList(result.chunks).size() == 4, "分块数量");
+        TEST_ASSERT(countChunkFiles() == 4, "每块一个文件");
+        TEST_ASSERT(storage.loadText(result.chunks) == text, "读取内容一致");
+
+        TEST_ASSERT(!storage.saveText("").success, "空文本存储失败");
+
+        TEST_PASS("testSaveAndLoad: 分块存储和读取正常");
+        return true;
+    }
+
+    bool testCompression() {
+        resetTestEnvironment();
+        auto& storage = suyan::TextStorage::instance();
+
+        std::string text = createLogText(4 * 1024 * 1024);
+        auto result = storage.saveText(text);
+        TEST_ASSERT(result.success, "存储成功");
+
+        std::cout << "  原文: " << text.size() / 1024 << "KB, 压缩后: "
+                  << result.compressedSize / 1024 << "KB" << std::endl;
+        TEST_ASSERT(result.compressedSize < static_cast<int64_t>(text.size() / 4), "日志压缩到原大小的 1/4 以下");
+        TEST_ASSERT(storage.getStorageSize() == result.compressedSize, "存储大小统计");
+
+        TEST_PASS("testCompression: 压缩率达标");
+        return true;
+    }
+
+    bool testChunkDeduplication() {
+        resetTestEnvironment();
+        auto& storage = suyan::TextStorage::instance();
+
+        std::string text = createLogText(suyan::TextStorage::kChunkSize * 2);
+        auto first = storage.saveText(text);
+        size_t fileCount = countChunkFiles();
+
+        auto second = storage.saveText(text);
+        TEST_ASSERT(second.success && second.chunks == first.chunks, "相同内容得到相同的分块清单");
+        TEST_ASSERT(countChunkFiles() == fileCount, "没有写入新文件");
+        TEST_ASSERT(second.compressedSize == first.compressedSize, "压缩大小一致");
+
+        TEST_PASS("testChunkDeduplication: 相同分块只存一份");
+        return true;
+    }
+
+    bool testSharedChunks() {
+        resetTestEnvironment();
+        auto& storage = suyan::TextStorage::instance();
+
+        // 追加内容的日志：前面完整的分块与旧版本共享
+        std::string log = createLogText(suyan::TextStorage::kChunkSize * 2);
+        log.resize(suyan::TextStorage::kChunkSize * 2);
+        std::string appended = log + createLogText(1000, "WARN");
+        auto first = storage.saveText(log);
+        auto second = storage.saveText(appended);
+
+        auto firstChunks = suyan::TextStorage::parseChunkList(first.chunks);
+        auto secondChunks = suyan::TextStorage::parseChunkList(second.chunks);
+        TEST_ASSERT(secondChunks.size() == 3, "追加后的分块数量");
+        TEST_ASSERT(secondChunks[0] == firstChunks[0] && secondChunks[1] == firstChunks[1], "前面的分块共享");
+        TEST_ASSERT(countChunkFiles() == 3, "只新增一个文件");
+        TEST_ASSERT(storage.loadText(second.chunks) == appended, "读取追加后的内容");
+
+        TEST_PASS("testSharedChunks: 分块在记录之间共享");
+        return true;
+    }
+
+    bool testMissingChunk() {
+        resetTestEnvironment();
+        auto& storage = suyan::TextStorage::instance();
+
+        auto result = storage.saveText(createLogText(suyan::TextStorage::kChunkSize + 1));
+        auto chunks = suyan::TextStorage::parseChunkList(result.chunks);
+        fs::remove(storage.getChunkPath(chunks[1]));
+        TEST_ASSERT(storage.loadText(result.chunks).empty(), "分块缺失时返回空");
+
+        TEST_PASS("testMissingChunk: 分块缺失处理正常");
+        return true;
+    }
+
+    bool testCorruptedChunk() {
+        resetTestEnvironment();
+        auto& storage = suyan::TextStorage::instance();
+
+        auto result = storage.saveText(createLogText(1000));
+        {
+            std::ofstream out(storage.getChunkPath(result.chunks), std::ios::binary | std::ios::trunc);
+            out << "not compressed";
+        }
+        TEST_ASSERT(storage.loadText(result.chunks).empty(), "分块损坏时返回空");
+
+        TEST_PASS("testCorruptedChunk: 分块损坏处理正常");
+        return true;
+    }
+
+    bool testDeleteChunks() {
+        resetTestEnvironment();
+        auto& storage = suyan::TextStorage::instance();
+
+        auto result = storage.saveText(createLogText(suyan::TextStorage::kChunkSize + 1));
+        TEST_ASSERT(storage.deleteChunks(suyan::TextStorage::parseChunkList(result.chunks)), "删除成功");
+        TEST_ASSERT(countChunkFiles() == 0, "文件已删除");
+        TEST_ASSERT(storage.deleteChunks({"not_exist"}), "删除不存在的分块不报错");
+
+        TEST_PASS("testDeleteChunks: 分块删除正常");
+        return true;
+    }
+
+    bool testParseChunkList() {
+        using suyan::TextStorage;
+        TEST_ASSERT(TextStorage::parseChunkList("").empty(), "空清单");
+
+        auto hashes = TextStorage::parseChunkList("aa,bb,,cc");
+        TEST_ASSERT(hashes.size() == 3 && hashes[0] == "aa" && hashes[2] == "cc", "忽略空项");
+
+        TEST_PASS("testParseChunkList: 分块清单解析正常");
+        return true;
+    }
+};
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+
+    TextStorageTest test;
+    return test.runAllTests() ? 0 : 1;
+}
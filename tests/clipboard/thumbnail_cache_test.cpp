@@ -0,0 +1,309 @@
+/**
+ * ThumbnailCache 单元测试
+ *
+ * 测试缩略图图集的追加、索引重建、截断恢复、压缩，以及不读取文件的 QPixmap 查询和后台加载。
+ */
+
+#include <iostream>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <QGuiApplication>
+#include <QImage>
+#include <QBuffer>
+#include <QPixmap>
+#include "image_storage.h"
+#include "thumbnail_cache.h"
+
+namespace fs = std::filesystem;
+
+// 测试辅助宏
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "✗ 断言失败: " << message << std::endl; \
+            std::cerr << "  位置: " << __FILE__ << ":" << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define TEST_PASS(message) \
+    std::cout << "✓ " << message << std::endl
+
+class ThumbnailCacheTest {
+public:
+    ThumbnailCacheTest() {
+        // 使用临时目录进行测试
+        testBaseDir_ = fs::temp_directory_path().string() + "/suyan_thumbnail_cache_test";
+        atlasPath_ = testBaseDir_ + "/thumbnails.atlas";
+
+        // 清理之前的测试数据
+        fs::remove_all(testBaseDir_);
+    }
+
+    ~ThumbnailCacheTest() {
+        suyan::ThumbnailCache::instance().shutdown();
+        suyan::ImageStorage::instance().shutdown();
+        fs::remove_all(testBaseDir_);
+    }
+
+    bool runAllTests() {
+        std::cout << "=== ThumbnailCache 单元测试 ===" << std::endl;
+        std::cout << "测试数据目录: " << testBaseDir_ << std::endl;
+        std::cout << std::endl;
+
+        bool allPassed = true;
+
+        // 图集测试
+        allPassed &= testInitializeCreatesAtlas();
+        allPassed &= testEnsureAppendsEntry();
+        allPassed &= testPixmapWithoutThumbnailFile();
+        allPassed &= testPixmapAppendsOnMiss();
+        allPassed &= testMissingThumbnail();
+        allPassed &= testTruncatedEntry();
+
+        // 维护测试
+        allPassed &= testCompact();
+        allPassed &= testClear();
+
+        std::cout << std::endl;
+        if (allPassed) {
+            std::cout << "=== 所有测试通过 ===" << std::endl;
+        } else {
+            std::cout << "=== 部分测试失败 ===" << std::endl;
+        }
+
+        return allPassed;
+    }
+
+private:
+    std::string testBaseDir_;
+    std::string atlasPath_;
+
+    // 重置测试环境
+    void resetTestEnvironment() {
+        auto& cache = suyan::ThumbnailCache::instance();
+        auto& storage = suyan::ImageStorage::instance();
+        cache.shutdown();
+        storage.shutdown();
+        fs::remove_all(testBaseDir_);
+        storage.initialize(testBaseDir_);
+        cache.initialize(atlasPath_);
+    }
+
+    // 保存一张纯色测试图片，返回缩略图路径（记录中的相对路径）
+    std::string saveTestImage(const std::string& hash, QColor color = Qt::red) {
+        QImage image(400, 300, QImage::Format_ARGB32);
+        image.fill(color);
+
+        QByteArray byteArray;
+        QBuffer buffer(&byteArray);
+        buffer.open(QIODevice::WriteOnly);
+        image.save(&buffer, "PNG");
+        buffer.close();
+
+        std::vector<uint8_t> data(byteArray.begin(), byteArray.end());
+        return suyan::ImageStorage::instance().saveImage(data, "png", hash).thumbnailPath;
+    }
+
+    // ========== 图集测试 ==========
+
+    bool testInitializeCreatesAtlas() {
+        resetTestEnvironment();
+        auto& cache = suyan::ThumbnailCache::instance();
+
+        TEST_ASSERT(cache.isInitialized(), "图集应该已打开");
+        TEST_ASSERT(fs::exists(atlasPath_), "图集文件应该已创建");
+        TEST_ASSERT(cache.size() == 0, "新图集没有条目");
+        TEST_ASSERT(cache.getAtlasSize() == 8, "新图集只有文件头");
+
+        TEST_PASS("testInitializeCreatesAtlas: 创建图集正常");
+        return true;
+    }
+
+    bool testEnsureAppendsEntry() {
+        resetTestEnvironment();
+        auto& cache = suyan::ThumbnailCache::instance();
+
+        std::string thumbnailPath = saveTestImage("aa11bb22", Qt::red);
+        TEST_ASSERT(!thumbnailPath.empty(), "应该生成缩略图");
+
+        TEST_ASSERT(cache.ensure(thumbnailPath), "写入图集应该成功");
+        TEST_ASSERT(cache.contains(thumbnailPath), "图集中应该有该缩略图");
+        TEST_ASSERT(cache.size() == 1, "图集应该有 1 个条目");
+
+        // 重复写入不追加
+        int64_t atlasSize = cache.getAtlasSize();
+        TEST_ASSERT(cache.ensure(thumbnailPath), "重复写入返回 true");
+        TEST_ASSERT(cache.getAtlasSize() == atlasSize, "重复写入不追加");
+
+        // 按显示尺寸保存，颜色不变
+        QPixmap pixmap = cache.pixmap(thumbnailPath);
+        TEST_ASSERT(!pixmap.isNull(), "应该返回缩略图");
+        TEST_ASSERT(pixmap.width() <= suyan::ThumbnailCache::kDisplayWidth &&
+                    pixmap.height() == suyan::ThumbnailCache::kDisplayHeight, "缩略图为显示尺寸（4:3 按高度缩放）");
+        QColor center = pixmap.toImage().pixelColor(pixmap.width() / 2, pixmap.height() / 2);
+        TEST_ASSERT(center.red() > 240 && center.green() < 15 && center.blue() < 15, "颜色应该不变");
+
+        TEST_PASS("testEnsureAppendsEntry: 写入图集正常");
+        return true;
+    }
+
+    bool testPixmapWithoutThumbnailFile() {
+        resetTestEnvironment();
+        auto& cache = suyan::ThumbnailCache::instance();
+
+        std::string thumbnailPath = saveTestImage("cc33dd44", Qt::blue);
+        TEST_ASSERT(cache.ensure(thumbnailPath), "写入图集应该成功");
+
+        // 删除缩略图文件并重新打开图集（清空 LRU），仍可从图集读取
+        suyan::ImageStorage::instance().deleteImage("", thumbnailPath);
+        TEST_ASSERT(!suyan::ImageStorage::instance().imageExists(thumbnailPath), "缩略图文件已删除");
+        cache.shutdown();
+        TEST_ASSERT(cache.initialize(atlasPath_), "重新打开图集应该成功");
+        TEST_ASSERT(cache.contains(thumbnailPath), "重新打开后索引应该重建");
+
+        QPixmap pixmap = cache.pixmap(thumbnailPath);
+        TEST_ASSERT(!pixmap.isNull(), "不读取文件也应该返回缩略图");
+        QColor center = pixmap.toImage().pixelColor(pixmap.width() / 2, pixmap.height() / 2);
+        TEST_ASSERT(center.blue() > 240 && center.red() < 15, "颜色应该不变");
+
+        TEST_PASS("testPixmapWithoutThumbnailFile: 从图集读取缩略图正常");
+        return true;
+    }
+
+    bool testPixmapAppendsOnMiss() {
+        resetTestEnvironment();
+        auto& cache = suyan::ThumbnailCache::instance();
+
+        // 旧记录：图集中没有，第一次显示时先返回空（显示占位），由加载线程写入图集
+        std::string thumbnailPath = saveTestImage("ee55ff66");
+        TEST_ASSERT(!cache.contains(thumbnailPath), "图集中还没有该缩略图");
+
+        std::vector<std::string> readyPaths;
+        std::mutex readyMutex;
+        cache.setReadyHandler([&](const std::string& path) {
+            std::lock_guard<std::mutex> lock(readyMutex);
+            readyPaths.push_back(path);
+        });
+        bool placeholder = cache.pixmap(thumbnailPath).isNull();
+        cache.waitForIdle();
+
+        // 无法解码的缩略图不通知
+        bool missingPlaceholder = cache.pixmap("thumbnails/no/ne/none.png").isNull();
+        cache.waitForIdle();
+        cache.setReadyHandler(nullptr);
+
+        TEST_ASSERT(placeholder, "未命中时不在调用线程解码");
+        TEST_ASSERT(readyPaths == std::vector<std::string>({thumbnailPath}), "加载完成后只通知可显示的缩略图");
+        TEST_ASSERT(cache.contains(thumbnailPath), "加载完成后应该写入图集");
+        TEST_ASSERT(!cache.pixmap(thumbnailPath).isNull(), "再次显示时返回缩略图");
+        TEST_ASSERT(missingPlaceholder && cache.pixmap("thumbnails/no/ne/none.png").isNull(),
+                    "不存在的缩略图返回空");
+
+        TEST_PASS("testPixmapAppendsOnMiss: 未命中时后台写入图集正常");
+        return true;
+    }
+
+    bool testMissingThumbnail() {
+        resetTestEnvironment();
+        auto& cache = suyan::ThumbnailCache::instance();
+
+        TEST_ASSERT(cache.pixmap("thumbnails/no/ne/none.png").isNull(), "不存在的缩略图返回空");
+        TEST_ASSERT(!cache.ensure("thumbnails/no/ne/none.png"), "不存在的缩略图不能写入");
+        TEST_ASSERT(cache.pixmap("").isNull(), "空路径返回空");
+        TEST_ASSERT(cache.size() == 0, "图集中没有条目");
+
+        TEST_PASS("testMissingThumbnail: 缺失的缩略图处理正常");
+        return true;
+    }
+
+    bool testTruncatedEntry() {
+        resetTestEnvironment();
+        auto& cache = suyan::ThumbnailCache::instance();
+
+        std::string thumbnailPath = saveTestImage("1a2b3c4d");
+        TEST_ASSERT(cache.ensure(thumbnailPath), "写入图集应该成功");
+        int64_t atlasSize = cache.getAtlasSize();
+        cache.shutdown();
+
+        // 模拟写入中断：末尾留下不完整的条目
+        {
+            std::ofstream file(atlasPath_, std::ios::binary | std::ios::app);
+            const char partial[] = "SYTE\x05\0\0\0partial";
+            file.write(partial, sizeof(partial));
+        }
+        TEST_ASSERT(static_cast<int64_t>(fs::file_size(atlasPath_)) > atlasSize, "末尾有不完整的条目");
+
+        TEST_ASSERT(cache.initialize(atlasPath_), "重新打开图集应该成功");
+        TEST_ASSERT(cache.size() == 1, "完整的条目应该保留");
+        TEST_ASSERT(cache.getAtlasSize() == atlasSize, "不完整的条目应该被截掉");
+        TEST_ASSERT(!cache.pixmap(thumbnailPath).isNull(), "保留的条目可以读取");
+
+        TEST_PASS("testTruncatedEntry: 截断不完整条目正常");
+        return true;
+    }
+
+    // ========== 维护测试 ==========
+
+    bool testCompact() {
+        resetTestEnvironment();
+        auto& cache = suyan::ThumbnailCache::instance();
+
+        std::vector<std::string> paths;
+        const QColor colors[] = {Qt::red, Qt::green, Qt::blue, Qt::yellow};
+        for (int i = 0; i < 4; i++) {
+            paths.push_back(saveTestImage("5e6f7a8" + std::to_string(i), colors[i]));
+            TEST_ASSERT(cache.ensure(paths.back()), "写入图集应该成功");
+        }
+
+        // 全部有效时不重写
+        TEST_ASSERT(!cache.compact(paths), "无用条目不到一半时不应该重写");
+        TEST_ASSERT(cache.size() == 4, "条目数不变");
+
+        // 只保留 1 个
+        int64_t atlasSize = cache.getAtlasSize();
+        TEST_ASSERT(cache.compact({paths[2]}), "无用条目超过一半时应该重写");
+        TEST_ASSERT(cache.size() == 1 && cache.contains(paths[2]), "只保留有效条目");
+        TEST_ASSERT(cache.getAtlasSize() < atlasSize / 2, "图集应该变小");
+
+        // 重写后内容正确，并且可以继续追加
+        suyan::ImageStorage::instance().deleteImage("", paths[2]);
+        QPixmap pixmap = cache.pixmap(paths[2]);
+        TEST_ASSERT(!pixmap.isNull(), "保留的条目可以读取");
+        QColor center = pixmap.toImage().pixelColor(pixmap.width() / 2, pixmap.height() / 2);
+        TEST_ASSERT(center.blue() > 240 && center.red() < 15, "保留的条目内容正确");
+        TEST_ASSERT(cache.ensure(paths[0]), "重写后可以继续追加");
+        TEST_ASSERT(cache.size() == 2, "追加后条目数");
+
+        TEST_PASS("testCompact: 压缩图集正常");
+        return true;
+    }
+
+    bool testClear() {
+        resetTestEnvironment();
+        auto& cache = suyan::ThumbnailCache::instance();
+
+        std::string thumbnailPath = saveTestImage("9f8e7d6c");
+        TEST_ASSERT(cache.ensure(thumbnailPath), "写入图集应该成功");
+        TEST_ASSERT(!cache.pixmap(thumbnailPath).isNull(), "应该返回缩略图");
+
+        cache.clear();
+        TEST_ASSERT(cache.isInitialized(), "清空后图集仍然打开");
+        TEST_ASSERT(cache.size() == 0, "清空后没有条目");
+        TEST_ASSERT(cache.getAtlasSize() == 8, "清空后只有文件头");
+
+        TEST_PASS("testClear: 清空图集正常");
+        return true;
+    }
+};
+
+int main(int argc, char* argv[]) {
+    // QPixmap 需要 QGuiApplication
+    QGuiApplication app(argc, argv);
+
+    ThumbnailCacheTest test;
+    return test.runAllTests() ? 0 : 1;
+}
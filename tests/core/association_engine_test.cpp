@@ -0,0 +1,272 @@
+/**
+ * AssociationEngine 单元测试
+ *
+ * 测试联想索引的生成与映射、按上下文查询，以及提交历史的记录与持久化。
+ */
+
+#include <iostream>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <algorithm>
+#include "association_engine.h"
+
+namespace fs = std::filesystem;
+using suyan::AssociationEngine;
+
+// 测试辅助宏
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "✗ 断言失败: " << message << std::endl; \
+            std::cerr << "  位置: " << __FILE__ << ":" << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define TEST_PASS(message) \
+    std::cout << "✓ " << message << std::endl
+
+class AssociationEngineTest {
+public:
+    AssociationEngineTest() {
+        testDir_ = fs::temp_directory_path().string() + "/suyan_association_test";
+        fs::remove_all(testDir_);
+        userDir_ = testDir_ + "/user";
+        sharedDir_ = testDir_ + "/shared";
+        fs::create_directories(userDir_);
+        fs::create_directories(sharedDir_ + "/cn_dicts");
+    }
+
+    ~AssociationEngineTest() {
+        AssociationEngine::instance().shutdown();
+        fs::remove_all(testDir_);
+    }
+
+    bool runAllTests() {
+        std::cout << "=== AssociationEngine 单元测试 ===" << std::endl;
+        std::cout << std::endl;
+
+        bool allPassed = true;
+
+        allPassed &= testCollectDictionaries();
+        allPassed &= testBuildAndLookup();
+        allPassed &= testInvalidIndex();
+        allPassed &= testHistory();
+        allPassed &= testHistoryAutoSave();
+        allPassed &= testHistoryPersistence();
+        allPassed &= testRebuildOnDictionaryChange();
+
+        std::cout << std::endl;
+        if (allPassed) {
+            std::cout << "=== 所有测试通过 ===" << std::endl;
+        } else {
+            std::cout << "=== 部分测试失败 ===" << std::endl;
+        }
+        return allPassed;
+    }
+
+private:
+    std::string testDir_;
+    std::string userDir_;
+    std::string sharedDir_;
+
+    void writeFile(const std::string& path, const std::string& content) {
+        std::ofstream out(path, std::ios::trunc);
+        out << content;
+    }
+
+    void writeDictionaries() {
+        writeFile(sharedDir_ + "/rime_ice.dict.yaml",
+                  "---\n"
+                  "name: rime_ice\n"
+                  "import_tables:\n"
+                  "  - cn_dicts/base     # 基础词库\n"
+                  "  # - cn_dicts/41448  # 未启用\n"
+                  "  - cn_dicts/missing\n"
+                  "...\n"
+                  "A\tA\n");
+        writeFile(sharedDir_ + "/cn_dicts/base.dict.yaml",
+                  "---\n"
+                  "name: base\n"
+                  "...\n"
+                  "# 注释\n"
+                  "中\tzhong\t100\n"
+                  "中国\tzhong guo\t900\n"
+                  "中华\tzhong hua\t800\n"
+                  "中华人民共和国\tzhong hua ren min gong he guo\t500\n"
+                  "中华民族\tzhong hua min zu\t600\n"
+                  "中国人\tzhong guo ren\t300\n"
+                  "华为\thua wei\t700\n"
+                  "华人\thua ren\t400\n"
+                  "中国\tzhong guo\t10\n");
+    }
+
+    bool testCollectDictionaries() {
+        writeDictionaries();
+
+        auto paths = AssociationEngine::collectDictionaries(userDir_, sharedDir_);
+        TEST_ASSERT(paths.size() == 2, "主词库 + base，注释和不存在的词库被跳过");
+        TEST_ASSERT(paths[0] == sharedDir_ + "/rime_ice.dict.yaml", "主词库");
+        TEST_ASSERT(paths[1] == sharedDir_ + "/cn_dicts/base.dict.yaml", "引用的词库");
+
+        // 用户目录中的词库优先
+        fs::create_directories(userDir_ + "/cn_dicts");
+        writeFile(userDir_ + "/cn_dicts/base.dict.yaml", "---\nname: base\n...\n");
+        paths = AssociationEngine::collectDictionaries(userDir_, sharedDir_);
+        TEST_ASSERT(paths.size() == 2 && paths[1] == userDir_ + "/cn_dicts/base.dict.yaml", "用户词库优先");
+        fs::remove_all(userDir_ + "/cn_dicts");
+
+        TEST_PASS("testCollectDictionaries: 词库收集正常");
+        return true;
+    }
+
+    bool testBuildAndLookup() {
+        auto& engine = AssociationEngine::instance();
+        TEST_ASSERT(engine.initialize(userDir_, sharedDir_), "初始化成功");
+        TEST_ASSERT(fs::exists(engine.getIndexPath()), "索引已生成");
+
+        // 单字前缀：按权重降序，同一词条的多个读音只出现一次
+        auto results = engine.lookup("中", 10);
+        TEST_ASSERT(results.size() == 5, "「中」的后续数量");
+        TEST_ASSERT(results[0] == "国" && results[1] == "华", "按权重排序");
+        TEST_ASSERT(results[2] == "华民族" && results[3] == "华人民共和国", "长后续");
+        TEST_ASSERT(results[4] == "国人", "低权重后续");
+
+        // 更长的上下文排在前面，再接末尾单字的后续
+        results = engine.lookup("中华", 10);
+        TEST_ASSERT(results.size() == 4, "「中华」的后续数量");
+        TEST_ASSERT(results[0] == "民族" && results[1] == "人民共和国", "双字上下文优先");
+        TEST_ASSERT(results[2] == "为" && results[3] == "人", "其后为末字「华」的后续");
+
+        TEST_ASSERT(engine.lookup("中华", 1).size() == 1, "数量限制");
+        TEST_ASSERT(engine.lookup("中国，", 10).empty(), "以标点结尾不联想");
+        TEST_ASSERT(engine.lookup("abc", 10).empty(), "英文不联想");
+        TEST_ASSERT(engine.lookup("人", 10).empty(), "无后续的字");
+
+        TEST_PASS("testBuildAndLookup: 索引生成与查询正常");
+        return true;
+    }
+
+    bool testInvalidIndex() {
+        auto& engine = AssociationEngine::instance();
+        std::string badPath = testDir_ + "/bad.bin";
+
+        writeFile(badPath, "not an index");
+        TEST_ASSERT(!engine.loadIndex(badPath), "格式不符的文件被拒绝");
+
+        // 截断的索引
+        std::ifstream in(engine.getIndexPath(), std::ios::binary);
+        std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        writeFile(badPath, content.substr(0, content.size() - 1));
+        TEST_ASSERT(!engine.loadIndex(badPath), "截断的文件被拒绝");
+        TEST_ASSERT(engine.lookup("中", 10).empty(), "无索引时无词库结果");
+
+        TEST_ASSERT(engine.loadIndex(engine.getIndexPath()), "重新映射");
+        TEST_ASSERT(!engine.lookup("中", 10).empty(), "恢复查询");
+
+        TEST_PASS("testInvalidIndex: 索引校验正常");
+        return true;
+    }
+
+    bool testHistory() {
+        auto& engine = AssociationEngine::instance();
+        engine.clearHistory();
+
+        // 提交「中华」后提交「人民」，再次提交「中华」时「人民」排在最前
+        engine.recordCommit("中华");
+        engine.recordCommit("人民");
+        auto results = engine.lookup("中华", 3);
+        TEST_ASSERT(!results.empty() && results[0] == "人民", "历史优先");
+        TEST_ASSERT(results.size() == 3 && results[1] == "民族", "其后为词库结果");
+
+        // 次数多的历史排在前面
+        engine.recordCommit("中华");
+        engine.recordCommit("文化");
+        engine.recordCommit("中华");
+        engine.recordCommit("文化");
+        results = engine.lookup("中华", 2);
+        TEST_ASSERT(results[0] == "文化" && results[1] == "人民", "按次数排序");
+
+        // 按前文末尾两字匹配
+        results = engine.lookup("伟大的中华", 1);
+        TEST_ASSERT(results.size() == 1 && results[0] == "文化", "末尾两字匹配");
+
+        // 标点和重置上下文都不产生历史
+        engine.recordCommit("，");
+        engine.recordCommit("世界");
+        TEST_ASSERT(engine.lookup("，", 5).empty(), "标点不记录");
+        engine.recordCommit("你好");
+        engine.resetContext();
+        engine.recordCommit("朋友");
+        results = engine.lookup("你好", 5);
+        TEST_ASSERT(std::find(results.begin(), results.end(), "朋友") == results.end(), "重置后不记录");
+
+        TEST_PASS("testHistory: 提交历史正常");
+        return true;
+    }
+
+    bool testHistoryAutoSave() {
+        auto& engine = AssociationEngine::instance();
+        auto historyPath = userDir_ + "/association_history.txt";
+        fs::remove(historyPath);
+
+        // 不调用 shutdown，累积足够的历史记录后也会写回
+        engine.recordCommit("中华");
+        engine.recordCommit("文化");
+        TEST_ASSERT(!fs::exists(historyPath), "少量记录不立即写回");
+        for (int i = 0; i < 40; ++i) {
+            engine.recordCommit("中华");
+            engine.recordCommit(i % 2 == 0 ? "文化" : "人民");
+        }
+        TEST_ASSERT(fs::exists(historyPath), "累积记录后自动写回");
+
+        TEST_PASS("testHistoryAutoSave: 历史定期写回正常");
+        return true;
+    }
+
+    bool testHistoryPersistence() {
+        auto& engine = AssociationEngine::instance();
+        engine.shutdown();
+        TEST_ASSERT(fs::exists(userDir_ + "/association_history.txt"), "关闭时保存历史");
+
+        TEST_ASSERT(engine.initialize(userDir_, sharedDir_), "重新初始化");
+        auto results = engine.lookup("中华", 2);
+        TEST_ASSERT(results.size() == 2 && results[0] == "文化" && results[1] == "人民", "历史已恢复");
+
+        TEST_PASS("testHistoryPersistence: 历史持久化正常");
+        return true;
+    }
+
+    bool testRebuildOnDictionaryChange() {
+        auto& engine = AssociationEngine::instance();
+        engine.shutdown();
+
+        // 索引比词库新时不重新生成
+        auto indexPath = userDir_ + "/association.bin";
+        auto before = fs::last_write_time(indexPath);
+        TEST_ASSERT(engine.initialize(userDir_, sharedDir_), "初始化");
+        TEST_ASSERT(fs::last_write_time(indexPath) == before, "索引未重新生成");
+        engine.shutdown();
+
+        // 词库更新后重新生成
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        writeFile(sharedDir_ + "/cn_dicts/base.dict.yaml",
+                  "---\nname: base\n...\n"
+                  "人工智能\tren gong zhi neng\t100\n");
+        fs::last_write_time(sharedDir_ + "/cn_dicts/base.dict.yaml",
+                            before + std::chrono::seconds(1));
+        TEST_ASSERT(engine.initialize(userDir_, sharedDir_), "初始化");
+        auto results = engine.lookup("人工", 5);
+        TEST_ASSERT(results.size() == 1 && results[0] == "智能", "新词库生效");
+        TEST_ASSERT(engine.lookup("中", 5).empty(), "旧词条已移除");
+
+        TEST_PASS("testRebuildOnDictionaryChange: 词库更新后重新生成");
+        return true;
+    }
+};
+
+int main() {
+    AssociationEngineTest test;
+    return test.runAllTests() ? 0 : 1;
+}
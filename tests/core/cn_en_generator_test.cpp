@@ -0,0 +1,211 @@
+/**
+ * CnEnGenerator 单元测试
+ *
+ * 测试全拼到各双拼方案的编码转换，以及部署时按当前方案生成变体词库。
+ */
+
+#include <iostream>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include "cn_en_generator.h"
+
+namespace fs = std::filesystem;
+using suyan::CnEnGenerator;
+using suyan::DoublePinyinScheme;
+
+// 测试辅助宏
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "✗ 断言失败: " << message << std::endl; \
+            std::cerr << "  位置: " << __FILE__ << ":" << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define TEST_PASS(message) \
+    std::cout << "✓ " << message << std::endl
+
+class CnEnGeneratorTest {
+public:
+    CnEnGeneratorTest() {
+        testDir_ = fs::temp_directory_path().string() + "/suyan_cn_en_test";
+        fs::remove_all(testDir_);
+        userDir_ = testDir_ + "/user";
+        sharedDir_ = testDir_ + "/shared";
+        fs::create_directories(userDir_);
+        fs::create_directories(sharedDir_ + "/en_dicts");
+    }
+
+    ~CnEnGeneratorTest() {
+        fs::remove_all(testDir_);
+    }
+
+    bool runAllTests() {
+        std::cout << "=== CnEnGenerator 单元测试 ===" << std::endl;
+        std::cout << std::endl;
+
+        bool allPassed = true;
+
+        allPassed &= testSchemeForSchemaId();
+        allPassed &= testConvertSyllable();
+        allPassed &= testConvertCode();
+        allPassed &= testGenerate();
+        allPassed &= testDeployActiveVariant();
+
+        std::cout << std::endl;
+        if (allPassed) {
+            std::cout << "=== 所有测试通过 ===" << std::endl;
+        } else {
+            std::cout << "=== 部分测试失败 ===" << std::endl;
+        }
+        return allPassed;
+    }
+
+private:
+    std::string testDir_;
+    std::string userDir_;
+    std::string sharedDir_;
+
+    void writeFile(const std::string& path, const std::string& content) {
+        std::ofstream out(path, std::ios::trunc);
+        out << content;
+    }
+
+    std::string readFile(const std::string& path) {
+        std::ifstream in(path);
+        return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    }
+
+    bool testSchemeForSchemaId() {
+        TEST_ASSERT(CnEnGenerator::schemeForSchemaId("double_pinyin_flypy") == DoublePinyinScheme::Flypy,
+                    "小鹤双拼方案");
+        TEST_ASSERT(CnEnGenerator::schemeForSchemaId("double_pinyin") == DoublePinyinScheme::Natural,
+                    "自然码双拼方案");
+        TEST_ASSERT(!CnEnGenerator::schemeForSchemaId("rime_ice").has_value(), "全拼无需变体");
+        TEST_ASSERT(CnEnGenerator::variantFileName(DoublePinyinScheme::Natural) == "cn_en_double_pinyin.txt",
+                    "自然码变体文件名");
+        TEST_ASSERT(CnEnGenerator::variantFileName(DoublePinyinScheme::Mspy) == "cn_en_mspy.txt",
+                    "微软双拼变体文件名");
+
+        TEST_PASS("testSchemeForSchemaId: 方案映射正常");
+        return true;
+    }
+
+    bool testConvertSyllable() {
+        TEST_ASSERT(CnEnGenerator::convertSyllable("guang", DoublePinyinScheme::Flypy) == "gl", "小鹤 guang");
+        TEST_ASSERT(CnEnGenerator::convertSyllable("zhang", DoublePinyinScheme::Natural) == "vh", "自然码 zhang");
+        TEST_ASSERT(CnEnGenerator::convertSyllable("zhang", DoublePinyinScheme::Abc) == "ah", "ABC zhang");
+        TEST_ASSERT(CnEnGenerator::convertSyllable("ting", DoublePinyinScheme::Mspy) == "t;", "微软 ting");
+        TEST_ASSERT(CnEnGenerator::convertSyllable("ai", DoublePinyinScheme::Abc) == "ol", "ABC 零声母 ai");
+        TEST_ASSERT(CnEnGenerator::convertSyllable("ai", DoublePinyinScheme::Jiajia) == "as", "加加零声母 ai");
+        TEST_ASSERT(CnEnGenerator::convertSyllable("er", DoublePinyinScheme::Ziguang) == "oj", "紫光零声母 er");
+        TEST_ASSERT(CnEnGenerator::convertSyllable("xu", DoublePinyinScheme::Flypy) == "xu", "单韵母不变");
+        TEST_ASSERT(CnEnGenerator::convertSyllable("lve", DoublePinyinScheme::Abc) == "lm", "ABC lve");
+        TEST_ASSERT(CnEnGenerator::convertSyllable("xyz", DoublePinyinScheme::Flypy).empty(), "非法音节");
+
+        TEST_PASS("testConvertSyllable: 音节转换正常");
+        return true;
+    }
+
+    bool testConvertCode() {
+        auto flypy = DoublePinyinScheme::Flypy;
+        TEST_ASSERT(CnEnGenerator::convertCode("X光片", "Xguangpian", flypy) == "Xglpm", "字母保留大小写");
+        TEST_ASSERT(CnEnGenerator::convertCode("X光片", "xguangpian", flypy) == "xglpm", "小写编码");
+        TEST_ASSERT(CnEnGenerator::convertCode("红Buff", "hongBuff", flypy) == "hsBuff", "英文单词不转换");
+        TEST_ASSERT(CnEnGenerator::convertCode("Cinity厅", "cinityting", flypy) == "cinitytk",
+                    "英文单词不被误切为音节");
+        TEST_ASSERT(CnEnGenerator::convertCode("A4纸", "Asizhi", flypy) == "Asivi", "数字按读音转换");
+        TEST_ASSERT(CnEnGenerator::convertCode("3G网络", "sanGwangluo", flypy) == "sjGwhlo",
+                    "字母须与文本对齐");
+        TEST_ASSERT(CnEnGenerator::convertCode("J.K.罗琳", "JKluolin", flypy) == "JKlolb", "标点不占编码");
+        TEST_ASSERT(CnEnGenerator::convertCode("乔治·R.R.马丁", "qiaozhiRRmading", flypy) == "qnviRRmadk",
+                    "中间点不占编码");
+        TEST_ASSERT(CnEnGenerator::convertCode("智能ABC", "zhinengABC", flypy) == "vingABC",
+                    "按字数切分音节");
+        TEST_ASSERT(CnEnGenerator::convertCode("T.S.艾略特", "TSailvete", DoublePinyinScheme::Abc) == "TSollmte",
+                    "ABC 略特");
+        TEST_ASSERT(CnEnGenerator::convertCode("X光", "Yguang", flypy).empty(), "无法对齐返回空");
+
+        TEST_PASS("testConvertCode: 词条编码转换正常");
+        return true;
+    }
+
+    bool testGenerate() {
+        std::string source = sharedDir_ + "/en_dicts/cn_en.txt";
+        writeFile(source,
+                  "# Rime table\n"
+                  "# 此行之后不能写注释\n"
+                  "X光\tXguang\n"
+                  "X光\txguang\n"
+                  "T恤衫\ttxushan\n");
+
+        std::string output = testDir_ + "/cn_en_flypy.txt";
+        TEST_ASSERT(CnEnGenerator::generate(source, output, DoublePinyinScheme::Flypy), "生成成功");
+
+        std::string content = readFile(output);
+        TEST_ASSERT(content.find("#@/db_name\tcn_en_flypy.txt\n") != std::string::npos, "文件头 db_name");
+        TEST_ASSERT(content.find("# generator_version: ") != std::string::npos, "文件头生成器版本");
+        TEST_ASSERT(content.find("X光\tXgl\nX光\txgl\nT恤衫\ttxuuj\n") != std::string::npos, "词条内容");
+        TEST_ASSERT(!fs::exists(output + ".tmp"), "临时文件已清理");
+
+        TEST_PASS("testGenerate: 变体生成正常");
+        return true;
+    }
+
+    bool testDeployActiveVariant() {
+        std::string enDicts = userDir_ + "/en_dicts";
+
+        // 无 user.yaml 时取 default.yaml 第一个方案（全拼），不生成变体
+        writeFile(sharedDir_ + "/default.yaml",
+                  "schema_list:\n"
+                  "  - schema: rime_ice\n"
+                  "  - schema: double_pinyin_flypy\n");
+        TEST_ASSERT(CnEnGenerator::detectActiveSchema(userDir_, sharedDir_) == "rime_ice", "默认方案");
+        TEST_ASSERT(CnEnGenerator::deployActiveVariant(userDir_, sharedDir_), "全拼部署成功");
+        TEST_ASSERT(!fs::exists(enDicts + "/cn_en_flypy.txt"), "全拼不生成变体");
+
+        // 切换到小鹤双拼
+        writeFile(userDir_ + "/user.yaml",
+                  "var:\n"
+                  "  previously_selected_schema: double_pinyin_flypy\n");
+        TEST_ASSERT(CnEnGenerator::detectActiveSchema(userDir_, sharedDir_) == "double_pinyin_flypy",
+                    "读取 user.yaml");
+        TEST_ASSERT(CnEnGenerator::deployActiveVariant(userDir_, sharedDir_), "小鹤部署成功");
+        TEST_ASSERT(fs::exists(enDicts + "/cn_en_flypy.txt"), "生成小鹤变体");
+
+        // 切换到微软双拼，旧变体被删除
+        writeFile(userDir_ + "/user.yaml",
+                  "var:\n"
+                  "  previously_selected_schema: double_pinyin_mspy\n");
+        TEST_ASSERT(CnEnGenerator::deployActiveVariant(userDir_, sharedDir_), "微软部署成功");
+        TEST_ASSERT(fs::exists(enDicts + "/cn_en_mspy.txt"), "生成微软变体");
+        TEST_ASSERT(!fs::exists(enDicts + "/cn_en_flypy.txt"), "删除过期变体");
+
+        // 旧版本生成器生成的变体（没有版本行）即使比全拼词库新也重新生成
+        std::string mspy = enDicts + "/cn_en_mspy.txt";
+        writeFile(mspy, "# Rime table\n# 此行之后不能写注释\n");
+        fs::last_write_time(mspy, fs::last_write_time(sharedDir_ + "/en_dicts/cn_en.txt") + std::chrono::hours(1));
+        bool regenerated = false;
+        TEST_ASSERT(CnEnGenerator::deployVariant("double_pinyin_mspy", userDir_, sharedDir_, &regenerated),
+                    "重新部署成功");
+        TEST_ASSERT(regenerated, "报告已重新生成");
+        TEST_ASSERT(readFile(mspy).find("# generator_version: ") != std::string::npos, "旧版本变体已重新生成");
+
+        // 当前版本生成且比全拼词库新时跳过
+        auto generatedTime = fs::last_write_time(mspy);
+        TEST_ASSERT(CnEnGenerator::deployVariant("double_pinyin_mspy", userDir_, sharedDir_, &regenerated),
+                    "再次部署成功");
+        TEST_ASSERT(fs::last_write_time(mspy) == generatedTime, "已是最新时不重新生成");
+        TEST_ASSERT(!regenerated, "报告未重新生成");
+
+        TEST_PASS("testDeployActiveVariant: 部署变体正常");
+        return true;
+    }
+};
+
+int main() {
+    CnEnGeneratorTest test;
+    return test.runAllTests() ? 0 : 1;
+}
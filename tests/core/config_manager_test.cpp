@@ -138,6 +138,7 @@ private:
         
         auto inputConfig = config.getInputConfig();
         TEST_ASSERT(inputConfig.defaultMode == suyan::DefaultInputMode::Chinese, "默认输入模式应该是中文");
+        TEST_ASSERT(inputConfig.associationEnabled == false, "联想功能默认应该关闭");
         
         auto freqConfig = config.getFrequencyConfig();
         TEST_ASSERT(freqConfig.enabled == true, "词频功能默认应该启用");
@@ -369,6 +370,7 @@ private:
         TEST_ASSERT(clipboardConfig.enabled == true, "剪贴板功能默认应该启用");
         TEST_ASSERT(clipboardConfig.maxAgeDays == 30, "默认保留天数应该是 30");
         TEST_ASSERT(clipboardConfig.maxCount == 1000, "默认最大条数应该是 1000");
+        TEST_ASSERT(clipboardConfig.maxStorageMB == 1024, "默认存储空间上限应该是 1024MB");
         TEST_ASSERT(clipboardConfig.hotkey == "Cmd+Shift+V", "默认快捷键应该是 Cmd+Shift+V");
         
         // 测试启用/禁用
@@ -397,6 +399,14 @@ private:
         config.setClipboardMaxCount(20000);  // 应该被限制为 10000
         TEST_ASSERT(config.getClipboardConfig().maxCount == 10000, "最大条数应该被限制为 10000");
         
+        // 测试存储空间上限
+        config.setClipboardMaxStorageMB(512);
+        TEST_ASSERT(config.getClipboardConfig().maxStorageMB == 512, "存储空间上限应该是 512MB");
+        config.setClipboardMaxStorageMB(10);  // 应该被限制为 100
+        TEST_ASSERT(config.getClipboardConfig().maxStorageMB == 100, "存储空间上限应该被限制为 100MB");
+        config.setClipboardMaxStorageMB(100000);  // 应该被限制为 51200
+        TEST_ASSERT(config.getClipboardConfig().maxStorageMB == 51200, "存储空间上限应该被限制为 51200MB");
+        
         // 测试快捷键
         config.setClipboardHotkey("Ctrl+Shift+C");
         TEST_ASSERT(config.getClipboardConfig().hotkey == "Ctrl+Shift+C", "快捷键应该是 Ctrl+Shift+C");
@@ -405,6 +415,7 @@ private:
         TEST_ASSERT(config.getBool("clipboard.enabled") == true, "通过通用访问获取启用状态");
         TEST_ASSERT(config.getInt("clipboard.max_age_days") == 365, "通过通用访问获取保留天数");
         TEST_ASSERT(config.getInt("clipboard.max_count") == 10000, "通过通用访问获取最大条数");
+        TEST_ASSERT(config.getInt("clipboard.max_storage_mb") == 51200, "通过通用访问获取存储空间上限");
         TEST_ASSERT(config.getString("clipboard.hotkey") == "Ctrl+Shift+C", "通过通用访问获取快捷键");
         
         // 测试通用设置
@@ -414,6 +425,8 @@ private:
         TEST_ASSERT(config.getClipboardConfig().maxAgeDays == 14, "通过通用访问设置保留天数");
         config.setInt("clipboard.max_count", 2000);
         TEST_ASSERT(config.getClipboardConfig().maxCount == 2000, "通过通用访问设置最大条数");
+        config.setInt("clipboard.max_storage_mb", 2048);
+        TEST_ASSERT(config.getClipboardConfig().maxStorageMB == 2048, "通过通用访问设置存储空间上限");
         config.setString("clipboard.hotkey", "Alt+V");
         TEST_ASSERT(config.getClipboardConfig().hotkey == "Alt+V", "通过通用访问设置快捷键");
         
@@ -431,6 +444,7 @@ private:
         config.setClipboardEnabled(false);
         config.setClipboardMaxAgeDays(7);
         config.setClipboardMaxCount(500);
+        config.setClipboardMaxStorageMB(256);
         config.setClipboardHotkey("Cmd+Alt+V");
         
         // 保存
@@ -450,6 +464,7 @@ private:
         TEST_ASSERT(config.getClipboardConfig().enabled == false, "重新加载后剪贴板应该禁用");
         TEST_ASSERT(config.getClipboardConfig().maxAgeDays == 7, "重新加载后保留天数应该是 7");
         TEST_ASSERT(config.getClipboardConfig().maxCount == 500, "重新加载后最大条数应该是 500");
+        TEST_ASSERT(config.getClipboardConfig().maxStorageMB == 256, "重新加载后存储空间上限应该是 256MB");
         TEST_ASSERT(config.getClipboardConfig().hotkey == "Cmd+Alt+V", "重新加载后快捷键应该是 Cmd+Alt+V");
         
         // 恢复默认值以便后续测试
@@ -0,0 +1,251 @@
+/**
+ * CustomPhraseManager 单元测试
+ *
+ * 测试自定义短语的增删、调序、持久化以及 custom_phrase.txt 导入导出和首次导入。
+ */
+
+#include <iostream>
+#include <filesystem>
+#include <fstream>
+#include <QCoreApplication>
+#include <QSignalSpy>
+#include "custom_phrase_manager.h"
+
+namespace fs = std::filesystem;
+using suyan::CustomPhraseManager;
+
+// 测试辅助宏
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "✗ 断言失败: " << message << std::endl; \
+            std::cerr << "  位置: " << __FILE__ << ":" << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define TEST_PASS(message) \
+    std::cout << "✓ " << message << std::endl
+
+class CustomPhraseManagerTest {
+public:
+    CustomPhraseManagerTest() {
+        testDataDir_ = fs::temp_directory_path().string() + "/suyan_custom_phrase_test";
+        fs::remove_all(testDataDir_);
+    }
+
+    ~CustomPhraseManagerTest() {
+        CustomPhraseManager::instance().shutdown();
+        fs::remove_all(testDataDir_);
+    }
+
+    bool runAllTests() {
+        std::cout << "=== CustomPhraseManager 单元测试 ===" << std::endl;
+        std::cout << "测试数据目录: " << testDataDir_ << std::endl;
+        std::cout << std::endl;
+
+        bool allPassed = true;
+
+        allPassed &= testInitialize();
+        allPassed &= testAddAndLookup();
+        allPassed &= testRemove();
+        allPassed &= testMove();
+        allPassed &= testPersistence();
+        allPassed &= testSignals();
+        allPassed &= testExportImport();
+        allPassed &= testImportLegacyFileOnce();
+
+        std::cout << std::endl;
+        if (allPassed) {
+            std::cout << "=== 所有测试通过 ===" << std::endl;
+        } else {
+            std::cout << "=== 部分测试失败 ===" << std::endl;
+        }
+        return allPassed;
+    }
+
+private:
+    std::string testDataDir_;
+
+    bool testInitialize() {
+        auto& mgr = CustomPhraseManager::instance();
+        TEST_ASSERT(mgr.initialize(testDataDir_), "初始化成功");
+        TEST_ASSERT(mgr.isInitialized(), "已初始化");
+        TEST_ASSERT(fs::exists(mgr.getDatabasePath()), "数据库文件已创建");
+        TEST_ASSERT(mgr.getPhraseCount() == 0, "初始为空");
+
+        TEST_PASS("testInitialize: 初始化正常");
+        return true;
+    }
+
+    bool testAddAndLookup() {
+        auto& mgr = CustomPhraseManager::instance();
+        mgr.clearAll();
+
+        TEST_ASSERT(mgr.addPhrase("yx", "user@example.com"), "添加短语");
+        TEST_ASSERT(mgr.addPhrase("yx", "work@example.com"), "追加短语");
+        TEST_ASSERT(mgr.addPhrase("yx", "first@example.com", 0), "插入到首位");
+        TEST_ASSERT(!mgr.addPhrase("yx", "user@example.com"), "重复短语被拒绝");
+        TEST_ASSERT(!mgr.addPhrase("", "empty"), "空编码被拒绝");
+
+        const auto& phrases = mgr.lookup("yx");
+        TEST_ASSERT(phrases.size() == 3, "短语数量");
+        TEST_ASSERT(phrases[0] == "first@example.com", "插入位置");
+        TEST_ASSERT(phrases[1] == "user@example.com", "原顺序后移");
+        TEST_ASSERT(phrases[2] == "work@example.com", "末尾短语");
+        TEST_ASSERT(mgr.lookup("none").empty(), "未知编码返回空");
+        TEST_ASSERT(mgr.hasCode("yx") && !mgr.hasCode("none"), "hasCode");
+        TEST_ASSERT(mgr.getPhraseCount() == 3, "短语总数");
+
+        TEST_PASS("testAddAndLookup: 添加与查询正常");
+        return true;
+    }
+
+    bool testRemove() {
+        auto& mgr = CustomPhraseManager::instance();
+
+        TEST_ASSERT(mgr.removePhrase("yx", "user@example.com"), "删除短语");
+        TEST_ASSERT(!mgr.removePhrase("yx", "user@example.com"), "重复删除失败");
+        TEST_ASSERT(mgr.lookup("yx").size() == 2, "剩余两条");
+        TEST_ASSERT(mgr.lookup("yx")[1] == "work@example.com", "后续短语前移");
+
+        mgr.removePhrase("yx", "first@example.com");
+        mgr.removePhrase("yx", "work@example.com");
+        TEST_ASSERT(!mgr.hasCode("yx"), "删空后编码移除");
+        TEST_ASSERT(mgr.getPhraseCount() == 0, "总数归零");
+
+        TEST_PASS("testRemove: 删除正常");
+        return true;
+    }
+
+    bool testMove() {
+        auto& mgr = CustomPhraseManager::instance();
+        mgr.clearAll();
+        mgr.addPhrase("sj", "A");
+        mgr.addPhrase("sj", "B");
+        mgr.addPhrase("sj", "C");
+
+        TEST_ASSERT(mgr.movePhrase("sj", "C", 0), "移到首位");
+        const auto& phrases = mgr.lookup("sj");
+        TEST_ASSERT(phrases[0] == "C" && phrases[1] == "A" && phrases[2] == "B", "顺序 C A B");
+
+        TEST_ASSERT(mgr.movePhrase("sj", "C", -1), "移到末尾");
+        TEST_ASSERT(mgr.lookup("sj")[2] == "C", "顺序 A B C");
+        TEST_ASSERT(!mgr.movePhrase("sj", "D", 0), "不存在的短语");
+
+        TEST_PASS("testMove: 调序正常");
+        return true;
+    }
+
+    bool testPersistence() {
+        auto& mgr = CustomPhraseManager::instance();
+        mgr.clearAll();
+        mgr.addPhrase("dz", "地址一");
+        mgr.addPhrase("dz", "地址二");
+        mgr.movePhrase("dz", "地址二", 0);
+
+        // 重新打开后顺序保持
+        mgr.shutdown();
+        TEST_ASSERT(mgr.initialize(testDataDir_), "重新初始化");
+        const auto& phrases = mgr.lookup("dz");
+        TEST_ASSERT(phrases.size() == 2, "持久化数量");
+        TEST_ASSERT(phrases[0] == "地址二" && phrases[1] == "地址一", "持久化顺序");
+
+        TEST_PASS("testPersistence: 持久化正常");
+        return true;
+    }
+
+    bool testSignals() {
+        auto& mgr = CustomPhraseManager::instance();
+        QSignalSpy changedSpy(&mgr, &CustomPhraseManager::phrasesChanged);
+        QSignalSpy reloadedSpy(&mgr, &CustomPhraseManager::dataReloaded);
+
+        mgr.addPhrase("xh", "信号");
+        TEST_ASSERT(changedSpy.count() == 1, "添加发出 phrasesChanged");
+        TEST_ASSERT(changedSpy.takeFirst().at(0).toString() == "xh", "信号携带编码");
+
+        mgr.clearAll();
+        TEST_ASSERT(reloadedSpy.count() == 1, "清空发出 dataReloaded");
+
+        TEST_PASS("testSignals: 信号正常");
+        return true;
+    }
+
+    bool testExportImport() {
+        auto& mgr = CustomPhraseManager::instance();
+        mgr.clearAll();
+        mgr.addPhrase("yx", "a@example.com");
+        mgr.addPhrase("yx", "b@example.com");
+        mgr.addPhrase("sj", "13800000000");
+
+        std::string exportPath = testDataDir_ + "/custom_phrase.txt";
+        TEST_ASSERT(mgr.exportToFile(exportPath), "导出成功");
+
+        std::ifstream in(exportPath);
+        std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        TEST_ASSERT(content.find("#@/db_name\tcustom_phrase.txt") != std::string::npos, "RIME 文件头");
+        TEST_ASSERT(content.find("a@example.com\tyx\t2\n") != std::string::npos, "首位权重最高");
+        TEST_ASSERT(content.find("b@example.com\tyx\t1\n") != std::string::npos, "次位权重");
+
+        // 替换导入：权重决定顺序
+        std::string importPath = testDataDir_ + "/import.txt";
+        {
+            std::ofstream out(importPath);
+            out << "# 注释\n";
+            out << "低\tdj\t1\n";
+            out << "高\tdj\t9\n";
+            out << "无权重\twq\n";
+        }
+        TEST_ASSERT(mgr.importFromFile(importPath, false) == 3, "导入三条");
+        TEST_ASSERT(!mgr.hasCode("yx"), "替换模式清空旧数据");
+        TEST_ASSERT(mgr.lookup("dj")[0] == "高" && mgr.lookup("dj")[1] == "低", "按权重排序");
+        TEST_ASSERT(mgr.lookup("wq").size() == 1, "无权重条目");
+
+        // 往返：导出再导入结果一致
+        TEST_ASSERT(mgr.exportToFile(exportPath), "再次导出");
+        TEST_ASSERT(mgr.importFromFile(exportPath, false) == 3, "往返导入");
+        TEST_ASSERT(mgr.lookup("dj")[0] == "高", "往返后顺序不变");
+
+        TEST_PASS("testExportImport: 导入导出正常");
+        return true;
+    }
+
+    bool testImportLegacyFileOnce() {
+        auto& mgr = CustomPhraseManager::instance();
+        mgr.shutdown();
+        fs::remove_all(testDataDir_);
+        TEST_ASSERT(mgr.initialize(testDataDir_), "初始化");
+
+        // 用户目录没有文件时使用共享目录的文件
+        std::string userPath = testDataDir_ + "/user/custom_phrase.txt";
+        std::string sharedPath = testDataDir_ + "/shared/custom_phrase.txt";
+        fs::create_directories(testDataDir_ + "/shared");
+        {
+            std::ofstream out(sharedPath);
+            out << "# Rime table\n";
+            out << "邮箱\tyx\n";
+            out << "手机\tsj\n";
+        }
+        TEST_ASSERT(mgr.importLegacyFileOnce({userPath, sharedPath}) == 2, "首次导入");
+        TEST_ASSERT(mgr.lookup("yx").size() == 1, "导入的短语可查询");
+
+        // 只导入一次：删除的短语不会重新出现，重新打开后也不再导入
+        TEST_ASSERT(mgr.removePhrase("yx", "邮箱"), "删除短语");
+        TEST_ASSERT(mgr.importLegacyFileOnce({userPath, sharedPath}) == 0, "不重复导入");
+        mgr.shutdown();
+        TEST_ASSERT(mgr.initialize(testDataDir_), "重新初始化");
+        TEST_ASSERT(mgr.importLegacyFileOnce({userPath, sharedPath}) == 0, "重新打开后不重复导入");
+        TEST_ASSERT(!mgr.hasCode("yx") && mgr.hasCode("sj"), "删除的短语没有重新导入");
+
+        TEST_PASS("testImportLegacyFileOnce: 一次性导入正常");
+        return true;
+    }
+};
+
+int main(int argc, char* argv[]) {
+    // 需要 QCoreApplication 来支持 Qt 信号
+    QCoreApplication app(argc, argv);
+
+    CustomPhraseManagerTest test;
+    return test.runAllTests() ? 0 : 1;
+}
@@ -0,0 +1,208 @@
+/**
+ * EnglishCompleter 单元测试
+ *
+ * 测试英文补全索引的生成与映射、前缀查询的排序和大小写处理。
+ */
+
+#include <iostream>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include "english_completer.h"
+
+namespace fs = std::filesystem;
+using suyan::EnglishCompleter;
+
+// 测试辅助宏
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "✗ 断言失败: " << message << std::endl; \
+            std::cerr << "  位置: " << __FILE__ << ":" << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define TEST_PASS(message) \
+    std::cout << "✓ " << message << std::endl
+
+class EnglishCompleterTest {
+public:
+    EnglishCompleterTest() {
+        testDir_ = fs::temp_directory_path().string() + "/suyan_english_test";
+        fs::remove_all(testDir_);
+        userDir_ = testDir_ + "/user";
+        sharedDir_ = testDir_ + "/shared";
+        fs::create_directories(userDir_);
+        fs::create_directories(sharedDir_ + "/en_dicts");
+    }
+
+    ~EnglishCompleterTest() {
+        EnglishCompleter::instance().shutdown();
+        fs::remove_all(testDir_);
+    }
+
+    bool runAllTests() {
+        std::cout << "=== EnglishCompleter 单元测试 ===" << std::endl;
+        std::cout << std::endl;
+
+        bool allPassed = true;
+
+        allPassed &= testBuildAndComplete();
+        allPassed &= testCaseHandling();
+        allPassed &= testInvalidIndex();
+        allPassed &= testRebuildOnDictionaryChange();
+
+        std::cout << std::endl;
+        if (allPassed) {
+            std::cout << "=== 所有测试通过 ===" << std::endl;
+        } else {
+            std::cout << "=== 部分测试失败 ===" << std::endl;
+        }
+        return allPassed;
+    }
+
+private:
+    std::string testDir_;
+    std::string userDir_;
+    std::string sharedDir_;
+
+    void writeFile(const std::string& path, const std::string& content) {
+        std::ofstream out(path, std::ios::trunc);
+        out << content;
+    }
+
+    void writeDictionaries() {
+        writeFile(sharedDir_ + "/melt_eng.dict.yaml",
+                  "---\n"
+                  "name: melt_eng\n"
+                  "import_tables:\n"
+                  "  - en_dicts/en_ext\n"
+                  "  - en_dicts/en\n"
+                  "...\n");
+        writeFile(sharedDir_ + "/en_dicts/en_ext.dict.yaml",
+                  "---\n"
+                  "name: en_ext\n"
+                  "...\n"
+                  "help\thelp\t10\n"
+                  "iPhone\tiphone\n"
+                  "HTML\thtml\n");
+        writeFile(sharedDir_ + "/en_dicts/en.dict.yaml",
+                  "---\n"
+                  "name: en\n"
+                  "...\n"
+                  "# 注释\n"
+                  "hello\thello\n"
+                  "help\thelp\n"
+                  "helpful\thelpful\n"
+                  "he\the\n"
+                  "held\theld\n"
+                  "He'll\thell\n"
+                  "word\tword\n"
+                  "web3\tweb3\n"
+                  "naïve\tnaïve\n");
+    }
+
+    bool testBuildAndComplete() {
+        writeDictionaries();
+
+        auto& completer = EnglishCompleter::instance();
+        TEST_ASSERT(completer.initialize(userDir_, sharedDir_), "初始化成功");
+        TEST_ASSERT(completer.isInitialized(), "索引已映射");
+        TEST_ASSERT(fs::exists(completer.getIndexPath()), "索引已生成");
+
+        // 有权重的排最前，其余按编码长度、再按词库顺序
+        auto results = completer.complete("he", 10);
+        TEST_ASSERT(results.size() == 6, "「he」的补全数量");
+        TEST_ASSERT(results[0] == "help", "高权重优先");
+        TEST_ASSERT(results[1] == "he", "其后编码较短者优先");
+        TEST_ASSERT(results[2] == "held" && results[3] == "He'll", "同长度按词库顺序");
+        TEST_ASSERT(results[4] == "hello" && results[5] == "helpful", "长单词在后");
+
+        // 同一单词只出现一次
+        results = completer.complete("help", 10);
+        TEST_ASSERT(results.size() == 2 && results[0] == "help" && results[1] == "helpful", "重复单词去重");
+
+        TEST_ASSERT(completer.complete("he", 2).size() == 2, "数量限制");
+        TEST_ASSERT(completer.complete("web", 5).size() == 1, "编码可包含数字");
+        TEST_ASSERT(completer.complete("na", 5).empty(), "非字母数字编码被跳过");
+        TEST_ASSERT(completer.complete("xyz", 5).empty(), "无匹配");
+        TEST_ASSERT(completer.complete("", 5).empty(), "空前缀");
+
+        TEST_PASS("testBuildAndComplete: 索引生成与查询正常");
+        return true;
+    }
+
+    bool testCaseHandling() {
+        auto& completer = EnglishCompleter::instance();
+
+        auto results = completer.complete("Hel", 3);
+        TEST_ASSERT(results.size() == 3 && results[0] == "Help" && results[1] == "Held", "首字母大写");
+        TEST_ASSERT(results[2] == "He'll", "带大写的单词保持原样");
+
+        results = completer.complete("HEL", 1);
+        TEST_ASSERT(results.size() == 1 && results[0] == "HELP", "全部大写");
+
+        results = completer.complete("Ip", 1);
+        TEST_ASSERT(results.size() == 1 && results[0] == "iPhone", "词库中的大小写保持原样");
+
+        results = completer.complete("Ht", 1);
+        TEST_ASSERT(results.size() == 1 && results[0] == "HTML", "缩写保持原样");
+
+        TEST_PASS("testCaseHandling: 大小写处理正常");
+        return true;
+    }
+
+    bool testInvalidIndex() {
+        auto& completer = EnglishCompleter::instance();
+        std::string badPath = testDir_ + "/bad.bin";
+
+        writeFile(badPath, "not an index");
+        TEST_ASSERT(!completer.loadIndex(badPath), "格式不符的文件被拒绝");
+
+        // 截断的索引
+        std::ifstream in(completer.getIndexPath(), std::ios::binary);
+        std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        writeFile(badPath, content.substr(0, content.size() - 1));
+        TEST_ASSERT(!completer.loadIndex(badPath), "截断的文件被拒绝");
+        TEST_ASSERT(completer.complete("he", 5).empty(), "无索引时无结果");
+
+        TEST_ASSERT(completer.loadIndex(completer.getIndexPath()), "重新映射");
+        TEST_ASSERT(!completer.complete("he", 5).empty(), "恢复查询");
+
+        TEST_PASS("testInvalidIndex: 索引校验正常");
+        return true;
+    }
+
+    bool testRebuildOnDictionaryChange() {
+        auto& completer = EnglishCompleter::instance();
+        completer.shutdown();
+
+        // 索引比词库新时不重新生成
+        auto indexPath = userDir_ + "/english.bin";
+        auto before = fs::last_write_time(indexPath);
+        TEST_ASSERT(completer.initialize(userDir_, sharedDir_), "初始化");
+        TEST_ASSERT(fs::last_write_time(indexPath) == before, "索引未重新生成");
+        completer.shutdown();
+
+        // 词库更新后重新生成
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        writeFile(sharedDir_ + "/en_dicts/en.dict.yaml",
+                  "---\nname: en\n...\n"
+                  "world\tworld\n");
+        fs::last_write_time(sharedDir_ + "/en_dicts/en.dict.yaml",
+                            before + std::chrono::seconds(1));
+        TEST_ASSERT(completer.initialize(userDir_, sharedDir_), "初始化");
+        auto results = completer.complete("wor", 5);
+        TEST_ASSERT(results.size() == 1 && results[0] == "world", "新词库生效");
+        TEST_ASSERT(completer.complete("hello", 5).empty(), "旧词条已移除");
+
+        TEST_PASS("testRebuildOnDictionaryChange: 词库更新后重新生成");
+        return true;
+    }
+};
+
+int main() {
+    EnglishCompleterTest test;
+    return test.runAllTests() ? 0 : 1;
+}
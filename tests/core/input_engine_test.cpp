@@ -8,16 +8,19 @@
  * - 模式切换
  * - 状态管理
  * - 词频学习
+ * - 联想
  */
 
 #include <iostream>
 #include <cassert>
 #include <filesystem>
+#include <fstream>
 #include <vector>
 #include <string>
 
 // Qt 头文件必须在 rime_api.h 之前包含
 #include "frequency_manager.h"
+#include "custom_phrase_manager.h"
 
 #ifdef Bool
 #undef Bool
@@ -25,6 +28,7 @@
 
 #include "input_engine.h"
 #include "platform_bridge.h"
+#include "association_engine.h"
 
 #ifdef Bool
 #undef Bool
@@ -176,6 +180,15 @@ public:
 
         // 回调测试
         allPassed &= testCallbacks();
+
+        // 批量按键测试
+        allPassed &= testProcessKeySequence();
+
+        // 自定义短语测试
+        allPassed &= testCustomPhrases();
+
+        // 联想测试
+        allPassed &= testAssociations();
         
         // 词频学习测试
         allPassed &= testFrequencyLearning();
@@ -491,6 +504,222 @@ private:
         return true;
     }
     
+    // ========== 批量按键测试 ==========
+
+    bool testProcessKeySequence() {
+        engine_.reset();
+
+        int stateChangedCount = 0;
+        std::vector<std::string> commits;
+        engine_.setStateChangedCallback([&](const suyan::InputState&) {
+            stateChangedCount++;
+        });
+        engine_.setCommitTextCallback([&](const std::string& text) {
+            commits.push_back(text);
+        });
+
+        // 输入 nihao 后空格上屏，再输入 ma：一次提交，一次状态通知
+        std::vector<suyan::KeyEvent> keys;
+        for (char c : std::string("nihao")) {
+            keys.push_back({c, 0});
+        }
+        keys.push_back({suyan::KeyCode::Space, 0});
+        keys.push_back({'m', 0});
+        keys.push_back({'a', 0});
+
+        auto result = engine_.processKeySequence(keys);
+        TEST_ASSERT(result.handledCount == static_cast<int>(keys.size()), "所有按键都应被处理");
+        TEST_ASSERT(stateChangedCount == 1, "批量处理只应通知一次状态变化");
+        TEST_ASSERT(commits.size() == 1 && !commits[0].empty(), "期间的提交应合并为一次");
+        TEST_ASSERT(result.outputs.size() == 1 && result.outputs[0].isCommit &&
+                    result.outputs[0].text == commits[0], "结果中记录提交的文字");
+        std::cout << "  批量提交: " << commits[0] << std::endl;
+
+        auto state = engine_.getState();
+        TEST_ASSERT(state.rawInput == "ma", "批量处理后应继续输入 'ma'，实际是: " + state.rawInput);
+
+        // 未处理的按键：之前的提交先送达，之后的提交在按键之后
+        engine_.reset();
+        commits.clear();
+        std::vector<std::string> order;
+        engine_.setCommitTextCallback([&](const std::string& text) {
+            commits.push_back(text);
+            order.push_back("commit");
+        });
+        // 没有输入时的回车由应用处理（换行）
+        const suyan::KeyEvent passKey{suyan::KeyCode::Return, 0};
+        std::vector<suyan::KeyEvent> mixed;
+        for (char c : std::string("nihao")) {
+            mixed.push_back({c, 0});
+        }
+        mixed.push_back({suyan::KeyCode::Space, 0});
+        mixed.push_back(passKey);
+        for (char c : std::string("ma")) {
+            mixed.push_back({c, 0});
+        }
+        mixed.push_back({suyan::KeyCode::Space, 0});
+
+        auto mixedResult = engine_.processKeySequence(mixed, [&](const suyan::KeyEvent& key) {
+            order.push_back(key.keyCode == passKey.keyCode ? "key" : "other");
+        });
+        TEST_ASSERT(mixedResult.handledCount == static_cast<int>(mixed.size()) - 1, "没有输入时的回车不由引擎处理");
+        TEST_ASSERT(order == std::vector<std::string>({"commit", "key", "commit"}), "提交与未处理按键按顺序交错");
+        TEST_ASSERT(mixedResult.outputs.size() == 3 &&
+                    mixedResult.outputs[0].isCommit && mixedResult.outputs[0].text == commits[0] &&
+                    !mixedResult.outputs[1].isCommit && mixedResult.outputs[1].key.keyCode == passKey.keyCode &&
+                    mixedResult.outputs[2].isCommit && mixedResult.outputs[2].text == commits[1],
+                    "结果按顺序记录提交和未处理的按键");
+
+        // 空序列不触发任何回调
+        stateChangedCount = 0;
+        auto emptyResult = engine_.processKeySequence(nullptr, 0);
+        TEST_ASSERT(emptyResult.handledCount == 0 && emptyResult.outputs.empty(), "空序列没有输出");
+        TEST_ASSERT(stateChangedCount == 0, "空序列不通知状态变化");
+
+        // 清除引用局部变量的回调
+        engine_.setStateChangedCallback(nullptr);
+        engine_.setCommitTextCallback(nullptr);
+        engine_.reset();
+
+        TEST_PASS("testProcessKeySequence: 批量按键处理正常");
+        return true;
+    }
+
+    // ========== 自定义短语测试 ==========
+
+    bool testCustomPhrases() {
+        std::string phraseDataDir = userDataDir_ + "/custom_phrase_test";
+        fs::remove_all(phraseDataDir);
+        fs::create_directories(phraseDataDir);
+
+        auto& phraseMgr = suyan::CustomPhraseManager::instance();
+        if (phraseMgr.isInitialized()) {
+            phraseMgr.shutdown();
+        }
+        TEST_ASSERT(phraseMgr.initialize(phraseDataDir), "CustomPhraseManager 初始化应该成功");
+        phraseMgr.clearAll();
+
+        std::vector<std::string> commits;
+        engine_.setCommitTextCallback([&](const std::string& text) {
+            commits.push_back(text);
+        });
+
+        // 有 RIME 候选时：首个短语为首选，空格上屏短语
+        TEST_ASSERT(phraseMgr.addPhrase("ni", "你好呀"), "添加短语");
+        engine_.reset();
+        engine_.processKeyEvent('n', 0);
+        engine_.processKeyEvent('i', 0);
+        auto state = engine_.getState();
+        TEST_ASSERT(!state.candidates.empty() && state.candidates[0].text == "你好呀", "短语排在首位");
+        TEST_ASSERT(state.highlightedIndex == 0, "首个短语为高亮候选");
+        TEST_ASSERT(static_cast<int>(state.candidates.size()) <= state.pageSize, "合并后不超过一页");
+        engine_.processKeyEvent(suyan::KeyCode::Space, 0);
+        TEST_ASSERT(!commits.empty() && commits.back() == "你好呀", "空格上屏首个短语");
+
+        // 短语超过一页：只显示一页，数字键选到最后一个显示的短语
+        for (int i = 1; i <= 12; ++i) {
+            phraseMgr.addPhrase("ni", "短语" + std::to_string(i));
+        }
+        engine_.processKeyEvent('n', 0);
+        engine_.processKeyEvent('i', 0);
+        state = engine_.getState();
+        TEST_ASSERT(static_cast<int>(state.candidates.size()) == state.pageSize, "短语过多时只显示一页");
+        std::string lastShown = state.candidates.back().text;
+        engine_.processKeyEvent('0' + state.pageSize, 0);
+        TEST_ASSERT(commits.back() == lastShown, "数字键按显示位置上屏");
+
+        // RIME 没有候选时（全拼没有以 u 开头的音节）：只显示短语，高亮不越界，空格上屏短语
+        TEST_ASSERT(phraseMgr.addPhrase("uu", "有有"), "添加短语");
+        engine_.processKeyEvent('u', 0);
+        engine_.processKeyEvent('u', 0);
+        state = engine_.getState();
+        TEST_ASSERT(!state.candidates.empty() && state.candidates[0].text == "有有", "短语排在首位");
+        TEST_ASSERT(state.highlightedIndex >= 0 &&
+                    state.highlightedIndex < static_cast<int>(state.candidates.size()), "高亮在候选范围内");
+        engine_.processKeyEvent(suyan::KeyCode::Space, 0);
+        TEST_ASSERT(commits.back() == "有有", "空格上屏短语");
+
+        // 清理
+        engine_.setCommitTextCallback(nullptr);
+        engine_.reset();
+        phraseMgr.clearAll();
+        phraseMgr.shutdown();
+
+        TEST_PASS("testCustomPhrases: 自定义短语选择正常");
+        return true;
+    }
+
+    // ========== 联想测试 ==========
+
+    bool testAssociations() {
+        std::string assocDir = userDataDir_ + "/association_test";
+        fs::remove_all(assocDir);
+        fs::create_directories(assocDir);
+        {
+            std::ofstream dict(assocDir + "/rime_ice.dict.yaml", std::ios::trunc);
+            dict << "---\nname: rime_ice\n...\n"
+                 << "你好吗\tni hao ma\t100\n"
+                 << "你好世界\tni hao shi jie\t90\n"
+                 << "好的\thao de\t80\n";
+        }
+        auto& association = suyan::AssociationEngine::instance();
+        association.shutdown();
+        TEST_ASSERT(association.initialize(assocDir, assocDir), "AssociationEngine 初始化应该成功");
+
+        std::vector<std::string> commits;
+        engine_.setCommitTextCallback([&](const std::string& text) {
+            commits.push_back(text);
+        });
+        auto typeAndCommit = [&](const std::string& input) {
+            for (char c : input) {
+                engine_.processKeyEvent(c, 0);
+            }
+            engine_.processKeyEvent(suyan::KeyCode::Space, 0);
+        };
+
+        // 默认关闭：提交后的数字键交给应用
+        engine_.reset();
+        TEST_ASSERT(!engine_.isAssociationEnabled(), "联想默认关闭");
+        typeAndCommit("nihao");
+        TEST_ASSERT(commits.size() == 1, "提交一次");
+        TEST_ASSERT(!engine_.processKeyEvent('1', 0), "联想关闭时数字键不被拦截");
+        TEST_ASSERT(commits.size() == 1, "数字键不提交联想");
+
+        // 启用后：联想显示时数字键选择联想
+        engine_.setAssociationEnabled(true);
+        engine_.reset();
+        commits.clear();
+        typeAndCommit("nihao");
+        auto state = engine_.getState();
+        TEST_ASSERT(!state.candidates.empty(), "提交后显示联想，提交的是: " + commits.back());
+        TEST_ASSERT(engine_.processKeyEvent('1', 0), "数字键选择联想");
+        TEST_ASSERT(commits.size() == 2, "联想短语上屏");
+
+        // 批量处理（连续输入）中的数字键不选择联想
+        engine_.reset();
+        commits.clear();
+        std::vector<suyan::KeyEvent> keys;
+        for (char c : std::string("nihao")) {
+            keys.push_back({c, 0});
+        }
+        keys.push_back({suyan::KeyCode::Space, 0});
+        keys.push_back({'1', 0});
+        auto result = engine_.processKeySequence(keys);
+        TEST_ASSERT(result.handledCount == static_cast<int>(keys.size()) - 1, "数字键由应用处理");
+        TEST_ASSERT(commits.size() == 1, "只提交输入的文字");
+        TEST_ASSERT(!result.outputs.empty() && !result.outputs.back().isCommit &&
+                    result.outputs.back().key.keyCode == '1', "数字键原样输出");
+
+        // 清理
+        engine_.setCommitTextCallback(nullptr);
+        engine_.setAssociationEnabled(false);
+        engine_.reset();
+        association.shutdown();
+
+        TEST_PASS("testAssociations: 联想开关与数字键处理正常");
+        return true;
+    }
+
     // ========== 词频学习测试 ==========
     
     bool testFrequencyLearning() {